@@ -14,156 +14,620 @@
 // limitations under the License.
 //
 #include "AL/usdmaya/CodeTimings.h"
-#include <vector>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace AL {
 namespace usdmaya {
 
+namespace {
+
 //----------------------------------------------------------------------------------------------------------------------
-Profiler::ProfilerSectionStackNode Profiler::m_timeStack[MAX_TIMESTAMP_STACK_SIZE];
-uint32_t Profiler::m_stackPos = 0;
-Profiler::ProfilerSectionPathLUT Profiler::m_map;
+/// \brief  a completed section, as recorded by the thread that ran it
+//----------------------------------------------------------------------------------------------------------------------
+struct ProfilerEvent
+{
+  const ProfilerSectionTag* m_entry; ///< the section that was run
+  uint64_t m_start; ///< the time the section started (in nanoseconds since the profiler was first used)
+  uint64_t m_end; ///< the time the section ended (in nanoseconds since the profiler was first used)
+  uint32_t m_depth; ///< the number of sections the section was nested within
+};
+
+/// the number of events held in each block of a thread's event buffer
+const size_t EVENTS_PER_CHUNK = 4096;
 
+/// the maximum number of blocks in a thread's event buffer. Once a thread has filled them all, it overwrites its
+/// oldest events.
+const size_t MAX_CHUNKS_PER_THREAD = 64;
+
+/// the value of ThreadEvents::m_rootBegin while a thread is not running a section
+const size_t NO_OPEN_SECTION = size_t(-1);
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  a block of events in a thread's event buffer. Blocks are never moved once allocated, so the events within
+///         them can be read while the thread appends to later blocks.
 //----------------------------------------------------------------------------------------------------------------------
-inline bool Profiler::compareTimeStamps(const iter_t a, const iter_t b)
+struct ProfilerEventChunk
 {
-  if(a->second.tv_sec > b->second.tv_sec) return true;
-  if(a->second.tv_sec < b->second.tv_sec) return false;
-  return a->second.tv_nsec > b->second.tv_nsec;
-}
+  ProfilerEvent m_events[EVENTS_PER_CHUNK];
+  ProfilerEventChunk* m_next = nullptr;
+};
 
-#define INDENT for(uint32_t i = 0; i < indent; ++i) os << "  ";
+//----------------------------------------------------------------------------------------------------------------------
+uint64_t currentTime()
+{
+  static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count());
+}
 
 //----------------------------------------------------------------------------------------------------------------------
-void Profiler::print(std::ostream& os, iter_t it, const ProfilerSectionPathLUT& lut, uint32_t indent, double total)
+double toMilliseconds(const uint64_t nanoseconds)
 {
-  const ProfilerSectionPath& hp = it->first;
-  const AL::usdmaya::ProfilerSectionTag& he = *hp.m_top;
+  return nanoseconds * 0.000001;
+}
 
-  double timeTaken = (it->second.tv_sec * 1000.0f + it->second.tv_nsec * 0.000001f);
-  double percentage = timeTaken / total;
-  percentage = int(10000.0 * percentage) * 0.01;
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  returns the duration at the given percentile (nearest rank) of the sorted durations
+//----------------------------------------------------------------------------------------------------------------------
+uint64_t percentile(const std::vector<uint64_t>& sortedDurations, const double p)
+{
+  if(sortedDurations.empty())
+  {
+    return 0;
+  }
+  size_t rank = size_t(std::ceil(p * sortedDurations.size()));
+  return sortedDurations[std::min(std::max(rank, size_t(1)), sortedDurations.size()) - 1];
+}
 
-  INDENT;
+//----------------------------------------------------------------------------------------------------------------------
+void printTime(std::ostream& os, const double timeTaken)
+{
   if(timeTaken > 20000.0)
   {
-    os << "[" << percentage << "%](" << (timeTaken * 0.001) << "S) " << he.m_sectionName << std::endl;
+    os << (timeTaken * 0.001) << "S";
   }
   else
   {
-    os << "[" << percentage << "%](" << timeTaken << "ms) " << he.m_sectionName << std::endl;
+    os << timeTaken << "ms";
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  the timings of all runs of a section (or of a path of sections), gathered for a report
+//----------------------------------------------------------------------------------------------------------------------
+struct ProfilerStats
+{
+  const ProfilerSectionTag* m_entry = nullptr;
+  std::vector<uint64_t> m_durations;
+  uint64_t m_total = 0;
+
+  void add(const uint64_t duration)
+  {
+    m_durations.push_back(duration);
+    m_total += duration;
+  }
+
+  void printCounts(std::ostream& os)
+  {
+    std::sort(m_durations.begin(), m_durations.end());
+    os << "n=" << m_durations.size() << ", p50=";
+    printTime(os, toMilliseconds(percentile(m_durations, 0.5)));
+    os << ", p99=";
+    printTime(os, toMilliseconds(percentile(m_durations, 0.99)));
+  }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  a node in the report tree. The path of sections leading to a node identifies it, so the same section
+///         called from two places appears twice.
+//----------------------------------------------------------------------------------------------------------------------
+struct ProfilerReportNode
+{
+  ProfilerStats m_stats;
+  std::unordered_map<const ProfilerSectionTag*, size_t> m_children;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+void writeJsonString(std::ostream& os, const std::string& str)
+{
+  os << '"';
+  for(const char c : str)
+  {
+    switch(c)
+    {
+    case '"': os << "\\\""; break;
+    case '\\': os << "\\\\"; break;
+    case '\n': os << "\\n"; break;
+    case '\r': os << "\\r"; break;
+    case '\t': os << "\\t"; break;
+    default:
+      if((unsigned char)c < 0x20)
+      {
+        const char* const hex = "0123456789abcdef";
+        os << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+      }
+      else
+      {
+        os << c;
+      }
+      break;
+    }
+  }
+  os << '"';
+}
+
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  the sections recorded by a single thread.
+///
+///         The stack is only ever touched by the owning thread. The owning thread appends completed sections to the
+///         chunks without locking, and then publishes them by incrementing m_count. The chunk list itself is only
+///         changed with the registry lock held (by the owning thread when it needs another chunk, and by clearAll),
+///         which is also held while reports read the published events. Events are indexed from the start of the
+///         thread, so the first chunk holds the events from m_headIndex onwards. When the thread exits, its events
+///         are handed back to the registry, which frees them on the next clearAll.
+//----------------------------------------------------------------------------------------------------------------------
+struct Profiler::ThreadEvents
+{
+  struct StackNode
+  {
+    const ProfilerSectionTag* m_entry;
+    uint64_t m_start;
+  };
+
+  struct Registry;
+  static Registry& registry();
+
+  ~ThreadEvents()
+  {
+    while(m_head)
+    {
+      ProfilerEventChunk* const next = m_head->m_next;
+      delete m_head;
+      m_head = next;
+    }
+  }
+
+  void append(const ProfilerEvent& event)
+  {
+    const size_t count = m_count.load(std::memory_order_relaxed);
+    const size_t offset = count % EVENTS_PER_CHUNK;
+    if(!offset)
+    {
+      addChunk();
+    }
+    m_tail->m_events[offset] = event;
+    m_count.store(count + 1, std::memory_order_release);
   }
 
-  std::vector<iter_t> sorted;
-  for(auto a = lut.begin(), e = lut.end(); a != e; ++a)
+  void addChunk();
+
+  /// must be called with the registry locked
+  ProfilerEventChunk* popHead()
   {
-    if(a->first.m_parent == &hp)
+    ProfilerEventChunk* const chunk = m_head;
+    m_head = chunk->m_next;
+    if(!m_head)
     {
-      sorted.push_back(a);
+      m_tail = nullptr;
     }
+    chunk->m_next = nullptr;
+    m_headIndex += EVENTS_PER_CHUNK;
+    --m_numChunks;
+    m_begin = std::max(m_begin, m_headIndex);
+    m_reported = std::max(m_reported, m_begin);
+    return chunk;
   }
-  std::sort(sorted.begin(), sorted.end(), compareTimeStamps);
 
-  for(auto a = sorted.begin(), e = sorted.end(); a != e; ++a)
+  /// must be called with the registry locked. Frees the chunks whose events have all been discarded by clearAll,
+  /// except for the last one, which the owning thread may still be appending to.
+  void freeDiscardedChunks()
   {
-    print(os, *a, lut, indent + 1, total);
+    while(m_head != m_tail && m_headIndex + EVENTS_PER_CHUNK <= m_begin)
+    {
+      delete popHead();
+    }
   }
+
+  /// must be called with the registry locked
+  void copyEvents(const size_t first, const size_t last, std::vector<ProfilerEvent>& events) const
+  {
+    assert(first >= m_headIndex);
+    const ProfilerEventChunk* chunk = m_head;
+    for(size_t i = m_headIndex / EVENTS_PER_CHUNK; i < first / EVENTS_PER_CHUNK; ++i)
+    {
+      chunk = chunk->m_next;
+    }
+    for(size_t i = first; i < last; ++i)
+    {
+      const size_t offset = i % EVENTS_PER_CHUNK;
+      if(i != first && !offset)
+      {
+        chunk = chunk->m_next;
+      }
+      events.push_back(chunk->m_events[offset]);
+    }
+  }
+
+  StackNode m_stack[MAX_TIMESTAMP_STACK_SIZE];
+  uint32_t m_stackPos = 0;
+  uint32_t m_threadIndex = 0;
+  bool m_exited = false; ///< set (with the registry locked) once the owning thread has exited
+
+  ProfilerEventChunk* m_head = nullptr;
+  ProfilerEventChunk* m_tail = nullptr;
+  std::atomic<size_t> m_count {0};
+
+  /// the number of events recorded before the thread started its current root section (or NO_OPEN_SECTION), so
+  /// that clearAll can keep the events of the sections that are still running
+  std::atomic<size_t> m_rootBegin {NO_OPEN_SECTION};
+
+  // only accessed with the registry locked
+  size_t m_headIndex = 0; ///< the index of the first event in m_head
+  size_t m_numChunks = 0; ///< the number of chunks from m_head to m_tail
+  size_t m_begin = 0; ///< the first event that has not been discarded by clearAll (or overwritten)
+  size_t m_reported = 0; ///< the first event that has not been reported by printReport
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  the event buffers of every thread that has recorded a section. The buffers are owned here (rather than by
+///         the threads), so that the sections run on worker threads can still be reported after the thread exits.
+///         The buffers of exited threads are freed by clearAll, or as soon as the thread exits if it has no events
+///         left to report.
+//----------------------------------------------------------------------------------------------------------------------
+struct Profiler::ThreadEvents::Registry
+{
+  std::mutex m_mutex;
+  std::vector<std::unique_ptr<ThreadEvents>> m_threads;
+  uint32_t m_nextThreadIndex = 0;
+
+  /// must be called with the registry locked
+  void erase(const ThreadEvents* const events)
+  {
+    m_threads.erase(std::remove_if(m_threads.begin(), m_threads.end(),
+        [events](const std::unique_ptr<ThreadEvents>& thread) { return thread.get() == events; }), m_threads.end());
+  }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+Profiler::ThreadEvents::Registry& Profiler::ThreadEvents::registry()
+{
+  static Registry r;
+  return r;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void Profiler::printReport(std::ostream& os)
+void Profiler::ThreadEvents::addChunk()
 {
-  double total = 0;
-  std::vector<iter_t> sorted;
-  for(auto a = m_map.begin(), e = m_map.end(); a != e; ++a)
+  std::lock_guard<std::mutex> lock(registry().m_mutex);
+
+  // reuse the oldest chunk if its events have been discarded, or if the buffer is full (losing its events)
+  ProfilerEventChunk* chunk;
+  if(m_head && (m_headIndex + EVENTS_PER_CHUNK <= m_begin || m_numChunks == MAX_CHUNKS_PER_THREAD))
+  {
+    chunk = popHead();
+  }
+  else
   {
-    if(!a->first.m_parent)
+    chunk = new ProfilerEventChunk;
+  }
+
+  if(m_tail)
+  {
+    m_tail->m_next = chunk;
+  }
+  else
+  {
+    m_head = chunk;
+  }
+  m_tail = chunk;
+  ++m_numChunks;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+Profiler::ThreadEvents& Profiler::threadEvents()
+{
+  // hands the thread's events back to the registry when the thread exits
+  struct Owner
+  {
+    ThreadEvents* m_events = nullptr;
+
+    ~Owner()
     {
-      total += (a->second.tv_sec * 1000.0f + a->second.tv_nsec * 0.000001f);
-      sorted.push_back(a);
+      if(!m_events)
+      {
+        return;
+      }
+      auto& r = ThreadEvents::registry();
+      std::lock_guard<std::mutex> lock(r.m_mutex);
+      if(m_events->m_count.load(std::memory_order_relaxed) == m_events->m_begin)
+      {
+        r.erase(m_events);
+      }
+      else
+      {
+        m_events->m_exited = true;
+      }
     }
+  };
+
+  static thread_local Owner owner;
+  if(!owner.m_events)
+  {
+    auto& r = ThreadEvents::registry();
+
+    std::unique_ptr<ThreadEvents> created(new ThreadEvents);
+
+    std::lock_guard<std::mutex> lock(r.m_mutex);
+    created->m_threadIndex = r.m_nextThreadIndex++;
+    owner.m_events = created.get();
+    r.m_threads.push_back(std::move(created));
   }
-  std::sort(sorted.begin(), sorted.end(), compareTimeStamps);
+  return *owner.m_events;
+}
 
-  for(auto a = sorted.begin(), e = sorted.end(); a != e; ++a)
+//----------------------------------------------------------------------------------------------------------------------
+void Profiler::pushTime(const AL::usdmaya::ProfilerSectionTag* entry)
+{
+  ThreadEvents& events = threadEvents();
+  assert(MAX_TIMESTAMP_STACK_SIZE > events.m_stackPos);
+
+  if(!events.m_stackPos)
   {
-    print(os, *a, m_map, 0, total);
+    events.m_rootBegin.store(events.m_count.load(std::memory_order_relaxed), std::memory_order_release);
   }
 
-  clearAll();
+  ThreadEvents::StackNode& node = events.m_stack[events.m_stackPos++];
+  node.m_entry = entry;
+  node.m_start = currentTime();
 }
 
-#ifdef _WIN32
+//----------------------------------------------------------------------------------------------------------------------
+void Profiler::popTime()
+{
+  const uint64_t endTime = currentTime();
+  ThreadEvents& events = threadEvents();
+  assert(events.m_stackPos > 0);
+  const ThreadEvents::StackNode& node = events.m_stack[--events.m_stackPos];
+  events.append(ProfilerEvent{node.m_entry, node.m_start, endTime, events.m_stackPos});
+  if(!events.m_stackPos)
+  {
+    events.m_rootBegin.store(NO_OPEN_SECTION, std::memory_order_release);
+  }
+}
 
-#include <Windows.h>
-int clock_gettime(int, struct timespec *spec)      //C-file part
+//----------------------------------------------------------------------------------------------------------------------
+const ProfilerSectionTag* Profiler::sectionTag(const std::string& sectionName, const char* filePath, size_t lineNumber)
 {
-  __int64 wintime; GetSystemTimeAsFileTime((FILETIME*)&wintime);
-  wintime -= 116444736000000000i64;  //1jan1601 to 1jan1970
-  spec->tv_sec = wintime / 10000000i64;           //seconds
-  spec->tv_nsec = wintime % 10000000i64 * 100;      //nano-seconds
-  return 0;
+  // the elements of an unordered_set are never moved, so the tags can be referenced by the recorded events
+  static std::mutex mutex;
+  static std::unordered_set<ProfilerSectionTag> tags;
+  std::lock_guard<std::mutex> lock(mutex);
+  return &*tags.emplace(sectionName, filePath, lineNumber).first;
 }
-#define CLOCK_REALTIME_COARSE 0
 
-#endif
+//----------------------------------------------------------------------------------------------------------------------
+void Profiler::beginReport()
+{
+  auto& r = ThreadEvents::registry();
+  std::lock_guard<std::mutex> lock(r.m_mutex);
+  for(auto& thread : r.m_threads)
+  {
+    thread->m_reported = thread->m_count.load(std::memory_order_acquire);
+  }
+}
 
 //----------------------------------------------------------------------------------------------------------------------
-void Profiler::pushTime(const AL::usdmaya::ProfilerSectionTag* entry)
+void Profiler::clearAll()
 {
-  assert(MAX_TIMESTAMP_STACK_SIZE > m_stackPos);
-  m_timeStack[m_stackPos].m_entry = entry;
-  #ifdef _WIN32
-  while(clock_gettime(CLOCK_REALTIME_COARSE, &m_timeStack[m_stackPos].m_time) != 0) /* deliberately empty */;
-  #endif
+  auto& r = ThreadEvents::registry();
+  std::lock_guard<std::mutex> lock(r.m_mutex);
+
+  // nothing will record into the buffers of threads that have exited, so free them now
+  r.m_threads.erase(std::remove_if(r.m_threads.begin(), r.m_threads.end(),
+      [](const std::unique_ptr<ThreadEvents>& thread) { return thread->m_exited; }), r.m_threads.end());
 
-  const timespec null_ts = {0, 0};
-  if(m_stackPos)
+  for(auto& thread : r.m_threads)
   {
-    auto parent = m_timeStack[m_stackPos - 1].m_path;
-    ProfilerSectionPath path(entry, &parent->first);
-    auto it = m_map.find(path);
-    if(it != m_map.end())
-    {
-      m_timeStack[m_stackPos].m_path = it;
-    }
-    else
-    {
-      m_map.insert(std::make_pair(path, null_ts));
-      m_timeStack[m_stackPos].m_path = m_map.find(path);
-    }
+    // keep the events recorded within the root section the thread is running (if any), so that it is still
+    // complete when it ends. The count is read first, so a root section that ends in between is kept as well.
+    const size_t count = thread->m_count.load(std::memory_order_acquire);
+    const size_t rootBegin = thread->m_rootBegin.load(std::memory_order_acquire);
+    thread->m_begin = std::max(thread->m_begin, std::min(count, rootBegin));
+    thread->m_reported = std::max(thread->m_reported, thread->m_begin);
+    thread->freeDiscardedChunks();
   }
-  else
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+static void printNode(
+    std::ostream& os,
+    std::vector<ProfilerReportNode>& nodes,
+    const size_t index,
+    const uint32_t indent,
+    const double total)
+{
+  ProfilerReportNode& node = nodes[index];
+  const double timeTaken = toMilliseconds(node.m_stats.m_total);
+  double percentage = total > 0 ? timeTaken / total : 0;
+  percentage = int(10000.0 * percentage) * 0.01;
+
+  for(uint32_t i = 0; i < indent; ++i) os << "  ";
+  os << "[" << percentage << "%](";
+  printTime(os, timeTaken);
+  os << ") " << node.m_stats.m_entry->sectionName() << " (";
+  node.m_stats.printCounts(os);
+  os << ")" << std::endl;
+
+  std::vector<size_t> sorted;
+  for(const auto& child : node.m_children)
+  {
+    sorted.push_back(child.second);
+  }
+  std::sort(sorted.begin(), sorted.end(), [&nodes](const size_t a, const size_t b)
+    { return nodes[a].m_stats.m_total > nodes[b].m_stats.m_total; });
+
+  for(const size_t child : sorted)
+  {
+    printNode(os, nodes, child, indent + 1, total);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void Profiler::printReport(std::ostream& os)
+{
+  // node 0 is a dummy root, whose children are the root sections of every thread
+  std::vector<ProfilerReportNode> nodes(1);
   {
-    ProfilerSectionPath path(entry, 0);
-    auto it = m_map.find(path);
-    if(it != m_map.end())
+    auto& r = ThreadEvents::registry();
+    std::lock_guard<std::mutex> lock(r.m_mutex);
+    std::vector<ProfilerEvent> events;
+    std::vector<size_t> path;
+    for(auto& thread : r.m_threads)
     {
-      m_timeStack[m_stackPos].m_path = it;
+      const size_t count = thread->m_count.load(std::memory_order_acquire);
+      events.clear();
+      thread->copyEvents(thread->m_reported, count, events);
+      thread->m_reported = count;
+
+      // the events are recorded as each section ends, so sort them back into the order they started (parents first)
+      std::sort(events.begin(), events.end(), [](const ProfilerEvent& a, const ProfilerEvent& b)
+        { return a.m_start < b.m_start || (a.m_start == b.m_start && a.m_depth < b.m_depth); });
+
+      path.assign(1, 0);
+      for(const ProfilerEvent& event : events)
+      {
+        // pop back to the parent of this event. If the parent has not completed yet (so was not recorded), this
+        // leaves the event under the closest recorded ancestor.
+        while(path.size() > event.m_depth + 1)
+        {
+          path.pop_back();
+        }
+
+        const size_t parent = path.back();
+        auto inserted = nodes[parent].m_children.emplace(event.m_entry, nodes.size());
+        if(inserted.second)
+        {
+          nodes.emplace_back();
+          nodes.back().m_stats.m_entry = event.m_entry;
+        }
+        const size_t index = inserted.first->second;
+        nodes[index].m_stats.add(event.m_end - event.m_start);
+        path.push_back(index);
+      }
     }
-    else
+  }
+
+  double total = 0;
+  for(const auto& root : nodes[0].m_children)
+  {
+    total += toMilliseconds(nodes[root.second].m_stats.m_total);
+  }
+
+  std::vector<size_t> sorted;
+  for(const auto& root : nodes[0].m_children)
+  {
+    sorted.push_back(root.second);
+  }
+  std::sort(sorted.begin(), sorted.end(), [&nodes](const size_t a, const size_t b)
+    { return nodes[a].m_stats.m_total > nodes[b].m_stats.m_total; });
+
+  for(const size_t root : sorted)
+  {
+    printNode(os, nodes, root, 0, total);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void Profiler::printSummary(std::ostream& os)
+{
+  std::unordered_map<const ProfilerSectionTag*, ProfilerStats> stats;
+  {
+    auto& r = ThreadEvents::registry();
+    std::lock_guard<std::mutex> lock(r.m_mutex);
+    std::vector<ProfilerEvent> events;
+    for(auto& thread : r.m_threads)
     {
-      m_map.insert(std::make_pair(path, null_ts));
-      m_timeStack[m_stackPos].m_path = m_map.find(path);
+      events.clear();
+      thread->copyEvents(thread->m_begin, thread->m_count.load(std::memory_order_acquire), events);
+      for(const ProfilerEvent& event : events)
+      {
+        ProfilerStats& s = stats[event.m_entry];
+        s.m_entry = event.m_entry;
+        s.add(event.m_end - event.m_start);
+      }
     }
   }
 
-  ++m_stackPos;
+  std::vector<ProfilerStats*> sorted;
+  for(auto& s : stats)
+  {
+    sorted.push_back(&s.second);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const ProfilerStats* a, const ProfilerStats* b)
+    { return a->m_total > b->m_total; });
+
+  for(ProfilerStats* s : sorted)
+  {
+    os << s->m_entry->sectionName() << " [" << s->m_entry->filePath() << ":" << s->m_entry->lineNumber() << "] total=";
+    printTime(os, toMilliseconds(s->m_total));
+    os << ", ";
+    s->printCounts(os);
+    os << std::endl;
+  }
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void Profiler::popTime()
+void Profiler::writeChromeTrace(std::ostream& os)
 {
-  assert(m_stackPos > 0);
-  --m_stackPos;
-  timespec endtime;
-  #ifdef _WIN32
-  while(clock_gettime(CLOCK_REALTIME_COARSE, &endtime) != 0) /* deliberately empty */;
-  #endif
-  // compute time difference
-  timespec diff = timeDiff(m_timeStack[m_stackPos].m_time, endtime);
-  m_timeStack[m_stackPos].m_path->second = timeAdd(diff, m_timeStack[m_stackPos].m_path->second);
+  auto& r = ThreadEvents::registry();
+  std::lock_guard<std::mutex> lock(r.m_mutex);
+
+  const std::ios::fmtflags flags = os.flags();
+  os << std::fixed << std::setprecision(3);
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  bool first = true;
+  std::vector<ProfilerEvent> events;
+  for(auto& thread : r.m_threads)
+  {
+    events.clear();
+    thread->copyEvents(thread->m_begin, thread->m_count.load(std::memory_order_acquire), events);
+    if(events.empty())
+    {
+      continue;
+    }
+
+    os << (first ? "\n" : ",\n");
+    first = false;
+    os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->m_threadIndex
+       << ",\"args\":{\"name\":\"AL_USDMaya thread " << thread->m_threadIndex << "\"}}";
+
+    for(const ProfilerEvent& event : events)
+    {
+      // timestamps are in microseconds
+      os << ",\n{\"name\":";
+      writeJsonString(os, event.m_entry->sectionName());
+      os << ",\"cat\":\"AL_USDMaya\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->m_threadIndex
+         << ",\"ts\":" << (event.m_start * 0.001)
+         << ",\"dur\":" << ((event.m_end - event.m_start) * 0.001)
+         << ",\"args\":{\"file\":";
+      writeJsonString(os, event.m_entry->filePath());
+      os << ",\"line\":" << event.m_entry->lineNumber() << "}}";
+    }
+  }
+
+  os << "\n]}\n";
+  os.flags(flags);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -14,13 +14,12 @@
 // limitations under the License.
 //
 #pragma once
-#include <unordered_map>
+#include "AL/usdmaya/Api.h"
+#include <functional>
 #include <string>
 #include <ostream>
-#include <ctime>
 #include <cassert>
 #include <stdint.h>
-#include <time.h>
 
 namespace AL {
 namespace usdmaya {
@@ -68,6 +67,18 @@ public:
   inline size_t hash() const
     { return m_hash;}
 
+  /// \brief  returns the human readable name of this section
+  inline const std::string& sectionName() const
+    { return m_sectionName; }
+
+  /// \brief  returns the file that contains this section
+  inline const std::string& filePath() const
+    { return m_filePath; }
+
+  /// \brief  returns the line number in the file where this section starts
+  inline size_t lineNumber() const
+    { return m_lineNumber; }
+
 private:
   const std::string m_sectionName; ///< the human readable identifier for this section
   const std::string m_filePath; ///< the file that contains this code section
@@ -75,56 +86,6 @@ private:
   const size_t m_hash; ///< unique hash to identify this section
 };
 
-//----------------------------------------------------------------------------------------------------------------------
-/// \ingroup  profiler
-/// \brief  This class represents a path made up of AL::usdmaya::ProfilerSectionTag's. It is used so that we can distinguish between
-///         identical code sections, accessed from alternative paths, e.g.
-/// \code
-/// void func1() {
-///   AL_BEGIN_PROFILE_SECTION(func1);
-///   AL_END_PROFILE_SECTION();
-/// }
-/// void func2() {
-///   AL_BEGIN_PROFILE_SECTION(func2);
-///   func1();
-///   AL_END_PROFILE_SECTION();
-/// }
-/// void func3() {
-///   AL_BEGIN_PROFILE_SECTION(func3);
-///   func1();
-///   AL_END_PROFILE_SECTION();
-/// }
-/// \endcode
-/// In this case, we can access func1 via two paths: |func2|func1, and |func3|func1
-//----------------------------------------------------------------------------------------------------------------------
-class ProfilerSectionPath
-{
-  friend class Profiler;
-public:
-
-  /// \brief  ctor
-  /// \param  top the top node on the profiling stack
-  /// \param  parent the parent path
-  inline ProfilerSectionPath(const AL::usdmaya::ProfilerSectionTag* const top, const ProfilerSectionPath* const parent = 0)
-    : m_top(top), m_parent(parent), m_hash(m_top->hash() ^ (m_parent ? m_parent->hash() : 0))
-    {}
-
-  /// \brief  equality operator
-  /// \param  rhs the right hand side of the comparison
-  /// \return true if the paths are the same
-  inline bool operator == (const ProfilerSectionPath& rhs) const
-    { return (m_hash == rhs.m_hash && m_top == rhs.m_top && m_parent == rhs.m_parent); }
-
-  /// \brief  return the hash of this class
-  /// \return the hash of this class
-  inline size_t hash() const
-    { return m_hash;}
-
-private:
-  const ProfilerSectionTag* const m_top;
-  const ProfilerSectionPath* const m_parent;
-  const size_t m_hash;
-};
 } // usdmaya
 } // AL
 
@@ -136,11 +97,6 @@ template<> struct hash<AL::usdmaya::ProfilerSectionTag> {
     return k.hash();
   }
 };
-template<> struct hash<AL::usdmaya::ProfilerSectionPath> {
-  inline size_t operator()(const AL::usdmaya::ProfilerSectionPath& k) const {
-    return k.hash();
-  }
-};
 } // std
 #endif
 
@@ -149,8 +105,8 @@ namespace AL {
 namespace usdmaya {
 //----------------------------------------------------------------------------------------------------------------------
 /// \ingroup  profiler
-/// \brief  This class implements a very simple incode profiler. This profiler is NOT thread safe. It is mainly used to
-///         get some basic stats on the where the bottlenecks are during a file import/export operation. A simple example
+/// \brief  This class implements a simple in-code profiler. It is mainly used to get some basic stats on where the
+///         bottlenecks are during file import/export, stage loads, variant switches, and selection. A simple example
 ///         of usage:
 /// \code
 /// void func1() {
@@ -180,76 +136,69 @@ namespace usdmaya {
 ///   AL::usdmaya::Profiler::printReport(std::cout);
 /// }
 /// \endcode
+///
+///         The profiler is thread safe. Each thread records the sections it completes into its own buffer, without
+///         taking any locks, and the buffers of all threads are merged when a report is generated. Sections are
+///         nested per thread, i.e. a section started on a worker thread is a root section of that thread.
+///
+///         Recorded sections are kept until clearAll() is called, so that a whole session can be written out as a
+///         Chrome trace (viewable in chrome://tracing or https://ui.perfetto.dev) with writeChromeTrace(), or
+///         summarised with printSummary(). printReport() only reports the sections recorded since the previous report.
+///         The buffer of each thread holds the last 262144 sections it recorded, after which it overwrites the oldest.
 //----------------------------------------------------------------------------------------------------------------------
 class Profiler
 {
 public:
 
-  /// \brief  call to output the report
+  /// \brief  prints a hierarchical breakdown of the sections that have completed since the previous report (or the
+  ///         last call to beginReport or clearAll), along with the number of times each was run and the median and
+  ///         99th percentile of their durations.
   /// \param  os the stream to write the report to
+  AL_USDMAYA_PUBLIC
   static void printReport(std::ostream& os);
 
-  /// \brief  call to clear internal timers
-  static inline void clearAll()
-    {
-      assert(m_stackPos == 0);
-      m_map.clear();
-    }
+  /// \brief  prints the number of times each section has run since the last call to clearAll, along with its total
+  ///         time and the median and 99th percentile of its durations, regardless of where it was called from.
+  /// \param  os the stream to write the summary to
+  AL_USDMAYA_PUBLIC
+  static void printSummary(std::ostream& os);
+
+  /// \brief  writes all of the sections recorded since the last call to clearAll as a Chrome trace event JSON file.
+  /// \param  os the stream to write the trace to
+  AL_USDMAYA_PUBLIC
+  static void writeChromeTrace(std::ostream& os);
+
+  /// \brief  marks all of the sections recorded so far as reported, so that the next call to printReport only
+  ///         includes the sections that follow.
+  AL_USDMAYA_PUBLIC
+  static void beginReport();
+
+  /// \brief  call to discard all recorded sections, apart from those within sections that are still running (which are
+  ///         kept until the section that contains them ends, and is recorded in turn).
+  AL_USDMAYA_PUBLIC
+  static void clearAll();
 
   /// \brief  do not call directly. Use the AL_BEGIN_PROFILE_SECTION macro
   /// \param  entry a unique tag for this code section.
+  AL_USDMAYA_PUBLIC
   static void pushTime(const ProfilerSectionTag* entry);
 
   /// \brief  do not call directly. Use the AL_END_PROFILE_SECTION macro
+  AL_USDMAYA_PUBLIC
   static void popTime();
 
-private:
-
-  typedef std::unordered_map<ProfilerSectionPath, timespec> ProfilerSectionPathLUT;
-  typedef ProfilerSectionPathLUT::const_iterator iter_t;
-  static inline bool compareTimeStamps(const iter_t, const iter_t);
-  static void print(std::ostream& os, iter_t, const ProfilerSectionPathLUT&, uint32_t, double);
-
-  struct ProfilerSectionStackNode
-  {
-    timespec m_time;
-    const ProfilerSectionTag* m_entry;
-    ProfilerSectionPathLUT::iterator m_path;
-  };
-
-  static inline timespec timeDiff(const timespec startTime, const timespec endTime)
-  {
-    timespec ts;
-    if (endTime.tv_nsec < startTime.tv_nsec)
-    {
-      ts.tv_sec = endTime.tv_sec - 1 - startTime.tv_sec;
-      ts.tv_nsec =  1000000000 + endTime.tv_nsec - startTime.tv_nsec;
-    }
-    else
-    {
-      ts.tv_sec = endTime.tv_sec - startTime.tv_sec;
-      ts.tv_nsec =  endTime.tv_nsec - startTime.tv_nsec;
-    }
-    return ts;
-  }
-  static inline timespec timeAdd(timespec t1, timespec t2)
-  {
-    timespec ts;
-    int32_t sec = t2.tv_sec + t1.tv_sec;
-    int32_t nsec = t2.tv_nsec + t1.tv_nsec;
-    if (nsec >= 1000000000)
-    {
-      nsec -= 1000000000;
-      sec++;
-    }
-    ts.tv_sec = sec;
-    ts.tv_nsec = nsec;
-    return ts;
-  }
+  /// \brief  do not call directly. Use the AL_BEGIN_NAMED_PROFILE_SECTION macro
+  /// \param  sectionName the name of the section, which may be built at runtime (e.g. from the name of a node)
+  /// \param  filePath the file that contains this code section
+  /// \param  lineNumber the line number in the file where this section starts
+  /// \return a tag for the section. The same tag is returned for the same name and location, and lives for the
+  ///         lifetime of the process.
+  AL_USDMAYA_PUBLIC
+  static const ProfilerSectionTag* sectionTag(const std::string& sectionName, const char* filePath, size_t lineNumber);
 
-  static ProfilerSectionStackNode m_timeStack[MAX_TIMESTAMP_STACK_SIZE];
-  static uint32_t m_stackPos;
-  static ProfilerSectionPathLUT m_map;
+private:
+  struct ThreadEvents;
+  static ThreadEvents& threadEvents();
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -265,6 +214,14 @@ private:
     AL::usdmaya::Profiler::pushTime(&__entry); \
   }
 
+/// \ingroup  profiler
+/// Put this macro at the start of a timed section of code whose name is only known at runtime, e.g.
+/// AL_BEGIN_NAMED_PROFILE_SECTION(std::string("OpenStage: ") + nodeName). Each distinct name is reported separately.
+#define AL_BEGIN_NAMED_PROFILE_SECTION(SectionName) \
+  { \
+    AL::usdmaya::Profiler::pushTime(AL::usdmaya::Profiler::sectionTag(SectionName, __FILE__, __LINE__)); \
+  }
+
 /// \ingroup  profiler
 /// Put this macro after a timed section of code.
 #define AL_END_PROFILE_SECTION() \
@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "AL/usdmaya/Global.h"
+#include "AL/usdmaya/CodeTimings.h"
 #include "AL/usdmaya/StageCache.h"
 #include "AL/usdmaya/DebugCodes.h"
 #include "AL/usdmaya/TypeIDs.h"
@@ -391,29 +392,36 @@ static void postFileRead(void*)
   MFnDependencyNode fn;
   {
     std::vector<MObjectHandle>& unloadedProxies = nodes::ProxyShape::GetUnloadedProxyShapes();
-    unsigned int numUnloadedProxies = unloadedProxies.size();
-    for(unsigned int i = 0; i < numUnloadedProxies; ++i)
+    std::vector<nodes::ProxyShape*> proxies;
+    proxies.reserve(unloadedProxies.size());
+    for(const MObjectHandle& handle : unloadedProxies)
     {
-      if(!(unloadedProxies[i].isValid() && unloadedProxies[i].isAlive()))
+      if(!(handle.isValid() && handle.isAlive()))
       {
         continue;
       }
-      fn.setObject(unloadedProxies[i].object());
+      fn.setObject(handle.object());
       if(fn.typeId() != nodes::ProxyShape::kTypeId)
       {
         TF_CODING_ERROR("ProxyShape::m_unloadedProxyShapes had a non-Proxy-Shape mobject");
         continue;
       }
+      proxies.push_back((nodes::ProxyShape*)fn.userNode());
+    }
+
+    // ensure that each proxy shape has a valid USD stage! The stages are opened concurrently, so the time taken to
+    // open a scene is not the sum of the time taken to open each stage.
+    nodes::ProxyShape::loadStages(proxies);
 
-      // execute a pull on each proxy shape to ensure that each one has a valid USD stage!
-      nodes::ProxyShape* proxy = (nodes::ProxyShape*)fn.userNode();
-      proxy->loadStage();
-      auto stage = proxy->getUsdStage();
+    for(nodes::ProxyShape* proxy : proxies)
+    {
+      AL_BEGIN_NAMED_PROFILE_SECTION(std::string("PostFileRead: ") + proxy->name().asChar());
       proxy->deserialiseTranslatorContext();
       proxy->findTaggedPrims();
       proxy->deserialiseTransformRefs();
       proxy->constructGLImagingEngine();
       proxy->addAttributeChangedCallback();
+      AL_END_PROFILE_SECTION();
     }
     unloadedProxies.clear();
   }
@@ -182,6 +182,11 @@ MStatus registerPlugin(AFnPlugin& plugin)
     MGlobal::setOptionVarValue("AL_usdmaya_pickMode", static_cast<int>(nodes::ProxyShape::PickMode::kPrims));
   }
 
+  if(!MGlobal::optionVarExists("AL_usdmaya_binaryLayerSerialisation"))
+  {
+    MGlobal::setOptionVarValue("AL_usdmaya_binaryLayerSerialisation", 0);
+  }
+
 
   MStatus status;
 
@@ -229,6 +234,7 @@ MStatus registerPlugin(AFnPlugin& plugin)
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProxyShapePostSelect);
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::InternalProxyShapeSelect);
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::UsdDebugCommand);
+  AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProfilerCommand);
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::ListEvents);
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::ListCallbacks);
   AL_REGISTER_COMMAND(plugin, AL::usdmaya::cmds::Callback);
@@ -296,6 +302,9 @@ MStatus unregisterPlugin(AFnPlugin& plugin)
 {
   MStatus status;
 
+  // make sure that no stage is still being loaded in the background once the plugin has gone
+  AL::usdmaya::nodes::ProxyShape::cancelAsyncStageLoads();
+
   // gpuCachePluginMain used as an example.
   if (MGlobal::kInteractive == MGlobal::mayaState()) {
     MString cmd = "deleteSelectTypeItem(\"Surface\",\"";
@@ -343,6 +352,7 @@ MStatus unregisterPlugin(AFnPlugin& plugin)
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::EventQuery);
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::EventLookup);
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::UsdDebugCommand);
+  AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::ProfilerCommand);
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::fileio::ImportCommand);
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::fileio::ExportCommand);
   AL_UNREGISTER_COMMAND(plugin, AL::usdmaya::cmds::TranslatePrim);
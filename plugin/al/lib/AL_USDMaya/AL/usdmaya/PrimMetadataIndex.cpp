@@ -0,0 +1,282 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "AL/usdmaya/PrimMetadataIndex.h"
+#include "AL/usdmaya/Metadata.h"
+
+#include "pxr/usd/usd/primRange.h"
+#include "pxr/usd/usd/stage.h"
+
+#include <algorithm>
+
+namespace AL {
+namespace usdmaya {
+
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t PrimMetadataIndex::readFlags(const UsdPrim& prim)
+{
+  uint32_t flags = 0;
+
+  bool excludeGeo = false;
+  if(prim.GetMetadata(Metadata::excludeFromProxyShape, &excludeGeo) && excludeGeo)
+  {
+    flags |= kExcluded;
+  }
+
+  TfToken token;
+  if(prim.GetMetadata(Metadata::selectability, &token) && token == Metadata::unselectable)
+  {
+    flags |= kUnselectable;
+  }
+
+  // prims without a lock (or with lockInherited) take the lock state of their parent
+  if(prim.GetMetadata(Metadata::locked, &token))
+  {
+    if(token == Metadata::lockTransform)
+    {
+      flags |= kLockTransform;
+    }
+    else
+    if(token == Metadata::lockUnlocked)
+    {
+      flags |= kLockUnlocked;
+    }
+  }
+  return flags;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t PrimMetadataIndex::resolve(uint32_t parentResolved, uint32_t authored)
+{
+  uint32_t resolved = (parentResolved | authored) & (kUnselectable | kExcluded);
+  if(authored & kLockTransform)
+  {
+    resolved |= kLockTransform;
+  }
+  else
+  if(!(authored & kLockUnlocked))
+  {
+    resolved |= parentResolved & kLockTransform;
+  }
+  return resolved;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t PrimMetadataIndex::authoredFlags(const SdfPath& path) const
+{
+  auto it = m_entries.find(path);
+  return it != m_entries.end() ? it->second.m_authored : 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t PrimMetadataIndex::resolvedFlags(const SdfPath& path) const
+{
+  // every ancestor of a stored path is also stored, so the closest stored ancestor holds the state of the path
+  for(SdfPath current = path; !current.IsEmpty(); current = current.GetParentPath())
+  {
+    auto it = m_entries.find(current);
+    if(it != m_entries.end())
+    {
+      return it->second.m_resolved;
+    }
+  }
+  return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+PrimMetadataIndex::EntryTable::iterator PrimMetadataIndex::insert(const SdfPath& path)
+{
+  // find the closest ancestor that is already stored. Any ancestors added by the insertion have no authored flags,
+  // and so simply inherit its state.
+  SdfPath closestPath = path.GetParentPath();
+  uint32_t inherited = 0;
+  for(; !closestPath.IsEmpty(); closestPath = closestPath.GetParentPath())
+  {
+    auto it = m_entries.find(closestPath);
+    if(it != m_entries.end())
+    {
+      inherited = it->second.m_resolved;
+      break;
+    }
+  }
+
+  auto inserted = m_entries.insert(EntryTable::value_type(path, Entry()));
+  if(inserted.second)
+  {
+    for(SdfPath current = path; current != closestPath; current = current.GetParentPath())
+    {
+      m_entries.find(current)->second.m_resolved = inherited;
+    }
+  }
+  return inserted.first;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void PrimMetadataIndex::resolveSubtree(EntryTable::iterator root)
+{
+  const uint32_t resolved = resolve(resolvedFlags(root->first.GetParentPath()), root->second.m_authored);
+  if(resolved == root->second.m_resolved)
+  {
+    return;
+  }
+  root->second.m_resolved = resolved;
+
+  // the table is iterated depth first, so each parent has been resolved before its children
+  auto range = m_entries.FindSubtreeRange(root->first);
+  for(auto it = std::next(range.first); it != range.second; ++it)
+  {
+    const Entry& parent = m_entries.find(it->first.GetParentPath())->second;
+    it->second.m_resolved = resolve(parent.m_resolved, it->second.m_authored);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool PrimMetadataIndex::setAuthoredFlags(const SdfPath& path, uint32_t flags, uint32_t mask)
+{
+  auto it = m_entries.find(path);
+  if(it == m_entries.end())
+  {
+    if(!(flags & mask))
+    {
+      return false;
+    }
+    it = insert(path);
+  }
+
+  const uint32_t authored = (it->second.m_authored & ~mask) | (flags & mask);
+  if(authored == it->second.m_authored)
+  {
+    return false;
+  }
+  it->second.m_authored = authored;
+  resolveSubtree(it);
+  return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void PrimMetadataIndex::resetAuthoredFlag(uint32_t flag, const SdfPathVector& paths)
+{
+  // rebuild the table from the paths that still have some flags authored, so that paths which no longer have any
+  // flags do not accumulate between traversals
+  EntryTable entries;
+  for(const auto& entry : m_entries)
+  {
+    const uint32_t authored = entry.second.m_authored & ~flag;
+    if(authored)
+    {
+      entries[entry.first].m_authored = authored;
+    }
+  }
+  for(const SdfPath& path : paths)
+  {
+    entries[path].m_authored |= flag;
+  }
+  m_entries.swap(entries);
+
+  for(auto& entry : m_entries)
+  {
+    const SdfPath parentPath = entry.first.GetParentPath();
+    const uint32_t parentResolved = parentPath.IsEmpty() ? 0 : m_entries.find(parentPath)->second.m_resolved;
+    entry.second.m_resolved = resolve(parentResolved, entry.second.m_authored);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+SdfPathVector PrimMetadataIndex::pathsWithAuthoredFlag(uint32_t flag) const
+{
+  SdfPathVector paths;
+  for(const auto& entry : m_entries)
+  {
+    if(entry.second.m_authored & flag)
+    {
+      paths.push_back(entry.first);
+    }
+  }
+  std::sort(paths.begin(), paths.end());
+  return paths;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t PrimMetadataIndex::removeSubtree(const SdfPath& path)
+{
+  auto range = m_entries.FindSubtreeRange(path);
+  if(range.first == range.second)
+  {
+    return 0;
+  }
+
+  uint32_t flags = 0;
+  for(auto it = range.first; it != range.second; ++it)
+  {
+    flags |= it->second.m_authored;
+  }
+  m_entries.erase(range.first);
+  return flags;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t PrimMetadataIndex::update(
+    const UsdStageWeakPtr& stage,
+    const UsdNotice::ObjectsChanged::PathRange& resyncedPaths,
+    const UsdNotice::ObjectsChanged::PathRange& changedInfoOnlyPaths)
+{
+  uint32_t changed = 0;
+  for(const SdfPath& path : resyncedPaths)
+  {
+    if(path.IsPropertyPath())
+    {
+      continue;
+    }
+
+    // everything beneath a resynced path may have changed, so the subtree is read again from the stage
+    changed |= removeSubtree(path);
+    UsdPrim prim = stage->GetPrimAtPath(path);
+    if(!prim)
+    {
+      continue;
+    }
+    for(const UsdPrim& child : UsdPrimRange(prim))
+    {
+      const uint32_t flags = readFlags(child);
+      if(flags)
+      {
+        setAuthoredFlags(child.GetPath(), flags);
+        changed |= flags;
+      }
+    }
+  }
+
+  for(const SdfPath& path : changedInfoOnlyPaths)
+  {
+    if(path.IsPropertyPath())
+    {
+      continue;
+    }
+
+    UsdPrim prim = stage->GetPrimAtPath(path);
+    const uint32_t flags = prim ? readFlags(prim) : 0;
+    const uint32_t previous = authoredFlags(path);
+    if(setAuthoredFlags(path, flags))
+    {
+      changed |= flags ^ previous;
+    }
+  }
+  return changed;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
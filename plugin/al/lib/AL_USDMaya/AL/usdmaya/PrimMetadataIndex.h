@@ -0,0 +1,172 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+
+#include "./Api.h"
+
+#include "pxr/pxr.h"
+#include "pxr/usd/sdf/path.h"
+#include "pxr/usd/sdf/pathTable.h"
+#include "pxr/usd/usd/notice.h"
+#include "pxr/usd/usd/prim.h"
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace AL {
+namespace usdmaya {
+
+///---------------------------------------------------------------------------------------------------------------------
+/// \brief  A path trie that records the selectability, lock and exclusion metadata authored on the prims of a stage,
+///         along with the state each prim inherits from its ancestors.
+///
+///         Only the prims with some authored metadata (and their ancestors) are stored, so the state of any other prim
+///         is that of its closest stored ancestor. Looking up the state of a path therefore walks up at most the depth
+///         of the path. When the metadata of a prim changes, the inherited state of its stored descendants is resolved
+///         again from the trie, without reading any of those prims.
+///---------------------------------------------------------------------------------------------------------------------
+class PrimMetadataIndex
+{
+public:
+
+  /// the metadata that is tracked for each prim
+  enum Flags : uint32_t
+  {
+    kUnselectable = 1 << 0, ///< the prim (and its descendants) cannot be selected
+    kExcluded = 1 << 1, ///< the prim (and its descendants) are excluded from the proxy shape
+    kLockTransform = 1 << 2, ///< the transform of the prim (and of descendants that inherit the lock) is locked
+    kLockUnlocked = 1 << 3, ///< the prim (and descendants that inherit the lock) is unlocked, regardless of its parent
+    kLockFlags = kLockTransform | kLockUnlocked,
+    kAllFlags = kUnselectable | kExcluded | kLockFlags
+  };
+
+  ///-------------------------------------------------------------------------------------------------------------------
+  /// \brief  reads the tracked metadata from a prim
+  /// \param  prim the prim to read
+  /// \return the flags authored on the prim
+  ///-------------------------------------------------------------------------------------------------------------------
+  AL_USDMAYA_PUBLIC
+  static uint32_t readFlags(const UsdPrim& prim);
+
+  ///-------------------------------------------------------------------------------------------------------------------
+  /// \brief  returns true if the path, or one of its ancestors, is unselectable
+  ///-------------------------------------------------------------------------------------------------------------------
+  inline bool isUnselectable(const SdfPath& path) const
+    { return resolvedFlags(path) & kUnselectable; }
+
+  ///-------------------------------------------------------------------------------------------------------------------
+  /// \brief  returns true if the path, or one of its ancestors, is excluded from the proxy shape
+  ///-------------------------------------------------------------------------------------------------------------------
+  inline bool isExcluded(const SdfPath& path) const
+    { return resolvedFlags(path) & kExcluded; }
+
+  ///-------------------------------------------------------------------------------------------------------------------
+  /// \brief  returns true if the transform of the path is locked, either directly, or by inheriting the lock of an
+  ///         ancestor without an unlocked ancestor in between
+  ///-------------------------------------------------------------------------------------------------------------------
+  inline bool isLocked(const SdfPath& path) const
+    { return resolvedFlags(path) & kLockTransform; }
+
+  ///-------------------------------------------------------------------------------------------------------------------
+  /// \brief  returns the flags authored on the path itself
+  ///-------------------------------------------------------------------------------------------------------------------
+  AL_USDMAYA_PUBLIC
+  uint32_t authoredFlags(const SdfPath& path) const;
+
+  ///-------------------------------------------------------------------------------------------------------------------
+  /// \brief  returns the state the path has, or inherits. For the lock flags, only kLockTransform is returned, if the
+  ///         path is locked.
+  ///-------------------------------------------------------------------------------------------------------------------
+  AL_USDMAYA_PUBLIC
+  uint32_t resolvedFlags(const SdfPath& path) const;
+
+  ///-------------------------------------------------------------------------------------------------------------------
+  /// \brief  sets some of the flags authored on a path
+  /// \param  path the path of the prim
+  /// \param  flags the new values of the flags
+  /// \param  mask the flags to set. Flags outside of the mask are left as they are.
+  /// \return true if the authored flags changed
+  ///-------------------------------------------------------------------------------------------------------------------
+  AL_USDMAYA_PUBLIC
+  bool setAuthoredFlags(const SdfPath& path, uint32_t flags, uint32_t mask = kAllFlags);
+
+  ///-------------------------------------------------------------------------------------------------------------------
+  /// \brief  replaces a flag on every path, e.g. with the results of a traversal of the whole stage
+  /// \param  flag the flag to replace
+  /// \param  paths the paths that have the flag authored. Every other path will have the flag cleared.
+  ///-------------------------------------------------------------------------------------------------------------------
+  AL_USDMAYA_PUBLIC
+  void resetAuthoredFlag(uint32_t flag, const SdfPathVector& paths);
+
+  ///-------------------------------------------------------------------------------------------------------------------
+  /// \brief  returns the sorted paths that have the flag authored on them
+  ///-------------------------------------------------------------------------------------------------------------------
+  AL_USDMAYA_PUBLIC
+  SdfPathVector pathsWithAuthoredFlag(uint32_t flag) const;
+
+  ///-------------------------------------------------------------------------------------------------------------------
+  /// \brief  applies the changes in an ObjectsChanged notice. Each resynced path has its subtree discarded, and the
+  ///         prims within it read again. For the paths whose info changed, only the prim itself is read. Changes to
+  ///         properties are ignored, since they do not affect prim metadata.
+  /// \param  stage the stage that sent the notice
+  /// \param  resyncedPaths the resynced paths in the notice
+  /// \param  changedInfoOnlyPaths the changed info only paths in the notice
+  /// \return the flags whose authored values changed
+  ///-------------------------------------------------------------------------------------------------------------------
+  AL_USDMAYA_PUBLIC
+  uint32_t update(
+      const UsdStageWeakPtr& stage,
+      const UsdNotice::ObjectsChanged::PathRange& resyncedPaths,
+      const UsdNotice::ObjectsChanged::PathRange& changedInfoOnlyPaths);
+
+  ///-------------------------------------------------------------------------------------------------------------------
+  /// \brief  discards the stored state of a path and its descendants
+  /// \return the flags that were authored within the subtree
+  ///-------------------------------------------------------------------------------------------------------------------
+  AL_USDMAYA_PUBLIC
+  uint32_t removeSubtree(const SdfPath& path);
+
+  ///-------------------------------------------------------------------------------------------------------------------
+  /// \brief  discards everything
+  ///-------------------------------------------------------------------------------------------------------------------
+  inline void clear()
+    { m_entries.clear(); }
+
+  ///-------------------------------------------------------------------------------------------------------------------
+  /// \brief  returns the number of paths stored (those with authored flags, and their ancestors)
+  ///-------------------------------------------------------------------------------------------------------------------
+  inline size_t size() const
+    { return m_entries.size(); }
+
+private:
+  struct Entry
+  {
+    uint32_t m_authored = 0; ///< the flags authored on the prim
+    uint32_t m_resolved = 0; ///< the state of the prim, taking its ancestors into account
+  };
+  typedef SdfPathTable<Entry> EntryTable;
+
+  static uint32_t resolve(uint32_t parentResolved, uint32_t authored);
+  EntryTable::iterator insert(const SdfPath& path);
+  void resolveSubtree(EntryTable::iterator root);
+
+private:
+  EntryTable m_entries;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
@@ -5,9 +5,10 @@ namespace usdmaya {
 
 bool SelectabilityDB::isPathUnselectable(const SdfPath& path) const
 {
-  for(SdfPath unselectablePath : m_unselectablePaths)
+  // the paths are sorted, so each ancestor of the path can be looked up, rather than testing every unselectable path
+  for(SdfPath current = path; !current.IsEmpty(); current = current.GetParentPath())
   {
-    if(path.HasPrefix(unselectablePath))
+    if(std::binary_search(m_unselectablePaths.begin(), m_unselectablePaths.end(), current))
     {
       return true;
     }
@@ -62,8 +63,8 @@ void SelectabilityDB::addPathAsUnselectable(const SdfPath& path)
 
 bool SelectabilityDB::removeUnselectablePath(const SdfPath& path)
 {
-  auto foundPathEntry = std::find(m_unselectablePaths.begin(), m_unselectablePaths.end(), path);
-  if(foundPathEntry != m_unselectablePaths.end())
+  auto foundPathEntry = std::lower_bound(m_unselectablePaths.begin(), m_unselectablePaths.end(), path);
+  if(foundPathEntry != m_unselectablePaths.end() && *foundPathEntry == path)
   {
     m_unselectablePaths.erase(foundPathEntry);
     return true;
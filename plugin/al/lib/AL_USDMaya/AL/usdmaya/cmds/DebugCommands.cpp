@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "AL/usdmaya/cmds/DebugCommands.h"
+#include "AL/usdmaya/CodeTimings.h"
 #include "AL/usdmaya/DebugCodes.h"
 #include "AL/maya/utils/MenuBuilder.h"
 
@@ -24,6 +25,9 @@
 #include "maya/MArgDatabase.h"
 #include "maya/MStringArray.h"
 
+#include <fstream>
+#include <sstream>
+
 namespace AL {
 namespace usdmaya {
 namespace cmds {
@@ -223,6 +227,112 @@ const char* const UsdDebugCommand::g_helpText =  R"(
 
 )";
 
+//----------------------------------------------------------------------------------------------------------------------
+AL_MAYA_DEFINE_COMMAND(ProfilerCommand, AL_usdmaya);
+
+//----------------------------------------------------------------------------------------------------------------------
+MArgDatabase ProfilerCommand::makeDatabase(const MArgList& args)
+{
+  MStatus status;
+  MArgDatabase database(syntax(), args, &status);
+  if(!status)
+    throw status;
+  return database;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MSyntax ProfilerCommand::createSyntax()
+{
+  MSyntax syn;
+  syn.addFlag("-h", "-help", MSyntax::kNoArg);
+  syn.addFlag("-r", "-report", MSyntax::kNoArg);
+  syn.addFlag("-s", "-summary", MSyntax::kNoArg);
+  syn.addFlag("-t", "-trace", MSyntax::kString);
+  syn.addFlag("-c", "-clear", MSyntax::kNoArg);
+  return syn;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool ProfilerCommand::isUndoable() const
+{
+  return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MStatus ProfilerCommand::doIt(const MArgList& argList)
+{
+  TF_DEBUG(ALUSDMAYA_COMMANDS).Msg("AL_usdmaya_ProfilerCommand::doIt\n");
+  try
+  {
+    MArgDatabase args = makeDatabase(argList);
+    AL_MAYA_COMMAND_HELP(args, g_helpText);
+
+    if(args.isFlagSet("-r"))
+    {
+      std::ostringstream oss;
+      Profiler::printReport(oss);
+      setResult(MString(oss.str().c_str()));
+    }
+    else
+    if(args.isFlagSet("-s"))
+    {
+      std::ostringstream oss;
+      Profiler::printSummary(oss);
+      setResult(MString(oss.str().c_str()));
+    }
+    else
+    if(args.isFlagSet("-t"))
+    {
+      MString filePath;
+      args.getFlagArgument("-t", 0, filePath);
+      std::ofstream ofs(filePath.asChar());
+      if(!ofs)
+      {
+        MGlobal::displayError(MString("AL_usdmaya_Profiler: unable to write trace to ") + filePath);
+        return MS::kFailure;
+      }
+      Profiler::writeChromeTrace(ofs);
+    }
+
+    if(args.isFlagSet("-c"))
+    {
+      Profiler::clearAll();
+    }
+  }
+  catch(const MStatus&)
+  {
+
+  }
+  return MS::kSuccess;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const char* const ProfilerCommand::g_helpText =  R"(
+    AL_usdmaya_ProfilerCommand Overview:
+
+      The plugin records the time spent in its profiled sections (stage load, prim translation, variant switches,
+      selection and export) on every thread. To print the timings recorded since the last report, use the -r/-report
+      flag:
+
+        AL_usdmaya_ProfilerCommand -r;
+
+      To print the count, total, p50 and p99 of each section over all of the recorded timings, use the
+      -s/-summary flag:
+
+        AL_usdmaya_ProfilerCommand -s;
+
+      To write the recorded timings to a file that can be loaded into chrome://tracing (or https://ui.perfetto.dev),
+      use the -t/-trace flag:
+
+        AL_usdmaya_ProfilerCommand -t "/tmp/al_usdmaya_trace.json";
+
+      To discard the recorded timings, use the -c/-clear flag. It may be combined with the other flags, in which case
+      the timings are cleared after they have been output.
+
+        AL_usdmaya_ProfilerCommand -t "/tmp/al_usdmaya_trace.json" -c;
+
+)";
+
 //----------------------------------------------------------------------------------------------------------------------
 }
 }
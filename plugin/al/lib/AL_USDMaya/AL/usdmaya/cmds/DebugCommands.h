@@ -45,6 +45,21 @@ private:
   MStatus doIt(const MArgList& args) override;
 };
 
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  A command that prints the timings gathered by the AL::usdmaya::Profiler, or writes them to a Chrome trace.
+/// \ingroup commands
+//----------------------------------------------------------------------------------------------------------------------
+class ProfilerCommand
+  : public MPxCommand
+{
+  MArgDatabase makeDatabase(const MArgList& args);
+public:
+  AL_MAYA_DECLARE_COMMAND();
+private:
+  bool isUndoable() const override;
+  MStatus doIt(const MArgList& args) override;
+};
+
 /// builds the GUI for the TfDebug notices
 AL_USDMAYA_PUBLIC
 void constructDebugCommandGuis();
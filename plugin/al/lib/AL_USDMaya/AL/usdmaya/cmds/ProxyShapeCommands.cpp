@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "AL/maya/utils/CommandGuiHelper.h"
+#include "AL/usdmaya/CodeTimings.h"
 #include "AL/usdmaya/DebugCodes.h"
 #include "AL/usdmaya/cmds/ProxyShapeCommands.h"
 #include "AL/usdmaya/fileio/TransformIterator.h"
@@ -34,10 +35,24 @@
 
 #include <sstream>
 #include <algorithm>
+#include <vector>
 #include "AL/usdmaya/utils/Utils.h"
 
 namespace {
     typedef void (AL::usdmaya::nodes::SelectionList::*SelectionListModifierFunc)(SdfPath);
+
+    // the arguments to ProxyShapeSelect::selectPaths, which are handed to the command it runs so that the selection
+    // change is recorded as a single undoable operation. The command takes the most recent entry as soon as it starts,
+    // so nested selection changes cannot take each other's entries.
+    struct PendingSelection
+    {
+      AL::usdmaya::nodes::ProxyShape* proxy;
+      const SdfPathVector* paths;
+      MGlobal::ListAdjustment mode;
+      bool internal;
+      MString commandString;
+    };
+    std::vector<PendingSelection> g_pendingSelections;
 }
 
 namespace AL {
@@ -202,6 +217,7 @@ MSyntax ProxyShapeImport::createSyntax()
   syntax.addFlag("-epp", "-excludePrimPath", MSyntax::kString);
   syntax.addFlag("-ctt", "-connectToTime", MSyntax::kBoolean);
   syntax.addFlag("-ul",    "-unloaded", MSyntax::kBoolean);
+  syntax.addFlag("-la", "-loadAsync", MSyntax::kBoolean);
   syntax.addFlag("-fp", "-fullpaths", MSyntax::kBoolean);
   syntax.makeFlagMultiUse("-arp");
 
@@ -403,6 +419,12 @@ MStatus ProxyShapeImport::doIt(const MArgList& args)
     database.getFlagArgument("-ul", 0, unloaded);
     m_modifier.newPlugValueBool(MPlug(m_shape, nodes::ProxyShape::unloaded()), unloaded);
   }
+  if(database.isFlagSet("-la"))
+  {
+    bool loadAsync;
+    database.getFlagArgument("-la", 0, loadAsync);
+    m_modifier.newPlugValueBool(MPlug(m_shape, nodes::ProxyShape::loadAsync()), loadAsync);
+  }
 
 
   if(hasStagePopulationMaskInclude) m_modifier.newPlugValueString(MPlug(m_shape, nodes::ProxyShape::populationMaskIncludePaths()), populationMaskIncludePath);
@@ -1010,6 +1032,7 @@ MSyntax ProxyShapeSelect::createSyntax()
   syntax.addFlag("-r", "-replace", MSyntax::kNoArg);
   syntax.addFlag("-d", "-deselect", MSyntax::kNoArg);
   syntax.addFlag("-i", "-internal", MSyntax::kNoArg);
+  syntax.addFlag("-ps", "-pendingSelection", MSyntax::kNoArg);
   syntax.makeFlagMultiUse("-pp");
   return syntax;
 }
@@ -1028,13 +1051,27 @@ MStatus ProxyShapeSelect::doIt(const MArgList& args)
   {
     MArgDatabase db = makeDatabase(args);
     AL_MAYA_COMMAND_HELP(db, g_helpText);
+
+    // when run by selectPaths, the paths are taken as they are, rather than parsed from the arguments
+    if(db.isFlagSet("-ps"))
+    {
+      if(g_pendingSelections.empty())
+      {
+        MGlobal::displayError("AL_usdmaya_ProxyShapeSelect: -pendingSelection is only used by ProxyShapeSelect::selectPaths");
+        return MS::kFailure;
+      }
+      const PendingSelection pending = g_pendingSelections.back();
+      g_pendingSelections.pop_back();
+      setCommandString(pending.commandString);
+      return select(pending.proxy, *pending.paths, pending.mode, pending.internal);
+    }
+
     nodes::ProxyShape* proxy = getShapeNode(db);
     if(!proxy)
     {
       throw MS::kFailure;
     }
-    SdfPathVector orderedPaths;
-    nodes::SelectionUndoHelper::SdfPathHashSet unorderedPaths;
+    SdfPathVector paths;
 
     MGlobal::ListAdjustment mode = MGlobal::kAddToList;
     if(db.isFlagSet("-cl"))
@@ -1048,16 +1085,7 @@ MStatus ProxyShapeSelect::doIt(const MArgList& args)
         MArgList args;
         db.getFlagArgumentList("-pp", i, args);
         MString pathString = args.asString(0);
-
-        SdfPath path(AL::maya::utils::convert(pathString));
-
-        if(!proxy->selectabilityDB().isPathUnselectable(path) && path.IsAbsolutePath())
-        {
-          auto insertResult = unorderedPaths.insert(path);
-          if (insertResult.second) {
-            orderedPaths.push_back(path);
-          }
-        }
+        paths.emplace_back(AL::maya::utils::convert(pathString));
       }
 
       if(db.isFlagSet("-tgl"))
@@ -1080,15 +1108,7 @@ MStatus ProxyShapeSelect::doIt(const MArgList& args)
         mode = MGlobal::kRemoveFromList;
       }
     }
-    const bool isInternal = db.isFlagSet("-i");
-
-    m_helper = new nodes::SelectionUndoHelper(proxy, unorderedPaths, mode, isInternal);
-    if(!proxy->doSelect(*m_helper, orderedPaths))
-    {
-      delete m_helper;
-      m_helper = 0;
-    }
-    return _redoIt(isInternal);
+    return select(proxy, paths, mode, db.isFlagSet("-i"));
   }
   catch(const MStatus& status)
   {
@@ -1102,6 +1122,94 @@ MStatus ProxyShapeSelect::doIt(const MArgList& args)
   }
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+MStatus ProxyShapeSelect::select(
+    nodes::ProxyShape* proxy,
+    const SdfPathVector& paths,
+    MGlobal::ListAdjustment mode,
+    bool isInternal)
+{
+  SdfPathVector orderedPaths;
+  nodes::SelectionUndoHelper::SdfPathHashSet unorderedPaths;
+  orderedPaths.reserve(paths.size());
+  for(const SdfPath& path : paths)
+  {
+    if(!proxy->selectabilityDB().isPathUnselectable(path) && path.IsAbsolutePath())
+    {
+      auto insertResult = unorderedPaths.insert(path);
+      if (insertResult.second) {
+        orderedPaths.push_back(path);
+      }
+    }
+  }
+
+  AL_BEGIN_PROFILE_SECTION(Select);
+  m_helper = new nodes::SelectionUndoHelper(proxy, unorderedPaths, mode, isInternal);
+  AL_BEGIN_PROFILE_SECTION(DoSelect);
+  if(!proxy->doSelect(*m_helper, orderedPaths))
+  {
+    delete m_helper;
+    m_helper = 0;
+  }
+  AL_END_PROFILE_SECTION();
+  const MStatus status = _redoIt(isInternal);
+  AL_END_PROFILE_SECTION();
+  return status;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+MStatus ProxyShapeSelect::selectPaths(
+    nodes::ProxyShape* proxy,
+    const SdfPathVector& paths,
+    MGlobal::ListAdjustment mode,
+    bool isInternal)
+{
+  TF_DEBUG(ALUSDMAYA_COMMANDS).Msg("ProxyShapeSelect::selectPaths %lu\n", paths.size());
+  if(!proxy)
+  {
+    return MS::kFailure;
+  }
+
+  PendingSelection pending { proxy, &paths, mode, isInternal, MString() };
+
+  // the command is journalled (and named in the undo queue) as the equivalent -pp command
+  const char* modeFlag = " -a";
+  switch(mode)
+  {
+  case MGlobal::kReplaceList: modeFlag = " -r"; break;
+  case MGlobal::kXORWithList: modeFlag = " -tgl"; break;
+  case MGlobal::kRemoveFromList: modeFlag = " -d"; break;
+  default: break;
+  }
+  const MString proxyName = MFnDagNode(proxy->thisMObject()).fullPathName();
+  std::string commandString(kName.asChar());
+  commandString.reserve(commandString.size() + paths.size() * 40 + proxyName.length() + 32);
+  if(isInternal)
+  {
+    commandString += " -i";
+  }
+  commandString += modeFlag;
+  for(const SdfPath& path : paths)
+  {
+    commandString += " -pp \"";
+    commandString += path.GetString();
+    commandString += '"';
+  }
+  commandString += " \"";
+  commandString += proxyName.asChar();
+  commandString += '"';
+  pending.commandString = commandString.c_str();
+
+  g_pendingSelections.push_back(pending);
+  const MStatus status = MGlobal::executeCommand(kName + " -ps", false, true);
+  if(!g_pendingSelections.empty() && g_pendingSelections.back().paths == &paths)
+  {
+    // the command never started
+    g_pendingSelections.pop_back();
+  }
+  return status;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 MStatus ProxyShapeSelect::undoIt()
 {
@@ -1534,6 +1642,12 @@ AL_usdmaya_ProxyShapeImport Overview:
        -unloaded true   //< don't load any loadable prims
        -unloaded false  //< load all loadable prims
 
+   Heavy stages can be opened on a background thread with the -la/-loadAsync flag _(the default is false)_. Until the
+   stage is ready, the proxy shape draws a placeholder box, and the StageLoaded event is triggered once it is. This only
+   applies when Maya is running interactively; otherwise the stage is opened before the command returns.
+
+       -loadAsync true
+
     The command will return a string array containing the names of all instances of the created node. (There will be
     more than one instance if more than one transform was selected or passed into the command.)  By default, the will
     be the shortest-unique names; if -fp/-fullpaths is given, then they will be full path names.
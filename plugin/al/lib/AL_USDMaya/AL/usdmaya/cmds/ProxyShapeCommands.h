@@ -24,6 +24,7 @@
 
 #include "maya/MPxCommand.h"
 #include "maya/MDagModifier.h"
+#include "maya/MGlobal.h"
 #include "maya/MObject.h"
 #include "maya/MObjectArray.h"
 #include "maya/MSelectionList.h"
@@ -225,12 +226,24 @@ public:
   ProxyShapeSelect () : m_helper(0) {}
   ~ProxyShapeSelect() { delete m_helper; }
   AL_MAYA_DECLARE_COMMAND();
+
+  /// \brief  Performs a selection operation on the proxy shape from C++, as a single undoable command. The paths are
+  ///         handed to the command as they are, rather than being written to and parsed from a command string (the
+  ///         command is still journalled as the equivalent -pp command).
+  /// \param  proxy the proxy shape on which the selection operation will be performed
+  /// \param  paths the USD paths to be selected / toggled / unselected
+  /// \param  mode the selection mode (add, remove, xor, etc)
+  /// \param  isInternal if true, modifications to Maya's selection list will NOT occur (the -i flag)
+  /// \return the status of the command
+  AL_USDMAYA_PUBLIC
+  static MStatus selectPaths(nodes::ProxyShape* proxy, const SdfPathVector& paths, MGlobal::ListAdjustment mode, bool isInternal = false);
 private:
   bool isUndoable() const override;
   MStatus doIt(const MArgList& args) override;
   MStatus undoIt() override;
   MStatus redoIt() override;
   MStatus _redoIt(bool isInternal);
+  MStatus select(nodes::ProxyShape* proxy, const SdfPathVector& paths, MGlobal::ListAdjustment mode, bool isInternal);
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -14,7 +14,10 @@
 // limitations under the License.
 //
 #include <algorithm>
+#include <deque>
+#include <future>
 #include <iterator>
+#include <memory>
 
 #include "AL/usdmaya/utils/MeshUtils.h"
 #include "AL/usdmaya/fileio/ExportParams.h"
@@ -25,6 +28,10 @@
 #include "maya/MItDependencyGraph.h"
 #include "maya/MFnAnimCurve.h"
 #include "maya/MAnimControl.h"
+#include "maya/MDGContext.h"
+#if MAYA_API_VERSION >= 20180000
+#include "maya/MDGContextGuard.h"
+#endif
 #include "maya/MGlobal.h"
 #include "maya/MFnMesh.h"
 #include "maya/MAnimUtil.h"
@@ -44,6 +51,135 @@ const static std::array<MFn::Type, 4> g_nodeTypesConsiderToBeAnimation {
 //----------------------------------------------------------------------------------------------------------------------
 const static AnimationCheckTransformAttributes g_AnimationCheckTransformAttributes;
 
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Makes maya evaluate at the time of the frame being exported, for the lifetime of this object. If the context
+///         is requested (and supported by the current maya version) the plugs are evaluated within an MDGContext,
+///         otherwise the global scene time is changed.
+//----------------------------------------------------------------------------------------------------------------------
+class ScopedEvaluationTime
+{
+public:
+  ScopedEvaluationTime(const MTime& time, const bool useContext)
+    : m_context(time)
+  {
+#if MAYA_API_VERSION >= 20180000
+    if(useContext)
+    {
+      m_guard.reset(new MDGContextGuard(m_context));
+      return;
+    }
+#endif
+    MAnimControl::setCurrentTime(time);
+  }
+
+  /// \brief  returns true if the values are being evaluated within a DG context
+  bool usingContext() const
+  {
+#if MAYA_API_VERSION >= 20180000
+    return m_guard != nullptr;
+#else
+    return false;
+#endif
+  }
+
+private:
+  MDGContext m_context;
+#if MAYA_API_VERSION >= 20180000
+  std::unique_ptr<MDGContextGuard> m_guard;
+#endif
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  copies the points of the mesh into the points array, which is only reallocated if it is not large enough (or
+///         if its memory is shared)
+//----------------------------------------------------------------------------------------------------------------------
+bool copyPoints(MFnMesh& fnMesh, VtArray<GfVec3f>& points)
+{
+  MStatus status;
+  const float* pointsData = fnMesh.getRawPoints(&status);
+  if(!status)
+    return false;
+  const uint32_t numVertices = fnMesh.numVertices();
+  points.resize(numVertices);
+  memcpy((GfVec3f*)points.data(), pointsData, sizeof(float) * 3 * numVertices);
+  return true;
+}
+
+} // anon
+
+//----------------------------------------------------------------------------------------------------------------------
+MeshAnimExportContext::MeshAnimExportContext(const MDagPath& path, const UsdAttribute& pointsAttr)
+  : m_path(path), m_pointsAttr(pointsAttr)
+{
+  MStatus status = m_fnMesh.setObject(path);
+  m_valid = (status == MS::kSuccess);
+  if(m_valid)
+  {
+    m_outMesh = m_fnMesh.findPlug("outMesh", true, &status);
+    m_valid = (status == MS::kSuccess);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool MeshAnimExportContext::readPoints(const UsdTimeCode timeCode, const bool usingContext)
+{
+  m_changed = false;
+  if(!m_valid)
+    return false;
+
+  if(usingContext)
+  {
+    // the function set reads the mesh at the current scene time, whereas reading the outMesh plug respects the
+    // current DG context
+    MStatus status;
+    MObject meshData = m_outMesh.asMObject();
+    MFnMesh fnMesh(meshData, &status);
+    if(!status || !copyPoints(fnMesh, m_points))
+      return false;
+  }
+  else
+  if(!copyPoints(m_fnMesh, m_points))
+  {
+    return false;
+  }
+
+  // an exact comparison against the last points written, which usually fails within the first few points if the mesh
+  // has moved
+  m_changed = !m_hasWritten || m_points.size() != m_written.size() ||
+              memcmp(m_points.cdata(), m_written.cdata(), sizeof(GfVec3f) * m_points.size()) != 0;
+  if(!m_changed)
+  {
+    m_skipped = true;
+    m_heldTimeCode = timeCode;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const VtArray<GfVec3f>& MeshAnimExportContext::commitPoints()
+{
+  // the previously written points are recycled as the read buffer if USD is not holding on to them. If it is, clear
+  // will release them, and the next read will allocate a new buffer rather than copy on write.
+  m_written.swap(m_points);
+  m_points.clear();
+  m_hasWritten = true;
+  m_skipped = false;
+  return m_written;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshAnimExportContext::writePoints(const UsdTimeCode timeCode)
+{
+  if(!m_changed)
+    return;
+  if(hasHeldPoints())
+  {
+    m_pointsAttr.Set(m_written, m_heldTimeCode);
+  }
+  m_pointsAttr.Set(commitPoints(), timeCode);
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 bool AnimationTranslator::considerToBeAnimation(const MFn::Type nodeType)
 {
@@ -258,50 +394,61 @@ bool AnimationTranslator::isAnimatedTransform(const MObject& transformNode)
 //----------------------------------------------------------------------------------------------------------------------
 void AnimationTranslator::exportAnimation(const ExporterParams& params)
 {
-  auto const startAttrib =  m_animatedPlugs.begin();
-  auto const endAttrib =  m_animatedPlugs.end();
-  auto const startAttribScaled =  m_scaledAnimatedPlugs.begin();
-  auto const endAttribScaled =  m_scaledAnimatedPlugs.end();
-  auto const startTransformAttrib = m_animatedTransformPlugs.begin();
-  auto const endTransformAttrib = m_animatedTransformPlugs.end();
-  auto const startMesh = m_animatedMeshes.begin();
-  auto const endMesh = m_animatedMeshes.end();
-  if((startAttrib != endAttrib) ||
-     (startAttribScaled != endAttribScaled) ||
-     (startTransformAttrib != endTransformAttrib) ||
-     (startMesh != endMesh) ||
-     (!m_animatedNodes.empty()))
+  if(params.m_pipelinedAnimation)
+  {
+    exportAnimationPipelined(params);
+    return;
+  }
+
+  if(!m_animatedPlugs.empty() ||
+     !m_scaledAnimatedPlugs.empty() ||
+     !m_animatedTransformPlugs.empty() ||
+     !m_animatedMeshes.empty() ||
+     !m_animatedNodes.empty())
   {
+    std::deque<MeshAnimExportContext> meshContexts;
+    for(size_t i = 0, n = m_animatedMeshes.size(); i < n; ++i)
+    {
+      meshContexts.emplace_back(m_animatedMeshes.path(i), m_animatedMeshes.attribute(i));
+    }
+
     double increment = 1.0 / std::max(1U, params.m_subSamples);
     for(double t = params.m_minFrame, e = params.m_maxFrame + 1e-3f; t < e; t += increment)
     {
-      MAnimControl::setCurrentTime(t);
+      ScopedEvaluationTime evaluationTime(MTime(t), params.m_dgContextEvaluation);
       UsdTimeCode timeCode(t);
-      for(auto it = startAttrib; it != endAttrib; ++it)
+      for(size_t i = 0, n = m_animatedPlugs.size(); i < n; ++i)
       {
         /// \todo This feels wrong. Split the DgNodeTranslator class into 3 ...
         ///         maya::Dg
         ///         usdmaya::Dg
         ///         usdmaya::fileio::translator::Dg
-        translators::DgNodeTranslator::copyAttributeValue(it->first, it->second, timeCode);
+        translators::DgNodeTranslator::copyAttributeValue(m_animatedPlugs.plug(i), m_animatedPlugs.attribute(i), timeCode);
       }
-      for(auto it = startAttribScaled; it != endAttribScaled; ++it)
+      for(size_t i = 0, n = m_scaledAnimatedPlugs.size(); i < n; ++i)
       {
         /// \todo This feels wrong. Split the DgNodeTranslator class into 3 ...
         ///         maya::Dg
         ///         usdmaya::Dg
         ///         usdmaya::fileio::translator::Dg
-        translators::DgNodeTranslator::copyAttributeValue(it->first, it->second.attr, it->second.scale, timeCode);
+        translators::DgNodeTranslator::copyAttributeValue(
+            m_scaledAnimatedPlugs.plug(i), m_scaledAnimatedPlugs.attribute(i), m_scaledAnimatedPlugs.scale(i), timeCode);
       }
-      for (auto it = startTransformAttrib; it != endTransformAttrib; ++it)
+      for(size_t i = 0, n = m_animatedTransformPlugs.size(); i < n; ++i)
       {
-        translators::TransformTranslator::copyAttributeValue(it->first, it->second, timeCode);
+        translators::TransformTranslator::copyAttributeValue(
+            m_animatedTransformPlugs.plug(i), m_animatedTransformPlugs.attribute(i), timeCode);
       }
-      for(auto it = startMesh; it != endMesh; ++it)
+      for(auto& meshContext : meshContexts)
       {
-        UsdGeomMesh mesh(it->second.GetPrim());
-        AL::usdmaya::utils::MeshExportContext context(it->first, mesh, timeCode);
-        context.copyVertexData(timeCode);
+        if(meshContext.readPoints(timeCode, evaluationTime.usingContext()))
+        {
+          meshContext.writePoints(timeCode);
+        }
+        else
+        {
+          MGlobal::displayError(MString("Unable to access mesh vertices on mesh: ") + meshContext.path().fullPathName());
+        }
       }
       for(auto nodeAnim : m_animatedNodes)
       {
@@ -311,6 +458,123 @@ void AnimationTranslator::exportAnimation(const ExporterParams& params)
   }
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+void AnimationTranslator::exportAnimationPipelined(const ExporterParams& params)
+{
+  const size_t numPlugs = m_animatedPlugs.size();
+  const size_t numScaledPlugs = m_scaledAnimatedPlugs.size();
+  const size_t numTransformPlugs = m_animatedTransformPlugs.size();
+  const size_t numMeshes = m_animatedMeshes.size();
+  const size_t numValues = numPlugs + numScaledPlugs + numTransformPlugs + numMeshes;
+  if(!numValues && m_animatedNodes.empty())
+  {
+    return;
+  }
+
+  // the meshes skip the frames in which their points have not changed. When such a run ends, the points of the last
+  // skipped frame are also written (at the time of that frame).
+  std::deque<MeshAnimExportContext> meshContexts;
+  for(size_t i = 0; i < numMeshes; ++i)
+  {
+    meshContexts.emplace_back(m_animatedMeshes.path(i), m_animatedMeshes.attribute(i));
+  }
+  struct HeldValue
+  {
+    size_t m_index;
+    UsdTimeCode m_timeCode;
+    VtValue m_value;
+  };
+
+  // gather the attributes we will be writing to in the same order the values are staged in each frame
+  std::vector<UsdAttribute> attributes;
+  attributes.reserve(numValues);
+  attributes.insert(attributes.end(), m_animatedPlugs.attributes().begin(), m_animatedPlugs.attributes().end());
+  attributes.insert(attributes.end(), m_scaledAnimatedPlugs.attributes().begin(), m_scaledAnimatedPlugs.attributes().end());
+  attributes.insert(attributes.end(), m_animatedTransformPlugs.attributes().begin(), m_animatedTransformPlugs.attributes().end());
+  attributes.insert(attributes.end(), m_animatedMeshes.attributes().begin(), m_animatedMeshes.attributes().end());
+
+  // Authoring into a single layer from more than one thread at once is not supported by Sdf, so at most one frame is
+  // being written at any time. The benefit comes from overlapping that write with maya evaluating the next frame.
+  std::future<void> pendingWrite;
+  auto writeFrame = [&attributes](std::vector<VtValue> values, std::vector<HeldValue> heldValues, UsdTimeCode timeCode)
+  {
+    // the held samples close off a run of skipped frames, so are written before the samples of this frame
+    for(const HeldValue& held : heldValues)
+    {
+      attributes[held.m_index].Set(held.m_value, held.m_timeCode);
+    }
+    for(size_t i = 0, n = values.size(); i < n; ++i)
+    {
+      if(!values[i].IsEmpty())
+      {
+        attributes[i].Set(values[i], timeCode);
+      }
+    }
+  };
+
+  double increment = 1.0 / std::max(1U, params.m_subSamples);
+  for(double t = params.m_minFrame, e = params.m_maxFrame + 1e-3f; t < e; t += increment)
+  {
+    ScopedEvaluationTime evaluationTime(MTime(t), params.m_dgContextEvaluation);
+    UsdTimeCode timeCode(t);
+
+    // pull all of the values out of maya on the main thread
+    std::vector<VtValue> values(numValues);
+    size_t index = 0;
+    for(size_t i = 0; i < numPlugs; ++i)
+    {
+      translators::DgNodeTranslator::getAttributeValue(m_animatedPlugs.plug(i), m_animatedPlugs.attribute(i), values[index++]);
+    }
+    for(size_t i = 0; i < numScaledPlugs; ++i)
+    {
+      translators::DgNodeTranslator::getAttributeValue(
+          m_scaledAnimatedPlugs.plug(i), m_scaledAnimatedPlugs.attribute(i), m_scaledAnimatedPlugs.scale(i), values[index++]);
+    }
+    for(size_t i = 0; i < numTransformPlugs; ++i)
+    {
+      translators::TransformTranslator::getAttributeValue(
+          m_animatedTransformPlugs.plug(i), m_animatedTransformPlugs.attribute(i), values[index++]);
+    }
+    std::vector<HeldValue> heldValues;
+    for(auto& meshContext : meshContexts)
+    {
+      if(!meshContext.readPoints(timeCode, evaluationTime.usingContext()))
+      {
+        MGlobal::displayError(MString("Unable to access mesh vertices on mesh: ") + meshContext.path().fullPathName());
+      }
+      else
+      if(meshContext.changed())
+      {
+        if(meshContext.hasHeldPoints())
+        {
+          heldValues.push_back({index, meshContext.heldTimeCode(), VtValue(meshContext.heldPoints())});
+        }
+        values[index] = VtValue(meshContext.commitPoints());
+      }
+      ++index;
+    }
+
+    // wait for the previous frame to be written before anything else touches the stage
+    if(pendingWrite.valid())
+    {
+      pendingWrite.wait();
+    }
+
+    // custom translators read from maya and author into USD in one step, so they remain on the main thread
+    for(auto& nodeAnim : m_animatedNodes)
+    {
+      nodeAnim.m_translator->exportCustomAnim(nodeAnim.m_path, nodeAnim.m_prim, timeCode);
+    }
+
+    pendingWrite = std::async(std::launch::async, writeFrame, std::move(values), std::move(heldValues), timeCode);
+  }
+
+  if(pendingWrite.valid())
+  {
+    pendingWrite.wait();
+  }
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 AnimationCheckTransformAttributes::AnimationCheckTransformAttributes()
 {
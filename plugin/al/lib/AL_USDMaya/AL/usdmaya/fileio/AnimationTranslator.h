@@ -23,51 +23,270 @@
 #include "maya/MPlug.h"
 #include "maya/MString.h"
 #include "maya/MDagPath.h"
+#include "maya/MFnMesh.h"
 #include "maya/MObjectHandle.h"
 
 #include <vector>
 #include <array>
-#include <map>
+#include <unordered_set>
 
 #include <utility>
 
 #include "pxr/pxr.h"
+#include "pxr/base/gf/vec3f.h"
+#include "pxr/base/vt/array.h"
 #include "pxr/usd/usd/stage.h"
 
 PXR_NAMESPACE_USING_DIRECTIVE
 
-/// \brief  operator to compare MPlugs with < operator
-struct compare_MPlug
+namespace AL {
+namespace usdmaya {
+namespace fileio {
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  A flat store of animated plugs and the USD attributes they are exported into. The data is held as a structure
+///         of arrays so that the per-frame export walks contiguous memory. Plugs are de-duplicated on the identity of
+///         their node, attribute and the logical indices of their element plugs (rather than on plug names), so
+///         registering a plug never needs to build or compare strings.
+/// \ingroup   fileio
+//----------------------------------------------------------------------------------------------------------------------
+class AnimatedPlugs
 {
-  bool operator () (const MPlug& a, const MPlug& b) const
+public:
+
+  /// \brief  returns true if the plug has already been registered
+  /// \param  plug the plug to look for
+  inline bool contains(const MPlug& plug) const
+    { return m_keys.find(PlugKey(plug)) != m_keys.end(); }
+
+  /// \brief  registers a plug, if it has not been registered already
+  /// \param  plug the maya plug to read the anim data from
+  /// \param  attribute the usd attribute to write the anim data into
+  /// \param  scale a scale to apply to convert units if needed
+  /// \return true if the plug was added, false if it was already present
+  inline bool insert(const MPlug& plug, const UsdAttribute& attribute, const float scale = 1.0f)
   {
-    return strcmp(a.name().asChar(), b.name().asChar()) < 0;;
+    if(!m_keys.emplace(plug).second)
+      return false;
+    m_plugs.push_back(plug);
+    m_attributes.push_back(attribute);
+    m_scales.push_back(scale);
+    return true;
   }
+
+  /// \brief  returns the number of registered plugs
+  inline size_t size() const
+    { return m_plugs.size(); }
+
+  /// \brief  returns true if no plugs have been registered
+  inline bool empty() const
+    { return m_plugs.empty(); }
+
+  /// \brief  returns the maya plug at the given index
+  inline const MPlug& plug(const size_t index) const
+    { return m_plugs[index]; }
+
+  /// \brief  returns the usd attribute at the given index
+  inline const UsdAttribute& attribute(const size_t index) const
+    { return m_attributes[index]; }
+
+  /// \brief  returns the unit scale at the given index
+  inline float scale(const size_t index) const
+    { return m_scales[index]; }
+
+  /// \brief  returns all of the registered usd attributes, in registration order
+  inline const std::vector<UsdAttribute>& attributes() const
+    { return m_attributes; }
+
+private:
+  struct PlugKey
+  {
+    explicit PlugKey(const MPlug& plug)
+      : m_node(plug.node()), m_attribute(plug.attribute())
+    {
+      // elements of array attributes (and the children of those elements) share the attribute object, so the logical
+      // indices of every element on the way up to the node are needed to tell them apart, e.g. a[1].b[2] and a[3].b[2]
+      m_hash = MObjectHandle(m_node).hashCode() * 31u + MObjectHandle(m_attribute).hashCode() * 17u;
+      MPlug current = plug;
+      for(;;)
+      {
+        if(current.isElement())
+        {
+          const int32_t logicalIndex = int32_t(current.logicalIndex());
+          m_logicalIndices.push_back(logicalIndex);
+          m_hash = m_hash * 31u + uint32_t(logicalIndex);
+          current = current.array();
+        }
+        else
+        if(current.isChild())
+        {
+          current = current.parent();
+        }
+        else
+        {
+          break;
+        }
+      }
+    }
+    bool operator == (const PlugKey& other) const
+      { return m_attribute == other.m_attribute && m_node == other.m_node && m_logicalIndices == other.m_logicalIndices; }
+    MObject m_node;
+    MObject m_attribute;
+    std::vector<int32_t> m_logicalIndices;
+    uint32_t m_hash;
+  };
+  struct PlugKeyHash
+  {
+    size_t operator () (const PlugKey& key) const
+      { return key.m_hash; }
+  };
+  std::unordered_set<PlugKey, PlugKeyHash> m_keys;
+  std::vector<MPlug> m_plugs;
+  std::vector<UsdAttribute> m_attributes;
+  std::vector<float> m_scales;
 };
 
-/// \brief  operator to compare MDagPaths with < operator
-struct compare_MDagPath
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  A flat store of animated meshes and the USD points attributes they are exported into, de-duplicated on the
+///         identity of the mesh node and its instance number.
+/// \ingroup   fileio
+//----------------------------------------------------------------------------------------------------------------------
+class AnimatedMeshes
 {
-  bool operator () (const MDagPath& a, const MDagPath& b) const
+public:
+
+  /// \brief  registers a mesh, if it has not been registered already
+  /// \param  path the path to the animated maya mesh
+  /// \param  attribute the usd attribute to write the points into
+  /// \return true if the mesh was added, false if it was already present
+  inline bool insert(const MDagPath& path, const UsdAttribute& attribute)
   {
-    return strcmp(a.fullPathName().asChar(), b.fullPathName().asChar()) < 0;;
+    if(!m_keys.emplace(path).second)
+      return false;
+    m_paths.push_back(path);
+    m_attributes.push_back(attribute);
+    return true;
   }
-};
 
-namespace AL {
-namespace usdmaya {
-namespace fileio {
+  /// \brief  returns the number of registered meshes
+  inline size_t size() const
+    { return m_paths.size(); }
 
-/// \brief  an attribute that has a scaling on it (due to unit differences)
-struct ScaledPair
-{
-  UsdAttribute attr; ///< the attribute to export
-  float scale; ///< the scale to apply
+  /// \brief  returns true if no meshes have been registered
+  inline bool empty() const
+    { return m_paths.empty(); }
+
+  /// \brief  returns the mesh path at the given index
+  inline const MDagPath& path(const size_t index) const
+    { return m_paths[index]; }
+
+  /// \brief  returns the usd attribute at the given index
+  inline const UsdAttribute& attribute(const size_t index) const
+    { return m_attributes[index]; }
+
+  /// \brief  returns all of the registered usd attributes, in registration order
+  inline const std::vector<UsdAttribute>& attributes() const
+    { return m_attributes; }
+
+private:
+  struct MeshKey
+  {
+    explicit MeshKey(const MDagPath& path)
+      : m_node(path.node()), m_instance(path.instanceNumber())
+      { m_hash = MObjectHandle(m_node).hashCode() * 31u + m_instance; }
+    bool operator == (const MeshKey& other) const
+      { return m_instance == other.m_instance && m_node == other.m_node; }
+    MObject m_node;
+    uint32_t m_instance;
+    uint32_t m_hash;
+  };
+  struct MeshKeyHash
+  {
+    size_t operator () (const MeshKey& key) const
+      { return key.m_hash; }
+  };
+  std::unordered_set<MeshKey, MeshKeyHash> m_keys;
+  std::vector<MDagPath> m_paths;
+  std::vector<UsdAttribute> m_attributes;
 };
 
-typedef std::map<MPlug, UsdAttribute, compare_MPlug> PlugAttrVector;
-typedef std::map<MDagPath, UsdAttribute, compare_MDagPath> MeshAttrVector;
-typedef std::map<MPlug, ScaledPair, compare_MPlug> PlugAttrScaledVector;
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  The state kept for an animated mesh across all of the frames of an animation export. The mesh function set
+///         and the outMesh plug are resolved once, the points are read into a buffer that is recycled between frames,
+///         and the frames in which the points are identical to the last points written are skipped.
+///
+///         When a run of unchanged frames ends, the points of the last skipped frame are written as well, so that a
+///         linearly interpolated read between the samples either side of the run still returns the unchanged points.
+/// \ingroup   fileio
+//----------------------------------------------------------------------------------------------------------------------
+class MeshAnimExportContext
+{
+public:
+
+  /// \brief  constructor
+  /// \param  path the path to the animated maya mesh
+  /// \param  pointsAttr the usd attribute to write the points into
+  AL_USDMAYA_PUBLIC
+  MeshAnimExportContext(const MDagPath& path, const UsdAttribute& pointsAttr);
+
+  /// \brief  reads the points of the mesh at the time being evaluated, and compares them against the last points written
+  /// \param  timeCode the time code of the frame being exported
+  /// \param  usingContext true if maya is evaluating within a DG context, rather than at the current scene time
+  /// \return false if the points could not be read
+  AL_USDMAYA_PUBLIC
+  bool readPoints(UsdTimeCode timeCode, bool usingContext);
+
+  /// \brief  returns true if the points last read differ from the last points written, and so need to be written
+  inline bool changed() const
+    { return m_changed; }
+
+  /// \brief  returns true if the frames before the current one were skipped, in which case the held points need to be
+  ///         written at heldTimeCode() before the changed points are written
+  inline bool hasHeldPoints() const
+    { return m_changed && m_skipped; }
+
+  /// \brief  returns the time code of the last skipped frame
+  inline UsdTimeCode heldTimeCode() const
+    { return m_heldTimeCode; }
+
+  /// \brief  returns the points that were last written
+  inline const VtArray<GfVec3f>& heldPoints() const
+    { return m_written; }
+
+  /// \brief  marks the changed points last read as written, and returns them so they can be written into USD. Any held
+  ///         points must be taken before this is called. The returned array shares its memory with the held points
+  ///         for the next frame, so the next call to readPoints reads into a new buffer.
+  /// \return the points last read
+  AL_USDMAYA_PUBLIC
+  const VtArray<GfVec3f>& commitPoints();
+
+  /// \brief  writes the points last read into the points attribute, if they changed (preceded by the held points if
+  ///         the frames before were skipped)
+  /// \param  timeCode the time code of the frame being exported
+  AL_USDMAYA_PUBLIC
+  void writePoints(UsdTimeCode timeCode);
+
+  /// \brief  returns the path to the maya mesh
+  inline const MDagPath& path() const
+    { return m_path; }
+
+  /// \brief  returns the usd points attribute
+  inline const UsdAttribute& attribute() const
+    { return m_pointsAttr; }
+
+private:
+  MDagPath m_path;
+  MFnMesh m_fnMesh;
+  MPlug m_outMesh;
+  UsdAttribute m_pointsAttr;
+  VtArray<GfVec3f> m_points;
+  VtArray<GfVec3f> m_written;
+  UsdTimeCode m_heldTimeCode;
+  bool m_valid = false;
+  bool m_hasWritten = false;
+  bool m_changed = false;
+  bool m_skipped = false;
+};
 
 //----------------------------------------------------------------------------------------------------------------------
 /// \brief  A utility class to help with exporting animated plugs from maya
@@ -128,10 +347,10 @@ public:
   ///         static (false).
   inline void addPlug(const MPlug& plug, const UsdAttribute& attribute, const bool assumeExpressionIsAnimated)
   {
-    if(m_animatedPlugs.find(plug) != m_animatedPlugs.end())
+    if(m_animatedPlugs.contains(plug))
       return;
     if(isAnimated(plug, assumeExpressionIsAnimated))
-      m_animatedPlugs.emplace(plug, attribute);
+      m_animatedPlugs.insert(plug, attribute);
   }
 
   /// \brief  add a plug to the animation translator (if the plug is animated)
@@ -142,10 +361,10 @@ public:
   ///         static (false).
   inline void addPlug(const MPlug& plug, const UsdAttribute& attribute, const float scale, const bool assumeExpressionIsAnimated)
   {
-    if(m_scaledAnimatedPlugs.find(plug) != m_scaledAnimatedPlugs.end())
+    if(m_scaledAnimatedPlugs.contains(plug))
       return;
     if(isAnimated(plug, assumeExpressionIsAnimated))
-      m_scaledAnimatedPlugs.emplace(plug, ScaledPair{attribute, scale});
+      m_scaledAnimatedPlugs.insert(plug, attribute, scale);
   }
 
   /// \brief  add a transform plug to the animation translator (if the plug is animated)
@@ -156,10 +375,10 @@ public:
   ///         static (false).
   inline void addTransformPlug(const MPlug& plug, const UsdAttribute& attribute, const bool assumeExpressionIsAnimated)
   {
-    if(m_animatedTransformPlugs.find(plug) != m_animatedTransformPlugs.end())
+    if(m_animatedTransformPlugs.contains(plug))
       return;
     if (isAnimated(plug, assumeExpressionIsAnimated))
-      m_animatedTransformPlugs.emplace(plug, attribute);
+      m_animatedTransformPlugs.insert(plug, attribute);
   }
 
   /// \brief  add a transform plug to the animation translator (if the plug is animated)
@@ -168,8 +387,7 @@ public:
   ///         attribute can't be handled by generic DgNodeTranslator
   inline void forceAddTransformPlug(const MPlug& plug, const UsdAttribute& attribute)
   {
-    if(m_animatedTransformPlugs.find(plug) == m_animatedTransformPlugs.end())
-      m_animatedTransformPlugs.emplace(plug, attribute);
+    m_animatedTransformPlugs.insert(plug, attribute);
   }
 
   /// \brief  add a scaled plug to the animation translator (if the plug is animated)
@@ -179,8 +397,7 @@ public:
   /// \param  scale a scale to apply to convert units if needed
   inline void forceAddPlug(const MPlug& plug, const UsdAttribute& attribute, const float scale)
   {
-    if(m_scaledAnimatedPlugs.find(plug) == m_scaledAnimatedPlugs.end())
-      m_scaledAnimatedPlugs.emplace(plug, ScaledPair{ attribute, scale });
+    m_scaledAnimatedPlugs.insert(plug, attribute, scale);
   }
 
   /// \brief  add an animated plug to the animation translator (if the plug is animated)
@@ -189,8 +406,7 @@ public:
   ///         attribute can't be handled by generic DgNodeTranslator
   inline void forceAddPlug(const MPlug& plug, const UsdAttribute& attribute)
   {
-    if(m_animatedPlugs.find(plug) == m_animatedPlugs.end())
-      m_animatedPlugs.emplace(plug, attribute);
+    m_animatedPlugs.insert(plug, attribute);
   }
 
   /// \brief  add a mesh to the animation translator
@@ -198,8 +414,7 @@ public:
   /// \param  attribute the corresponding maya attribute to write the anim data into if the plug is animated
   inline void addMesh(const MDagPath& path, const UsdAttribute& attribute)
   {
-    if(m_animatedMeshes.find(path) == m_animatedMeshes.end())
-      m_animatedMeshes.emplace(path, attribute);
+    m_animatedMeshes.insert(path, attribute);
   }
 
   /// \brief  After the scene has been exported, call this method to export the animation data on various attributes
@@ -207,6 +422,13 @@ public:
   AL_USDMAYA_PUBLIC
   void exportAnimation(const ExporterParams& params);
 
+  /// \brief  An alternative to exportAnimation (selected via ExporterParams::m_pipelinedAnimation). For each frame, the
+  ///         values are pulled from maya on the main thread into a staging buffer, and then written into USD on a
+  ///         worker thread whilst maya evaluates the next frame.
+  /// \param  params the export options
+  AL_USDMAYA_PUBLIC
+  void exportAnimationPipelined(const ExporterParams& params);
+
   /// \brief  insert a prim into the anim translator for custom anim export. 
   /// \param  translator the plugin translator to handle the export of anim data for the node
   /// \param  dagPath the maya dag path for the maya object to export
@@ -226,10 +448,10 @@ private:
     UsdPrim m_prim;
   };
   std::vector<NodeExportInfo> m_animatedNodes;
-  PlugAttrVector m_animatedPlugs;
-  PlugAttrScaledVector m_scaledAnimatedPlugs;
-  PlugAttrVector m_animatedTransformPlugs;
-  MeshAttrVector m_animatedMeshes;
+  AnimatedPlugs m_animatedPlugs;
+  AnimatedPlugs m_scaledAnimatedPlugs;
+  AnimatedPlugs m_animatedTransformPlugs;
+  AnimatedMeshes m_animatedMeshes;
 };
 
 
@@ -13,6 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include "AL/usdmaya/CodeTimings.h"
 #include "AL/usdmaya/fileio/AnimationTranslator.h"
 #include "AL/usdmaya/fileio/Export.h"
 #include "AL/usdmaya/fileio/NodeFactory.h"
@@ -49,6 +50,7 @@
 #include "pxr/base/gf/transform.h"
 #include "pxr/usd/usdGeom/camera.h"
 
+#include <map>
 #include <unordered_set>
 #include <algorithm>
 #include "AL/usdmaya/utils/Utils.h"
@@ -926,6 +928,7 @@ void Export::exportSceneHierarchy(MDagPath rootPath, SdfPath& defaultPrim)
 //----------------------------------------------------------------------------------------------------------------------
 void Export::doExport()
 {
+  AL_BEGIN_PROFILE_SECTION(Export);
   // make sure the node factory has been initialised as least once prior to use
   getNodeFactory();
 
@@ -945,6 +948,7 @@ void Export::doExport()
   const MSelectionList& sl = m_params.m_nodes;
   SdfPath defaultPrim;
 
+  AL_BEGIN_PROFILE_SECTION(ExportSceneHierarchy);
   for(uint32_t i = 0, n = sl.length(); i < n; ++i)
   {
     MDagPath path;
@@ -968,18 +972,27 @@ void Export::doExport()
       objects.append(obj);
     }
   }
+  AL_END_PROFILE_SECTION();
 
   if(m_params.m_animTranslator)
   {
+    AL_BEGIN_PROFILE_SECTION(ExportAnimation);
     m_params.m_animTranslator->exportAnimation(m_params);
+    AL_END_PROFILE_SECTION();
     m_impl->setAnimationFrame(m_params.m_minFrame, m_params.m_maxFrame);
 
     // return user to their original frame
     MAnimControl::setCurrentTime(oldCurTime);
   }
 
+  AL_BEGIN_PROFILE_SECTION(ProcessInstances);
   m_impl->processInstances();
+  AL_END_PROFILE_SECTION();
+
+  AL_BEGIN_PROFILE_SECTION(SaveLayer);
   m_impl->doExport(m_params.m_fileName.asChar(), m_params.m_filterSample, defaultPrim);
+  AL_END_PROFILE_SECTION();
+  AL_END_PROFILE_SECTION();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -1082,6 +1095,14 @@ MStatus ExportCommand::doIt(const MArgList& args)
   {
     AL_MAYA_CHECK_ERROR(argData.getFlagArgument("ws", 0, m_params.m_exportInWorldSpace), "ALUSDExport: Unable to fetch \"world space\" argument");
   }
+  if(argData.isFlagSet("pla", &status))
+  {
+    AL_MAYA_CHECK_ERROR(argData.getFlagArgument("pla", 0, m_params.m_pipelinedAnimation), "ALUSDExport: Unable to fetch \"pipelined animation\" argument");
+  }
+  if(argData.isFlagSet("dgc", &status))
+  {
+    AL_MAYA_CHECK_ERROR(argData.getFlagArgument("dgc", 0, m_params.m_dgContextEvaluation), "ALUSDExport: Unable to fetch \"dg context\" argument");
+  }
   if(m_params.m_animation)
   {
     m_params.m_animTranslator = new AnimationTranslator;
@@ -1175,6 +1196,10 @@ MSyntax ExportCommand::createSyntax()
   AL_MAYA_CHECK_ERROR2(status, errorString);
   status = syntax.addFlag("-ws", "-worldSpace", MSyntax::kBoolean);
   AL_MAYA_CHECK_ERROR2(status, errorString);
+  status = syntax.addFlag("-pla", "-pipelinedAnimation", MSyntax::kBoolean);
+  AL_MAYA_CHECK_ERROR2(status, errorString);
+  status = syntax.addFlag("-dgc", "-dgContext", MSyntax::kBoolean);
+  AL_MAYA_CHECK_ERROR2(status, errorString);
   syntax.enableQuery(false);
   syntax.enableEdit(false);
 
@@ -1204,6 +1229,12 @@ ExportCommand Overview:
 
   The exporter can remove samples that contain the same data for adjacent samples
     1. AL_usdmaya_ExportCommand -f "<path/to/out/file.usd>" -fs
+
+  Animated data can be written into USD on a worker thread, whilst maya evaluates the next frame
+    1. AL_usdmaya_ExportCommand -f "<path/to/out/file.usd>" -ani -pla 1
+
+  Animation can be evaluated within a DG context for each sample, rather than by changing the scene time (Maya 2018+)
+    1. AL_usdmaya_ExportCommand -f "<path/to/out/file.usd>" -ani -dgc 1
 )";
 
 //----------------------------------------------------------------------------------------------------------------------
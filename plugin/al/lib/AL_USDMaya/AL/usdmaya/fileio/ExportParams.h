@@ -62,6 +62,8 @@ struct ExporterParams
   int m_compactionLevel = 3; ///< by default apply the strongest level of data compaction
   AnimationTranslator* m_animTranslator = 0; ///< the animation translator to help exporting the animation data
   bool m_extensiveAnimationCheck = true; ///< if true, extensive animation check will be performed on transform nodes.
+  bool m_pipelinedAnimation = false; ///< if true, animation samples are written into USD on a worker thread whilst maya evaluates the next frame.
+  bool m_dgContextEvaluation = false; ///< if true, animation is evaluated within an MDGContext for each sample, rather than by changing the scene time (requires maya 2018+)
   int m_exportAtWhichTime = 0; ///< controls where the data will be written to: 0 = default time, 1 = earliest time, 2 = current time
   UsdTimeCode m_timeCode = UsdTimeCode::Default();
 };
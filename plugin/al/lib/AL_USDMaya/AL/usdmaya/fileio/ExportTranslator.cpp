@@ -82,6 +82,8 @@ MStatus ExportTranslator::writer(const MFileObject& file, const AL::maya::utils:
   params.m_exportAtWhichTime = options.getBool(kExportAtWhichTime);
   params.m_exportInWorldSpace = options.getBool(kExportInWorldSpace);
   params.m_subSamples = options.getInt(kSubSamples);
+  params.m_pipelinedAnimation = options.getBool(kPipelinedAnimation);
+  params.m_dgContextEvaluation = options.getBool(kDGContextEvaluation);
 
   if(params.m_animation)
   {
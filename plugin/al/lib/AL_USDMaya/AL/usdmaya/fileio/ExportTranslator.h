@@ -65,6 +65,8 @@ AL_MAYA_TRANSLATOR_BEGIN(ExportTranslator, "AL usdmaya export", false, true, "us
   static constexpr const char* const kFilterSample = "Filter Sample"; ///< export filter sample option name
   static constexpr const char* const kExportAtWhichTime = "Export At Which Time";
   static constexpr const char* const kExportInWorldSpace = "Export In World Space";
+  static constexpr const char* const kPipelinedAnimation = "Pipelined Animation"; ///< write animation samples on a worker thread
+  static constexpr const char* const kDGContextEvaluation = "DG Context Evaluation"; ///< evaluate animation without changing the scene time
 
   AL_USDMAYA_PUBLIC
   static const char* const compactionLevels[];
@@ -103,6 +105,8 @@ AL_MAYA_TRANSLATOR_BEGIN(ExportTranslator, "AL usdmaya export", false, true, "us
     if(!options.addBool(kFilterSample, defaultValues.m_filterSample)) return MS::kFailure;
     if(!options.addEnum(kExportAtWhichTime, timelineLevel, defaultValues.m_exportAtWhichTime)) return MS::kFailure;
     if(!options.addBool(kExportInWorldSpace, defaultValues.m_exportAtWhichTime)) return MS::kFailure;
+    if(!options.addBool(kPipelinedAnimation, defaultValues.m_pipelinedAnimation)) return MS::kFailure;
+    if(!options.addBool(kDGContextEvaluation, defaultValues.m_dgContextEvaluation)) return MS::kFailure;
     
     return MS::kSuccess;
   }
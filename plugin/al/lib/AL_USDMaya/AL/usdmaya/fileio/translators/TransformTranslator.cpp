@@ -776,6 +776,17 @@ MStatus TransformTranslator::copyAttributes(const MObject& from, UsdPrim& to, co
 
 //----------------------------------------------------------------------------------------------------------------------
 void TransformTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr, const UsdTimeCode& timeCode)
+{
+  VtValue value;
+  getAttributeValue(plug, usdAttr, value);
+  if(!value.IsEmpty())
+  {
+    usdAttr.Set(value, timeCode);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void TransformTranslator::getAttributeValue(const MPlug& plug, const UsdAttribute& usdAttr, VtValue& result)
 {
   MObject node = plug.node();
   MObject attribute = plug.attribute();
@@ -784,7 +795,7 @@ void TransformTranslator::copyAttributeValue(const MPlug& plug, UsdAttribute& us
   {
     bool value;
     getBool(node, attribute, value);
-    usdAttr.Set(value ? UsdGeomTokens->inherited : UsdGeomTokens->invisible, timeCode);
+    result = value ? UsdGeomTokens->inherited : UsdGeomTokens->invisible;
   }
 }
 
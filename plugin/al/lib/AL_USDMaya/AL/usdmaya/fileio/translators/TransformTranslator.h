@@ -78,6 +78,14 @@ public:
   AL_USDMAYA_PUBLIC
   static void copyAttributeValue(const MPlug& attr, UsdAttribute& usdAttr, const UsdTimeCode& timeCode);
 
+  /// \brief  read the attribute value from the plug specified, converted to the type expected by usdAttr. Nothing is
+  ///         written to usdAttr.
+  /// \param  attr the attribute to be read
+  /// \param  usdAttr the attribute whose type determines the conversion
+  /// \param  result the returned value. This will be empty if the plug is not handled by the transform translator
+  AL_USDMAYA_PUBLIC
+  static void getAttributeValue(const MPlug& attr, const UsdAttribute& usdAttr, VtValue& result);
+
   /// \brief  retrieve the corresponding maya attribute for the transform operation.
   /// \param  operation the transform operation we want the maya attribute handle for
   /// \param  attribute the returned attribute handle
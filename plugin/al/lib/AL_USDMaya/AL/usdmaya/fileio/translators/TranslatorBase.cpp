@@ -81,9 +81,11 @@ TranslatorManufacture::RefPtr TranslatorManufacture::get(const TfToken type_name
 
   TfType type = TfType::FindDerivedByName<UsdSchemaBase>(type_name);
   std::string typeName(type.GetTypeName());
-  if (m_translatorsMap.find(typeName)!= m_translatorsMap.end())
+  // only reads from the map, since this is called concurrently by the hierarchy traversal
+  auto it = m_translatorsMap.find(typeName);
+  if (it != m_translatorsMap.end())
   {
-    return m_translatorsMap[typeName];
+    return it->second;
   }
   return TfNullPtr;
 }
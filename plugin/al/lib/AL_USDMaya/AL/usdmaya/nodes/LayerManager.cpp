@@ -20,6 +20,9 @@
 #include "AL/maya/utils/Utils.h"
 #include "AL/maya/utils/MayaHelperMacros.h"
 
+#include "pxr/base/arch/fileSystem.h"
+#include "pxr/base/tf/fileUtils.h"
+#include "pxr/base/tf/stringUtils.h"
 #include "pxr/usd/sdf/fileFormat.h"
 #include "pxr/usd/sdf/textFileFormat.h"
 #include "pxr/usd/usd/usdaFileFormat.h"
@@ -39,6 +42,9 @@
 #include <boost/thread.hpp>
 #include <boost/thread/shared_lock_guard.hpp>
 
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <mutex>
 
 namespace {
@@ -108,14 +114,197 @@ namespace {
     }
     return dgmod.doIt();
   }
+
+  // The optionVar that selects binary serialization of layers, and the header that identifies the binary form
+  const char* const g_binaryLayerSerialisationOptionVar = "AL_usdmaya_binaryLayerSerialisation";
+  const char* const g_binaryLayerHeader = "#usdc-base64\n";
+
+  const char* const g_base64Chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+  // Appends the base64 encoding of the given bytes onto the output string. The serialized attribute is a string, so
+  // the raw crate bytes need to be mapped onto characters that survive being written into a maya ascii file.
+  void encodeBase64(const std::string& bytes, std::string& output)
+  {
+    const size_t numBytes = bytes.size();
+    output.reserve(output.size() + ((numBytes + 2) / 3) * 4);
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(bytes.data());
+    size_t i = 0;
+    for(; i + 2 < numBytes; i += 3)
+    {
+      const uint32_t triple = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8) | uint32_t(data[i + 2]);
+      output.push_back(g_base64Chars[(triple >> 18) & 0x3F]);
+      output.push_back(g_base64Chars[(triple >> 12) & 0x3F]);
+      output.push_back(g_base64Chars[(triple >> 6) & 0x3F]);
+      output.push_back(g_base64Chars[triple & 0x3F]);
+    }
+    if(i < numBytes)
+    {
+      uint32_t triple = uint32_t(data[i]) << 16;
+      if(i + 1 < numBytes)
+      {
+        triple |= uint32_t(data[i + 1]) << 8;
+      }
+      output.push_back(g_base64Chars[(triple >> 18) & 0x3F]);
+      output.push_back(g_base64Chars[(triple >> 12) & 0x3F]);
+      output.push_back(i + 1 < numBytes ? g_base64Chars[(triple >> 6) & 0x3F] : '=');
+      output.push_back('=');
+    }
+  }
+
+  // Decodes the base64 characters in [begin, end), returning false if an invalid character is encountered
+  bool decodeBase64(const char* begin, const char* end, std::string& bytes)
+  {
+    int8_t lookup[256];
+    std::fill(lookup, lookup + 256, int8_t(-1));
+    for(int8_t i = 0; i < 64; ++i)
+    {
+      lookup[uint8_t(g_base64Chars[i])] = i;
+    }
+
+    bytes.clear();
+    bytes.reserve(((end - begin) / 4) * 3);
+    uint32_t accumulator = 0;
+    int bits = 0;
+    for(const char* c = begin; c != end; ++c)
+    {
+      if(*c == '=')
+      {
+        break;
+      }
+      const int8_t value = lookup[uint8_t(*c)];
+      if(value < 0)
+      {
+        return false;
+      }
+      accumulator = (accumulator << 6) | uint32_t(value);
+      bits += 6;
+      if(bits >= 8)
+      {
+        bits -= 8;
+        bytes.push_back(char((accumulator >> bits) & 0xFF));
+      }
+    }
+    return true;
+  }
+
+  // Writes the layer out as a crate file, and returns the base64 encoded content of that file (with a header)
+  bool exportLayerToBinaryString(const SdfLayerHandle& layer, std::string& output)
+  {
+    const std::string tempPath = ArchMakeTmpFileName("AL_usdmaya_layer", ".usdc");
+    if(!layer->Export(tempPath))
+    {
+      return false;
+    }
+
+    std::string bytes;
+    {
+      std::ifstream file(tempPath, std::ios::in | std::ios::binary);
+      bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    TfDeleteFile(tempPath);
+    if(bytes.empty())
+    {
+      return false;
+    }
+
+    output = g_binaryLayerHeader;
+    encodeBase64(bytes, output);
+    return true;
+  }
+
+  // Replaces the content of the layer with the crate data encoded in a string generated by exportLayerToBinaryString
+  bool importLayerFromBinaryString(const SdfLayerHandle& layer, const std::string& input)
+  {
+    const size_t headerLength = strlen(g_binaryLayerHeader);
+    std::string bytes;
+    if(!decodeBase64(input.data() + headerLength, input.data() + input.size(), bytes))
+    {
+      return false;
+    }
+
+    const std::string tempPath = ArchMakeTmpFileName("AL_usdmaya_layer", ".usdc");
+    {
+      std::ofstream file(tempPath, std::ios::out | std::ios::binary);
+      file.write(bytes.data(), bytes.size());
+      if(!file)
+      {
+        return false;
+      }
+    }
+
+    bool result = false;
+    {
+      SdfLayerRefPtr source = SdfLayer::OpenAsAnonymous(tempPath);
+      if(source)
+      {
+        layer->TransferContent(source);
+        result = true;
+      }
+    }
+    TfDeleteFile(tempPath);
+    return result;
+  }
 }
 
 namespace AL {
 namespace usdmaya {
 namespace nodes {
 
+//----------------------------------------------------------------------------------------------------------------------
+LayerManager::LayerManager()
+  : MPxNode(), NodeHelper()
+{
+  TfWeakPtr<LayerManager> me(this);
+  m_layersChangedNoticeKey = TfNotice::Register(me, &LayerManager::onLayersChanged);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
 LayerManager::~LayerManager()
 {
+  TfNotice::Revoke(m_layersChangedNoticeKey);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void LayerManager::onLayersChanged(SdfNotice::LayersDidChange const& notice)
+{
+  std::lock_guard<std::mutex> lock(m_encodedLayersMutex);
+  if(m_encodedLayers.empty())
+  {
+    return;
+  }
+  for(const SdfLayerHandle& layer : notice.GetLayers())
+  {
+    m_encodedLayers.erase(layer);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+const std::string& LayerManager::encodeLayer(const SdfLayerHandle& layer, const bool binary)
+{
+  auto it = m_encodedLayers.find(layer);
+  if(it != m_encodedLayers.end() && it->second.m_binary == binary)
+  {
+    TF_DEBUG(ALUSDMAYA_LAYERS).Msg("LayerManager::encodeLayer reusing serialization of %s\n", layer->GetIdentifier().c_str());
+    return it->second.m_data;
+  }
+
+  TF_DEBUG(ALUSDMAYA_LAYERS).Msg("LayerManager::encodeLayer serializing %s\n", layer->GetIdentifier().c_str());
+  EncodedLayer& encoded = m_encodedLayers[layer];
+  encoded.m_binary = binary;
+  encoded.m_data.clear();
+  if(binary && !exportLayerToBinaryString(layer, encoded.m_data))
+  {
+    MGlobal::displayWarning(MString("Unable to serialize layer \"") + layer->GetIdentifier().c_str() +
+                            "\" in binary form, falling back to usda");
+    encoded.m_data.clear();
+    layer->ExportToString(&encoded.m_data);
+  }
+  else
+  if(!binary)
+  {
+    layer->ExportToString(&encoded.m_data);
+  }
+  return encoded.m_data;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -395,6 +584,10 @@ bool LayerManager::removeLayer(SdfLayerHandle layer)
     MGlobal::displayError("LayerManager::removeLayer - given layer is no longer valid");
     return false;
   }
+  {
+    std::lock_guard<std::mutex> encodedLock(m_encodedLayersMutex);
+    m_encodedLayers.erase(layer);
+  }
   boost::unique_lock<boost::shared_mutex> lock(m_layersMutex);
   return m_layerDatabase.removeLayer(layerRef);
 }
@@ -431,13 +624,15 @@ MStatus LayerManager::populateSerialisationAttributes()
   // Then fill out the array attribute
   MDataBlock dataBlock = forceCache();
 
+  const bool binary = MGlobal::optionVarIntValue(g_binaryLayerSerialisationOptionVar) != 0;
+
   MArrayDataHandle layersArrayHandle = dataBlock.outputArrayValue(m_layers, &status);
   AL_MAYA_CHECK_ERROR(status, errorString);
   {
     boost::shared_lock_guard<boost::shared_mutex> lock(m_layersMutex);
+    std::lock_guard<std::mutex> encodedLock(m_encodedLayersMutex);
     MArrayDataBuilder builder(&dataBlock, layers(), m_layerDatabase.max_size(), &status);
     AL_MAYA_CHECK_ERROR(status, errorString);
-    std::string temp;
     for (const auto& layerAndIds : m_layerDatabase)
     {
       auto& layer = layerAndIds.first;
@@ -446,8 +641,7 @@ MStatus LayerManager::populateSerialisationAttributes()
       MDataHandle idHandle = layersElemHandle.child(m_identifier);
       idHandle.setString(AL::maya::utils::convert(layer->GetIdentifier()));
       MDataHandle serializedHandle = layersElemHandle.child(m_serialized);
-      layer->ExportToString(&temp);
-      serializedHandle.setString(AL::maya::utils::convert(temp));
+      serializedHandle.setString(AL::maya::utils::convert(encodeLayer(layer, binary)));
       MDataHandle anonHandle = layersElemHandle.child(m_anonymous);
       anonHandle.setBool(layer->IsAnonymous());
     }
@@ -551,6 +745,16 @@ void LayerManager::loadAllLayers()
           fileFormat = SdfFileFormat::FindById(UsdUsdaFileFormatTokens->Id);
         }
         else
+        if(TfStringStartsWith(serializedVal, g_binaryLayerHeader))
+        {
+          // the crate data can be transferred into a layer of any format, so keep the one the identifier implies
+          fileFormat = SdfFileFormat::FindByExtension(identifierVal);
+          if(!fileFormat)
+          {
+            fileFormat = SdfFileFormat::FindById(UsdUsdaFileFormatTokens->Id);
+          }
+        }
+        else
         {
           fileFormat = SdfFileFormat::FindById(SdfTextFileFormatTokens->Id);
         }
@@ -583,7 +787,8 @@ void LayerManager::loadAllLayers()
         serializedVal.c_str(),
         serializedVal.length() > MAX_LAYER_CHARS ? "<truncated>\n" : ""
         );
-    if(!layer->ImportFromString(serializedVal))
+    const bool binary = TfStringStartsWith(serializedVal, g_binaryLayerHeader);
+    if(binary ? !importLayerFromBinaryString(layer, serializedVal) : !layer->ImportFromString(serializedVal))
     {
       TF_DEBUG(ALUSDMAYA_LAYERS).Msg("...layer import failed!\n");
       MGlobal::displayError(MString("Failed to import serialized layer: ") + serializedVal.c_str());
@@ -591,6 +796,14 @@ void LayerManager::loadAllLayers()
     }
     TF_DEBUG(ALUSDMAYA_LAYERS).Msg("...layer import succeeded!\n");
     addLayer(layer, identifierVal);
+
+    // The layer content matches what was just read, so unless it is edited, the next save can store the same string
+    {
+      std::lock_guard<std::mutex> encodedLock(m_encodedLayersMutex);
+      EncodedLayer& encoded = m_encodedLayers[layer];
+      encoded.m_binary = binary;
+      encoded.m_data.swap(serializedVal);
+    }
   }
 }
 
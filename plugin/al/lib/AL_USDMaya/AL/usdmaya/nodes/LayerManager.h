@@ -19,6 +19,9 @@
 
 #include "AL/maya/utils/NodeHelper.h"
 #include "pxr/pxr.h"
+#include "pxr/base/tf/notice.h"
+#include "pxr/base/tf/weakBase.h"
+#include "pxr/usd/sdf/notice.h"
 #include "pxr/usd/usd/stage.h"
 
 #include "maya/MPxLocatorNode.h"
@@ -27,6 +30,7 @@
 
 #include <iterator>
 #include <map>
+#include <mutex>
 #include <set>
 #include <boost/thread.hpp>
 
@@ -227,17 +231,22 @@ private:
 //----------------------------------------------------------------------------------------------------------------------
 /// \brief  The layer manager node handles serialization and deserialization of all layers used by all ProxyShapes
 ///         It may temporarily contain non-dirty layers, but those will be filtered out by query operations.
+///
+///         Layers are serialized as usda text by default. If the "AL_usdmaya_binaryLayerSerialisation" optionVar is
+///         set to 1, they are instead stored as base64 encoded crate (usdc) data, which is typically far smaller and
+///         quicker to parse for large layers. The encoded form of each layer is cached, and is only regenerated once
+///         the layer has changed, so saving repeatedly only re-encodes the layers that have been edited in between.
 /// \ingroup nodes
 //----------------------------------------------------------------------------------------------------------------------
 class LayerManager
   : public MPxNode,
-    public AL::maya::utils::NodeHelper
+    public AL::maya::utils::NodeHelper,
+    public TfWeakBase
 {
 public:
 
   /// \brief  ctor
-  inline LayerManager()
-    : MPxNode(), NodeHelper() {}
+  LayerManager();
 
   ~LayerManager();
 
@@ -349,9 +358,21 @@ public:
 
 private:
   static MObject _findNode();
+  void onLayersChanged(SdfNotice::LayersDidChange const& notice);
+  const std::string& encodeLayer(const SdfLayerHandle& layer, bool binary);
 
   LayerDatabase m_layerDatabase;
 
+  // the most recent serialization of each layer, discarded whenever the layer changes (guarded by m_encodedLayersMutex)
+  struct EncodedLayer
+  {
+    bool m_binary;
+    std::string m_data;
+  };
+  std::map<SdfLayerHandle, EncodedLayer> m_encodedLayers;
+  std::mutex m_encodedLayersMutex;
+  TfNotice::Key m_layersChangedNoticeKey;
+
   // Note on layerManager / multithreading:
   // I don't know that layerManager will be used in a multihreaded manenr... but I also don't know it COULDN'T be.
   // (I haven't really looked into the way maya's new multi-threaded node evaluation works, for instance.) This is
@@ -86,38 +86,93 @@ MStatus MeshAnimDeformer::compute(const MPlug& plug, MDataBlock& data)
   UsdStageRefPtr stage = getStage();
   if(stage)
   {
-    UsdPrim prim = stage->GetPrimAtPath(m_cachePath);
-    UsdGeomMesh mesh(prim);
+    if(m_sampleCachesDirty || get_pointer(m_cachedStage) != get_pointer(stage))
+    {
+      updateSampleCaches(stage);
+    }
 
     MFnMesh fnMesh(obj);
     float* const ptr = (float*)fnMesh.getRawPoints(&status);
-    if(ptr)
+    if(ptr && m_points.isAnimated())
+    {
+      m_points.evaluate(usdTime.GetValue(), ptr, fnMesh.numVertices());
+    }
+
+    float* const nptr = (float*)fnMesh.getRawNormals(&status);
+    if(nptr && m_normals.isAnimated())
+    {
+      m_normals.evaluate(usdTime.GetValue(), nptr, fnMesh.numNormals());
+    }
+    outputHandle.set(obj);
+  }
+  return status;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshAnimDeformer::updateSampleCaches(const UsdStageRefPtr& stage)
+{
+  TF_DEBUG(ALUSDMAYA_GEOMETRY_DEFORMER).Msg("MeshAnimDeformer::updateSampleCaches %s\n", m_cachePath.GetText());
+  m_sampleCachesDirty = false;
+  if(get_pointer(m_cachedStage) != get_pointer(stage))
+  {
+    TfNotice::Revoke(m_objectsChangedNoticeKey);
+    m_cachedStage = stage;
+    TfWeakPtr<MeshAnimDeformer> me(this);
+    m_objectsChangedNoticeKey = TfNotice::Register(me, &MeshAnimDeformer::onObjectsChanged, m_cachedStage);
+  }
+
+  UsdGeomMesh mesh(m_cachePath.IsEmpty() ? UsdPrim() : stage->GetPrimAtPath(m_cachePath));
+  m_points.reset(mesh ? mesh.GetPointsAttr() : UsdAttribute());
+  m_normals.reset(mesh ? mesh.GetNormalsAttr() : UsdAttribute());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshAnimDeformer::onObjectsChanged(UsdNotice::ObjectsChanged const& notice, UsdStageWeakPtr const& sender)
+{
+  if(m_cachePath.IsEmpty())
+  {
+    return;
+  }
+
+  // only the points and normals of the cached prim are read into the caches
+  auto isCachedAttribute = [this](const SdfPath& path)
+  {
+    return path.IsPropertyPath() && path.GetPrimPath() == m_cachePath &&
+           (path.GetNameToken() == UsdGeomTokens->points || path.GetNameToken() == UsdGeomTokens->normals);
+  };
+
+  // a resync of the prim or any of its ancestors may replace the attributes, whereas a change to the info (e.g. the
+  // metadata) of an ancestor leaves the samples of the prim untouched
+  auto resyncsPrim = [this, &isCachedAttribute](const UsdNotice::ObjectsChanged::PathRange& paths)
+  {
+    for(auto it = paths.begin(); it != paths.end(); ++it)
     {
-      UsdAttribute points = mesh.GetPointsAttr();
-      if(points.GetNumTimeSamples() > 1)
+      const SdfPath& path = *it;
+      if(path.IsPropertyPath() ? isCachedAttribute(path) : m_cachePath.HasPrefix(path))
       {
-        VtArray<GfVec3f> pointData;
-        points.Get(&pointData, usdTime);
-        const size_t numPoints = pointData.size();
-        std::memcpy(ptr, pointData.cdata(), sizeof(float) * 3 * numPoints);
+        return true;
       }
     }
+    return false;
+  };
 
-    float* const nptr = (float*)fnMesh.getRawNormals(&status);
-    if(nptr)
+  auto changesSamples = [&isCachedAttribute](const UsdNotice::ObjectsChanged::PathRange& paths)
+  {
+    for(auto it = paths.begin(); it != paths.end(); ++it)
     {
-      UsdAttribute normals = mesh.GetNormalsAttr();
-      if(normals.GetNumTimeSamples() > 1)
+      if(isCachedAttribute(*it))
       {
-        VtArray<GfVec3f> normalData;
-        normals.Get(&normalData, usdTime);
-        const size_t numNormals = normalData.size();
-        std::memcpy(nptr, normalData.cdata(), sizeof(float) * 3 * numNormals);
+        return true;
       }
     }
-    outputHandle.set(obj);
+    return false;
+  };
+
+  if(resyncsPrim(notice.GetResyncedPaths()) || changesSamples(notice.GetChangedInfoOnlyPaths()))
+  {
+    TF_DEBUG(ALUSDMAYA_GEOMETRY_DEFORMER).Msg("MeshAnimDeformer::onObjectsChanged %s\n", m_cachePath.GetText());
+    m_sampleCachesDirty = true;
   }
-  return status;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -189,6 +244,7 @@ void MeshAnimDeformer::onAttributeChanged(MNodeMessage::AttributeMessage msg, MP
       if (primPathStr.length())
       {
         deformer->m_cachePath = SdfPath(AL::maya::utils::convert(primPathStr));
+        deformer->m_sampleCachesDirty = true;
       }
     }
   }
@@ -19,6 +19,9 @@
 #include "AL/maya/utils/MayaHelperMacros.h"
 #include "AL/usdmaya/utils/ForwardDeclares.h"
 #include "pxr/pxr.h"
+#include "AL/usdmaya/nodes/MeshAnimSampleCache.h"
+#include "pxr/base/tf/weakBase.h"
+#include "pxr/usd/usd/notice.h"
 #include "pxr/usd/usd/stage.h"
 #include "maya/MPxNode.h"
 #include "maya/MObjectHandle.h"
@@ -32,11 +35,15 @@ namespace nodes {
 
 //----------------------------------------------------------------------------------------------------------------------
 /// \brief   This node is a simple deformer that modifies 
+///          The time samples of the points and normals are read through a MeshAnimSampleCache, which is rebuilt
+///          when the prim path or stage change, when the prim or one of its ancestors is resynced, or when the points or
+///          normals of the prim change.
 /// \ingroup nodes
 //----------------------------------------------------------------------------------------------------------------------
 class MeshAnimDeformer
   : public MPxNode,
-    public AL::maya::utils::NodeHelper
+    public AL::maya::utils::NodeHelper,
+    public TfWeakBase
 {
 public:
 
@@ -46,7 +53,10 @@ public:
      {}
 
   inline ~MeshAnimDeformer()
-    { MNodeMessage::removeCallback(m_attributeChanged); }
+    {
+      MNodeMessage::removeCallback(m_attributeChanged);
+      TfNotice::Revoke(m_objectsChangedNoticeKey);
+    }
 
   //--------------------------------------------------------------------------------------------------------------------
   /// Type Info & Registration
@@ -70,10 +80,17 @@ private:
   static void onAttributeChanged(MNodeMessage::AttributeMessage, MPlug&, MPlug&, void*);
   MStatus compute(const MPlug& plug, MDataBlock& data) override;
   UsdStageRefPtr getStage();
+  void updateSampleCaches(const UsdStageRefPtr& stage);
+  void onObjectsChanged(UsdNotice::ObjectsChanged const& notice, UsdStageWeakPtr const& sender);
 private:
   SdfPath m_cachePath;
   MObjectHandle proxyShapeHandle;
   MCallbackId m_attributeChanged = 0;
+  UsdStageWeakPtr m_cachedStage;
+  MeshAnimSampleCache m_points;
+  MeshAnimSampleCache m_normals;
+  TfNotice::Key m_objectsChangedNoticeKey;
+  std::atomic<bool> m_sampleCachesDirty{true};
 };
 
 //----------------------------------------------------------------------------------------------------------------------
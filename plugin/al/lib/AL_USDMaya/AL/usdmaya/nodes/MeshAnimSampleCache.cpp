@@ -0,0 +1,159 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "AL/usdmaya/nodes/MeshAnimSampleCache.h"
+#include "AL/usdmaya/DebugCodes.h"
+
+#include "pxr/base/work/loops.h"
+#include "pxr/usd/usd/stage.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace AL {
+namespace usdmaya {
+namespace nodes {
+
+//----------------------------------------------------------------------------------------------------------------------
+MeshAnimSampleCache::MeshAnimSampleCache(const uint32_t prefetchWindow)
+  : m_query(), m_times(), m_decoded(), m_prefetchWindow(prefetchWindow)
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshAnimSampleCache::reset(const UsdAttribute& attr)
+{
+  m_decoded.clear();
+  m_times.clear();
+  m_query = attr ? UsdAttributeQuery(attr) : UsdAttributeQuery();
+  if(attr)
+  {
+    m_query.GetTimeSamples(&m_times);
+    m_linearInterpolation = attr.GetStage()->GetInterpolationType() == UsdInterpolationTypeLinear;
+    TF_DEBUG(ALUSDMAYA_GEOMETRY_DEFORMER).Msg("MeshAnimSampleCache::reset %s (%zu samples)\n",
+                                              attr.GetPath().GetText(), m_times.size());
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshAnimSampleCache::evict(const size_t firstSampleIndex, const size_t lastSampleIndex)
+{
+  m_decoded.erase(m_decoded.begin(), m_decoded.lower_bound(firstSampleIndex));
+  m_decoded.erase(m_decoded.upper_bound(lastSampleIndex), m_decoded.end());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void MeshAnimSampleCache::decode(const size_t firstSampleIndex, const size_t lastSampleIndex)
+{
+  std::vector<size_t> missing;
+  for(size_t i = firstSampleIndex; i <= lastSampleIndex && i < m_times.size(); ++i)
+  {
+    if(m_decoded.find(i) == m_decoded.end())
+    {
+      missing.push_back(i);
+    }
+  }
+
+  if(missing.empty())
+  {
+    return;
+  }
+
+  // Each task only reads from the stage and writes into its own element of the results, and all of them have
+  // completed before this returns, so the stage is never read once the caller has finished evaluating.
+  std::vector<VtVec3fArray> results(missing.size());
+  auto decodeSamples = [this, &missing, &results](size_t begin, size_t end)
+  {
+    for(size_t i = begin; i < end; ++i)
+    {
+      m_query.Get(&results[i], UsdTimeCode(m_times[missing[i]]));
+    }
+  };
+  if(missing.size() > 1)
+  {
+    WorkParallelForN(missing.size(), decodeSamples);
+  }
+  else
+  {
+    decodeSamples(0, 1);
+  }
+
+  for(size_t i = 0; i < missing.size(); ++i)
+  {
+    m_decoded.emplace(missing[i], std::move(results[i]));
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+size_t MeshAnimSampleCache::evaluate(const double time, float* const output, const size_t maxCount)
+{
+  if(m_times.empty())
+  {
+    return 0;
+  }
+
+  // find the samples that bracket the time (clamped to the first and last samples)
+  const auto upper = std::lower_bound(m_times.begin(), m_times.end(), time);
+  size_t lo, hi;
+  if(upper == m_times.begin())
+  {
+    lo = hi = 0;
+  }
+  else
+  if(upper == m_times.end())
+  {
+    lo = hi = m_times.size() - 1;
+  }
+  else
+  if(*upper == time)
+  {
+    lo = hi = size_t(upper - m_times.begin());
+  }
+  else
+  {
+    hi = size_t(upper - m_times.begin());
+    lo = hi - 1;
+  }
+
+  evict(lo, hi + m_prefetchWindow);
+  decode(lo, hi + m_prefetchWindow);
+  const VtVec3fArray& lower = m_decoded[lo];
+  const VtVec3fArray& higher = m_decoded[hi];
+
+  const size_t count = std::min(lower.size(), maxCount);
+  const float* const lowerData = reinterpret_cast<const float*>(lower.cdata());
+  if(lo != hi && m_linearInterpolation && lower.size() == higher.size())
+  {
+    TF_DEBUG(ALUSDMAYA_GEOMETRY_DEFORMER).Msg("MeshAnimSampleCache::evaluate interpolating %f between %f and %f\n",
+                                              time, m_times[lo], m_times[hi]);
+    const float alpha = float((time - m_times[lo]) / (m_times[hi] - m_times[lo]));
+    const float* const higherData = reinterpret_cast<const float*>(higher.cdata());
+    for(size_t i = 0, n = count * 3; i < n; ++i)
+    {
+      output[i] = lowerData[i] + alpha * (higherData[i] - lowerData[i]);
+    }
+  }
+  else
+  {
+    std::memcpy(output, lowerData, sizeof(float) * 3 * count);
+  }
+  return count;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+} // nodes
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
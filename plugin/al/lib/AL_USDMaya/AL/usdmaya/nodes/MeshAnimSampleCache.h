@@ -0,0 +1,100 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+
+#include "../Api.h"
+
+#include <map>
+#include <vector>
+
+#include "pxr/pxr.h"
+#include "pxr/base/vt/types.h"
+#include "pxr/usd/usd/attribute.h"
+#include "pxr/usd/usd/attributeQuery.h"
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace AL {
+namespace usdmaya {
+namespace nodes {
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Caches the decoded time samples of a GfVec3f array attribute (e.g. the points or normals of a mesh), so that
+///         playback does not need to read from the stage on every frame.
+///
+///         The authored sample times are queried once when the attribute is set. When a time is evaluated, the two
+///         samples that bracket it are decoded (if they are not already cached), and linearly interpolated on sub
+///         frames. Any samples missing from the window that follows are decoded in parallel at the same time, so that
+///         they are ready by the time the playhead reaches them. Samples outside of the window are discarded.
+///
+///         All of the decoding happens within evaluate(), and has completed by the time it returns. The stage is only
+///         read while the caller is evaluating, so it must not be modified by another thread during that call.
+//----------------------------------------------------------------------------------------------------------------------
+class MeshAnimSampleCache
+{
+public:
+
+  /// \brief  ctor
+  /// \param  prefetchWindow the number of samples to decode ahead of the last evaluated time
+  AL_USDMAYA_PUBLIC
+  MeshAnimSampleCache(uint32_t prefetchWindow = 8);
+
+  /// \brief  sets the attribute to read the samples from, discarding any cached samples.
+  /// \param  attr the attribute to cache. This may be invalid, in which case the cache is empty.
+  AL_USDMAYA_PUBLIC
+  void reset(const UsdAttribute& attr);
+
+  /// \brief  discards the attribute and all cached samples
+  inline void clear()
+    { reset(UsdAttribute()); }
+
+  /// \brief  returns true if the attribute has more than one time sample
+  inline bool isAnimated() const
+    { return m_times.size() > 1; }
+
+  /// \brief  returns the attribute that is currently cached
+  inline UsdAttribute attribute() const
+    { return m_query.GetAttribute(); }
+
+  /// \brief  computes the value of the attribute at the specified time, interpolating between the bracketing samples
+  ///         if the stage uses linear interpolation.
+  /// \param  time the time to evaluate
+  /// \param  output the buffer to write the values into (as 3 floats per element)
+  /// \param  maxCount the maximum number of elements that can be written into the output buffer
+  /// \return the number of elements written into the output buffer
+  AL_USDMAYA_PUBLIC
+  size_t evaluate(double time, float* output, size_t maxCount);
+
+  /// \brief  returns the number of samples that have been decoded and are held in the cache
+  inline size_t decodedSampleCount() const
+    { return m_decoded.size(); }
+
+private:
+  void decode(size_t firstSampleIndex, size_t lastSampleIndex);
+  void evict(size_t firstSampleIndex, size_t lastSampleIndex);
+
+  UsdAttributeQuery m_query;
+  std::vector<double> m_times;
+  std::map<size_t, VtVec3fArray> m_decoded;
+  uint32_t m_prefetchWindow;
+  bool m_linearInterpolation = true;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+} // nodes
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
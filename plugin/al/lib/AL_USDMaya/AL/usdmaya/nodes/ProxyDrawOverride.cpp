@@ -29,6 +29,8 @@
 #include "maya/MPointArray.h"
 #include "maya/M3dView.h"
 #include "maya/MSelectionContext.h"
+#include "maya/MUIDrawManager.h"
+#include "maya/MVector.h"
 
 #if defined(WANT_UFE_BUILD)
 #include "AL/usdmaya/TypeIDs.h"
@@ -65,6 +67,7 @@ public:
   Engine* m_engine = 0;
   ProxyShape* m_shape = 0;
   MDagPath m_objPath;
+  bool m_loading = false;
 };
 }
 
@@ -134,6 +137,21 @@ MUserData* ProxyDrawOverride::prepareForDraw(
   if (!shape)
     return nullptr;
 
+  // whilst the stage is being loaded in the background, only the placeholder is drawn (by addUIDrawables)
+  if (shape->isStageLoading())
+  {
+    if (data == nullptr)
+    {
+      data = new RenderUserData;
+    }
+    data->m_objPath = objPath;
+    data->m_shape = shape;
+    data->m_rootPrim = UsdPrim();
+    data->m_engine = nullptr;
+    data->m_loading = true;
+    return data;
+  }
+
   auto engine = shape->engine();
   if(!engine)
   {
@@ -159,10 +177,32 @@ MUserData* ProxyDrawOverride::prepareForDraw(
   data->m_shape = shape;
   data->m_rootPrim = shape->getRootPrim();
   data->m_engine = engine;
+  data->m_loading = false;
 
   return data;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyDrawOverride::addUIDrawables(
+    const MDagPath& objPath,
+    MHWRender::MUIDrawManager& drawManager,
+    const MHWRender::MFrameContext& frameContext,
+    const MUserData* data)
+{
+  auto ptr = static_cast<const RenderUserData*>(data);
+  if(!ptr || !ptr->m_loading)
+    return;
+
+  TF_DEBUG(ALUSDMAYA_DRAW).Msg("ProxyDrawOverride::addUIDrawables drawing the loading placeholder\n");
+  const MBoundingBox bound = ProxyShape::placeholderBound();
+  drawManager.beginDrawable();
+  drawManager.setColor(MColor(1.0f, 0.6f, 0.0f));
+  drawManager.box(bound.center(), MVector::yAxis, MVector::xAxis,
+                  bound.width() * 0.5, bound.height() * 0.5, bound.depth() * 0.5, false);
+  drawManager.text(bound.center(), "Loading USD stage...", MHWRender::MUIDrawManager::kCenter);
+  drawManager.endDrawable();
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 void ProxyDrawOverride::draw(const MHWRender::MDrawContext& context, const MUserData* data)
 {
@@ -545,10 +585,15 @@ bool ProxyDrawOverride::userSelect(
   UsdImagingGLRenderParams params;
 
   auto* proxyShape = static_cast<ProxyShape*>(getShape(objPath));
+  // there is nothing to select whilst the stage is being loaded in the background
+  UsdStageRefPtr stage = proxyShape->getUsdStage();
+  if (!stage)
+    return false;
+
   auto engine = proxyShape->engine();
   proxyShape->m_pleaseIgnoreSelection = true;
 
-  UsdPrim root = proxyShape->getUsdStage()->GetPseudoRoot();
+  UsdPrim root = stage->GetPseudoRoot();
 
   Engine::HitBatch hitBatch;
   SdfPathVector rootPath;
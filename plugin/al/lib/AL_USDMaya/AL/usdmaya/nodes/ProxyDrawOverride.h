@@ -83,6 +83,21 @@ public:
       const MHWRender::MFrameContext& frameContext,
       MUserData* oldData) override;
 
+  /// \brief  Returns true, so that addUIDrawables is called to draw the placeholder of a stage that is loading
+  bool hasUIDrawables() const override
+    { return true; }
+
+  /// \brief  Draws a placeholder box (and a message) whilst the stage of the proxy is loaded in the background.
+  /// \param  objPath The path to the object being drawn
+  /// \param  drawManager the draw manager used to draw the placeholder
+  /// \param  frameContext  Frame level context information
+  /// \param  data the user data generated by the prepareForDraw method
+  void addUIDrawables(
+      const MDagPath& objPath,
+      MHWRender::MUIDrawManager& drawManager,
+      const MHWRender::MFrameContext& frameContext,
+      const MUserData* data) override;
+
   /// \brief  draw classification string for this override
   AL_USDMAYA_PUBLIC
   static MString kDrawDbClassification;
@@ -53,6 +53,7 @@ typedef boost::filesystem::path path;
 #include "AL/usdmaya/nodes/ProxyShape.h"
 #include "AL/usdmaya/nodes/Transform.h"
 #include "AL/usdmaya/nodes/TransformationMatrix.h"
+#include "AL/usdmaya/nodes/proxy/HierarchyTraversal.h"
 #include "AL/usdmaya/nodes/proxy/PrimFilter.h"
 #include "AL/usdmaya/Version.h"
 #include "AL/usd/utils/ForwardDeclares.h"
@@ -66,17 +67,29 @@ typedef boost::filesystem::path path;
 #include "maya/MNodeClass.h"
 #include "maya/MFileIO.h"
 #include "maya/MCommandResult.h"
+#include "maya/MFnDependencyNode.h"
+#include "maya/MObjectHandle.h"
 
 #include "pxr/base/arch/systemInfo.h"
 #include "pxr/base/tf/fileUtils.h"
+#include "pxr/base/work/loops.h"
+#include "pxr/usd/sdf/changeBlock.h"
 #include "pxr/usd/ar/resolver.h"
+#include "pxr/usd/ar/resolverContextBinder.h"
+#include "pxr/usd/usd/primRange.h"
 #include "pxr/usd/usd/stageCacheContext.h"
+#include "pxr/usd/usdGeom/tokens.h"
 #include "pxr/usdImaging/usdImaging/primAdapter.h"
 #include "pxr/usdImaging/usdImaging/meshAdapter.h"
 #include "pxr/usd/usdUtils/stageCache.h"
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #if defined(WANT_UFE_BUILD)
 #include "ufe/path.h"
@@ -202,6 +215,66 @@ static std::string resolveRelativePathWithinMayaContext(const MObject &proxyShap
   return path.string();
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  everything needed to open the stage of a proxy shape, gathered from the node on the main thread
+//----------------------------------------------------------------------------------------------------------------------
+struct ProxyShape::StageLoadRequest
+{
+  MString m_file; ///< the file path on the proxy
+  std::string m_fileString; ///< the resolved file path
+  std::string m_resolverConfig; ///< the asset the resolver should be configured for
+  ArResolverContext m_resolverContext; ///< the context the root layer is found and the stage is composed with
+  SdfLayerRefPtr m_sessionLayer;
+  UsdStagePopulationMask m_mask;
+  UsdStage::InitialLoadSet m_loadOperation = UsdStage::LoadAll;
+  bool m_loadAsync = false;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  the stages being opened on background threads. A background thread only opens its stage, and marks the load
+///         as finished. The rest of the load is completed on the main thread, by an idle callback that is registered
+///         whilst there are loads outstanding, or by waitForAsyncStageLoads.
+//----------------------------------------------------------------------------------------------------------------------
+struct ProxyShape::AsyncStageLoads
+{
+  struct Load
+  {
+    std::thread m_thread;
+    UsdStageRefPtr m_stage;
+    MObjectHandle m_handle;
+    uint32_t m_loadId;
+    MString m_file;
+    std::string m_fileString;
+    std::string m_resolverConfig;
+    bool m_finished = false; ///< set by the background thread, with the mutex locked
+  };
+  typedef std::vector<std::unique_ptr<Load>> Loads;
+
+  // in case the plugin was not unloaded, so cancelAsyncStageLoads was never called
+  ~AsyncStageLoads()
+    { takeFinished(true); }
+
+  static AsyncStageLoads& get()
+  {
+    static AsyncStageLoads loads;
+    return loads;
+  }
+
+  void start(ProxyShape* proxy, const StageLoadRequest& request, uint32_t loadId);
+  Loads takeFinished(bool wait);
+  static void onIdle(void* clientData);
+  static void finish(Load& load);
+
+  std::mutex m_mutex;
+  Loads m_loads;
+  MCallbackId m_idleCallback = 0;
+};
+
+namespace {
+/// if true, stages are loaded in the background in batch mode as well (see enableAsyncStageLoadsInBatchMode)
+bool g_asyncStageLoadsInBatchMode = false;
+} // anon
+
 //----------------------------------------------------------------------------------------------------------------------
 AL_MAYA_DEFINE_NODE(ProxyShape, AL_USDMAYA_PROXYSHAPE, AL_usdmaya);
 
@@ -224,6 +297,7 @@ MObject ProxyShape::m_sessionLayerName = MObject::kNullObj;
 MObject ProxyShape::m_serializedArCtx = MObject::kNullObj;
 MObject ProxyShape::m_serializedTrCtx = MObject::kNullObj;
 MObject ProxyShape::m_unloaded = MObject::kNullObj;
+MObject ProxyShape::m_loadAsync = MObject::kNullObj;
 MObject ProxyShape::m_inDrivenTransformsData = MObject::kNullObj;
 MObject ProxyShape::m_ambient = MObject::kNullObj;
 MObject ProxyShape::m_diffuse = MObject::kNullObj;
@@ -326,7 +400,10 @@ void ProxyShape::translatePrimsIntoMaya(
 {
   TF_DEBUG(ALUSDMAYA_EVALUATION).Msg("ProxyShape:translatePrimsIntoMaya ImportSize='%zd' TearDownSize='%zd' \n", importPrims.size(), teardownPrims.size());
 
+  AL_BEGIN_PROFILE_SECTION(TranslatePrims);
+  AL_BEGIN_PROFILE_SECTION(PrimFilter);
   proxy::PrimFilter filter(teardownPrims, importPrims, this);
+  AL_END_PROFILE_SECTION();
 
   if(TfDebug::IsEnabled(ALUSDMAYA_TRANSLATORS))
   {
@@ -394,6 +471,7 @@ void ProxyShape::translatePrimsIntoMaya(
     TF_DEBUG(ALUSDMAYA_EVALUATION).Msg("ProxyShape:translatePrimsIntoMaya excluded geometry has been modified, reconstructing imaging engine \n");
     constructGLImagingEngine();
   }
+  AL_END_PROFILE_SECTION();
 }
 //----------------------------------------------------------------------------------------------------------------------
 SdfPathVector ProxyShape::getPrimPathsFromCommaJoinedString(const MString &paths) const
@@ -439,9 +517,8 @@ void ProxyShape::constructGLImagingEngine()
 
       const SdfPathSet& translatedGeo = m_context->excludedGeometry();
       // combine the excluded paths
-      SdfPathVector excludedGeometryPaths;
-      excludedGeometryPaths.reserve(m_excludedTaggedGeometry.size() + m_excludedGeometry.size() + translatedGeo.size());
-      excludedGeometryPaths.assign(m_excludedTaggedGeometry.begin(), m_excludedTaggedGeometry.end());
+      SdfPathVector excludedGeometryPaths = m_metadataIndex.pathsWithAuthoredFlag(PrimMetadataIndex::kExcluded);
+      excludedGeometryPaths.reserve(excludedGeometryPaths.size() + m_excludedGeometry.size() + translatedGeo.size());
       excludedGeometryPaths.insert(excludedGeometryPaths.end(), m_excludedGeometry.begin(), m_excludedGeometry.end());
       excludedGeometryPaths.insert(excludedGeometryPaths.end(),
                                    translatedGeo.begin(),
@@ -612,92 +689,76 @@ ProxyShape::ProxyShape()
 
   registerEvents();
 
-  m_findExcludedPrims.preIteration = [this]() {
-    m_excludedTaggedGeometry.clear();
-  };
-  m_findExcludedPrims.iteration = [this]( const fileio::TransformIterator& transformIterator,
-                                          const UsdPrim& prim) {
+  m_findExcludedPrims.numPathLists = 1;
+  m_findExcludedPrims.parallelIteration = [](const UsdPrim& prim, SdfPathVector* pathLists) {
 
     bool excludeGeo = false;
-    if(prim.GetMetadata(Metadata::excludeFromProxyShape, &excludeGeo))
+    if(prim.GetMetadata(Metadata::excludeFromProxyShape, &excludeGeo) && excludeGeo)
     {
-      if (excludeGeo)
-      {
-        m_excludedTaggedGeometry.push_back(prim.GetPrimPath());
-      }
+      pathLists[0].push_back(prim.GetPrimPath());
     }
-
-    // If prim has exclusion tag or is a descendent of a prim with it, create as Maya geo
-    if (excludeGeo || primHasExcludedParent(prim))
+  };
+  m_findExcludedPrims.mergePathLists = [this](std::vector<SdfPathVector>& pathLists) {
+    const SdfPathVector& excludedTaggedGeometry = pathLists[0];
+    m_metadataIndex.resetAuthoredFlag(PrimMetadataIndex::kExcluded, excludedTaggedGeometry);
+
+    // If prim has exclusion tag or is a descendent of a prim with it, create as Maya geo. The paths are sorted, so
+    // any tagged descendants of a tagged prim directly follow it, and have already been handled.
+    SdfChangeBlock changeBlock;
+    VtValue schemaName(fileio::ALExcludedPrimSchema.GetString());
+    SdfPath lastExcludedPath;
+    for(const SdfPath& excludedPath : excludedTaggedGeometry)
     {
-      VtValue schemaName(fileio::ALExcludedPrimSchema.GetString());
-      prim.SetCustomDataByKey(fileio::ALSchemaType, schemaName);
+      if(!lastExcludedPath.IsEmpty() && excludedPath.HasPrefix(lastExcludedPath))
+      {
+        continue;
+      }
+      lastExcludedPath = excludedPath;
+      for(const UsdPrim& prim : UsdPrimRange(m_stage->GetPrimAtPath(excludedPath)))
+      {
+        prim.SetCustomDataByKey(fileio::ALSchemaType, schemaName);
+      }
     }
   };
   m_findExcludedPrims.postIteration = [this]() {
     constructExcludedPrims();
   };
 
-  m_findUnselectablePrims.preIteration = [this]() {
-
-  };
-  m_findUnselectablePrims.iteration = [this]
-                                    (const fileio::TransformIterator& transformIterator, const UsdPrim& prim) {
+  m_findUnselectablePrims.numPathLists = FindUnselectablePrimsLogic::kNumPathLists;
+  m_findUnselectablePrims.parallelIteration = [](const UsdPrim& prim, SdfPathVector* pathLists) {
 
     TfToken selectabilityPropertyToken;
-    if(prim.GetMetadata<TfToken>(Metadata::selectability, &selectabilityPropertyToken))
+    if(prim.GetMetadata<TfToken>(Metadata::selectability, &selectabilityPropertyToken) &&
+       selectabilityPropertyToken == Metadata::unselectable)
     {
-
-      //Check if this prim is unselectable
-      if(selectabilityPropertyToken == Metadata::unselectable)
-      {
-        m_findUnselectablePrims.newUnselectables.push_back(prim.GetPath());
-      }
-      else if(m_selectabilityDB.isPathUnselectable(prim.GetPath()) && selectabilityPropertyToken != Metadata::unselectable)
-      {
-        m_findUnselectablePrims.removeUnselectables.push_back(prim.GetPath());
-      }
+      pathLists[FindUnselectablePrimsLogic::kUnselectables].push_back(prim.GetPath());
     }
   };
-  m_findUnselectablePrims.postIteration = [this]() {
-    if(m_findUnselectablePrims.removeUnselectables.size() > 0)
-    {
-      m_selectabilityDB.removePathsAsUnselectable(m_findUnselectablePrims.removeUnselectables);
-    }
-
-    if(m_findUnselectablePrims.newUnselectables.size() > 0)
-    {
-      m_selectabilityDB.addPathsAsUnselectable(m_findUnselectablePrims.newUnselectables);
-    }
-
-    m_findUnselectablePrims.newUnselectables.clear();
-    m_findUnselectablePrims.removeUnselectables.clear();
+  m_findUnselectablePrims.mergePathLists = [this](std::vector<SdfPathVector>& pathLists) {
+    m_metadataIndex.resetAuthoredFlag(PrimMetadataIndex::kUnselectable, pathLists[FindUnselectablePrimsLogic::kUnselectables]);
+    syncSelectabilityDB();
   };
 
-  m_findLockedPrims.preIteration = [this]() {
-    this->m_lockTransformPrims.clear();
-    this->m_lockInheritedPrims.clear();
-  };
-  m_findLockedPrims.iteration = [this] ( const fileio::TransformIterator& transformIterator,
-                                         const UsdPrim& prim)
+  m_findLockedPrims.numPathLists = FindLockedPrimsLogic::kNumPathLists;
+  m_findLockedPrims.parallelIteration = [](const UsdPrim& prim, SdfPathVector* pathLists)
   {
     TfToken lockPropertyToken;
     if (prim.GetMetadata<TfToken>(Metadata::locked, & lockPropertyToken))
     {
       if (lockPropertyToken == Metadata::lockTransform)
       {
-        this->m_lockTransformPrims.insert(prim.GetPath());
+        pathLists[FindLockedPrimsLogic::kLockTransform].push_back(prim.GetPath());
       }
-      else if (lockPropertyToken == Metadata::lockInherited)
+      else if (lockPropertyToken == Metadata::lockUnlocked)
       {
-        this->m_lockInheritedPrims.insert(prim.GetPath());
+        pathLists[FindLockedPrimsLogic::kLockUnlocked].push_back(prim.GetPath());
       }
     }
-    else
-    {
-      this->m_lockInheritedPrims.insert(prim.GetPath());
-    }
-
+  };
+  m_findLockedPrims.mergePathLists = [this](std::vector<SdfPathVector>& pathLists) {
+    // prims without a lock tag inherit the state of their parent, so only the tagged prims need to be recorded
+    m_metadataIndex.resetAuthoredFlag(PrimMetadataIndex::kLockTransform, pathLists[FindLockedPrimsLogic::kLockTransform]);
+    m_metadataIndex.resetAuthoredFlag(PrimMetadataIndex::kLockUnlocked, pathLists[FindLockedPrimsLogic::kLockUnlocked]);
   };
   m_findLockedPrims.postIteration = [this]() {
     constructLockPrims();
@@ -779,6 +840,7 @@ MStatus ProxyShape::initialise()
     m_displayGuides = addBoolAttr("displayGuides", "dg", false, kCached | kKeyable | kWritable | kAffectsAppearance | kStorable);
     m_displayRenderGuides = addBoolAttr("displayRenderGuides", "drg", false, kCached | kKeyable | kWritable | kAffectsAppearance | kStorable);
     m_unloaded = addBoolAttr("unloaded", "ul", false, kCached | kKeyable | kWritable | kAffectsAppearance | kStorable);
+    m_loadAsync = addBoolAttr("loadAsync", "la", false, kCached | kReadable | kWritable | kStorable);
     m_serializedTrCtx = addStringAttr("serializedTrCtx", "srtc", kReadable|kWritable|kStorable|kHidden);
 
     addFrame("USD Timing Information");
@@ -911,7 +973,9 @@ void ProxyShape::onPrimResync(SdfPath primPath, SdfPathVector& previousPrims)
   proxyTransformPath.pop();
 
   // find the new set of prims
+  AL_BEGIN_PROFILE_SECTION(HuntForNativeNodes);
   UsdPrimVector newPrimSet = huntForNativeNodesUnderPrim(proxyTransformPath, primPath, translatorManufacture());
+  AL_END_PROFILE_SECTION();
 
   // Remove prims that have disappeared and translate in new prims
   translatePrimsIntoMaya(newPrimSet, previousPrims);
@@ -1040,7 +1104,9 @@ void ProxyShape::onObjectsChanged(UsdNotice::ObjectsChanged const& notice, UsdSt
   {
     m_compositionHasChanged = false;
 
+    AL_BEGIN_PROFILE_SECTION(VariantSwitch);
     onPrimResync(m_changedPath, m_variantSwitchedPrims);
+    AL_END_PROFILE_SECTION();
     m_variantSwitchedPrims.clear();
     m_changedPath = SdfPath();
 
@@ -1049,95 +1115,32 @@ void ProxyShape::onObjectsChanged(UsdNotice::ObjectsChanged const& notice, UsdSt
     AL::usdmaya::Profiler::printReport(strstr);
   }
 
-  SdfPathVector newUnselectables;
-  SdfPathVector removeUnselectables;
-  auto recordSelectablePrims = [&newUnselectables, &removeUnselectables, this](const UsdPrim& prim){
-    if(!prim.IsValid())
-    {
-      return;
-    }
-
-    TfToken unselectablePropertyValue;
-    if(prim.GetMetadata(Metadata::selectability, &unselectablePropertyValue))
-    {
-      //Check if this prim is unselectable
-      if(unselectablePropertyValue == Metadata::unselectable)
-      {
-        newUnselectables.push_back(prim.GetPath());
-      }
-      else if(m_selectabilityDB.isPathUnselectable(prim.GetPath()) && unselectablePropertyValue != Metadata::unselectable)
-      {
-        removeUnselectables.push_back(prim.GetPath());
-      }
-    }
-  };
-
-  SdfPathSet lockTransformPrims;
-  SdfPathSet lockInheritedPrims;
-  SdfPathSet unlockedPrims;
-  auto recordPrimsLockStatus = [&lockTransformPrims, &lockInheritedPrims, &unlockedPrims](const UsdPrim& prim) {
-    if (!prim.IsValid())
-    {
-      return;
-    }
-    TfToken lockPropertyValue;
-    if (prim.GetMetadata(Metadata::locked, &lockPropertyValue))
-    {
-      if (lockPropertyValue == Metadata::lockTransform)
-      {
-        lockTransformPrims.insert(prim.GetPath());
-      }
-      else if (lockPropertyValue == Metadata::lockInherited)
-      {
-        lockInheritedPrims.insert(prim.GetPath());
-      }
-      else if (lockPropertyValue == Metadata::lockUnlocked)
-      {
-        unlockedPrims.insert(prim.GetPath());
-      }
-    }
-    else
-    {
-      lockInheritedPrims.insert(prim.GetPath());
-    }
-  };
-
   const UsdNotice::ObjectsChanged::PathRange resyncedPaths = notice.GetResyncedPaths();
   for(const SdfPath& path : resyncedPaths)
   {
-    UsdPrim newPrim = m_stage->GetPrimAtPath(path);
-    recordSelectablePrims(newPrim);
-    recordPrimsLockStatus(newPrim);
+    m_boundingBoxCache.invalidate(path);
   }
 
   const UsdNotice::ObjectsChanged::PathRange changedInfoOnlyPaths = notice.GetChangedInfoOnlyPaths();
   for(const SdfPath& path : changedInfoOnlyPaths)
   {
-    UsdPrim changedPrim;
-    if(path.IsPropertyPath())
-    {
-      changedPrim = m_stage->GetPrimAtPath(path.GetParentPath());
-    }
-    else
-    {
-      changedPrim = m_stage->GetPrimAtPath(path);
-    }
-    recordSelectablePrims(changedPrim);
-    recordPrimsLockStatus(changedPrim);
+    m_boundingBoxCache.invalidate(path);
   }
 
-  if(!removeUnselectables.empty())
+  // only the prims within the resynced subtrees, and the prims whose info changed, are read again
+  const uint32_t changedFlags = m_metadataIndex.update(m_stage, resyncedPaths, changedInfoOnlyPaths);
+  if(changedFlags & PrimMetadataIndex::kUnselectable)
   {
-    m_selectabilityDB.removePathsAsUnselectable(removeUnselectables);
+    syncSelectabilityDB();
   }
 
-  if(!newUnselectables.empty())
+  // prims added beneath a locked prim inherit its lock, even if the lock itself has not changed
+  bool lockChanged = (changedFlags & PrimMetadataIndex::kLockFlags) != 0;
+  for(auto it = resyncedPaths.begin(); !lockChanged && it != resyncedPaths.end(); ++it)
   {
-    m_selectabilityDB.addPathsAsUnselectable(newUnselectables);
+    lockChanged = m_metadataIndex.isLocked(*it);
   }
-
-  bool lockChanged = updateLockPrims(lockTransformPrims, lockInheritedPrims, unlockedPrims);
-  if (lockChanged)
+  if(lockChanged)
   {
     constructLockPrims();
   }
@@ -1183,6 +1186,59 @@ void ProxyShape::validateTransforms()
   TF_DEBUG(ALUSDMAYA_EVALUATION).Msg("/validateTransforms\n");
 }
 
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  sorts paths (as recorded by a parallel traversal, in lexical order) back into the order in which a serial
+///         walk of the stage visits them, by comparing the indices of each path's ancestors amongst their siblings.
+///         The masters are not children of the pseudo root, so the prims within them follow all of the other prims,
+///         grouped by master.
+/// \param  stage the stage the paths belong to
+/// \param  paths the paths to sort
+//----------------------------------------------------------------------------------------------------------------------
+void sortIntoTraversalOrder(const UsdStageRefPtr& stage, SdfPathVector& paths)
+{
+  std::unordered_map<SdfPath, size_t, SdfPath::Hash> childIndices;
+  size_t nextMasterIndex = std::numeric_limits<size_t>::max() / 2;
+  auto childIndex = [&stage, &childIndices, &nextMasterIndex](const SdfPath& path)
+  {
+    auto it = childIndices.find(path);
+    if(it == childIndices.end())
+    {
+      // index all of the siblings at once
+      size_t index = 0;
+      for(const UsdPrim& child : stage->GetPrimAtPath(path.GetParentPath()).GetChildren())
+      {
+        childIndices.emplace(child.GetPath(), index++);
+      }
+      it = childIndices.find(path);
+      if(it == childIndices.end())
+      {
+        it = childIndices.emplace(path, nextMasterIndex++).first;
+      }
+    }
+    return it->second;
+  };
+
+  std::vector<std::pair<std::vector<size_t>, SdfPath>> keyed;
+  keyed.reserve(paths.size());
+  for(const SdfPath& path : paths)
+  {
+    std::vector<size_t> key;
+    for(const SdfPath& prefix : path.GetPrefixes())
+    {
+      key.push_back(childIndex(prefix));
+    }
+    keyed.emplace_back(std::move(key), path);
+  }
+  std::sort(keyed.begin(), keyed.end());
+
+  for(size_t i = 0; i < keyed.size(); ++i)
+  {
+    paths[i] = keyed[i].second;
+  }
+}
+} // anon
+
 //----------------------------------------------------------------------------------------------------------------------
 std::vector<UsdPrim> ProxyShape::huntForNativeNodesUnderPrim(
     const MDagPath& proxyTransformPath,
@@ -1191,24 +1247,111 @@ std::vector<UsdPrim> ProxyShape::huntForNativeNodesUnderPrim(
 {
   TF_DEBUG(ALUSDMAYA_EVALUATION).Msg("ProxyShape::huntForNativeNodesUnderPrim\n");
   std::vector<UsdPrim> prims;
-  fileio::SchemaPrimsUtils utils(manufacture);
+  if(!m_stage->GetPrimAtPath(startPath))
+  {
+    findExcludedGeometry();
+    return prims;
+  }
 
-  fileio::TransformIterator it(m_stage->GetPrimAtPath(startPath), proxyTransformPath);
-  for(; !it.done(); it.next())
+  // The excluded geometry is searched for in the same traversal. Since that traversal covers the whole stage, the
+  // schema prims are recorded for the prims beneath startPath, and for every master. Only the masters that can be
+  // reached from startPath are used.
+  enum PathList
+  {
+    kSchemaPrims,
+    kInstances,
+    kNumPathLists
+  };
+  const bool isAbsoluteRoot = startPath.IsAbsoluteRootPath();
+  fileio::SchemaPrimsUtils utils(manufacture);
+  HierarchyIterationLogic findSchemaPrims;
+  findSchemaPrims.numPathLists = kNumPathLists;
+  findSchemaPrims.parallelIteration = [&utils, &startPath, isAbsoluteRoot](const UsdPrim& prim, SdfPathVector* pathLists)
   {
-    UsdPrim prim = it.prim();
-    if(!prim.IsValid())
+    const SdfPath& path = prim.GetPath();
+    if(!isAbsoluteRoot && !path.HasPrefix(startPath) && !prim.IsInMaster())
     {
-      continue;
+      return;
     }
-
     fileio::translators::TranslatorRefPtr trans = utils.isSchemaPrim(prim);
     if(trans && trans->importableByDefault())
     {
-      prims.push_back(prim);
+      pathLists[kSchemaPrims].push_back(path);
     }
-  }
-  findExcludedGeometry();
+    if(!isAbsoluteRoot && prim.IsInstance())
+    {
+      pathLists[kInstances].push_back(path);
+    }
+  };
+  findSchemaPrims.mergePathLists = [this, &prims, &startPath, isAbsoluteRoot](std::vector<SdfPathVector>& pathLists)
+  {
+    // the path lists are sorted lexically, whereas the prims are returned in the order of a serial walk of the stage
+    const SdfPathVector& schemaPrims = pathLists[kSchemaPrims];
+    SdfPathVector found;
+    auto returnInTraversalOrder = [this, &prims, &found]()
+    {
+      sortIntoTraversalOrder(m_stage, found);
+      prims.reserve(found.size());
+      for(const SdfPath& path : found)
+      {
+        prims.push_back(m_stage->GetPrimAtPath(path));
+      }
+    };
+
+    if(isAbsoluteRoot)
+    {
+      found = schemaPrims;
+      returnInTraversalOrder();
+      return;
+    }
+
+    // find the masters of the instances beneath startPath, and then the masters of any instances within them
+    const SdfPathVector& instances = pathLists[kInstances];
+    SdfPathVector masters;
+    for(const SdfPath& path : instances)
+    {
+      if(path.HasPrefix(startPath))
+      {
+        masters.push_back(m_stage->GetPrimAtPath(path).GetMaster().GetPath());
+      }
+    }
+    SdfPathSet reachableMasters;
+    while(!masters.empty())
+    {
+      const SdfPath master = masters.back();
+      masters.pop_back();
+      if(!reachableMasters.insert(master).second)
+      {
+        continue;
+      }
+      for(auto it = std::lower_bound(instances.begin(), instances.end(), master);
+          it != instances.end() && it->HasPrefix(master); ++it)
+      {
+        masters.push_back(m_stage->GetPrimAtPath(*it).GetMaster().GetPath());
+      }
+    }
+
+    // the prims beneath startPath come first, followed by the prims in the masters
+    for(const SdfPath& path : schemaPrims)
+    {
+      if(path.HasPrefix(startPath))
+      {
+        found.push_back(path);
+      }
+    }
+    for(const SdfPath& master : reachableMasters)
+    {
+      for(auto it = std::lower_bound(schemaPrims.begin(), schemaPrims.end(), master);
+          it != schemaPrims.end() && it->HasPrefix(master); ++it)
+      {
+        found.push_back(*it);
+      }
+    }
+    returnInTraversalOrder();
+  };
+
+  const HierarchyIterationLogic* logics[] = { &findSchemaPrims, &m_findExcludedPrims };
+  proxy::traverseHierarchy(m_stage->GetPseudoRoot(), logics, 2);
   return prims;
 }
 
@@ -1266,13 +1409,8 @@ void ProxyShape::variantSelectionListener(SdfNotice::LayersDidChange const& noti
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void ProxyShape::loadStage()
+uint32_t ProxyShape::beginLoadStage(StageLoadRequest& request)
 {
-  TF_DEBUG(ALUSDMAYA_EVALUATION).Msg("ProxyShape::loadStage\n");
-
-  triggerEvent("PreStageLoaded");
-
-  AL_BEGIN_PROFILE_SECTION(LoadStage);
   MDataBlock dataBlock = forceCache();
   // in case there was already a stage in m_stage, check to see if it's edit target has been altered
   if (m_stage)
@@ -1280,6 +1418,11 @@ void ProxyShape::loadStage()
     trackEditTargetLayer();
   }
   m_stage = UsdStageRefPtr();
+  m_boundingBoxCache.clear();
+
+  // any load still running in the background is now stale, and its result will be discarded
+  const uint32_t loadId = ++m_stageLoadId;
+  m_stageLoading = false;
 
   // Get input attr values
   const MString file = inputStringValue(dataBlock, m_filePath);
@@ -1287,7 +1430,8 @@ void ProxyShape::loadStage()
   const MString serializedArCtx = inputStringValue(dataBlock, m_serializedArCtx);
 
   const MString populationMaskIncludePaths = inputStringValue(dataBlock, m_populationMaskIncludePaths);
-  UsdStagePopulationMask mask = constructStagePopulationMask(populationMaskIncludePaths);
+  request.m_file = file;
+  request.m_mask = constructStagePopulationMask(populationMaskIncludePaths);
 
   // TODO initialise the context using the serialised attribute
 
@@ -1313,99 +1457,343 @@ void ProxyShape::loadStage()
   {
     fileString.assign(file.asChar(), file.length());
   }
+  request.m_fileString = fileString;
 
   TF_DEBUG(ALUSDMAYA_TRANSLATORS).Msg("ProxyShape::loadStage called for the usd file: %s\n", fileString.c_str());
 
-  // Only try to create a stage for layers that can be opened.
-  if (SdfLayerRefPtr rootLayer = SdfLayer::FindOrOpen(fileString))
-  {
-    MStatus status;
-    SdfLayerRefPtr sessionLayer;
-
-    AL_BEGIN_PROFILE_SECTION(OpeningUsdStage);
-      AL_BEGIN_PROFILE_SECTION(OpeningSessionLayer);
+  // The session layer and the asset resolver config are gathered here, since they need the layer manager node and
+  // the maya attributes. Everything after that (opening the root layer and composing the stage) only talks to USD.
+  AL_BEGIN_PROFILE_SECTION(OpeningSessionLayer);
+    {
+      // Grab the session layer from the layer manager
+      if(sessionLayerName.length() > 0)
+      {
+        auto layerManager = LayerManager::findManager();
+        if(layerManager)
         {
-          // Grab the session layer from the layer manager
-          if(sessionLayerName.length() > 0)
+          request.m_sessionLayer = layerManager->findLayer(AL::maya::utils::convert(sessionLayerName));
+          if(!request.m_sessionLayer)
           {
-            auto layerManager = LayerManager::findManager();
-            if(layerManager)
-            {
-              sessionLayer = layerManager->findLayer(AL::maya::utils::convert(sessionLayerName));
-              if(!sessionLayer)
-              {
-                MGlobal::displayError(MString("ProxyShape \"") + name() + "\" had a serialized session layer"
-                    " named \"" + sessionLayerName + "\", but no matching layer could be found in the layerManager");
-              }
-            }
-            else
-            {
-              MGlobal::displayError(MString("ProxyShape \"") + name() + "\" had a serialized session layer,"
-                  " but no layerManager node was found");
-            }
+            MGlobal::displayError(MString("ProxyShape \"") + name() + "\" had a serialized session layer"
+                " named \"" + sessionLayerName + "\", but no matching layer could be found in the layerManager");
           }
+        }
+        else
+        {
+          MGlobal::displayError(MString("ProxyShape \"") + name() + "\" had a serialized session layer,"
+              " but no layerManager node was found");
+        }
+      }
 
-          // If we still have no sessionLayer, but there's data in serializedSessionLayer, then
-          // assume we're reading an "old" file, and read it for backwards compatibility.
-          if(!sessionLayer)
-          {
-            const MString serializedSessionLayer = inputStringValue(dataBlock, m_serializedSessionLayer);
-            if(serializedSessionLayer.length() != 0)
-            {
-              sessionLayer = SdfLayer::CreateAnonymous();
-              sessionLayer->ImportFromString(AL::maya::utils::convert(serializedSessionLayer));
-            }
-          }
+      // If we still have no sessionLayer, but there's data in serializedSessionLayer, then
+      // assume we're reading an "old" file, and read it for backwards compatibility.
+      if(!request.m_sessionLayer)
+      {
+        const MString serializedSessionLayer = inputStringValue(dataBlock, m_serializedSessionLayer);
+        if(serializedSessionLayer.length() != 0)
+        {
+          request.m_sessionLayer = SdfLayer::CreateAnonymous();
+          request.m_sessionLayer->ImportFromString(AL::maya::utils::convert(serializedSessionLayer));
         }
-      AL_END_PROFILE_SECTION();
+      }
+    }
+  AL_END_PROFILE_SECTION();
+
+  // Initialise the asset resolver with the resolverConfig string if there is one, otherwise with the filepath
+  const MString assetResolverConfig = inputStringValue(dataBlock, m_assetResolverConfig);
+  request.m_resolverConfig = assetResolverConfig.length() ? assetResolverConfig.asChar() : fileString;
 
-      AL_BEGIN_PROFILE_SECTION(OpenRootLayer);
+  // Configuring the resolver changes global state, which another load (running in the background) may change before
+  // this stage has been composed. So the stage is opened with its own context for the config instead.
+  request.m_resolverContext = PXR_NS::ArGetResolver().CreateDefaultContextForAsset(request.m_resolverConfig);
 
-      const MString assetResolverConfig = inputStringValue(dataBlock, m_assetResolverConfig);
+  request.m_loadOperation = inputBoolValue(dataBlock, m_unloaded) ? UsdStage::LoadNone : UsdStage::LoadAll;
 
-      if (assetResolverConfig.length()==0)
+  // Without an interactive session there is no idle loop to hand the stage back to the main thread, and whilst a
+  // file is being read, the stage must be ready by the time postFileRead runs.
+  request.m_loadAsync = inputBoolValue(dataBlock, m_loadAsync) &&
+                        (MGlobal::kInteractive == MGlobal::mayaState() || g_asyncStageLoadsInBatchMode) &&
+                        !MFileIO::isReadingFile();
+  return loadId;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+UsdStageRefPtr ProxyShape::openStage(const StageLoadRequest& request)
+{
+  UsdStageRefPtr stage;
+  ArResolverContextBinder binder(request.m_resolverContext);
+
+  // Only try to create a stage for layers that can be opened.
+  AL_BEGIN_PROFILE_SECTION(OpenRootLayer);
+  SdfLayerRefPtr rootLayer = SdfLayer::FindOrOpen(request.m_fileString);
+  AL_END_PROFILE_SECTION();
+  if(!rootLayer)
+  {
+    return stage;
+  }
+
+  AL_BEGIN_PROFILE_SECTION(UsdStageOpen);
+  {
+    UsdStageCacheContext ctx(StageCache::Get());
+
+    if (request.m_sessionLayer)
+    {
+      TF_DEBUG(ALUSDMAYA_TRANSLATORS).Msg("ProxyShape::loadStage is called with extra session layer.\n");
+      stage = UsdStage::OpenMasked(rootLayer, request.m_sessionLayer, request.m_resolverContext, request.m_mask,
+                                   request.m_loadOperation);
+    }
+    else
+    {
+      TF_DEBUG(ALUSDMAYA_TRANSLATORS).Msg("ProxyShape::loadStage is called without any session layer.\n");
+      stage = UsdStage::OpenMasked(rootLayer, request.m_resolverContext, request.m_mask, request.m_loadOperation);
+    }
+
+    // Expand the mask, since we do not really want to mask the possible relation targets.
+    if(stage)
+    {
+      stage->ExpandPopulationMask();
+    }
+  }
+  AL_END_PROFILE_SECTION();
+
+  return stage;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::loadStage()
+{
+  TF_DEBUG(ALUSDMAYA_EVALUATION).Msg("ProxyShape::loadStage\n");
+
+  triggerEvent("PreStageLoaded");
+
+  AL_BEGIN_PROFILE_SECTION(LoadStage);
+  StageLoadRequest request;
+  const uint32_t loadId = beginLoadStage(request);
+
+  if(request.m_loadAsync)
+  {
+    AL_END_PROFILE_SECTION();
+
+    TF_DEBUG(ALUSDMAYA_TRANSLATORS).Msg("ProxyShape::loadStage opening the stage in the background\n");
+    m_stageLoading = true;
+    stageDataDirtyPlug().setValue(true);
+    AsyncStageLoads::get().start(this, request, loadId);
+    return;
+  }
+
+  AL_BEGIN_PROFILE_SECTION(ConfigureResolver);
+  PXR_NS::ArGetResolver().ConfigureResolverForAsset(request.m_resolverConfig);
+  AL_END_PROFILE_SECTION();
+
+  UsdStageRefPtr stage = openStage(request);
+  AL_END_PROFILE_SECTION();
+  finishLoadStage(stage, request.m_file, request.m_fileString);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::loadStages(const std::vector<ProxyShape*>& proxies)
+{
+  TF_DEBUG(ALUSDMAYA_EVALUATION).Msg("ProxyShape::loadStages loading %zu stages\n", proxies.size());
+
+  AL_BEGIN_PROFILE_SECTION(LoadStages);
+  std::vector<StageLoadRequest> requests(proxies.size());
+  std::vector<std::string> names(proxies.size());
+  AL_BEGIN_PROFILE_SECTION(PrepareStageLoads);
+  for(size_t i = 0; i < proxies.size(); ++i)
+  {
+    proxies[i]->triggerEvent("PreStageLoaded");
+    proxies[i]->beginLoadStage(requests[i]);
+    names[i] = proxies[i]->name().asChar();
+  }
+  AL_END_PROFILE_SECTION();
+
+  // Opening the root layers and composing the stages only talks to USD, so all of the stages are opened at once. Each
+  // stage is composed with the resolver context of its own proxy, so the global resolver config is left alone.
+  std::vector<UsdStageRefPtr> stages(proxies.size());
+  AL_BEGIN_PROFILE_SECTION(OpenStages);
+  WorkParallelForN(requests.size(), [&requests, &names, &stages](const size_t begin, const size_t end)
+    {
+      for(size_t i = begin; i < end; ++i)
       {
-        // Initialise the asset resolver with the filepath
-        PXR_NS::ArGetResolver().ConfigureResolverForAsset(fileString);
+        AL_BEGIN_NAMED_PROFILE_SECTION("OpenStage: " + names[i]);
+        stages[i] = openStage(requests[i]);
+        AL_END_PROFILE_SECTION();
       }
-      else
+    }, 1);
+  AL_END_PROFILE_SECTION();
+
+  // leave the resolver configured as it would have been had the stages been loaded one after another
+  if(!requests.empty())
+  {
+    PXR_NS::ArGetResolver().ConfigureResolverForAsset(requests.back().m_resolverConfig);
+  }
+
+  AL_BEGIN_PROFILE_SECTION(FinishStageLoads);
+  for(size_t i = 0; i < proxies.size(); ++i)
+  {
+    AL_BEGIN_NAMED_PROFILE_SECTION("FinishStage: " + names[i]);
+    proxies[i]->finishLoadStage(stages[i], requests[i].m_file, requests[i].m_fileString, false);
+    AL_END_PROFILE_SECTION();
+  }
+  AL_END_PROFILE_SECTION();
+  AL_END_PROFILE_SECTION();
+
+  if(MGlobal::kInteractive == MGlobal::mayaState())
+  {
+    std::stringstream strstr;
+    strstr << "Breakdown for " << proxies.size() << " proxy shapes" << std::endl;
+    AL::usdmaya::Profiler::printReport(strstr);
+    MGlobal::displayInfo(AL::maya::utils::convert(strstr.str()));
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::AsyncStageLoads::start(ProxyShape* proxy, const StageLoadRequest& request, const uint32_t loadId)
+{
+  // The background thread only opens the stage, and does not touch any maya objects. The proxy is found again through
+  // its handle, since the node may have been deleted (or asked to load another stage) by the time the stage is ready.
+  Load* load = new Load;
+  load->m_handle = MObjectHandle(proxy->thisMObject());
+  load->m_loadId = loadId;
+  load->m_file = request.m_file;
+  load->m_fileString = request.m_fileString;
+  load->m_resolverConfig = request.m_resolverConfig;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_loads.emplace_back(load);
+  }
+
+  if(!m_idleCallback)
+  {
+    m_idleCallback = MEventMessage::addEventCallback("idle", onIdle, this);
+  }
+
+  load->m_thread = std::thread([this, request, load]()
+    {
+      UsdStageRefPtr stage = openStage(request);
+      std::lock_guard<std::mutex> lock(m_mutex);
+      load->m_stage = stage;
+      load->m_finished = true;
+    });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+ProxyShape::AsyncStageLoads::Loads ProxyShape::AsyncStageLoads::takeFinished(const bool wait)
+{
+  if(wait)
+  {
+    std::vector<Load*> running;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for(auto& load : m_loads)
       {
-        // Initialise the asset resolver with the resolverConfig string
-        PXR_NS::ArGetResolver().ConfigureResolverForAsset(assetResolverConfig.asChar());
+        running.push_back(load.get());
       }
-      AL_END_PROFILE_SECTION();
+    }
+    for(Load* load : running)
+    {
+      load->m_thread.join();
+    }
+  }
 
-      AL_BEGIN_PROFILE_SECTION(UsdStageOpen);
-      {
-        UsdStageCacheContext ctx(StageCache::Get());
+  Loads finished;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::stable_partition(m_loads.begin(), m_loads.end(),
+        [](const std::unique_ptr<Load>& load) { return !load->m_finished; });
+    std::move(it, m_loads.end(), std::back_inserter(finished));
+    m_loads.erase(it, m_loads.end());
+    if(m_loads.empty() && m_idleCallback)
+    {
+      MMessage::removeCallback(m_idleCallback);
+      m_idleCallback = 0;
+    }
+  }
 
-        bool unloadedFlag = inputBoolValue(dataBlock, m_unloaded);
-        UsdStage::InitialLoadSet loadOperation = unloadedFlag ? UsdStage::LoadNone : UsdStage::LoadAll;
+  // the threads of the finished loads have nothing left to do but exit
+  for(auto& load : finished)
+  {
+    if(load->m_thread.joinable())
+    {
+      load->m_thread.join();
+    }
+  }
+  return finished;
+}
 
-        if (sessionLayer)
-        {
-          TF_DEBUG(ALUSDMAYA_TRANSLATORS).Msg("ProxyShape::loadStage is called with extra session layer.\n");
-          m_stage = UsdStage::OpenMasked(rootLayer, sessionLayer, mask, loadOperation);
-        }
-        else
-        {
-          TF_DEBUG(ALUSDMAYA_TRANSLATORS).Msg("ProxyShape::loadStage is called without any session layer.\n");
-          m_stage = UsdStage::OpenMasked(rootLayer, mask, loadOperation);
-        }
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::AsyncStageLoads::onIdle(void* clientData)
+{
+  for(auto& load : static_cast<AsyncStageLoads*>(clientData)->takeFinished(false))
+  {
+    finish(*load);
+  }
+}
 
-        // Expand the mask, since we do not really want to mask the possible relation targets.
-        m_stage->ExpandPopulationMask();
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::AsyncStageLoads::finish(Load& load)
+{
+  if(!load.m_handle.isValid())
+  {
+    return;
+  }
+  MFnDependencyNode fn(load.m_handle.object());
+  ProxyShape* proxy = static_cast<ProxyShape*>(fn.userNode());
+  if(!proxy || proxy->m_stageLoadId != load.m_loadId)
+  {
+    TF_DEBUG(ALUSDMAYA_TRANSLATORS).Msg("ProxyShape::AsyncStageLoads discarding a stale stage for %s\n",
+        load.m_fileString.c_str());
+    return;
+  }
 
-        UsdStageCache::Id stageId = StageCache::Get().Insert(m_stage);
-        outputInt32Value(dataBlock, m_stageCacheId, stageId.ToLongInt());
+  // leave the resolver configured as it would have been had the stage been loaded synchronously
+  PXR_NS::ArGetResolver().ConfigureResolverForAsset(load.m_resolverConfig);
 
-        // Set the edit target to the session layer so any user interaction will wind up there
-        m_stage->SetEditTarget(m_stage->GetSessionLayer());
-        // Save the initial edit target
-        trackEditTargetLayer();
-      }
-      AL_END_PROFILE_SECTION();
-    AL_END_PROFILE_SECTION();
+  proxy->m_stageLoading = false;
+  proxy->finishLoadStage(load.m_stage, load.m_file, load.m_fileString);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::waitForAsyncStageLoads()
+{
+  for(auto& load : AsyncStageLoads::get().takeFinished(true))
+  {
+    AsyncStageLoads::finish(*load);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::cancelAsyncStageLoads()
+{
+  AsyncStageLoads::get().takeFinished(true);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::enableAsyncStageLoadsInBatchMode(const bool enable)
+{
+  g_asyncStageLoadsInBatchMode = enable;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::finishLoadStage(
+    UsdStageRefPtr stage,
+    const MString& file,
+    const std::string& fileString,
+    const bool printTimings)
+{
+  AL_BEGIN_PROFILE_SECTION(FinishLoadStage);
+  MDataBlock dataBlock = forceCache();
+  m_stage = stage;
+
+  if(m_stage)
+  {
+    UsdStageCache::Id stageId = StageCache::Get().Insert(m_stage);
+    outputInt32Value(dataBlock, m_stageCacheId, stageId.ToLongInt());
+
+    // Set the edit target to the session layer so any user interaction will wind up there
+    m_stage->SetEditTarget(m_stage->GetSessionLayer());
+    // Save the initial edit target
+    trackEditTargetLayer();
   }
   else
   if(!fileString.empty())
@@ -1418,7 +1806,7 @@ void ProxyShape::loadStage()
   // If no primPath string specified, then use the pseudo-root.
   const SdfPath rootPath(std::string("/"));
   MString primPathStr = inputStringValue(dataBlock, m_primPath);
-  if (primPathStr.length())
+  if (primPathStr.length() && m_stage)
   {
     m_path = SdfPath(AL::maya::utils::convert(primPathStr));
     UsdPrim prim = m_stage->GetPrimAtPath(m_path);
@@ -1443,7 +1831,7 @@ void ProxyShape::loadStage()
 
   AL_END_PROFILE_SECTION();
 
-  if(MGlobal::kInteractive == MGlobal::mayaState())
+  if(printTimings && MGlobal::kInteractive == MGlobal::mayaState())
   {
     std::stringstream strstr;
     strstr << "Breakdown for file: " << file << std::endl;
@@ -1454,35 +1842,40 @@ void ProxyShape::loadStage()
   stageDataDirtyPlug().setValue(true);
 
   triggerEvent("PostStageLoaded");
+  if(m_stage)
+  {
+    triggerEvent("StageLoaded");
+  }
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-bool ProxyShape::updateLockPrims(const SdfPathSet& lockTransformPrims, const SdfPathSet& lockInheritedPrims,
-                                 const SdfPathSet& unlockedPrims)
+MBoundingBox ProxyShape::placeholderBound()
 {
-  bool lockChanged = false;
-  for (auto lock : lockTransformPrims)
-  {
-    auto inserted = m_lockTransformPrims.insert(lock);
-    lockChanged = lockChanged || inserted.second;
-    auto erased = m_lockInheritedPrims.erase(lock);
-    lockChanged = lockChanged || erased;
-  }
-  for (auto inherited : lockInheritedPrims)
+  return MBoundingBox(MPoint(-0.5, -0.5, -0.5), MPoint(0.5, 0.5, 0.5));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::syncSelectabilityDB()
+{
+  const SdfPathVector unselectablePaths = m_metadataIndex.pathsWithAuthoredFlag(PrimMetadataIndex::kUnselectable);
+  const SdfPathVector& currentPaths = m_selectabilityDB.getUnselectablePaths();
+
+  SdfPathVector removeUnselectables;
+  std::set_difference(currentPaths.begin(), currentPaths.end(), unselectablePaths.begin(), unselectablePaths.end(),
+                      std::back_inserter(removeUnselectables));
+  SdfPathVector newUnselectables;
+  std::set_difference(unselectablePaths.begin(), unselectablePaths.end(), currentPaths.begin(), currentPaths.end(),
+                      std::back_inserter(newUnselectables));
+
+  if(!removeUnselectables.empty())
   {
-    auto erased = m_lockTransformPrims.erase(inherited);
-    lockChanged = lockChanged || erased;
-    auto inserted = m_lockInheritedPrims.insert(inherited);
-    lockChanged = lockChanged || inserted.second;
+    m_selectabilityDB.removePathsAsUnselectable(removeUnselectables);
   }
-  for (auto unlocked : unlockedPrims)
+
+  if(!newUnselectables.empty())
   {
-    auto erased = m_lockTransformPrims.erase(unlocked);
-    lockChanged = lockChanged || erased;
-    erased = m_lockInheritedPrims.erase(unlocked);
-    lockChanged = lockChanged || erased;
+    m_selectabilityDB.addPathsAsUnselectable(newUnselectables);
   }
-  return lockChanged;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -1561,19 +1954,30 @@ bool ProxyShape::lockTransformAttribute(const SdfPath& path, const bool lock)
 void ProxyShape::constructLockPrims()
 {
   TF_DEBUG(ALUSDMAYA_EVALUATION).Msg("ProxyShape::constructLockPrims\n");
-  SdfPathSet primsNeedLock = m_lockTransformPrims;
+  SdfPathSet primsNeedLock;
 
-  // add inherited lock prims if their parents are already in.
-  for (auto inherited : m_lockInheritedPrims)
+  // walk the subtree of each locked prim, stopping at any unlocked descendants. A locked prim that has already been
+  // visited lies within the subtree of another locked prim.
+  if(m_stage)
   {
-    const SdfPath parentPath = inherited.GetParentPath();
-    if (parentPath.IsEmpty())
-      continue;
-    auto parentIter = primsNeedLock.find(parentPath);
-    if (parentIter != primsNeedLock.end())
+    for (const SdfPath& lockPath : m_metadataIndex.pathsWithAuthoredFlag(PrimMetadataIndex::kLockTransform))
     {
-      auto lowerIter = std::lower_bound(parentIter, primsNeedLock.end(), inherited);
-      primsNeedLock.insert(lowerIter, inherited);
+      if (primsNeedLock.count(lockPath))
+        continue;
+      UsdPrim lockPrim = m_stage->GetPrimAtPath(lockPath);
+      if (!lockPrim)
+        continue;
+      UsdPrimRange range(lockPrim);
+      for (auto it = range.begin(); it != range.end(); ++it)
+      {
+        const SdfPath& path = it->GetPath();
+        if (m_metadataIndex.authoredFlags(path) & PrimMetadataIndex::kLockUnlocked)
+        {
+          it.PruneChildren();
+          continue;
+        }
+        primsNeedLock.insert(path);
+      }
     }
   }
 
@@ -1688,25 +2092,6 @@ void ProxyShape::postConstructor()
   addAttributeChangedCallback();
 }
 
-//----------------------------------------------------------------------------------------------------------------------
-bool ProxyShape::primHasExcludedParent(UsdPrim prim)
-{
-  TF_DEBUG(ALUSDMAYA_EVALUATION).Msg("ProxyShape::primHasExcludedParent\n");
-  if(prim.IsValid())
-  {
-    SdfPath primPath = prim.GetPrimPath();
-    TF_FOR_ALL(excludedPath, m_excludedTaggedGeometry)
-    {
-      if (primPath.HasPrefix(*excludedPath))
-      {
-        return true;
-      }
-    }
-  }
-
-  return false;
-}
-
 //----------------------------------------------------------------------------------------------------------------------
 MString ProxyShape::recordUsdPrimToMayaPath(const UsdPrim &usdPrim,
                                             const MObject &mayaObject){
@@ -1750,28 +2135,9 @@ void ProxyShape::findTaggedPrims(const HierarchyIterationLogics& iterationLogics
   if(!m_stage)
     return;
 
-  for(auto hl : iterationLogics)
-  {
-    hl->preIteration();
-  }
-
-  MDagPath m_parentPath;
-  for(fileio::TransformIterator it(m_stage, m_parentPath); !it.done(); it.next())
-  {
-    const UsdPrim& prim = it.prim();
-    if(!prim.IsValid())
-      continue;
-
-    for(auto hl : iterationLogics)
-    {
-      hl->iteration(it, prim);
-    }
-  }
-
-  for(auto hl : iterationLogics)
-  {
-    hl->postIteration();
-  }
+  AL_BEGIN_PROFILE_SECTION(FindTaggedPrims);
+  proxy::traverseHierarchy(m_stage->GetPseudoRoot(), iterationLogics, sizeof(iterationLogics) / sizeof(iterationLogics[0]));
+  AL_END_PROFILE_SECTION();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -1781,18 +2147,8 @@ void ProxyShape::findExcludedGeometry()
   if(!m_stage)
     return;
 
-  m_findExcludedPrims.preIteration();
-  MDagPath m_parentPath;
-
-  for(fileio::TransformIterator it(m_stage, m_parentPath); !it.done(); it.next())
-  {
-    const UsdPrim& prim = it.prim();
-    if(!prim.IsValid())
-      continue;
-    m_findExcludedPrims.iteration(it, prim);
-  }
-
-  m_findExcludedPrims.postIteration();
+  const HierarchyIterationLogic* logics[] = { &m_findExcludedPrims };
+  proxy::traverseHierarchy(m_stage->GetPseudoRoot(), logics, 1);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -1802,19 +2158,8 @@ void ProxyShape::findSelectablePrims()
   if(!m_stage)
     return;
 
-  m_findUnselectablePrims.preIteration();
-
-  MDagPath m_parentPath;
-  for(fileio::TransformIterator it(m_stage, m_parentPath); !it.done(); it.next())
-  {
-    const UsdPrim& prim = it.prim();
-    if(!prim.IsValid())
-      continue;
-
-    m_findUnselectablePrims.iteration(it, prim);
-  }
-
-  m_findUnselectablePrims.postIteration();
+  const HierarchyIterationLogic* logics[] = { &m_findUnselectablePrims };
+  proxy::traverseHierarchy(m_stage->GetPseudoRoot(), logics, 1);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -1828,8 +2173,8 @@ MStatus ProxyShape::computeOutStageData(const MPlug& plug, MDataBlock& dataBlock
     return MS::kFailure;
   }
 
-  // make sure a stage is loaded
-  if (!m_stage)
+  // make sure a stage is loaded (unless it is already being loaded in the background)
+  if (!m_stage && !m_stageLoading)
   {
     loadStage();
   }
@@ -1928,86 +2273,38 @@ MBoundingBox ProxyShape::boundingBox() const
   (void)outDataHandle;
   CHECK_MSTATUS_AND_RETURN(status, MBoundingBox() );
 
-  // XXX:aluk
-  // If we could cheaply determine whether a stage only has static geometry,
-  // we could make this value a constant one for that case, avoiding the
-  // memory overhead of a cache entry per frame
   UsdTimeCode currTime = UsdTimeCode(inputDoubleValue(dataBlock, m_outTime));
 
-  // RB: There must be a nicer way of doing this that avoids the map?
-  // The time codes are likely to be ranged, so an ordered array + binary search would surely work?
-  std::map<UsdTimeCode, MBoundingBox>::const_iterator cacheLookup = m_boundingBoxCache.find(currTime);
-  if (cacheLookup != m_boundingBoxCache.end())
+  UsdPrim prim = getUsdPrim(dataBlock);
+  if (!prim)
   {
-    return cacheLookup->second;
+    return m_stageLoading ? placeholderBound() : MBoundingBox();
   }
 
-  GfBBox3d allBox;
-  UsdPrim prim = getUsdPrim(dataBlock);
-  if (prim)
+  TfTokenVector purposes { UsdGeomTokens->default_, UsdGeomTokens->proxy };
+  if (inputBoolValue(dataBlock, m_displayGuides))
   {
-    UsdGeomImageable imageablePrim(prim);
-    bool showGuides = inputBoolValue(dataBlock, m_displayGuides);
-    bool showRenderGuides = inputBoolValue(dataBlock, m_displayRenderGuides);
-    if (showGuides && showRenderGuides)
-    {
-      allBox = imageablePrim.ComputeUntransformedBound(
-            currTime,
-            UsdGeomTokens->default_,
-            UsdGeomTokens->proxy,
-            UsdGeomTokens->guide,
-            UsdGeomTokens->render);
-    }
-    else
-    if (showGuides && !showRenderGuides)
-    {
-      allBox = imageablePrim.ComputeUntransformedBound(
-            currTime,
-            UsdGeomTokens->default_,
-            UsdGeomTokens->proxy,
-            UsdGeomTokens->guide);
-    }
-    else if (!showGuides && showRenderGuides)
-    {
-      allBox = imageablePrim.ComputeUntransformedBound(
-            currTime,
-            UsdGeomTokens->default_,
-            UsdGeomTokens->proxy,
-            UsdGeomTokens->render);
-    }
-    else
-    {
-      allBox = imageablePrim.ComputeUntransformedBound(
-            currTime,
-            UsdGeomTokens->default_,
-            UsdGeomTokens->proxy);
-    }
+    purposes.push_back(UsdGeomTokens->guide);
   }
-  else
+  if (inputBoolValue(dataBlock, m_displayRenderGuides))
   {
-    return MBoundingBox();
+    purposes.push_back(UsdGeomTokens->render);
   }
 
-  // insert new cache entry
-  MBoundingBox& retval = m_boundingBoxCache[currTime];
+  // static subtrees share a single bound across all times, so this is only computed when something has changed
+  const GfRange3d boxRange = m_boundingBoxCache.bound(prim, currTime, purposes);
 
   // Convert to GfRange3d to MBoundingBox
-  GfRange3d boxRange = allBox.ComputeAlignedBox();
   if (!boxRange.IsEmpty())
   {
-    retval = MBoundingBox(MPoint(boxRange.GetMin()[0],
-                                 boxRange.GetMin()[1],
-                                 boxRange.GetMin()[2]),
-                          MPoint(boxRange.GetMax()[0],
-                                 boxRange.GetMax()[1],
-                                 boxRange.GetMax()[2]));
-  }
-  else
-  {
-    retval = MBoundingBox(MPoint(-100000.0f, -100000.0f, -100000.0f), MPoint(100000.0f, 100000.0f, 100000.0f));
+    return MBoundingBox(MPoint(boxRange.GetMin()[0],
+                               boxRange.GetMin()[1],
+                               boxRange.GetMin()[2]),
+                        MPoint(boxRange.GetMax()[0],
+                               boxRange.GetMax()[1],
+                               boxRange.GetMax()[2]));
   }
-
-  return retval;
+  return MBoundingBox(MPoint(-100000.0f, -100000.0f, -100000.0f), MPoint(100000.0f, 100000.0f, 100000.0f));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -2053,6 +2350,8 @@ MStatus ProxyShape::computeDrivenAttributes(const MPlug& plug, MDataBlock& dataB
 
   MArrayDataHandle drvTransArray = dataBlock.inputArrayValue(m_inDrivenTransformsData);
   uint32_t elemCnt = drvTransArray.elementCount();
+  std::vector<proxy::DrivenTransforms*> drivenBlocks;
+  drivenBlocks.reserve(elemCnt);
   for (uint32_t elemIdx = 0; elemIdx < elemCnt; ++elemIdx)
   {
     drvTransArray.jumpToArrayElement(elemIdx);
@@ -2065,11 +2364,23 @@ MStatus ProxyShape::computeDrivenAttributes(const MPlug& plug, MDataBlock& dataB
 
     if (!drivenTransforms.drivenPrimPaths().empty())
     {
-      if(!drivenTransforms.update(m_stage, currentTime))
+      // resolving the attributes may author new specs, so this has to happen outside of the change block
+      if(!drivenTransforms.prepare(m_stage))
       {
         MString command("failed to update driven prims on block: ");
         MGlobal::displayError(command + elemIdx);
       }
+      drivenBlocks.push_back(&drivenTransforms);
+    }
+  }
+
+  // write the values of all blocks at the layer level, so that only a single change notice is sent
+  if (!drivenBlocks.empty())
+  {
+    SdfChangeBlock changeBlock;
+    for (auto drivenTransforms : drivenBlocks)
+    {
+      drivenTransforms->write(currentTime);
     }
   }
   return dataBlock.setClean(plug);
@@ -2128,7 +2439,7 @@ void ProxyShape::deserialiseTransformRefs()
             const uint32_t selected = tstrs[3].asUnsigned();
             const uint32_t refCounts = tstrs[4].asUnsigned();
             SdfPath path(tstrs[1].asChar());
-            m_requiredPaths.emplace(path, TransformReference(node, ptr, required, selected, refCounts));
+            insertTransformReference(path, TransformReference(node, ptr, required, selected, refCounts));
           }
           else
           {
@@ -2136,7 +2447,7 @@ void ProxyShape::deserialiseTransformRefs()
             const uint32_t selected = tstrs[3].asUnsigned();
             const uint32_t refCounts = tstrs[4].asUnsigned();
             SdfPath path(tstrs[1].asChar());
-            m_requiredPaths.emplace(path, TransformReference(node, 0, required, selected, refCounts));
+            insertTransformReference(path, TransformReference(node, 0, required, selected, refCounts));
           }
         }
       }
@@ -2150,7 +2461,7 @@ void ProxyShape::deserialiseTransformRefs()
 
 //----------------------------------------------------------------------------------------------------------------------
 ProxyShape::TransformReference::TransformReference(MObject mayaNode, Transform* node, uint32_t r, uint32_t s, uint32_t rc)
-  : m_transform(node), m_node(mayaNode)
+  : m_transform(node), m_node(mayaNode), m_nodeHash(MObjectHandle(mayaNode).hashCode())
 {
   m_required = r;
   m_selected = s;
@@ -2164,7 +2475,7 @@ void ProxyShape::cleanupTransformRefs()
   {
     if(!it->second.selected() && !it->second.required() && !it->second.refCount())
     {
-      m_requiredPaths.erase(it++);
+      eraseTransformReference(it++);
     }
     else
     {
@@ -2180,6 +2491,7 @@ void ProxyShape::registerEvents()
   registerEvent("PostDestroyProxyShape", AL::event::kUSDMayaEventType);
   registerEvent("PreStageLoaded", AL::event::kUSDMayaEventType);
   registerEvent("PostStageLoaded", AL::event::kUSDMayaEventType);
+  registerEvent("StageLoaded", AL::event::kUSDMayaEventType);
   registerEvent("ConstructGLEngine", AL::event::kUSDMayaEventType);
   registerEvent("DestroyGLEngine", AL::event::kUSDMayaEventType);
   registerEvent("PreSelectionChanged", AL::event::kUSDMayaEventType);
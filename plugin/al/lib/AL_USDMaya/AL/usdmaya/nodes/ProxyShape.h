@@ -24,10 +24,12 @@
 #include "AL/event/EventHandler.h"
 #include "AL/maya/event/MayaEventManager.h"
 #include <AL/usdmaya/SelectabilityDB.h>
+#include "AL/usdmaya/PrimMetadataIndex.h"
 #include "AL/usdmaya/DrivenTransformsData.h"
 #include "AL/usdmaya/fileio/translators/TranslatorBase.h"
 #include "AL/usdmaya/fileio/translators/TranslatorContext.h"
 #include "AL/usdmaya/fileio/translators/TransformTranslator.h"
+#include "AL/usdmaya/nodes/proxy/BoundingBoxCache.h"
 #include "AL/usdmaya/nodes/proxy/PrimFilter.h"
 #include "maya/MPxSurfaceShape.h"
 #include "maya/MEventMessage.h"
@@ -47,6 +49,7 @@
 #include "pxr/usdImaging/usdImagingGL/renderParams.h"
 #include <stack>
 #include <functional>
+#include <unordered_map>
 #include "AL/usd/utils/ForwardDeclares.h"
 
 #if defined(WANT_UFE_BUILD)
@@ -206,7 +209,10 @@ struct  HierarchyIterationLogic
   HierarchyIterationLogic():
       preIteration(nullptr),
       iteration(nullptr),
-      postIteration(nullptr)
+      postIteration(nullptr),
+      numPathLists(0),
+      parallelIteration(nullptr),
+      mergePathLists(nullptr)
   {}
 
   /// \brief  provide a method to be called prior to iteration of the UsdStage hierarchy
@@ -217,17 +223,31 @@ struct  HierarchyIterationLogic
 
   /// \brief  provide a method to be called after iteration of the UsdStage hierarchy
   std::function<void()> postIteration;
+
+  /// \brief  the number of path lists that parallelIteration sorts prims into
+  uint32_t numPathLists;
+
+  /// \brief  if set, this is called instead of iteration, concurrently from worker threads. It must only read from the
+  ///         prim, and records what it finds by appending the path of the prim to some of the (numPathLists) path lists.
+  std::function<void(const UsdPrim& prim, SdfPathVector* pathLists)> parallelIteration;
+
+  /// \brief  called on the main thread once the hierarchy has been traversed (before postIteration), with the path
+  ///         lists filled in by parallelIteration. Each list is sorted, and contains no duplicates.
+  std::function<void(std::vector<SdfPathVector>& pathLists)> mergePathLists;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
-/// \brief  implements the logic that constructs a list of objects that need to be added or removed from the selectable
-///         list of prims within a UsdStage
+/// \brief  implements the logic that constructs the list of prims tagged as unselectable within a UsdStage
 //----------------------------------------------------------------------------------------------------------------------
 struct FindUnselectablePrimsLogic
   : public HierarchyIterationLogic
 {
-  SdfPathVector newUnselectables; ///< items that need to be made unselectable
-  SdfPathVector removeUnselectables; ///< items that are unselectable, but need to be made selectable
+  /// the path lists filled in by parallelIteration
+  enum PathList
+  {
+    kUnselectables, ///< prims that are tagged as unselectable
+    kNumPathLists
+  };
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -236,6 +256,13 @@ struct FindUnselectablePrimsLogic
 struct FindLockedPrimsLogic
   : public HierarchyIterationLogic
 {
+  /// the path lists filled in by parallelIteration
+  enum PathList
+  {
+    kLockTransform, ///< prims whose transforms are locked
+    kLockUnlocked, ///< prims that are unlocked, regardless of the lock state of their parent
+    kNumPathLists
+  };
 };
 
 typedef const HierarchyIterationLogic*  HierarchyIterationLogics[3];
@@ -342,6 +369,9 @@ public:
   /// Open the stage unloaded.
   AL_DECL_ATTRIBUTE(unloaded);
 
+  /// Open the stage on a background thread (only when maya is running interactively)
+  AL_DECL_ATTRIBUTE(loadAsync);
+
   /// an array of MPxData for the driven transforms
   AL_DECL_ATTRIBUTE(inDrivenTransformsData);
 
@@ -467,7 +497,8 @@ public:
   /// \param  proxyTransformPath the DAG path of the proxy shape
   /// \param  startPath the path from which iteration needs to start in the UsdStage
   /// \param  manufacture the translator registry
-  /// \return the array of prims found that will need to be imported
+  /// \return the array of prims found that will need to be imported, in the order in which a walk of the stage visits
+  ///         them (the prims beneath startPath, followed by the prims within the masters of any instances)
   AL_USDMAYA_PUBLIC
   std::vector<UsdPrim> huntForNativeNodesUnderPrim(
       const MDagPath& proxyTransformPath,
@@ -552,7 +583,7 @@ public:
 
   /// \brief  destroys all internal transform references
   void destroyTransformReferences()
-    { m_requiredPaths.clear(); }
+    { m_requiredPaths.clear(); m_requiredPathsByNode.clear(); }
 
   /// \brief  Internal method. Used to filter out a set of paths into groups that need to be created, deleted, or updating.
   /// \param  previousPrims the previous list of prims underneath a prim in the process of a variant change
@@ -593,22 +624,7 @@ public:
   /// \param  path the returned prim path (if the node is found)
   /// \return true if the maya node is currently selected
   AL_USDMAYA_PUBLIC
-  bool isSelectedMObject(MObject obj, SdfPath& path)
-  {
-    for(auto it : m_requiredPaths)
-    {
-      if(obj == it.second.node())
-      {
-        path = it.first;
-        if(m_selectedPaths.count(it.first) > 0)
-        {
-          return true;
-        }
-        break;
-      }
-    }
-    return false;
-  }
+  bool isSelectedMObject(MObject obj, SdfPath& path);
 
   //--------------------------------------------------------------------------------------------------------------------
   /// \name   Plug-in Translator node methods
@@ -640,6 +656,8 @@ public:
   AL_USDMAYA_PUBLIC
   void findTaggedPrims();
 
+  /// \brief runs the iteration logics over the whole stage, in a single (parallel) traversal. See
+  ///        proxy::traverseHierarchy
   AL_USDMAYA_PUBLIC
   void findTaggedPrims(const HierarchyIterationLogics& iterationLogics);
 
@@ -812,10 +830,48 @@ public:
   const AL::usdmaya::SelectabilityDB& selectabilityDB() const
     { return const_cast<ProxyShape*>(this)->selectabilityDB(); }
 
-  /// \brief  used to reload the stage after file open
+  /// \brief  used to reload the stage after file open. If the loadAsync attribute is set (and maya is running
+  ///         interactively), the root layer is opened and the stage is composed on a background thread. Until it is
+  ///         ready, the proxy has no stage, and reports a placeholder bound. Once it is ready, the maya nodes for the
+  ///         stage are created on the main thread, and the StageLoaded event is triggered.
   AL_USDMAYA_PUBLIC
   void loadStage();
 
+  /// \brief  loads the stages of several proxy shapes, e.g. all of the proxies in a file that has just been read. The
+  ///         maya attributes of every proxy are read first, then all of the root layers are opened and the stages are
+  ///         composed concurrently, and finally the maya side of each load is completed one proxy at a time. The time
+  ///         taken to open and finish each stage is reported by the profiler as "OpenStage: <name>" and
+  ///         "FinishStage: <name>".
+  /// \param  proxies the proxy shapes to load
+  AL_USDMAYA_PUBLIC
+  static void loadStages(const std::vector<ProxyShape*>& proxies);
+
+  /// \brief  returns true whilst a stage is being loaded on a background thread
+  inline bool isStageLoading() const
+    { return m_stageLoading; }
+
+  /// \brief  the bound reported whilst a stage is being loaded on a background thread
+  AL_USDMAYA_PUBLIC
+  static MBoundingBox placeholderBound();
+
+  /// \brief  blocks until every stage being loaded on a background thread has been opened, and then completes the
+  ///         loads that have not been superseded (or had their proxy deleted) on the calling thread, which must be the
+  ///         main thread. Otherwise the loads are completed when maya is next idle.
+  AL_USDMAYA_PUBLIC
+  static void waitForAsyncStageLoads();
+
+  /// \brief  blocks until every stage being loaded on a background thread has been opened, and discards them. This is
+  ///         called when the plugin is unloaded, so that no load outlives the plugin.
+  AL_USDMAYA_PUBLIC
+  static void cancelAsyncStageLoads();
+
+  /// \brief  stages are only loaded on a background thread when maya is running interactively, since batch mode has no
+  ///         idle loop in which to complete the load. This allows them to be loaded in the background in batch mode as
+  ///         well, in which case they are completed by waitForAsyncStageLoads. Intended for tests.
+  /// \param  enable true to load stages in the background in batch mode
+  AL_USDMAYA_PUBLIC
+  static void enableAsyncStageLoadsInBatchMode(bool enable);
+
   /// \brief  adds the attribute changed callback to the proxy shape
   AL_USDMAYA_PUBLIC
   void addAttributeChangedCallback();
@@ -878,8 +934,7 @@ private:
   void insertTransformRefs(const std::vector<std::pair<SdfPath, MObject>>& removedRefs, TransformReason reason);
 
   void constructExcludedPrims();
-  bool updateLockPrims(const SdfPathSet& lockTransformPrims, const SdfPathSet& lockInheritedPrims,
-                       const SdfPathSet& unlockedPrims);
+  void syncSelectabilityDB();
   bool lockTransformAttribute(const SdfPath& path, bool lock);
 
   MObject makeUsdTransformChain_internal(
@@ -924,6 +979,7 @@ private:
     TransformReference(MObject mayaNode, Transform* node, uint32_t r, uint32_t s, uint32_t rc);
     Transform* m_transform;
     MObject node() const { return m_node; }
+    uint32_t nodeHash() const { return m_nodeHash; }
 
     bool decRef(const TransformReason reason);
     void incRef(const TransformReason reason);
@@ -945,6 +1001,9 @@ private:
       { m_selectedTemp = m_selected; }
   private:
     MObject m_node;
+    // the MObjectHandle hash code of the node when the reference was made (the node may since have been deleted, in
+    // which case the handle would hash to zero)
+    uint32_t m_nodeHash;
     // ref counting values
     struct
     {
@@ -962,6 +1021,18 @@ private:
   typedef std::map<SdfPath, TransformReference>  TransformReferenceMap;
   TransformReferenceMap m_requiredPaths;
 
+  /// a reverse lookup from the hash code of the maya node to the path(s) in m_requiredPaths that reference it, so that
+  /// the maya selection can be mapped back to prim paths without searching all of the transform references. This must
+  /// only be modified via insertTransformReference and eraseTransformReference.
+  typedef std::unordered_multimap<uint32_t, SdfPath> TransformReferenceIndex;
+  TransformReferenceIndex m_requiredPathsByNode;
+
+  /// insert a new transform reference into m_requiredPaths, and into the reverse lookup
+  TransformReferenceMap::iterator insertTransformReference(const SdfPath& path, const TransformReference& ref);
+
+  /// remove a transform reference from m_requiredPaths, and from the reverse lookup
+  void eraseTransformReference(TransformReferenceMap::iterator it);
+
 
   /// it is possible to end up with some invalid data in here as a result of a variant switch. When it looks as though a
   /// schema prim is going to change type, in cases where a payload fails to resolve, we can end up with null prims in the
@@ -1009,7 +1080,6 @@ private:
   UsdStagePopulationMask constructStagePopulationMask(const MString &paths) const;
 
   bool isStageValid() const;
-  bool primHasExcludedParent(UsdPrim prim);
   bool initPrim(const uint32_t index, MDGContext& ctx);
 
   void layerIdChanged(SdfNotice::LayerIdentifierDidChange const& notice, UsdStageWeakPtr const& sender);
@@ -1035,6 +1105,28 @@ private:
       return translator != 0;
     }
 
+private:
+  struct StageLoadRequest;
+  struct AsyncStageLoads;
+
+  /// \brief  the first half of loadStage, which reads everything needed to open the stage from the node
+  /// \param  request returns the details of the stage to open
+  /// \return the id of this load
+  uint32_t beginLoadStage(StageLoadRequest& request);
+
+  /// \brief  opens the root layer and composes the stage. This only talks to USD (and not maya), so it is safe to call
+  ///         from a background thread.
+  /// \param  request the stage to open
+  /// \return the stage, or null if it could not be opened
+  static UsdStageRefPtr openStage(const StageLoadRequest& request);
+
+  /// \brief  the second half of loadStage, run on the main thread once the stage has been opened
+  /// \param  stage the stage that was opened (null if it could not be)
+  /// \param  file the file path that was requested
+  /// \param  fileString the resolved file path that was opened
+  /// \param  printTimings if true, and maya is running interactively, the profiler report is displayed
+  void finishLoadStage(UsdStageRefPtr stage, const MString& file, const std::string& fileString, bool printTimings = true);
+
 private:
   SdfPathVector m_pathsOrdered;
   static std::vector<MObjectHandle> m_unloadedProxyShapes;
@@ -1053,14 +1145,12 @@ private:
   TfNotice::Key m_variantChangedNoticeKey;
   TfNotice::Key m_editTargetChanged;
 
-  mutable std::map<UsdTimeCode, MBoundingBox> m_boundingBoxCache;
+  mutable proxy::BoundingBoxCache m_boundingBoxCache;
   AL::event::CallbackId m_beforeSaveSceneId = -1;
   MCallbackId m_attributeChanged = 0;
   MCallbackId m_onSelectionChanged = 0;
   SdfPathVector m_excludedGeometry;
-  SdfPathVector m_excludedTaggedGeometry;
-  SdfPathSet m_lockTransformPrims;
-  SdfPathSet m_lockInheritedPrims;
+  PrimMetadataIndex m_metadataIndex;
   SdfPathSet m_currentLockedPrims;
   static MObject m_transformTranslate;
   static MObject m_transformRotate;
@@ -1075,6 +1165,8 @@ private:
   Engine* m_engine = 0;
 
   uint32_t m_engineRefCount = 0;
+  uint32_t m_stageLoadId = 0;
+  bool m_stageLoading = false;
   bool m_compositionHasChanged = false;
   bool m_drivenTransformsDirty = false;
   bool m_pleaseIgnoreSelection = false;
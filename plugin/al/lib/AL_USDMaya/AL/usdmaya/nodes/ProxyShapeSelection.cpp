@@ -13,6 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include "AL/usdmaya/cmds/ProxyShapeCommands.h"
 #include "AL/usdmaya/nodes/ProxyShape.h"
 #include "AL/usdmaya/nodes/Transform.h"
 #include "AL/usdmaya/nodes/TransformationMatrix.h"
@@ -25,6 +26,7 @@
 
 #include <set>
 #include <algorithm>
+#include <unordered_set>
 #include "AL/usdmaya/utils/Utils.h"
 
 
@@ -78,12 +80,10 @@ void ProxyShape::onSelectionChanged(void* ptr)
     MSelectionList sl;
     MGlobal::getActiveSelectionList(sl);
 
-    std::vector<SdfPath> unselectedSet;
-    MFnDagNode fnDag;
+    SdfPathVector unselectedSet;
 
     // now attempt to find any items that have been selected via maya (e.g. by clicking on the parent node in the outliner)
     bool hasNewItems = false;
-    MString precommand = "AL_usdmaya_ProxyShapeSelect -i -a";
     for(uint32_t i = 0; i < sl.length(); ++i)
     {
       MObject obj;
@@ -93,9 +93,6 @@ void ProxyShape::onSelectionChanged(void* ptr)
       {
         if(path.IsAbsolutePath())
         {
-          precommand += " -pp \"";
-          precommand += path.GetText();
-          precommand += "\"";
           hasNewItems = true;
         }
       }
@@ -108,40 +105,11 @@ void ProxyShape::onSelectionChanged(void* ptr)
     };
     std::sort(unselectedSet.begin(), unselectedSet.end(), compare_length());
 
-    // construct command to unselect the nodes (specifying the internal flag to ensure the selection list is not modified)
-    MString command = "AL_usdmaya_ProxyShapeSelect -i -d";
-    for(auto removed : unselectedSet)
-    {
-      command += " -pp \"";
-      command += removed.GetText();
-      command += "\"";
-    }
-
-    fnDag.setObject(proxy->thisMObject());
-
-    command += " \"";
-    command += fnDag.name().asChar();
-    command += "\"";
-
-    if(hasNewItems)
-    {
-      precommand += " \"";
-      precommand += fnDag.name().asChar();
-      precommand += "\";";
-      if(!unselectedSet.empty())
-      {
-        command = precommand + command;
-      }
-      else
-      {
-        command = precommand;
-      }
-    }
-
+    // unselect the nodes (as an internal selection, to ensure the selection list is not modified)
     if(unselectedSet.empty() && !hasNewItems)
     {
       proxy->m_pleaseIgnoreSelection = true;
-      MGlobal::executeCommand(command, false, true);
+      cmds::ProxyShapeSelect::selectPaths(proxy, unselectedSet, MGlobal::kRemoveFromList, true);
     }
   }
   else
@@ -162,34 +130,30 @@ void ProxyShape::onSelectionChanged(void* ptr)
     MSelectionList sl;
     MGlobal::getActiveSelectionList(sl, false);
 
-    bool hasItems = false;
-    bool hasNewItems = false;
-    MString precommand = "AL_usdmaya_ProxyShapeSelect -i -a";
-    MString command = "AL_usdmaya_ProxyShapeSelect -i -d";
+    SdfPathVector newPaths;
+    SdfPathVector removedPaths;
 
-    // maya bug work around.
-    auto hasObject = [] (MSelectionList sl, MObject node)
+    // maya bug work around. The selected nodes are gathered up front, rather than searching the list for each path.
+    struct HandleHash
     {
-      for(uint32_t i = 0; i < sl.length(); ++i)
-      {
-        MObject obj;
-        sl.getDependNode(i, obj);
-        if(node == obj)
-          return true;
-      }
-      return false;
+      size_t operator () (const MObjectHandle& handle) const
+        { return handle.hashCode(); }
     };
+    std::unordered_set<MObjectHandle, HandleHash> selectedNodes;
+    selectedNodes.reserve(sl.length());
+    for(uint32_t i = 0; i < sl.length(); ++i)
+    {
+      MObject obj;
+      sl.getDependNode(i, obj);
+      selectedNodes.insert(MObjectHandle(obj));
+    }
 
     for(auto selected : proxy->selectedPaths())
     {
       MObject obj = proxy->findRequiredPath(selected);
-      MFnDependencyNode fn(obj);
-      if(!hasObject(sl, obj))
+      if(!selectedNodes.count(MObjectHandle(obj)))
       {
-        hasItems = true;
-        command += " -pp \"";
-        command += selected.GetText();
-        command += "\"";
+        removedPaths.push_back(selected);
       }
     }
 
@@ -198,46 +162,34 @@ void ProxyShape::onSelectionChanged(void* ptr)
     {
       MObject obj;
       sl.getDependNode(i, obj);
-      MFnDependencyNode fn(obj);
       SdfPath path;
       if(!proxy->isSelectedMObject(obj, path))
       {
         if(path.IsAbsolutePath())
         {
-          precommand += " -pp \"";
-          precommand += path.GetText();
-          precommand += "\"";
-          hasNewItems = true;
+          newPaths.push_back(path);
         }
       }
     }
 
-    if(hasItems)
+    // the additions and removals are made as a single (internal) replacement of the selection, so that the change in
+    // the maya selection is undone in one step
+    if(!newPaths.empty() || !removedPaths.empty())
     {
-      MFnDagNode fnDag(proxy->thisMObject());
-      command += " \"";
-      command += fnDag.name().asChar();
-      command += "\"";
-      if(hasNewItems)
+      SelectionUndoHelper::SdfPathHashSet removedSet(removedPaths.begin(), removedPaths.end());
+      SdfPathVector paths;
+      paths.reserve(proxy->selectedPaths().size() + newPaths.size());
+      for(const SdfPath& selected : proxy->selectedPaths())
       {
-        precommand += " \"";
-        precommand += fnDag.name().asChar();
-        precommand += "\";";
-        command = precommand + command;
+        if(!removedSet.count(selected))
+        {
+          paths.push_back(selected);
+        }
       }
+      paths.insert(paths.end(), newPaths.begin(), newPaths.end());
+
       proxy->m_pleaseIgnoreSelection = true;
-      MGlobal::executeCommand(command, false, true);
-      proxy->m_pleaseIgnoreSelection = false;
-    }
-    else
-    if(hasNewItems)
-    {
-      MFnDagNode fnDag(proxy->thisMObject());
-      precommand += " \"";
-      precommand += fnDag.name().asChar();
-      precommand += "\";";
-      proxy->m_pleaseIgnoreSelection = true;
-      MGlobal::executeCommand(precommand, false, true);
+      cmds::ProxyShapeSelect::selectPaths(proxy, paths, MGlobal::kReplaceList, true);
       proxy->m_pleaseIgnoreSelection = false;
     }
   }
@@ -317,7 +269,7 @@ inline bool ProxyShape::TransformReference::checkRef(const TransformReason reaso
 
 //----------------------------------------------------------------------------------------------------------------------
 inline ProxyShape::TransformReference::TransformReference(const MObject& node, const TransformReason reason)
-  : m_node(node)
+  : m_node(node), m_nodeHash(MObjectHandle(node).hashCode())
 {
   m_required = 0;
   m_selected = 0;
@@ -327,6 +279,61 @@ inline ProxyShape::TransformReference::TransformReference(const MObject& node, c
   m_transform = (Transform*)fn.userNode();
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+ProxyShape::TransformReferenceMap::iterator ProxyShape::insertTransformReference(
+    const SdfPath& path,
+    const TransformReference& ref)
+{
+  auto inserted = m_requiredPaths.emplace(path, ref);
+  if(inserted.second && ref.nodeHash())
+  {
+    m_requiredPathsByNode.emplace(ref.nodeHash(), path);
+  }
+  return inserted.first;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void ProxyShape::eraseTransformReference(TransformReferenceMap::iterator it)
+{
+  auto range = m_requiredPathsByNode.equal_range(it->second.nodeHash());
+  for(auto entry = range.first; entry != range.second; ++entry)
+  {
+    if(entry->second == it->first)
+    {
+      m_requiredPathsByNode.erase(entry);
+      break;
+    }
+  }
+  m_requiredPaths.erase(it);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool ProxyShape::isSelectedMObject(MObject obj, SdfPath& path)
+{
+  // hash codes are not unique, so each candidate is checked against the node it references. If more than one path
+  // references the node, the first in path order is used.
+  auto found = m_requiredPaths.end();
+  auto range = m_requiredPathsByNode.equal_range(MObjectHandle(obj).hashCode());
+  for(auto entry = range.first; entry != range.second; ++entry)
+  {
+    auto it = m_requiredPaths.find(entry->second);
+    if(it != m_requiredPaths.end() && it->second.node() == obj)
+    {
+      if(found == m_requiredPaths.end() || it->first < found->first)
+      {
+        found = it;
+      }
+    }
+  }
+
+  if(found == m_requiredPaths.end())
+  {
+    return false;
+  }
+  path = found->first;
+  return m_selectedPaths.count(found->first) > 0;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 void ProxyShape::makeTransformReference(const SdfPath& path, const MObject& node, TransformReason reason)
 {
@@ -352,7 +359,7 @@ void ProxyShape::makeTransformReference(const SdfPath& path, const MObject& node
       {
         TransformReference ref(tempNode, reason);
         ref.incRef(reason);
-        m_requiredPaths.emplace(tempPath, ref);
+        insertTransformReference(tempPath, ref);
       }
       status = dagPath.pop();
       tempPath = tempPath.GetParentPath();
@@ -619,7 +626,7 @@ MObject ProxyShape::makeUsdTransformChain(
   }
   TransformReference ref(node, reason);
   ref.checkIncRef(reason);
-  m_requiredPaths.emplace(path, ref);
+  insertTransformReference(path, ref);
   return node;
 }
 
@@ -675,7 +682,7 @@ void ProxyShape::makeUsdTransformsInternal(const UsdPrim& usdPrim, const MObject
       modifier.newPlugValueString(ptrNode->primPathPlug(), prim.GetPath().GetText());
       TransformReference transformRef(node, reason);
       transformRef.incRef(reason);
-      m_requiredPaths.emplace(prim.GetPath(), transformRef);
+      insertTransformReference(prim.GetPath(), transformRef);
 
       makeUsdTransformsInternal(prim, node, modifier, reason, modifier2);
     }
@@ -757,7 +764,7 @@ void ProxyShape::removeUsdTransformChain(
       }
 
       m_currentLockedPrims.erase(parentPrim);
-      m_requiredPaths.erase(it);
+      eraseTransformReference(it);
     }
 
     parentPrim = parentPrim.GetParentPath();
@@ -809,7 +816,7 @@ void ProxyShape::removeUsdTransformChain(
         modifier.deleteNode(object);
       }
 
-      m_requiredPaths.erase(it);
+      eraseTransformReference(it);
     }
 
     parentPrim = parentPrim.GetParent();
@@ -841,7 +848,7 @@ void ProxyShape::removeUsdTransformsInternal(
     // work around for Maya's love of deleting the parent transforms of custom transform nodes :(
     modifier.reparentNode(it->second.node());
     modifier.deleteNode(it->second.node());
-    m_requiredPaths.erase(it);
+    eraseTransformReference(it);
   }
 }
 
@@ -939,7 +946,7 @@ void ProxyShape::removeTransformRefs(const std::vector<std::pair<SdfPath, MObjec
       {
         if(it->second.decRef(reason))
         {
-          m_requiredPaths.erase(it);
+          eraseTransformReference(it);
         }
       }
 
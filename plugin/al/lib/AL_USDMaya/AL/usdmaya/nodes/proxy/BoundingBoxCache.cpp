@@ -0,0 +1,374 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "AL/usdmaya/nodes/proxy/BoundingBoxCache.h"
+#include "AL/usdmaya/DebugCodes.h"
+
+#include "pxr/usd/usd/primRange.h"
+#include "pxr/usd/usdGeom/boundable.h"
+#include "pxr/usd/usdGeom/imageable.h"
+#include "pxr/usd/usdGeom/pointBased.h"
+#include "pxr/usd/usdGeom/pointInstancer.h"
+#include "pxr/usd/usdGeom/xformable.h"
+
+#include <algorithm>
+
+namespace AL {
+namespace usdmaya {
+namespace nodes {
+namespace proxy {
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+struct TimeLess
+{
+  bool operator () (const std::pair<UsdTimeCode, T>& a, const UsdTimeCode b) const
+    { return a.first < b; }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+inline typename std::vector<std::pair<UsdTimeCode, T>>::iterator findTime(std::vector<std::pair<UsdTimeCode, T>>& samples, const UsdTimeCode time)
+{
+  return std::lower_bound(samples.begin(), samples.end(), time, TimeLess<T>());
+}
+
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+GfRange3d BoundingBoxCache::bound(const UsdPrim& root, const UsdTimeCode time, const TfTokenVector& purposes)
+{
+  if(!root)
+  {
+    return GfRange3d();
+  }
+
+  if(root.GetPath() != m_rootPath || root.GetStage() != m_stage || purposes != m_purposes)
+  {
+    clear();
+    m_stage = root.GetStage();
+    m_rootPath = root.GetPath();
+    m_purposes = purposes;
+  }
+
+  if(m_staticBoundValid)
+  {
+    return m_staticBound;
+  }
+
+  auto sample = findTime(m_timeSampledBounds, time);
+  if(sample != m_timeSampledBounds.end() && sample->first == time)
+  {
+    return sample->second;
+  }
+
+  if(!m_subtreesValid)
+  {
+    updateSubtrees(root);
+  }
+
+  TF_DEBUG(ALUSDMAYA_EVALUATION).Msg("BoundingBoxCache::bound computing bound for %s at time %f\n",
+                                     m_rootPath.GetText(), time.GetValue());
+
+  GfBBox3d combined;
+  for(auto& subtree : m_subtrees)
+  {
+    combined = GfBBox3d::Combine(combined, subtreeBound(subtree, root, time));
+  }
+  const GfRange3d range = combined.ComputeAlignedRange();
+
+  // subtreeBound determines the variability of each subtree, so this is only known now
+  if(!m_numVaryingSubtrees)
+  {
+    m_timeSampledBounds.clear();
+    m_staticBound = range;
+    m_staticBoundValid = true;
+  }
+  else
+  {
+    m_timeSampledBounds.emplace(findTime(m_timeSampledBounds, time), time, range);
+  }
+  return range;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void BoundingBoxCache::invalidate(const SdfPath& path)
+{
+  if(m_subtrees.empty() && !m_staticBoundValid && m_timeSampledBounds.empty())
+  {
+    return;
+  }
+
+  const SdfPath primPath = path.GetPrimPath();
+  if(m_rootPath.HasPrefix(primPath))
+  {
+    clear();
+    return;
+  }
+
+  if(!primPath.HasPrefix(m_rootPath))
+  {
+    // Changes to an instance master affect the bounds of all of its instances. Rather than map the master back to
+    // each instance, discard everything (edits to masters are rare compared to edits to the instances themselves).
+    if(isInMaster(primPath))
+    {
+      TF_DEBUG(ALUSDMAYA_EVALUATION).Msg("BoundingBoxCache::invalidate master %s\n", primPath.GetText());
+      clear();
+    }
+    return;
+  }
+
+  // a gprim at the root is a single subtree
+  if(m_subtrees.size() == 1 && m_subtrees[0].m_path == m_rootPath)
+  {
+    clear();
+    return;
+  }
+
+  // whatever happens below, the combined bounds are no longer valid
+  m_staticBoundValid = false;
+  m_timeSampledBounds.clear();
+
+  // find the child of the root that contains the path
+  SdfPath subtreePath = primPath;
+  while(subtreePath.GetParentPath() != m_rootPath)
+  {
+    subtreePath = subtreePath.GetParentPath();
+  }
+
+  // a child of the root may have been added or removed, so the list of subtrees needs rebuilding
+  if(subtreePath == primPath)
+  {
+    m_subtreesValid = false;
+  }
+
+  auto it = std::lower_bound(m_subtrees.begin(), m_subtrees.end(), subtreePath,
+                             [](const Subtree& subtree, const SdfPath& p) { return subtree.m_path < p; });
+  if(it != m_subtrees.end() && it->m_path == subtreePath)
+  {
+    TF_DEBUG(ALUSDMAYA_EVALUATION).Msg("BoundingBoxCache::invalidate %s\n", subtreePath.GetText());
+    if(it->m_variability == Variability::kVarying)
+    {
+      --m_numVaryingSubtrees;
+    }
+    it->m_variability = Variability::kUnknown;
+    it->m_staticBoundValid = false;
+    it->m_timeSampledBounds.clear();
+    it->m_cache.reset();
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void BoundingBoxCache::clear()
+{
+  m_subtrees.clear();
+  m_numVaryingSubtrees = 0;
+  m_subtreesValid = false;
+  m_rootVisibilityVarying = false;
+  m_staticBoundValid = false;
+  m_timeSampledBounds.clear();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool BoundingBoxCache::isInMaster(const SdfPath& primPath) const
+{
+  UsdStageRefPtr stage = m_stage;
+  if(!stage || !primPath.IsAbsolutePath() || primPath.IsAbsoluteRootPath())
+  {
+    return false;
+  }
+
+  // masters are always root prims
+  SdfPath rootPrimPath = primPath;
+  while(!rootPrimPath.IsRootPrimPath())
+  {
+    rootPrimPath = rootPrimPath.GetParentPath();
+  }
+  const UsdPrim prim = stage->GetPrimAtPath(rootPrimPath);
+  return prim && prim.IsMaster();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void BoundingBoxCache::updateSubtrees(const UsdPrim& root)
+{
+  // the bbox cache honours inherited visibility, so animated visibility on the root prim (or any of its ancestors)
+  // makes every subtree time varying
+  m_rootVisibilityVarying = false;
+  for(UsdPrim prim = root; prim && !prim.IsPseudoRoot(); prim = prim.GetParent())
+  {
+    UsdGeomImageable imageable(prim);
+    if(imageable && imageable.GetVisibilityAttr().ValueMightBeTimeVarying())
+    {
+      m_rootVisibilityVarying = true;
+      break;
+    }
+  }
+
+  std::vector<Subtree> subtrees;
+  if(root.IsA<UsdGeomBoundable>())
+  {
+    // a gprim at the root is bounded as a single subtree
+    subtrees.resize(1);
+    subtrees[0].m_path = root.GetPath();
+  }
+  else
+  {
+    for(const UsdPrim& child : root.GetChildren())
+    {
+      subtrees.emplace_back();
+      subtrees.back().m_path = child.GetPath();
+    }
+    std::sort(subtrees.begin(), subtrees.end(), [](const Subtree& a, const Subtree& b) { return a.m_path < b.m_path; });
+  }
+
+  // keep hold of the data for any subtrees that were already cached (both arrays are sorted)
+  m_numVaryingSubtrees = 0;
+  auto existing = m_subtrees.begin();
+  for(auto& subtree : subtrees)
+  {
+    while(existing != m_subtrees.end() && existing->m_path < subtree.m_path)
+    {
+      ++existing;
+    }
+    if(existing != m_subtrees.end() && existing->m_path == subtree.m_path)
+    {
+      subtree = std::move(*existing);
+      if(subtree.m_variability == Variability::kVarying)
+      {
+        ++m_numVaryingSubtrees;
+      }
+    }
+  }
+  m_subtrees.swap(subtrees);
+  m_subtreesValid = true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+GfBBox3d BoundingBoxCache::subtreeBound(Subtree& subtree, const UsdPrim& root, const UsdTimeCode time)
+{
+  UsdPrim prim = subtree.m_path == m_rootPath ? root : root.GetStage()->GetPrimAtPath(subtree.m_path);
+  if(!prim)
+  {
+    return GfBBox3d();
+  }
+
+  if(subtree.m_variability == Variability::kUnknown)
+  {
+    const bool varying = m_rootVisibilityVarying || mightBeTimeVarying(prim);
+    subtree.m_variability = varying ? Variability::kVarying : Variability::kStatic;
+    if(varying)
+    {
+      ++m_numVaryingSubtrees;
+    }
+  }
+
+  if(subtree.m_staticBoundValid)
+  {
+    return subtree.m_staticBound;
+  }
+
+  auto sample = findTime(subtree.m_timeSampledBounds, time);
+  if(sample != subtree.m_timeSampledBounds.end() && sample->first == time)
+  {
+    return sample->second;
+  }
+
+  if(!subtree.m_cache)
+  {
+    subtree.m_cache.reset(new UsdGeomBBoxCache(time, m_purposes));
+  }
+  else
+  {
+    // the cache retains the bounds of any prims that are not time varying
+    subtree.m_cache->SetTime(time);
+  }
+
+  const GfBBox3d box = (prim == root) ?
+                       subtree.m_cache->ComputeUntransformedBound(prim) :
+                       subtree.m_cache->ComputeRelativeBound(prim, root);
+
+  if(subtree.m_variability == Variability::kStatic)
+  {
+    subtree.m_staticBound = box;
+    subtree.m_staticBoundValid = true;
+    // nothing else will be queried from a static subtree until it is invalidated
+    subtree.m_cache.reset();
+  }
+  else
+  {
+    subtree.m_timeSampledBounds.emplace(sample, time, box);
+  }
+  return box;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool BoundingBoxCache::mightBeTimeVarying(const UsdPrim& prim)
+{
+  UsdPrimRange range(prim, UsdTraverseInstanceProxies());
+  for(auto it = range.begin(); it != range.end(); ++it)
+  {
+    // the bbox cache ignores anything that is not imageable (and everything beneath it)
+    UsdGeomImageable imageable(*it);
+    if(!imageable)
+    {
+      it.PruneChildren();
+      continue;
+    }
+
+    if(imageable.GetVisibilityAttr().ValueMightBeTimeVarying())
+    {
+      return true;
+    }
+
+    UsdGeomXformable xformable(*it);
+    if(xformable && xformable.TransformMightBeTimeVarying())
+    {
+      return true;
+    }
+
+    UsdGeomBoundable boundable(*it);
+    if(boundable && boundable.GetExtentAttr().ValueMightBeTimeVarying())
+    {
+      return true;
+    }
+
+    UsdGeomPointBased pointBased(*it);
+    if(pointBased && pointBased.GetPointsAttr().ValueMightBeTimeVarying())
+    {
+      return true;
+    }
+
+    UsdGeomPointInstancer instancer(*it);
+    if(instancer &&
+       (instancer.GetPositionsAttr().ValueMightBeTimeVarying() ||
+        instancer.GetOrientationsAttr().ValueMightBeTimeVarying() ||
+        instancer.GetScalesAttr().ValueMightBeTimeVarying() ||
+        instancer.GetProtoIndicesAttr().ValueMightBeTimeVarying() ||
+        instancer.GetInvisibleIdsAttr().ValueMightBeTimeVarying()))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+} // proxy
+} // nodes
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,124 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+
+#include "../../Api.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "pxr/pxr.h"
+#include "pxr/base/gf/bbox3d.h"
+#include "pxr/base/gf/range3d.h"
+#include "pxr/usd/sdf/path.h"
+#include "pxr/usd/usd/prim.h"
+#include "pxr/usd/usd/timeCode.h"
+#include "pxr/usd/usdGeom/bboxCache.h"
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace AL {
+namespace usdmaya {
+namespace nodes {
+namespace proxy {
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Caches the untransformed bounds of the prim hierarchy displayed by a proxy shape.
+///
+///         The hierarchy is split into subtrees (one per child of the root prim). Subtrees that contain no time
+///         varying data hold a single bound that is shared by all time codes, whereas animated subtrees hold their
+///         bounds in a sorted array indexed by time code. Each subtree keeps its own UsdGeomBBoxCache alive between
+///         queries, so the bounds of static prims within an animated subtree are not recomputed when the time changes.
+///         The combined bound is cached in the same way, and is a single value when the whole hierarchy is static.
+///
+///         When the stage changes, invalidate() should be called with the changed paths, which discards the data for
+///         the subtrees containing those paths only.
+//----------------------------------------------------------------------------------------------------------------------
+class BoundingBoxCache
+{
+public:
+
+  /// \brief  returns the untransformed bound of the root prim (and all of its children) at the given time
+  /// \param  root the prim to bound. If this differs from the prim used in previous calls, the cache is cleared.
+  /// \param  time the time at which to compute the bound
+  /// \param  purposes the purposes included in the bound. If these differ from the purposes used in previous calls,
+  ///         the cache is cleared.
+  /// \return the axis aligned bound of the prim, which may be empty
+  AL_USDMAYA_PUBLIC
+  GfRange3d bound(const UsdPrim& root, UsdTimeCode time, const TfTokenVector& purposes);
+
+  /// \brief  discards any cached data for the subtree containing the specified path. If the path is the root prim (or
+  ///         one of its ancestors), or is within an instance master, all cached data is discarded. Any other paths
+  ///         outside of the root prim are ignored.
+  /// \param  path the path of a prim or property that has changed
+  AL_USDMAYA_PUBLIC
+  void invalidate(const SdfPath& path);
+
+  /// \brief  discards all cached data
+  AL_USDMAYA_PUBLIC
+  void clear();
+
+  /// \brief  returns true if the cached hierarchy has been found to contain no time varying data. Only meaningful
+  ///         after a call to bound().
+  inline bool isStatic() const
+    { return m_subtreesValid && !m_numVaryingSubtrees; }
+
+  /// \brief  returns the number of combined bounds currently stored in the cache
+  inline size_t size() const
+    { return m_staticBoundValid ? 1 : m_timeSampledBounds.size(); }
+
+private:
+  enum class Variability : uint8_t
+  {
+    kUnknown,
+    kStatic,
+    kVarying
+  };
+
+  struct Subtree
+  {
+    SdfPath m_path;
+    Variability m_variability = Variability::kUnknown;
+    bool m_staticBoundValid = false;
+    GfBBox3d m_staticBound;
+    std::vector<std::pair<UsdTimeCode, GfBBox3d>> m_timeSampledBounds;
+    std::unique_ptr<UsdGeomBBoxCache> m_cache;
+  };
+
+  void updateSubtrees(const UsdPrim& root);
+  GfBBox3d subtreeBound(Subtree& subtree, const UsdPrim& root, UsdTimeCode time);
+  bool isInMaster(const SdfPath& primPath) const;
+  static bool mightBeTimeVarying(const UsdPrim& prim);
+
+  UsdStageWeakPtr m_stage;
+  SdfPath m_rootPath;
+  TfTokenVector m_purposes;
+  std::vector<Subtree> m_subtrees;
+  uint32_t m_numVaryingSubtrees = 0;
+  bool m_subtreesValid = false;
+  bool m_rootVisibilityVarying = false;
+  bool m_staticBoundValid = false;
+  GfRange3d m_staticBound;
+  std::vector<std::pair<UsdTimeCode, GfRange3d>> m_timeSampledBounds;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+} // proxy
+} // nodes
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
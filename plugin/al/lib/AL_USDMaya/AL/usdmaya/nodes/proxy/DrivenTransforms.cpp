@@ -3,6 +3,11 @@
 #include "AL/usdmaya/nodes/proxy/DrivenTransforms.h"
 #include "AL/usdmaya/DebugCodes.h"
 
+#include "pxr/usd/sdf/changeBlock.h"
+#include "pxr/usd/usdGeom/xform.h"
+
+#include "maya/MGlobal.h"
+
 namespace AL {
 namespace usdmaya {
 namespace nodes {
@@ -14,41 +19,134 @@ void DrivenTransforms::resizeDrivenTransforms(const size_t primPathCount)
   m_drivenPrimPaths.resize(primPathCount);
   m_drivenMatrix.resize(primPathCount, MMatrix::identity);
   m_drivenVisibility.resize(primPathCount, true);
+  clearResolvedSpecs();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void DrivenTransforms::updateDrivenTransforms(std::vector<UsdPrim>& drivenPrims, const MTime& currentTime)
+SdfPath DrivenTransforms::resolveSpec(const UsdAttribute& attr) const
 {
-  for (uint32_t i = 0, cnt = m_dirtyMatrices.size(); i < cnt; ++i)
+  const SdfPath specPath = m_editTarget.MapToSpecPath(attr.GetPath());
+  if(specPath.IsEmpty())
   {
-    uint32_t idx = uint32_t(m_dirtyMatrices[i]);
-    // [RB] This seems redundant? Why not just prevent invalid data from entering the structure?
-    if (idx >= drivenPrims.size())
+    return SdfPath();
+  }
+  if(!m_layer->HasSpec(specPath))
+  {
+    // author the attribute in the edit target, so that the values can be set directly on the layer from now on
+    attr.GetPrim().CreateAttribute(attr.GetName(), attr.GetTypeName(), attr.IsCustom(), attr.GetVariability());
+    if(!m_layer->HasSpec(specPath))
     {
-      continue;
+      return SdfPath();
     }
-    UsdPrim& usdPrim = drivenPrims[idx];
-    if (!usdPrim.IsValid())
+  }
+  return specPath;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+SdfPath DrivenTransforms::resolveTransformSpec(const UsdPrim& prim) const
+{
+  UsdGeomXform xform(prim);
+  bool resetsXformStack = false;
+  std::vector<UsdGeomXformOp> xformops = xform.GetOrderedXformOps(&resetsXformStack);
+  for (auto& it : xformops)
+  {
+    if (it.GetOpType() == UsdGeomXformOp::TypeTransform)
     {
-      continue;
+      return resolveSpec(it.GetAttr());
     }
-    UsdGeomXform xform(usdPrim);
-    bool resetsXformStack = false;
-    std::vector<UsdGeomXformOp> xformops = xform.GetOrderedXformOps(&resetsXformStack);
-    bool pushed = false;
-    for (auto& it : xformops)
+  }
+  return resolveSpec(xform.AddTransformOp().GetAttr());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+SdfPath DrivenTransforms::resolveVisibilitySpec(const UsdPrim& prim) const
+{
+  UsdGeomXform xform(prim);
+  UsdAttribute attr = xform.GetVisibilityAttr();
+  if(!attr)
+  {
+    attr = xform.CreateVisibilityAttr();
+  }
+  return resolveSpec(attr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+bool DrivenTransforms::prepare(UsdStageRefPtr stage)
+{
+  if(m_dirtyMatrices.empty() && m_dirtyVisibilities.empty())
+  {
+    return true;
+  }
+  if(!stage)
+  {
+    return false;
+  }
+
+  // any previously resolved specs are only valid for the same stage and edit target
+  if(m_stage != UsdStagePtr(stage) || !(m_editTarget == stage->GetEditTarget()) || m_transformSpecs.size() != transformCount())
+  {
+    m_stage = stage;
+    m_editTarget = stage->GetEditTarget();
+    m_layer = m_editTarget.GetLayer();
+    m_layerOffset = m_editTarget.GetMapFunction().GetTimeOffset();
+    clearResolvedSpecs();
+  }
+
+  bool result = true;
+  auto resolveDirty = [&](const std::vector<int32_t>& dirtyIndices, SdfPathVector& specs,
+                          SdfPath (DrivenTransforms::*resolve)(const UsdPrim&) const)
+  {
+    for(const int32_t dirty : dirtyIndices)
     {
-      if (it.GetOpType() == UsdGeomXformOp::TypeTransform)
+      const uint32_t idx = uint32_t(dirty);
+      if(idx >= specs.size())
+      {
+        continue;
+      }
+      // the spec may have been removed from the layer since it was resolved
+      if(!specs[idx].IsEmpty() && m_layer->HasSpec(specs[idx]))
+      {
+        continue;
+      }
+      UsdPrim prim = stage->GetPrimAtPath(m_drivenPrimPaths[idx]);
+      if(!prim.IsValid())
       {
-        nodes::TransformationMatrix::pushMatrix(m_drivenMatrix[idx], it, currentTime.as(MTime::uiUnit()));
-        pushed = true;
-        break;
+        MString warningMsg;
+        warningMsg.format("Driven Prim [^1s] is not valid.", MString("") + idx);
+        MGlobal::displayWarning(warningMsg);
+        result = false;
+        specs[idx] = SdfPath();
+        continue;
       }
+      specs[idx] = (this->*resolve)(prim);
+    }
+  };
+
+  if(m_layer)
+  {
+    resolveDirty(m_dirtyMatrices, m_transformSpecs, &DrivenTransforms::resolveTransformSpec);
+    resolveDirty(m_dirtyVisibilities, m_visibilitySpecs, &DrivenTransforms::resolveVisibilitySpec);
+  }
+  return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void DrivenTransforms::writeDrivenTransforms(const double layerTime)
+{
+  for (uint32_t i = 0, cnt = m_dirtyMatrices.size(); i < cnt; ++i)
+  {
+    uint32_t idx = uint32_t(m_dirtyMatrices[i]);
+    if (idx >= m_transformSpecs.size() || m_transformSpecs[idx].IsEmpty())
+    {
+      continue;
     }
-    if (!pushed)
+
+    const SdfPath& specPath = m_transformSpecs[idx];
+    const GfMatrix4d& value = *(const GfMatrix4d*)(&m_drivenMatrix[idx]);
+    GfMatrix4d oldValue;
+    if(!m_layer->QueryTimeSample(specPath, layerTime, &oldValue) || value != oldValue)
     {
-      UsdGeomXformOp xformop = xform.AddTransformOp();
-      nodes::TransformationMatrix::pushMatrix(m_drivenMatrix[idx], xformop, currentTime.as(MTime::uiUnit()));
+      m_layer->SetTimeSample(specPath, layerTime, value);
     }
 
     TF_DEBUG(ALUSDMAYA_EVALUATION).Msg("ProxyShape::updateDrivenTransforms %lf %lf %lf %lf  %lf %lf %lf %lf  %lf %lf %lf %lf  %lf %lf %lf %lf\n",
@@ -69,63 +167,50 @@ void DrivenTransforms::updateDrivenTransforms(std::vector<UsdPrim>& drivenPrims,
         m_drivenMatrix[idx][3][2],
         m_drivenMatrix[idx][3][3]);
   }
-  m_dirtyMatrices.clear();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void DrivenTransforms::updateDrivenVisibility(std::vector<UsdPrim>& drivenPrims, const MTime& currentTime)
+void DrivenTransforms::writeDrivenVisibility(const double layerTime)
 {
   for (uint32_t i = 0, cnt = m_dirtyVisibilities.size(); i < cnt; ++i)
   {
     uint32_t idx = uint32_t(m_dirtyVisibilities[i]);
-    // [RB] This seems redundant? Why not just prevent invalid data from entering the structure?
-    if (idx >= drivenPrims.size())
+    if (idx >= m_visibilitySpecs.size() || m_visibilitySpecs[idx].IsEmpty())
     {
       continue;
     }
-    UsdPrim& usdPrim = drivenPrims[idx];
-    if (!usdPrim)
-    {
-      continue;
-    }
-    UsdGeomXform xform(usdPrim);
-    UsdAttribute attr = xform.GetVisibilityAttr();
-    if(!attr)
+
+    const SdfPath& specPath = m_visibilitySpecs[idx];
+    const TfToken& value = m_drivenVisibility[idx] ? UsdGeomTokens->inherited : UsdGeomTokens->invisible;
+    TfToken oldValue;
+    if(!m_layer->QueryTimeSample(specPath, layerTime, &oldValue) || value != oldValue)
     {
-      attr = xform.CreateVisibilityAttr();
+      m_layer->SetTimeSample(specPath, layerTime, value);
     }
-    attr.Set(m_drivenVisibility[idx] ? UsdGeomTokens->inherited : UsdGeomTokens->invisible, currentTime.as(MTime::uiUnit()));
   }
-  m_dirtyVisibilities.clear();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-bool DrivenTransforms::update(UsdStageRefPtr stage, const MTime& currentTime)
+void DrivenTransforms::write(const MTime& currentTime)
 {
-  std::vector<UsdPrim> drivenPrims;
-  drivenPrims.resize(transformCount());
-  bool result = true;
-  uint32_t cnt = m_drivenPrimPaths.size();
-  for (uint32_t idx = 0; idx < cnt; ++idx)
+  if(m_layer)
   {
-    auto path = m_drivenPrimPaths[idx];
-    drivenPrims[idx] = stage->GetPrimAtPath(path);
-    if (!drivenPrims[idx].IsValid())
-    {
-      MString warningMsg;
-      warningMsg.format("Driven Prim [^1s] is not valid.", MString("") + idx);
-      MGlobal::displayWarning(warningMsg);
-      result = false;
-    }
+    // map the stage time into the edit target layer, as UsdAttribute::Set would
+    const double layerTime = m_layerOffset.GetInverse() * currentTime.as(MTime::uiUnit());
+    writeDrivenTransforms(layerTime);
+    writeDrivenVisibility(layerTime);
   }
+  m_dirtyMatrices.clear();
+  m_dirtyVisibilities.clear();
+}
 
-  if (!dirtyMatrices().empty())
-  {
-    updateDrivenTransforms(drivenPrims, currentTime);
-  }
-  if (!dirtyVisibilities().empty())
+//----------------------------------------------------------------------------------------------------------------------
+bool DrivenTransforms::update(UsdStageRefPtr stage, const MTime& currentTime)
+{
+  const bool result = prepare(stage);
   {
-    updateDrivenVisibility(drivenPrims, currentTime);
+    SdfChangeBlock changeBlock;
+    write(currentTime);
   }
   return result;
 }
@@ -17,7 +17,10 @@
 
 #include "../../Api.h"
 
+#include "pxr/usd/sdf/layer.h"
+#include "pxr/usd/sdf/layerOffset.h"
 #include "pxr/usd/sdf/path.h"
+#include "pxr/usd/usd/editTarget.h"
 #include "pxr/usd/usd/prim.h"
 
 #include "maya/MPxData.h"
@@ -43,9 +46,14 @@ namespace proxy {
 ///         memory storage. setDrivenPrimPaths should be called to specify the prim paths. Whenever you need to specify
 ///         a change to the matrix or visibility values, call either dirtyVisibility or dirtyMatrix, and specify the
 ///         index of the prim to modify.
-///         Within the compute method of the node, constructDrivenPrimsArray should be called to construct the array
-///         of prims to update, which can then be passed to the update method to set the dirty values on the prim
+///         Within the compute method of the node, update should be called to set the dirty values on the prim
 ///         attributes.
+///
+///         The attribute specs that receive the values are resolved once per driven prim (in the current edit target
+///         layer), and are then written directly at the Sdf level. This allows the values for all of the dirty prims to
+///         be set within a single SdfChangeBlock, so that the stage sends a single change notice per evaluation. To
+///         batch the writes of many DrivenTransforms together, call prepare on each of them, and then call write on
+///         each of them within a single SdfChangeBlock.
 //----------------------------------------------------------------------------------------------------------------------
 class DrivenTransforms
 {
@@ -53,7 +61,8 @@ public:
 
   /// \brief  ctor
   inline DrivenTransforms()
-    : m_drivenPrimPaths(), m_drivenMatrix(), m_drivenVisibility(), m_dirtyMatrices(), m_dirtyVisibilities() {}
+    : m_drivenPrimPaths(), m_drivenMatrix(), m_drivenVisibility(), m_dirtyMatrices(), m_dirtyVisibilities(),
+      m_transformSpecs(), m_visibilitySpecs() {}
 
   /// \brief  returns the number of transforms
   inline size_t transformCount() const
@@ -67,15 +76,31 @@ public:
   /// \brief  set the driven prim paths on the host driven transforms
   /// \param  primPaths the prim paths to set on the proxy
   inline void setDrivenPrimPaths(const SdfPathVector& primPaths)
-    { m_drivenPrimPaths = primPaths; }
+    { m_drivenPrimPaths = primPaths; clearResolvedSpecs(); }
 
-  /// \brief  update the driven transforms
+  /// \brief  update the driven transforms. This is equivalent to calling prepare, followed by write within an
+  ///         SdfChangeBlock.
   /// \param  stage the stage to extract the prims from
   /// \param  currentTime the current time
-  ///
+  /// \return false if any of the dirty prims could not be found on the stage
   AL_USDMAYA_PUBLIC
   bool update(UsdStageRefPtr stage, const MTime& currentTime);
 
+  /// \brief  resolves (and if needed, creates) the attribute specs in the edit target layer of the stage for all dirty
+  ///         prims that have not previously been resolved. This uses the Usd API, so must not be called within an
+  ///         SdfChangeBlock.
+  /// \param  stage the stage to extract the prims from
+  /// \return false if any of the dirty prims could not be found on the stage
+  AL_USDMAYA_PUBLIC
+  bool prepare(UsdStageRefPtr stage);
+
+  /// \brief  writes the dirty matrix and visibility values to the attribute specs resolved by the last call to
+  ///         prepare, and clears the dirty indices. This only uses the Sdf API, so may be called within an
+  ///         SdfChangeBlock.
+  /// \param  currentTime the current time
+  AL_USDMAYA_PUBLIC
+  void write(const MTime& currentTime);
+
   /// \brief  dirties the visibility for the specified prim index
   /// \param  primIndex the index of the prim
   /// \param  newValue the new visibility value
@@ -120,14 +145,31 @@ public:
     { return m_drivenVisibility; }
 
 private:
-  void updateDrivenVisibility(std::vector<UsdPrim>& drivenPrims, const MTime& currentTime);
-  void updateDrivenTransforms(std::vector<UsdPrim>& drivenPrims, const MTime& currentTime);
+  inline void clearResolvedSpecs()
+    {
+      m_transformSpecs.assign(m_drivenPrimPaths.size(), SdfPath());
+      m_visibilitySpecs.assign(m_drivenPrimPaths.size(), SdfPath());
+    }
+  SdfPath resolveTransformSpec(const UsdPrim& prim) const;
+  SdfPath resolveVisibilitySpec(const UsdPrim& prim) const;
+  SdfPath resolveSpec(const UsdAttribute& attr) const;
+  void writeDrivenTransforms(double layerTime);
+  void writeDrivenVisibility(double layerTime);
 private:
   SdfPathVector m_drivenPrimPaths;
   std::vector<MMatrix> m_drivenMatrix;
   std::vector<bool> m_drivenVisibility;
   std::vector<int32_t> m_dirtyMatrices;
   std::vector<int32_t> m_dirtyVisibilities;
+
+  // the attribute specs (within m_layer) that are written to for each driven prim. An empty path indicates the spec
+  // has not yet been resolved.
+  SdfPathVector m_transformSpecs;
+  SdfPathVector m_visibilitySpecs;
+  UsdStageWeakPtr m_stage;
+  UsdEditTarget m_editTarget;
+  SdfLayerHandle m_layer;
+  SdfLayerOffset m_layerOffset;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,268 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "AL/usdmaya/nodes/ProxyShape.h"
+#include "AL/usdmaya/nodes/proxy/HierarchyTraversal.h"
+#include "AL/usdmaya/fileio/TransformIterator.h"
+#include "AL/usdmaya/CodeTimings.h"
+#include "AL/usdmaya/DebugCodes.h"
+
+#include "pxr/base/work/loops.h"
+#include "pxr/base/work/threadLimits.h"
+#include "pxr/usd/usd/stage.h"
+
+#include "maya/MDagPath.h"
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+
+namespace AL {
+namespace usdmaya {
+namespace nodes {
+namespace proxy {
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  the path lists recorded by a single task of the traversal
+//----------------------------------------------------------------------------------------------------------------------
+struct TraversalResults
+{
+  TraversalResults(const std::vector<const HierarchyIterationLogic*>& logics)
+    : m_pathLists(logics.size())
+  {
+    for(size_t i = 0; i < logics.size(); ++i)
+    {
+      m_pathLists[i].resize(logics[i]->numPathLists);
+    }
+  }
+
+  std::vector<std::vector<SdfPathVector>> m_pathLists; ///< the path lists of each logic
+  std::vector<UsdPrim> m_masters; ///< the masters of the instances found
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+void visitPrim(const UsdPrim& prim, const std::vector<const HierarchyIterationLogic*>& logics, TraversalResults& results)
+{
+  if(!prim.IsValid())
+  {
+    return;
+  }
+  for(size_t i = 0; i < logics.size(); ++i)
+  {
+    logics[i]->parallelIteration(prim, results.m_pathLists[i].data());
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  appends the prims to visit after prim. Instances are not expanded here, but their masters are recorded so
+///         that each master can be visited once the rest of the hierarchy has been traversed.
+//----------------------------------------------------------------------------------------------------------------------
+void appendChildren(const UsdPrim& prim, std::vector<UsdPrim>& prims, TraversalResults& results)
+{
+  if(!prim.IsValid())
+  {
+    return;
+  }
+  if(prim.IsInstance())
+  {
+    results.m_masters.push_back(prim.GetMaster());
+    return;
+  }
+  for(const UsdPrim& child : prim.GetChildren())
+  {
+    prims.push_back(child);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  visits the prims (and their descendants). The top of the hierarchy is expanded on the calling thread until
+///         there are enough subtrees to keep all of the worker threads busy.
+//----------------------------------------------------------------------------------------------------------------------
+void traverseSubtrees(
+    std::vector<UsdPrim> prims,
+    const std::vector<const HierarchyIterationLogic*>& logics,
+    std::vector<TraversalResults>& allResults)
+{
+  TraversalResults results(logics);
+  const size_t minSubtrees = 8 * WorkGetConcurrencyLimit();
+  std::vector<UsdPrim> next;
+  while(!prims.empty() && prims.size() < minSubtrees)
+  {
+    next.clear();
+    for(const UsdPrim& prim : prims)
+    {
+      visitPrim(prim, logics, results);
+      appendChildren(prim, next, results);
+    }
+    prims.swap(next);
+  }
+  allResults.push_back(std::move(results));
+
+  std::mutex mutex;
+  WorkParallelForN(prims.size(), [&prims, &logics, &allResults, &mutex](const size_t begin, const size_t end)
+    {
+      TraversalResults results(logics);
+      std::vector<UsdPrim> stack;
+      for(size_t i = begin; i < end; ++i)
+      {
+        stack.push_back(prims[i]);
+        while(!stack.empty())
+        {
+          const UsdPrim prim = stack.back();
+          stack.pop_back();
+          visitPrim(prim, logics, results);
+          appendChildren(prim, stack, results);
+        }
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      allResults.push_back(std::move(results));
+    }, 1);
+}
+
+} // anon
+
+//----------------------------------------------------------------------------------------------------------------------
+void traverseHierarchy(const UsdPrim& root, const HierarchyIterationLogic* const* logics, const size_t numLogics)
+{
+  TF_DEBUG(ALUSDMAYA_EVALUATION).Msg("traverseHierarchy %s\n", root.GetPath().GetText());
+  if(!root.IsValid())
+  {
+    return;
+  }
+
+  std::vector<const HierarchyIterationLogic*> parallelLogics;
+  std::vector<const HierarchyIterationLogic*> serialLogics;
+  for(size_t i = 0; i < numLogics; ++i)
+  {
+    if(logics[i]->parallelIteration)
+    {
+      parallelLogics.push_back(logics[i]);
+    }
+    else
+    if(logics[i]->iteration)
+    {
+      serialLogics.push_back(logics[i]);
+    }
+    if(logics[i]->preIteration)
+    {
+      logics[i]->preIteration();
+    }
+  }
+
+  if(!parallelLogics.empty())
+  {
+    AL_BEGIN_PROFILE_SECTION(ParallelTraversal);
+    std::vector<TraversalResults> allResults;
+    std::vector<UsdPrim> prims;
+    if(root.IsPseudoRoot())
+    {
+      TraversalResults rootResults(parallelLogics);
+      appendChildren(root, prims, rootResults);
+    }
+    else
+    {
+      prims.push_back(root);
+    }
+    traverseSubtrees(prims, parallelLogics, allResults);
+
+    // visit the masters of the instances found (which may in turn contain instances of other masters)
+    SdfPathSet visitedMasters;
+    for(size_t scanned = 0; scanned < allResults.size(); )
+    {
+      prims.clear();
+      for(const size_t end = allResults.size(); scanned < end; ++scanned)
+      {
+        for(const UsdPrim& master : allResults[scanned].m_masters)
+        {
+          if(visitedMasters.insert(master.GetPath()).second)
+          {
+            for(const UsdPrim& child : master.GetChildren())
+            {
+              prims.push_back(child);
+            }
+          }
+        }
+      }
+      if(!prims.empty())
+      {
+        traverseSubtrees(prims, parallelLogics, allResults);
+      }
+    }
+    AL_END_PROFILE_SECTION();
+
+    AL_BEGIN_PROFILE_SECTION(MergeTraversalResults);
+    for(size_t i = 0; i < parallelLogics.size(); ++i)
+    {
+      std::vector<SdfPathVector> pathLists(parallelLogics[i]->numPathLists);
+      for(size_t j = 0; j < pathLists.size(); ++j)
+      {
+        SdfPathVector& paths = pathLists[j];
+        size_t count = 0;
+        for(const TraversalResults& results : allResults)
+        {
+          count += results.m_pathLists[i][j].size();
+        }
+        paths.reserve(count);
+        for(TraversalResults& results : allResults)
+        {
+          SdfPathVector& found = results.m_pathLists[i][j];
+          std::move(found.begin(), found.end(), std::back_inserter(paths));
+        }
+        std::sort(paths.begin(), paths.end());
+        paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+      }
+      if(parallelLogics[i]->mergePathLists)
+      {
+        parallelLogics[i]->mergePathLists(pathLists);
+      }
+    }
+    AL_END_PROFILE_SECTION();
+  }
+
+  if(!serialLogics.empty())
+  {
+    AL_BEGIN_PROFILE_SECTION(SerialTraversal);
+    MDagPath parentPath;
+    for(fileio::TransformIterator it(root, parentPath); !it.done(); it.next())
+    {
+      const UsdPrim& prim = it.prim();
+      if(!prim.IsValid() || prim.IsPseudoRoot())
+        continue;
+
+      for(auto hl : serialLogics)
+      {
+        hl->iteration(it, prim);
+      }
+    }
+    AL_END_PROFILE_SECTION();
+  }
+
+  for(size_t i = 0; i < numLogics; ++i)
+  {
+    if(logics[i]->postIteration)
+    {
+      logics[i]->postIteration();
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+} // proxy
+} // nodes
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
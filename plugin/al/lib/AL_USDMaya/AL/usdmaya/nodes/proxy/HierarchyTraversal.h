@@ -0,0 +1,55 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#pragma once
+
+#include "../../Api.h"
+
+#include "pxr/usd/usd/prim.h"
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace AL {
+namespace usdmaya {
+namespace nodes {
+
+struct HierarchyIterationLogic;
+
+namespace proxy {
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Runs a set of hierarchy iteration logics over the prims beneath root, in a single traversal. The prims
+///         visited are the same as those visited by fileio::TransformIterator, i.e. the root itself (unless it is the
+///         pseudo root), its descendants, and the descendants of the masters of any instances found. Each master is
+///         only visited once, no matter how many instances refer to it.
+///
+///         Logics that provide a parallelIteration method are run on worker threads, each of which takes a subtree of
+///         the hierarchy. The path lists recorded by each thread are then merged, sorted and passed to mergePathLists.
+///         Any logics that only provide an iteration method are run afterwards in a serial walk with a
+///         fileio::TransformIterator. The preIteration and postIteration methods of every logic are called on the
+///         calling thread, before and after the traversal.
+/// \param  root the prim to start the traversal from
+/// \param  logics the logics to run
+/// \param  numLogics the number of logics
+//----------------------------------------------------------------------------------------------------------------------
+AL_USDMAYA_PUBLIC
+void traverseHierarchy(const UsdPrim& root, const HierarchyIterationLogic* const* logics, size_t numLogics);
+
+//----------------------------------------------------------------------------------------------------------------------
+} // proxy
+} // nodes
+} // usdmaya
+} // AL
+//----------------------------------------------------------------------------------------------------------------------
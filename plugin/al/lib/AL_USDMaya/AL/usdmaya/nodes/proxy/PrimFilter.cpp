@@ -2,6 +2,10 @@
 #include "AL/usdmaya/nodes/proxy/PrimFilter.h"
 #include "AL/usdmaya/fileio/SchemaPrims.h"
 
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+
 namespace AL {
 namespace usdmaya {
 namespace nodes {
@@ -9,56 +13,76 @@ namespace proxy {
 
 //----------------------------------------------------------------------------------------------------------------------
 PrimFilter::PrimFilter(const SdfPathVector& previousPrims, const std::vector<UsdPrim>& newPrimSet, PrimFilterInterface* proxy)
-        : m_newPrimSet(newPrimSet), m_transformsToCreate(), m_updatablePrimSet(), m_removedPrimSet()
+        : m_newPrimSet(), m_transformsToCreate(), m_updatablePrimSet(), m_removedPrimSet()
 {
-  // copy over original prims
-  m_removedPrimSet.assign(previousPrims.begin(), previousPrims.end());
-  std::sort(m_removedPrimSet.begin(), m_removedPrimSet.end(),  [](const SdfPath& a, const SdfPath& b){ return b < a; } );
+  // the previous prims are reverse sorted, so that children are removed before their parents
+  auto reverseOrder = [](const SdfPath& a, const SdfPath& b){ return b < a; };
+  SdfPathVector previousSorted(previousPrims.begin(), previousPrims.end());
+  std::sort(previousSorted.begin(), previousSorted.end(), reverseOrder);
 
-  for(auto it = m_newPrimSet.begin(); it != m_newPrimSet.end(); )
+  // a variant switch typically contains a handful of types, so the translator info is only looked up once per type
+  struct TypeInfo
   {
-    UsdPrim prim = *it;
-    auto lastIt = it;
-    ++it;
+    bool supportsUpdate = false;
+    bool requiresParent = false;
+  };
+  std::unordered_map<TfToken, TypeInfo, TfToken::HashFunctor> typeInfoCache;
 
+  SdfPathVector updatedPaths;
+  m_newPrimSet.reserve(newPrimSet.size());
+  for(const UsdPrim& prim : newPrimSet)
+  {
     SdfPath path = prim.GetPath();
 
     // check previous prim type (if it exists at all?)
     TfToken type = proxy->getTypeForPath(path);
     TfToken newType = prim.GetTypeName();
 
-    bool supportsUpdate = false;
-    bool requiresParent = false;
-    proxy->getTypeInfo(newType, supportsUpdate, requiresParent);
+    auto cached = typeInfoCache.emplace(newType, TypeInfo());
+    TypeInfo& info = cached.first->second;
+    if(cached.second)
+    {
+      proxy->getTypeInfo(newType, info.supportsUpdate, info.requiresParent);
+    }
+    bool requiresParent = info.requiresParent;
 
-    // if the type remains the same, and the type supports update
+    // if the type remains the same, and the type supports update. If the prim is still already there with the same type,
+    // it isn't new.
     if(type == newType)
     {
-      if(supportsUpdate)
+      if(info.supportsUpdate)
       {
         TF_DEBUG(ALUSDMAYA_TRANSLATORS).Msg(
                   "PrimFilter::PrimFilter %s prim has not changed type and supports updates or inactive.\n", path.GetText());
-        // locate the path and delete from the removed set (we do not want to delete this prim!
-        // Note that m_removedPrimSet is reverse sorted
-        auto iter = std::lower_bound(m_removedPrimSet.begin(), m_removedPrimSet.end(), path, [](const SdfPath& a, const SdfPath& b){ return b < a; } );
-        if(iter != removedPrimSet().end() && *iter == path)
+        // we do not want to delete this prim! The updated paths are removed from the previous set in one go, below.
+        if(std::binary_search(previousSorted.begin(), previousSorted.end(), path, reverseOrder))
         {
-          m_removedPrimSet.erase(iter);
+          updatedPaths.push_back(path);
           m_updatablePrimSet.push_back(prim);
           // skip creating transforms in this case.
           requiresParent = false;
         }
       }
-
-      //If the prim is still already there with the same type, it isn't new.
-      it = m_newPrimSet.erase(lastIt);
     }
+    else
+    {
+      m_newPrimSet.push_back(prim);
+    }
+
     // if we need a transform, make a note of it now
     if(requiresParent)
     {
       m_transformsToCreate.push_back(prim);
     }
   }
+
+  // the removed prims are the previous prims that were not updated. Both lists are reverse sorted, so this is a
+  // single merge, rather than an erase from the middle of the vector for each updated prim.
+  std::sort(updatedPaths.begin(), updatedPaths.end(), reverseOrder);
+  updatedPaths.erase(std::unique(updatedPaths.begin(), updatedPaths.end()), updatedPaths.end());
+  m_removedPrimSet.reserve(previousSorted.size() - updatedPaths.size());
+  std::set_difference(previousSorted.begin(), previousSorted.end(), updatedPaths.begin(), updatedPaths.end(),
+                      std::back_inserter(m_removedPrimSet), reverseOrder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
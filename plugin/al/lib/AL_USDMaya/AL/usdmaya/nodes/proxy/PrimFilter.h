@@ -46,7 +46,7 @@ struct PrimFilterInterface
   virtual TfToken getTypeForPath(const SdfPath& path) = 0;
 
   /// \brief  for a specific type, this method should return whether it supports update, and if that type requires a
-  ///         DAG path to be created.
+  ///         DAG path to be created. The filter caches the result, so this is called once for each type.
   /// \param  type the type to query
   /// \param  supportsUpdate returned value that indicates if the type in question can be updated
   /// \param  requiresParent returned value that indicates whether the type in question needs a DAG path to be created
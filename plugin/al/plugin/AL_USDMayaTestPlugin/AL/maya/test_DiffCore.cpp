@@ -1,6 +1,10 @@
 
 #include "AL/usd/utils/DiffCore.h"
 #include "AL/usd/utils/ALHalf.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
 #include <gtest/gtest.h>
 
 static inline float randFloat()
@@ -513,3 +517,204 @@ TEST(DataDiff, compareUvArray)
   u[22] -= 1.0f;
 }
 
+
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+std::vector<const AL::usd::utils::DiffCoreKernels*> availableKernels(std::vector<AL::usd::utils::SIMDTier>* tiers = nullptr)
+{
+  std::vector<const AL::usd::utils::DiffCoreKernels*> kernels;
+  for(uint32_t i = 0; i < uint32_t(AL::usd::utils::SIMDTier::kNumTiers); ++i)
+  {
+    if(const AL::usd::utils::DiffCoreKernels* k = AL::usd::utils::diffCoreKernels(AL::usd::utils::SIMDTier(i)))
+    {
+      kernels.push_back(k);
+      if(tiers)
+        tiers->push_back(AL::usd::utils::SIMDTier(i));
+    }
+  }
+  return kernels;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+bool vecNAreAllTheSameReference(const T* array, const size_t count, const size_t N)
+{
+  for(size_t i = N; i < count * N; ++i)
+  {
+    if(array[i] != array[i % N])
+      return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename A, typename B>
+bool compareArrayReference(const A* a, const B* b, const size_t count, const float eps)
+{
+  for(size_t i = 0; i < count; ++i)
+  {
+    if(std::abs(float(a[i]) - float(b[i])) > eps)
+      return false;
+  }
+  return true;
+}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Each SIMD tier must give the same results, for every array length (to exercise all of the tail cases), and for a
+// difference at any position within the array.
+TEST(DataDiff, simdTiersMatchReference)
+{
+  const std::vector<const AL::usd::utils::DiffCoreKernels*> tiers = availableKernels();
+  ASSERT_FALSE(tiers.empty());
+  const float eps = 1e-3f;
+
+  for(size_t count = 0; count < 100; ++count)
+  {
+    // small whole numbers are exactly representable as halfs
+    std::vector<float> f0(count * 4), f1;
+    std::vector<double> d0(count * 4), d1;
+    std::vector<GfHalf> h0(count * 4);
+    std::vector<int8_t> c0(count * 4), c1;
+    std::vector<int32_t> i0(count * 4), i1;
+    for(size_t i = 0; i < count * 4; ++i)
+    {
+      f0[i] = float(i % 7);
+      d0[i] = double(i % 7);
+      h0[i] = GfHalf(float(i % 7));
+      c0[i] = int8_t(i);
+      i0[i] = int32_t(i * 3);
+    }
+
+    // repeated vectors
+    std::vector<float> v2f(count * 2), v3f(count * 3), v4f(count * 4), u(count), v(count), uv(count * 2);
+    std::vector<double> v2d(count * 2), v3d(count * 3), v4d(count * 4);
+    for(size_t i = 0; i < count; ++i)
+    {
+      for(size_t j = 0; j < 2; ++j) { v2f[i * 2 + j] = float(j + 1); v2d[i * 2 + j] = double(j + 1); }
+      for(size_t j = 0; j < 3; ++j) { v3f[i * 3 + j] = float(j + 1); v3d[i * 3 + j] = double(j + 1); }
+      for(size_t j = 0; j < 4; ++j) { v4f[i * 4 + j] = float(j + 1); v4d[i * 4 + j] = double(j + 1); }
+      u[i] = uv[i * 2] = 0.25f;
+      v[i] = uv[i * 2 + 1] = 0.75f;
+    }
+
+    // -1 leaves the arrays the same
+    for(int64_t changed = -1; changed < int64_t(count); ++changed)
+    {
+      f1.assign(f0.begin(), f0.begin() + count);
+      d1.assign(d0.begin(), d0.begin() + count);
+      c1.assign(c0.begin(), c0.begin() + count);
+      i1.assign(i0.begin(), i0.begin() + count);
+      std::vector<float> v2fc(v2f), v3fc(v3f), v4fc(v4f), uc(u), vc(v), uvc(uv), rgba(v4f);
+      std::vector<double> v2dc(v2d), v3dc(v3d), v4dc(v4d);
+      if(changed >= 0)
+      {
+        const size_t c = size_t(changed);
+        f1[c] += 1.0f;
+        d1[c] += 1.0;
+        c1[c] += 1;
+        i1[c] += 1;
+        v2fc[c * 2 + 1] += 1.0f;
+        v2dc[c * 2 + 1] += 1.0;
+        v3fc[c * 3 + c % 3] += 1.0f;
+        v3dc[c * 3 + c % 3] += 1.0;
+        v4fc[c * 4 + c % 4] += 1.0f;
+        v4dc[c * 4 + c % 4] += 1.0;
+        rgba[c * 4 + c % 4] += 1.0f;
+        (c & 1 ? vc : uc)[c] += 1.0f;
+        uvc[c * 2 + (c & 1)] += 1.0f;
+      }
+
+      const bool f = compareArrayReference(f0.data(), f1.data(), count, eps);
+      const bool d = compareArrayReference(d0.data(), d1.data(), count, eps);
+      const bool hf = compareArrayReference(h0.data(), f1.data(), count, eps);
+      const bool hd = compareArrayReference(h0.data(), d1.data(), count, eps);
+      const bool c = compareArrayReference(c0.data(), c1.data(), count, 0.0f);
+      const bool i = compareArrayReference(i0.data(), i1.data(), count, 0.0f);
+      const bool uvSame = vecNAreAllTheSameReference(uc.data(), count, 1) &&
+                          vecNAreAllTheSameReference(vc.data(), count, 1);
+
+      for(const AL::usd::utils::DiffCoreKernels* k : tiers)
+      {
+        SCOPED_TRACE(testing::Message() << "count " << count << " changed " << changed);
+        EXPECT_EQ(f, k->compareArrayFloat(f0.data(), f1.data(), count, count, eps));
+        EXPECT_EQ(d, k->compareArrayDouble(d0.data(), d1.data(), count, count, eps));
+        EXPECT_EQ(hf, k->compareArrayHalfFloat(h0.data(), f1.data(), count, count, eps));
+        EXPECT_EQ(hd, k->compareArrayHalfDouble(h0.data(), d1.data(), count, count, eps));
+        EXPECT_EQ(d, k->compareArrayDoubleFloat(d1.data(), f0.data(), count, count, eps));
+        EXPECT_EQ(c, k->compareArrayInt8(c0.data(), c1.data(), count, count));
+        EXPECT_EQ(i, k->compareArrayInt32(i0.data(), i1.data(), count, count));
+
+        EXPECT_EQ(vecNAreAllTheSameReference(v2fc.data(), count, 2), k->vec2AreAllTheSameFloat(v2fc.data(), count));
+        EXPECT_EQ(vecNAreAllTheSameReference(v3fc.data(), count, 3), k->vec3AreAllTheSameFloat(v3fc.data(), count));
+        EXPECT_EQ(vecNAreAllTheSameReference(v4fc.data(), count, 4), k->vec4AreAllTheSameFloat(v4fc.data(), count));
+        EXPECT_EQ(vecNAreAllTheSameReference(v2dc.data(), count, 2), k->vec2AreAllTheSameDouble(v2dc.data(), count));
+        EXPECT_EQ(vecNAreAllTheSameReference(v3dc.data(), count, 3), k->vec3AreAllTheSameDouble(v3dc.data(), count));
+        EXPECT_EQ(vecNAreAllTheSameReference(v4dc.data(), count, 4), k->vec4AreAllTheSameDouble(v4dc.data(), count));
+        EXPECT_EQ(uvSame, k->vec2AreAllTheSameUV(uc.data(), vc.data(), count));
+
+        EXPECT_EQ(changed < 0, k->compareUvArray(u.data(), v.data(), uvc.data(), count, count, eps));
+        EXPECT_EQ(changed < 0, k->compareUvArray(uc.data(), vc.data(), uv.data(), count, count, eps));
+        EXPECT_EQ(changed < 0, k->compareUvArrayToConstant(0.25f, 0.75f, uc.data(), vc.data(), count, eps));
+        EXPECT_EQ(changed < 0, k->compareRGBAArray(1.0f, 2.0f, 3.0f, 4.0f, rgba.data(), count, eps));
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Reports the throughput of the main kernels for each SIMD tier
+TEST(DataDiff, simdTierThroughput)
+{
+  std::vector<AL::usd::utils::SIMDTier> tierIds;
+  const std::vector<const AL::usd::utils::DiffCoreKernels*> tiers = availableKernels(&tierIds);
+  std::cout << "DiffCore active tier: " << AL::usd::utils::simdTierName(AL::usd::utils::activeSIMDTier()) << std::endl;
+
+  const size_t maxCount = size_t(1) << 22;
+  std::vector<float> a(maxCount * 4, 1.0f), b(maxCount * 4, 1.0f);
+  std::vector<double> da(maxCount, 1.0), db(maxCount, 1.0);
+
+  struct Kernel
+  {
+    const char* name;
+    size_t bytesPerElement;
+    std::function<bool(const AL::usd::utils::DiffCoreKernels&, size_t)> run;
+  };
+  const Kernel kernels[] = {
+    { "compareArray(float)", 2 * sizeof(float),
+      [&](const AL::usd::utils::DiffCoreKernels& k, size_t n) { return k.compareArrayFloat(a.data(), b.data(), n, n, 1e-5f); } },
+    { "compareArray(double)", 2 * sizeof(double),
+      [&](const AL::usd::utils::DiffCoreKernels& k, size_t n) { return k.compareArrayDouble(da.data(), db.data(), n, n, 1e-5); } },
+    { "vec3AreAllTheSame(float)", 3 * sizeof(float),
+      [&](const AL::usd::utils::DiffCoreKernels& k, size_t n) { return k.vec3AreAllTheSameFloat(a.data(), n); } },
+    { "compareUvArray", 4 * sizeof(float),
+      [&](const AL::usd::utils::DiffCoreKernels& k, size_t n) { return k.compareUvArray(a.data(), b.data(), a.data() + maxCount, n, n, 1e-5f); } },
+    { "compareRGBAArray", 4 * sizeof(float),
+      [&](const AL::usd::utils::DiffCoreKernels& k, size_t n) { return k.compareRGBAArray(1.0f, 1.0f, 1.0f, 1.0f, a.data(), n, 1e-5f); } },
+  };
+
+  for(const Kernel& kernel : kernels)
+  {
+    for(size_t count = 1024; count <= maxCount; count <<= 4)
+    {
+      const size_t bytes = count * kernel.bytesPerElement;
+      const size_t iterations = std::max(size_t(1), (size_t(1) << 28) / bytes);
+      std::cout << "DiffCore " << kernel.name << " " << bytes << " bytes:";
+      for(size_t t = 0; t < tiers.size(); ++t)
+      {
+        bool result = true;
+        const auto start = std::chrono::high_resolution_clock::now();
+        for(size_t i = 0; i < iterations; ++i)
+        {
+          result = kernel.run(*tiers[t], count) && result;
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        EXPECT_TRUE(result);
+        const double seconds = std::chrono::duration<double>(end - start).count();
+        std::cout << " " << AL::usd::utils::simdTierName(tierIds[t]) << " "
+                  << (double(bytes) * iterations / seconds) * 1e-9 << " GB/s";
+      }
+      std::cout << std::endl;
+    }
+  }
+}
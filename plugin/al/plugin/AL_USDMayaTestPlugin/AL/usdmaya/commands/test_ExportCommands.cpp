@@ -19,6 +19,13 @@
 #include "maya/MGlobal.h"
 #include "maya/MFileIO.h"
 #include "maya/MFnDagNode.h"
+#include "maya/MAnimControl.h"
+#include "maya/MFnMesh.h"
+#include "maya/MPointArray.h"
+#include "maya/MSelectionList.h"
+#include "pxr/usd/usdGeom/mesh.h"
+
+#include <chrono>
 
 using AL::maya::test::buildTempPath;
 
@@ -170,3 +177,163 @@ TEST(ExportCommands, extensiveAnimationCheck)
   MGlobal::executeCommand(exportCmd, true);
   expectAnimation(false);
 }
+
+namespace {
+/// \brief  builds a scene with a large number of animated transforms and an animated mesh
+void buildAnimatedScene()
+{
+  MFileIO::newFile(true);
+  MGlobal::executeCommand(MString(
+    "for($i = 0; $i < 500; ++$i) {"
+    "  string $n = `createNode transform -n (\"animated\" + $i)`;"
+    "  setKeyframe -t 1 -v 0 -at tx $n; setKeyframe -t 100 -v $i -at tx $n;"
+    "  setKeyframe -t 1 -v 1 -at sy $n; setKeyframe -t 100 -v 2 -at sy $n;"
+    "}"
+    "polySphere -n animatedMesh -sx 200 -sy 200;"
+    "setKeyframe -t 1 -v 1 -at radius polySphere1; setKeyframe -t 100 -v 4 -at radius polySphere1;"), false, true);
+}
+
+/// \brief  exports the scene over frames 1 to 100 with the additional flags specified, and returns the time taken in ms
+double timedAnimationExport(const std::string& path, const char* const extraFlags)
+{
+  MString exportCmd;
+  exportCmd.format(MString("AL_usdmaya_ExportCommand -f \"^1s\" -frameRange 1 100 ^2s"), AL::maya::utils::convert(path), extraFlags);
+  auto start = std::chrono::high_resolution_clock::now();
+  MGlobal::executeCommand(exportCmd, true);
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/// \brief  checks that the two exported files contain identical time samples, and returns the number of animated attributes
+uint32_t compareAnimatedExports(const std::string& pathA, const std::string& pathB)
+{
+  UsdStageRefPtr stageA = UsdStage::Open(pathA);
+  UsdStageRefPtr stageB = UsdStage::Open(pathB);
+  EXPECT_TRUE(stageA);
+  EXPECT_TRUE(stageB);
+  if(!stageA || !stageB)
+    return 0;
+
+  uint32_t animatedAttributes = 0;
+  for(auto primA : stageA->Traverse())
+  {
+    UsdPrim primB = stageB->GetPrimAtPath(primA.GetPath());
+    EXPECT_TRUE(primB.IsValid());
+    if(!primB)
+      continue;
+    for(auto attrA : primA.GetAttributes())
+    {
+      UsdAttribute attrB = primB.GetAttribute(attrA.GetName());
+      EXPECT_TRUE(attrB.IsValid());
+      std::vector<double> timesA, timesB;
+      attrA.GetTimeSamples(&timesA);
+      attrB.GetTimeSamples(&timesB);
+      EXPECT_EQ(timesA, timesB);
+      animatedAttributes += timesA.empty() ? 0 : 1;
+      for(double t : timesA)
+      {
+        VtValue a, b;
+        attrA.Get(&a, t);
+        attrB.Get(&b, t);
+        EXPECT_EQ(a, b);
+      }
+    }
+  }
+  return animatedAttributes;
+}
+} // anon
+
+TEST(ExportCommands, pipelinedAnimation)
+{
+  buildAnimatedScene();
+
+  const std::string serial_path = buildTempPath("AL_USDMayaTests_serialAnimation.usda");
+  const std::string pipelined_path = buildTempPath("AL_USDMayaTests_pipelinedAnimation.usda");
+
+  const double serialTime = timedAnimationExport(serial_path, "");
+  const double pipelinedTime = timedAnimationExport(pipelined_path, "-pla 1");
+  std::cout << "animation export: serial " << serialTime << "ms, pipelined " << pipelinedTime << "ms" << std::endl;
+
+  // both export paths must author identical samples
+  EXPECT_LT(1000u, compareAnimatedExports(serial_path, pipelined_path));
+}
+
+TEST(ExportCommands, dgContextAnimation)
+{
+  buildAnimatedScene();
+  MGlobal::executeCommand("currentTime 50");
+
+  const std::string time_path = buildTempPath("AL_USDMayaTests_sceneTimeAnimation.usda");
+  const std::string context_path = buildTempPath("AL_USDMayaTests_dgContextAnimation.usda");
+  const std::string pipelined_path = buildTempPath("AL_USDMayaTests_dgContextPipelinedAnimation.usda");
+
+  const double sceneTime = timedAnimationExport(time_path, "");
+  const double contextTime = timedAnimationExport(context_path, "-dgc 1");
+  const double pipelinedTime = timedAnimationExport(pipelined_path, "-dgc 1 -pla 1");
+  std::cout << "animation export: scene time " << sceneTime << "ms, dg context " << contextTime
+            << "ms, dg context pipelined " << pipelinedTime << "ms" << std::endl;
+
+  EXPECT_LT(1000u, compareAnimatedExports(time_path, context_path));
+  EXPECT_LT(1000u, compareAnimatedExports(time_path, pipelined_path));
+  EXPECT_EQ(MTime(50.0), MAnimControl::currentTime());
+}
+
+TEST(ExportCommands, unchangedMeshFramesSkipped)
+{
+  // the sphere changes over frames 1 to 10 and 20 to 30, and holds its shape in between and afterwards
+  MFileIO::newFile(true);
+  MGlobal::executeCommand(MString(
+    "polySphere -n animatedMesh -sx 20 -sy 20;"
+    "setKeyframe -t 1 -v 1 -itt linear -ott linear -at radius polySphere1;"
+    "setKeyframe -t 10 -v 2 -itt linear -ott linear -at radius polySphere1;"
+    "setKeyframe -t 20 -v 2 -itt linear -ott linear -at radius polySphere1;"
+    "setKeyframe -t 30 -v 4 -itt linear -ott linear -at radius polySphere1;"), false, true);
+
+  const std::string serial_path = buildTempPath("AL_USDMayaTests_unchangedMeshFrames.usda");
+  const std::string pipelined_path = buildTempPath("AL_USDMayaTests_unchangedMeshFramesPipelined.usda");
+  MString exportCmd;
+  exportCmd.format(MString("AL_usdmaya_ExportCommand -f \"^1s\" -frameRange 1 40"), AL::maya::utils::convert(serial_path));
+  MGlobal::executeCommand(exportCmd, true);
+  exportCmd.format(MString("AL_usdmaya_ExportCommand -f \"^1s\" -frameRange 1 40 -pla 1"), AL::maya::utils::convert(pipelined_path));
+  MGlobal::executeCommand(exportCmd, true);
+  EXPECT_LE(1u, compareAnimatedExports(serial_path, pipelined_path));
+
+  UsdStageRefPtr stage = UsdStage::Open(serial_path);
+  ASSERT_TRUE(stage);
+  UsdGeomMesh mesh(stage->GetPrimAtPath(SdfPath("/animatedMesh")));
+  ASSERT_TRUE(mesh);
+  UsdAttribute pointsAttr = mesh.GetPointsAttr();
+
+  // frames 11 to 19 and 31 to 40 are skipped, with frame 20 written to close off the first run of unchanged frames
+  std::vector<double> times;
+  pointsAttr.GetTimeSamples(&times);
+  std::vector<double> expectedTimes;
+  for(int frame = 1; frame <= 30; ++frame)
+  {
+    if(frame <= 10 || frame >= 20)
+      expectedTimes.push_back(frame);
+  }
+  EXPECT_EQ(expectedTimes, times);
+
+  // every frame must still read back the points of the maya mesh at that frame
+  MSelectionList sl;
+  sl.add("animatedMeshShape");
+  MDagPath path;
+  sl.getDagPath(0, path);
+  MFnMesh fnMesh(path);
+  for(int frame = 1; frame <= 40; ++frame)
+  {
+    MAnimControl::setCurrentTime(MTime(frame, MTime::uiUnit()));
+    MPointArray mayaPoints;
+    fnMesh.getPoints(mayaPoints);
+    VtArray<GfVec3f> usdPoints;
+    pointsAttr.Get(&usdPoints, UsdTimeCode(frame));
+    ASSERT_EQ(mayaPoints.length(), usdPoints.size());
+    for(uint32_t i = 0; i < mayaPoints.length(); ++i)
+    {
+      EXPECT_NEAR(mayaPoints[i].x, usdPoints[i][0], 1e-5f);
+      EXPECT_NEAR(mayaPoints[i].y, usdPoints[i][1], 1e-5f);
+      EXPECT_NEAR(mayaPoints[i].z, usdPoints[i][2], 1e-5f);
+    }
+  }
+}
@@ -15,6 +15,7 @@
 //
 #include "test_usdmaya.h"
 
+#include "AL/usdmaya/cmds/ProxyShapeCommands.h"
 #include "AL/usdmaya/nodes/ProxyShape.h"
 #include "AL/usdmaya/nodes/Transform.h"
 #include "maya/MFnTransform.h"
@@ -22,6 +23,10 @@
 #include "maya/MGlobal.h"
 #include "maya/MItDependencyNodes.h"
 #include "maya/MFileIO.h"
+#include "maya/MDagModifier.h"
+
+#include <chrono>
+#include <iostream>
 
 using AL::maya::test::buildTempPath;
 
@@ -1166,3 +1171,142 @@ TEST(ProxyShapeSelect, repeatedSelection)
   MGlobal::executeCommand("undo", false, true);
   { SCOPED_TRACE(""); assertNothingSelected(proxy); }
 }
+
+// make sure selections made from C++ through ProxyShapeSelect::selectPaths are journalled with their arguments, and
+// can be undone and redone
+TEST(ProxyShapeSelect, selectPathsUndoRedo)
+{
+  MFileIO::newFile(true);
+  MGlobal::executeCommand("undoInfo -state 1;");
+
+  const std::string temp_path = buildTempPath("AL_USDMayaTests_selectPathsUndoRedo.usda");
+  {
+    UsdStageRefPtr stage = UsdStage::CreateInMemory();
+    UsdGeomXform::Define(stage, SdfPath("/root"));
+    UsdGeomXform::Define(stage, SdfPath("/root/hip1"));
+    UsdGeomXform::Define(stage, SdfPath("/root/hip2"));
+    stage->Export(temp_path, false);
+  }
+
+  MFnDagNode fn;
+  MObject xform = fn.create("transform");
+  MObject shape = fn.create("AL_usdmaya_ProxyShape", xform);
+  AL::usdmaya::nodes::ProxyShape* proxy = (AL::usdmaya::nodes::ProxyShape*)fn.userNode();
+  proxy->filePathPlug().setString(temp_path.c_str());
+
+  const SdfPath hip1("/root/hip1");
+  const SdfPath hip2("/root/hip2");
+  auto assertSelected = [proxy] (const SdfPathVector& paths)
+  {
+    EXPECT_EQ(paths.size(), proxy->selectedPaths().size());
+    for(const SdfPath& path : paths)
+    {
+      EXPECT_EQ(1u, proxy->selectedPaths().count(path));
+      EXPECT_TRUE(proxy->isRequiredPath(path));
+    }
+    MSelectionList sl;
+    MGlobal::getActiveSelectionList(sl);
+    EXPECT_EQ(paths.size(), sl.length());
+  };
+
+  MGlobal::executeCommand("select -cl;");
+  EXPECT_EQ(MStatus(MS::kSuccess),
+            AL::usdmaya::cmds::ProxyShapeSelect::selectPaths(proxy, {hip1, hip2}, MGlobal::kReplaceList));
+  { SCOPED_TRACE(""); assertSelected({hip1, hip2}); }
+
+  // the command is journalled with all of the paths it selected
+  MString undoName;
+  MGlobal::executeCommand("undoInfo -q -undoName", undoName);
+  EXPECT_NE(-1, undoName.indexW("/root/hip1"));
+  EXPECT_NE(-1, undoName.indexW("/root/hip2"));
+
+  EXPECT_EQ(MStatus(MS::kSuccess),
+            AL::usdmaya::cmds::ProxyShapeSelect::selectPaths(proxy, {hip1}, MGlobal::kRemoveFromList));
+  { SCOPED_TRACE(""); assertSelected({hip2}); }
+
+  MGlobal::executeCommand("undo", false, true);
+  { SCOPED_TRACE(""); assertSelected({hip1, hip2}); }
+  MGlobal::executeCommand("undo", false, true);
+  { SCOPED_TRACE(""); assertSelected({}); }
+  MGlobal::executeCommand("redo", false, true);
+  { SCOPED_TRACE(""); assertSelected({hip1, hip2}); }
+  MGlobal::executeCommand("redo", false, true);
+  { SCOPED_TRACE(""); assertSelected({hip2}); }
+
+  // the journalled command repeats the selection
+  MGlobal::executeCommand("AL_usdmaya_ProxyShapeSelect -a -pp \"/root/hip1\" -pp \"/root/hip2\" \"AL_usdmaya_ProxyShape1\"", false, true);
+  { SCOPED_TRACE(""); assertSelected({hip1, hip2}); }
+  MGlobal::executeCommand("undo", false, true);
+  { SCOPED_TRACE(""); assertSelected({hip2}); }
+
+  // there is nothing for the -pendingSelection flag to apply unless selectPaths provides it
+  EXPECT_NE(MStatus(MS::kSuccess), MGlobal::executeCommand("AL_usdmaya_ProxyShapeSelect -ps", false, true));
+}
+
+// times the mapping of a large maya selection back to prim paths (as done by onSelectionChanged)
+TEST(ProxyShapeSelect, selectionSyncPerformance)
+{
+  MFileIO::newFile(true);
+  const uint32_t count = 20000;
+
+  const std::string temp_path = buildTempPath("AL_USDMayaTests_selectionSyncPerformance.usda");
+  {
+    UsdStageRefPtr stage = UsdStage::CreateInMemory();
+    UsdGeomXform::Define(stage, SdfPath("/root"));
+    for(uint32_t i = 0; i < count; ++i)
+    {
+      UsdGeomXform::Define(stage, SdfPath("/root/xform" + std::to_string(i)));
+    }
+    stage->Export(temp_path, false);
+  }
+
+  MFnDagNode fn;
+  MObject xform = fn.create("transform");
+  MObject shape = fn.create("AL_usdmaya_ProxyShape", xform);
+  AL::usdmaya::nodes::ProxyShape* proxy = (AL::usdmaya::nodes::ProxyShape*)fn.userNode();
+  proxy->filePathPlug().setString(temp_path.c_str());
+  auto stage = proxy->getUsdStage();
+
+  MDagModifier modifier1;
+  MDGModifier modifier2;
+  proxy->makeUsdTransforms(stage->GetPrimAtPath(SdfPath("/root")), modifier1, AL::usdmaya::nodes::ProxyShape::kRequested, &modifier2);
+  EXPECT_EQ(MStatus(MS::kSuccess), modifier1.doIt());
+  EXPECT_EQ(MStatus(MS::kSuccess), modifier2.doIt());
+
+  MGlobal::executeCommand("select -cl;");
+  MGlobal::executeCommand("AL_usdmaya_ProxyShapeSelect -r -pp \"/root/xform0\" \"AL_usdmaya_ProxyShape1\"", false, true);
+  EXPECT_EQ(1, proxy->selectedPaths().size());
+
+  std::vector<SdfPath> paths;
+  MSelectionList sl;
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    paths.emplace_back("/root/xform" + std::to_string(i));
+    MObject node = proxy->findRequiredPath(paths.back());
+    ASSERT_FALSE(node.isNull());
+    sl.add(node);
+  }
+
+  typedef std::chrono::high_resolution_clock clock;
+  auto start = clock::now();
+  uint32_t numSelected = 0;
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    MObject obj;
+    sl.getDependNode(i, obj);
+    SdfPath path;
+    numSelected += proxy->isSelectedMObject(obj, path) ? 1 : 0;
+    EXPECT_EQ(paths[i], path);
+  }
+  const double lookupTime = std::chrono::duration<double>(clock::now() - start).count();
+  EXPECT_EQ(1u, numSelected);
+
+  // selecting the transforms in maya should select all of the prims
+  start = clock::now();
+  MGlobal::setActiveSelectionList(sl);
+  const double syncTime = std::chrono::duration<double>(clock::now() - start).count();
+  EXPECT_EQ(count, proxy->selectedPaths().size());
+
+  std::cout << "isSelectedMObject for " << count << " transforms: " << lookupTime << "s" << std::endl;
+  std::cout << "selection sync for " << count << " transforms: " << syncTime << "s" << std::endl;
+}
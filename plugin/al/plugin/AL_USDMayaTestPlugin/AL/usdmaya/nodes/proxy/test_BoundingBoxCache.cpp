@@ -0,0 +1,167 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "test_usdmaya.h"
+#include "AL/usdmaya/nodes/proxy/BoundingBoxCache.h"
+
+#include "pxr/usd/usd/stage.h"
+#include "pxr/usd/usdGeom/cube.h"
+#include "pxr/usd/usdGeom/tokens.h"
+#include "pxr/usd/usdGeom/xform.h"
+#include "pxr/usd/usdGeom/xformCommonAPI.h"
+
+using AL::usdmaya::nodes::proxy::BoundingBoxCache;
+
+namespace
+{
+//----------------------------------------------------------------------------------------------------------------------
+UsdGeomCube defineUnitCube(UsdStageRefPtr stage, const char* path, const GfVec3d& translate)
+{
+  UsdGeomCube cube = UsdGeomCube::Define(stage, SdfPath(path));
+  VtVec3fArray extent(2);
+  extent[0] = GfVec3f(-1.0f);
+  extent[1] = GfVec3f(1.0f);
+  cube.CreateExtentAttr().Set(extent);
+  UsdGeomXformCommonAPI(cube).SetTranslate(translate);
+  return cube;
+}
+
+const TfTokenVector g_purposes { UsdGeomTokens->default_, UsdGeomTokens->proxy };
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TEST(BoundingBoxCache, staticStageSharesOneEntry)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  defineUnitCube(stage, "/a", GfVec3d(0.0, 0.0, 0.0));
+  defineUnitCube(stage, "/b", GfVec3d(10.0, 0.0, 0.0));
+
+  BoundingBoxCache cache;
+  const GfRange3d first = cache.bound(stage->GetPseudoRoot(), UsdTimeCode(1.0), g_purposes);
+  EXPECT_TRUE(cache.isStatic());
+  EXPECT_EQ(GfRange3d(GfVec3d(-1.0, -1.0, -1.0), GfVec3d(11.0, 1.0, 1.0)), first);
+
+  for(double t = 2.0; t < 50.0; t += 1.0)
+  {
+    EXPECT_EQ(first, cache.bound(stage->GetPseudoRoot(), UsdTimeCode(t), g_purposes));
+  }
+  EXPECT_EQ(1u, cache.size());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TEST(BoundingBoxCache, animatedSubtree)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  defineUnitCube(stage, "/static", GfVec3d(0.0, 0.0, 0.0));
+  UsdGeomXform xform = UsdGeomXform::Define(stage, SdfPath("/animated"));
+  defineUnitCube(stage, "/animated/cube", GfVec3d(0.0, 0.0, 0.0));
+  UsdGeomXformCommonAPI api(xform);
+  api.SetTranslate(GfVec3d(0.0, 0.0, 0.0), UsdTimeCode(0.0));
+  api.SetTranslate(GfVec3d(0.0, 10.0, 0.0), UsdTimeCode(10.0));
+
+  BoundingBoxCache cache;
+  const UsdPrim root = stage->GetPseudoRoot();
+  EXPECT_EQ(GfRange3d(GfVec3d(-1.0, -1.0, -1.0), GfVec3d(1.0, 1.0, 1.0)), cache.bound(root, UsdTimeCode(0.0), g_purposes));
+  EXPECT_FALSE(cache.isStatic());
+  EXPECT_EQ(GfRange3d(GfVec3d(-1.0, -1.0, -1.0), GfVec3d(1.0, 6.0, 1.0)), cache.bound(root, UsdTimeCode(5.0), g_purposes));
+  EXPECT_EQ(GfRange3d(GfVec3d(-1.0, -1.0, -1.0), GfVec3d(1.0, 11.0, 1.0)), cache.bound(root, UsdTimeCode(10.0), g_purposes));
+
+  // out of order queries are returned from the sorted samples
+  EXPECT_EQ(GfRange3d(GfVec3d(-1.0, -1.0, -1.0), GfVec3d(1.0, 6.0, 1.0)), cache.bound(root, UsdTimeCode(5.0), g_purposes));
+  EXPECT_EQ(3u, cache.size());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TEST(BoundingBoxCache, invalidateSubtree)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  defineUnitCube(stage, "/a", GfVec3d(0.0, 0.0, 0.0));
+  UsdGeomCube b = defineUnitCube(stage, "/b", GfVec3d(0.0, 0.0, 0.0));
+
+  BoundingBoxCache cache;
+  const UsdPrim root = stage->GetPseudoRoot();
+  EXPECT_EQ(GfRange3d(GfVec3d(-1.0, -1.0, -1.0), GfVec3d(1.0, 1.0, 1.0)), cache.bound(root, UsdTimeCode(1.0), g_purposes));
+
+  // without invalidation, the stale bound is returned
+  UsdGeomXformCommonAPI(b).SetTranslate(GfVec3d(0.0, 0.0, 5.0));
+  EXPECT_EQ(GfRange3d(GfVec3d(-1.0, -1.0, -1.0), GfVec3d(1.0, 1.0, 1.0)), cache.bound(root, UsdTimeCode(1.0), g_purposes));
+
+  cache.invalidate(SdfPath("/b.xformOp:translate"));
+  EXPECT_EQ(GfRange3d(GfVec3d(-1.0, -1.0, -1.0), GfVec3d(1.0, 1.0, 6.0)), cache.bound(root, UsdTimeCode(1.0), g_purposes));
+
+  // animating the subtree moves it out of the static case
+  UsdGeomXformCommonAPI(b).SetTranslate(GfVec3d(0.0, 0.0, 0.0), UsdTimeCode(0.0));
+  UsdGeomXformCommonAPI(b).SetTranslate(GfVec3d(0.0, 0.0, 10.0), UsdTimeCode(10.0));
+  cache.invalidate(SdfPath("/b.xformOp:translate"));
+  EXPECT_EQ(GfRange3d(GfVec3d(-1.0, -1.0, -1.0), GfVec3d(1.0, 1.0, 11.0)), cache.bound(root, UsdTimeCode(10.0), g_purposes));
+  EXPECT_FALSE(cache.isStatic());
+
+  // a new child of the root is picked up
+  defineUnitCube(stage, "/c", GfVec3d(-10.0, 0.0, 0.0));
+  cache.invalidate(SdfPath("/c"));
+  EXPECT_EQ(GfRange3d(GfVec3d(-11.0, -1.0, -1.0), GfVec3d(1.0, 1.0, 11.0)), cache.bound(root, UsdTimeCode(10.0), g_purposes));
+
+  // changes outside of the root are ignored
+  BoundingBoxCache subCache;
+  const UsdPrim a = stage->GetPrimAtPath(SdfPath("/a"));
+  EXPECT_EQ(GfRange3d(GfVec3d(-1.0, -1.0, -1.0), GfVec3d(1.0, 1.0, 1.0)), subCache.bound(a, UsdTimeCode(1.0), g_purposes));
+  subCache.invalidate(SdfPath("/b"));
+  EXPECT_TRUE(subCache.isStatic());
+  EXPECT_EQ(1u, subCache.size());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TEST(BoundingBoxCache, invalidateMaster)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdGeomCube cube = defineUnitCube(stage, "/proto/cube", GfVec3d(0.0, 0.0, 0.0));
+  UsdGeomXform::Define(stage, SdfPath("/world"));
+  const char* const instancePaths[] = { "/world/a", "/world/b" };
+  for(const char* instancePath : instancePaths)
+  {
+    UsdGeomXform instance = UsdGeomXform::Define(stage, SdfPath(instancePath));
+    instance.GetPrim().GetReferences().AddInternalReference(SdfPath("/proto"));
+    instance.GetPrim().SetInstanceable(true);
+  }
+  UsdGeomXformCommonAPI(stage->GetPrimAtPath(SdfPath("/world/b"))).SetTranslate(GfVec3d(10.0, 0.0, 0.0));
+  ASSERT_EQ(1u, stage->GetMasters().size());
+  const SdfPath masterCubePath = stage->GetMasters()[0].GetPath().AppendChild(TfToken("cube"));
+
+  BoundingBoxCache cache;
+  const UsdPrim world = stage->GetPrimAtPath(SdfPath("/world"));
+  EXPECT_EQ(GfRange3d(GfVec3d(-1.0, -1.0, -1.0), GfVec3d(11.0, 1.0, 1.0)), cache.bound(world, UsdTimeCode(1.0), g_purposes));
+
+  // the change is reported against the master, which is outside of the root, but moves every instance
+  UsdGeomXformCommonAPI(cube).SetTranslate(GfVec3d(0.0, 5.0, 0.0));
+  cache.invalidate(masterCubePath.AppendProperty(TfToken("xformOp:translate")));
+  EXPECT_EQ(GfRange3d(GfVec3d(-1.0, 4.0, -1.0), GfVec3d(11.0, 6.0, 1.0)), cache.bound(world, UsdTimeCode(1.0), g_purposes));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TEST(BoundingBoxCache, animatedRootVisibility)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdGeomXform world = UsdGeomXform::Define(stage, SdfPath("/world"));
+  defineUnitCube(stage, "/world/cube", GfVec3d(0.0, 0.0, 0.0));
+  UsdAttribute visibility = world.CreateVisibilityAttr();
+  visibility.Set(UsdGeomTokens->invisible, UsdTimeCode(0.0));
+  visibility.Set(UsdGeomTokens->inherited, UsdTimeCode(10.0));
+
+  BoundingBoxCache cache;
+  EXPECT_TRUE(cache.bound(world.GetPrim(), UsdTimeCode(0.0), g_purposes).IsEmpty());
+  EXPECT_FALSE(cache.isStatic());
+  EXPECT_EQ(GfRange3d(GfVec3d(-1.0, -1.0, -1.0), GfVec3d(1.0, 1.0, 1.0)), cache.bound(world.GetPrim(), UsdTimeCode(10.0), g_purposes));
+  EXPECT_EQ(2u, cache.size());
+}
@@ -32,11 +32,29 @@
 #include "pxr/usd/usd/attribute.h"
 #include "pxr/usd/usdGeom/xform.h"
 #include "pxr/usd/usdGeom/xformCommonAPI.h"
+#include "pxr/usd/usd/notice.h"
+#include "pxr/usd/sdf/changeBlock.h"
+#include "pxr/base/tf/weakBase.h"
 
 #include <fstream>
 
 using AL::maya::test::buildTempPath;
 
+namespace
+{
+struct ObjectsChangedCounter : public TfWeakBase
+{
+  ObjectsChangedCounter(const UsdStageRefPtr& stage)
+    { m_key = TfNotice::Register(TfWeakPtr<ObjectsChangedCounter>(this), &ObjectsChangedCounter::onObjectsChanged, stage); }
+  ~ObjectsChangedCounter()
+    { TfNotice::Revoke(m_key); }
+  void onObjectsChanged(const UsdNotice::ObjectsChanged&, const UsdStageWeakPtr&)
+    { ++m_count; }
+  TfNotice::Key m_key;
+  int m_count = 0;
+};
+}
+
 
 static const char* const g_drivenData =
 "#usda 1.0\n"
@@ -228,3 +246,69 @@ TEST(ProxyShape, DrivenTransforms)
 
   }
 }
+
+TEST(ProxyShape, DrivenTransformsBatchedUpdate)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  const uint32_t numPrims = 1000;
+  SdfPathVector drivenPaths;
+  for(uint32_t i = 0; i < numPrims; ++i)
+  {
+    drivenPaths.emplace_back("/xform" + std::to_string(i));
+    UsdGeomXform::Define(stage, drivenPaths.back());
+  }
+
+  AL::usdmaya::nodes::proxy::DrivenTransforms dt;
+  dt.resizeDrivenTransforms(numPrims);
+  dt.setDrivenPrimPaths(drivenPaths);
+
+  const MTime time(5.0, MTime::uiUnit());
+  for(int pass = 0; pass < 2; ++pass)
+  {
+    for(uint32_t i = 0; i < numPrims; ++i)
+    {
+      MMatrix matrixValue = MMatrix::identity;
+      matrixValue[3][0] = double(i + pass);
+      dt.dirtyMatrix(i, matrixValue);
+      dt.dirtyVisibility(i, (i & 1) != 0);
+    }
+
+    // the first pass resolves (and creates) the attributes, the second only writes the values
+    EXPECT_TRUE(dt.prepare(stage));
+    ObjectsChangedCounter counter(stage);
+    {
+      SdfChangeBlock changeBlock;
+      dt.write(time);
+    }
+    EXPECT_EQ(1, counter.m_count);
+    EXPECT_TRUE(dt.dirtyMatrices().empty());
+    EXPECT_TRUE(dt.dirtyVisibilities().empty());
+
+    for(uint32_t i = 0; i < numPrims; ++i)
+    {
+      UsdGeomXform xform(stage->GetPrimAtPath(drivenPaths[i]));
+      bool resetsXformStack;
+      std::vector<UsdGeomXformOp> ops = xform.GetOrderedXformOps(&resetsXformStack);
+      ASSERT_EQ(1u, ops.size());
+      EXPECT_TRUE(ops[0].GetOpType() == UsdGeomXformOp::TypeTransform);
+      GfMatrix4d matrix;
+      ops[0].Get(&matrix, 5.0);
+      EXPECT_EQ(double(i + pass), matrix[3][0]);
+
+      TfToken visibility;
+      xform.GetVisibilityAttr().Get(&visibility, 5.0);
+      EXPECT_TRUE(((i & 1) ? UsdGeomTokens->inherited : UsdGeomTokens->invisible) == visibility);
+    }
+  }
+
+  // a prim that has been removed is reported, and the remaining prims are still written
+  stage->RemovePrim(drivenPaths[0]);
+  dt.dirtyMatrix(0, MMatrix::identity);
+  dt.dirtyMatrix(1, MMatrix::identity);
+  EXPECT_FALSE(dt.update(stage, time));
+  bool resetsXformStack;
+  GfMatrix4d matrix;
+  UsdGeomXformOp op = UsdGeomXform(stage->GetPrimAtPath(drivenPaths[1])).GetOrderedXformOps(&resetsXformStack)[0];
+  op.Get(&matrix, 5.0);
+  EXPECT_EQ(GfMatrix4d(1.0), matrix);
+}
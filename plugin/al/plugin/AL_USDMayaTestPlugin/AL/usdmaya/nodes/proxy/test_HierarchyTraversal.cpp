@@ -0,0 +1,125 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "test_usdmaya.h"
+#include "AL/usdmaya/nodes/ProxyShape.h"
+#include "AL/usdmaya/nodes/proxy/HierarchyTraversal.h"
+#include "AL/usdmaya/fileio/TransformIterator.h"
+
+#include "pxr/usd/usd/stage.h"
+#include "pxr/usd/usd/references.h"
+#include "pxr/usd/usdGeom/xform.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+namespace {
+
+UsdStageRefPtr constructInstancedStage()
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdGeomXform::Define(stage, SdfPath("/proto"));
+  UsdGeomXform::Define(stage, SdfPath("/proto/child"));
+  for(int i = 0; i < 20; ++i)
+  {
+    const std::string group = "/root/group" + std::to_string(i);
+    for(int j = 0; j < 20; ++j)
+    {
+      UsdGeomXform::Define(stage, SdfPath(group + "/xform" + std::to_string(j)));
+    }
+    UsdPrim instance = stage->DefinePrim(SdfPath(group + "/instance"));
+    instance.GetReferences().AddInternalReference(SdfPath("/proto"));
+    instance.SetInstanceable(true);
+  }
+  return stage;
+}
+
+}
+
+using AL::usdmaya::nodes::HierarchyIterationLogic;
+
+//----------------------------------------------------------------------------------------------------------------------
+// the parallel traversal should visit the same prims as a TransformIterator, but only visit each master once
+TEST(HierarchyTraversal, matchesTransformIterator)
+{
+  UsdStageRefPtr stage = constructInstancedStage();
+
+  SdfPathVector serialPaths;
+  HierarchyIterationLogic serial;
+  serial.iteration = [&serialPaths](const AL::usdmaya::fileio::TransformIterator&, const UsdPrim& prim)
+    { serialPaths.push_back(prim.GetPath()); };
+
+  std::atomic<int> masterVisits(0);
+  SdfPathVector parallelPaths;
+  HierarchyIterationLogic parallel;
+  parallel.numPathLists = 1;
+  parallel.parallelIteration = [&masterVisits](const UsdPrim& prim, SdfPathVector* pathLists)
+    {
+      pathLists[0].push_back(prim.GetPath());
+      if(prim.IsInMaster())
+      {
+        ++masterVisits;
+      }
+    };
+  parallel.mergePathLists = [&parallelPaths](std::vector<SdfPathVector>& pathLists)
+    { parallelPaths.swap(pathLists[0]); };
+
+  const HierarchyIterationLogic* logics[] = { &serial, &parallel };
+  AL::usdmaya::nodes::proxy::traverseHierarchy(stage->GetPseudoRoot(), logics, 2);
+
+  // the serial walk visits the master once per instance
+  std::sort(serialPaths.begin(), serialPaths.end());
+  serialPaths.erase(std::unique(serialPaths.begin(), serialPaths.end()), serialPaths.end());
+
+  EXPECT_FALSE(parallelPaths.empty());
+  EXPECT_TRUE(std::is_sorted(parallelPaths.begin(), parallelPaths.end()));
+  EXPECT_EQ(serialPaths, parallelPaths);
+  EXPECT_EQ(1, masterVisits);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// starting from a prim should visit that prim and its descendants, and the pre/merge/post methods run in order
+TEST(HierarchyTraversal, fromPrim)
+{
+  UsdStageRefPtr stage = constructInstancedStage();
+
+  std::string calls;
+  SdfPathVector paths;
+  HierarchyIterationLogic logic;
+  logic.preIteration = [&calls]() { calls += "pre "; };
+  logic.postIteration = [&calls]() { calls += "post"; };
+  logic.numPathLists = 2;
+  logic.parallelIteration = [](const UsdPrim& prim, SdfPathVector* pathLists)
+    { pathLists[prim.IsInMaster() ? 1 : 0].push_back(prim.GetPath()); };
+  logic.mergePathLists = [&calls, &paths](std::vector<SdfPathVector>& pathLists)
+    {
+      calls += "merge ";
+      EXPECT_EQ(2u, pathLists.size());
+      EXPECT_EQ(1u, pathLists[1].size());
+      paths.swap(pathLists[0]);
+    };
+
+  const HierarchyIterationLogic* logics[] = { &logic };
+  AL::usdmaya::nodes::proxy::traverseHierarchy(stage->GetPrimAtPath(SdfPath("/root/group3")), logics, 1);
+
+  EXPECT_EQ(std::string("pre merge post"), calls);
+  ASSERT_EQ(22u, paths.size());
+  EXPECT_EQ(SdfPath("/root/group3"), paths[0]);
+  for(const SdfPath& path : paths)
+  {
+    EXPECT_TRUE(path.HasPrefix(SdfPath("/root/group3")));
+  }
+}
@@ -33,7 +33,12 @@
 #include "pxr/usd/usdGeom/xform.h"
 #include "pxr/usd/usdGeom/xformCommonAPI.h"
 
+#include "pxr/usd/sdf/changeBlock.h"
+#include "pxr/usd/sdf/primSpec.h"
+
+#include <chrono>
 #include <fstream>
+#include <unordered_map>
 
 using AL::maya::test::buildTempPath;
 
@@ -267,3 +272,84 @@ TEST(PrimFilter, removedPaths)
   }
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Filters a variant switch that swaps half of 50k prims beneath a set for new ones, and reports the time taken.
+//----------------------------------------------------------------------------------------------------------------------
+TEST(PrimFilter, largeVariantSwitchBenchmark)
+{
+  struct TypeMapPrimFilterInterface : public AL::usdmaya::nodes::proxy::PrimFilterInterface
+  {
+    std::unordered_map<SdfPath, TfToken, SdfPath::Hash> types;
+    int typeInfoQueries = 0;
+
+    TfToken getTypeForPath(const SdfPath& path) override
+    {
+      auto it = types.find(path);
+      return it != types.end() ? it->second : TfToken();
+    }
+
+    bool getTypeInfo(TfToken type, bool& supportsUpdate, bool& requiresParent) override
+    {
+      ++typeInfoQueries;
+      supportsUpdate = true;
+      requiresParent = true;
+      return true;
+    }
+  };
+
+  const int numPrims = 50000;
+  const int primsPerGroup = 100;
+  const TfToken xformType("Xform");
+  auto groupPath = [](int i) { return "/set/group" + std::to_string(i / primsPerGroup); };
+
+  // every other prim keeps its path through the switch, the rest are replaced by prims with new names
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  SdfPathVector previous;
+  previous.reserve(numPrims);
+  TypeMapPrimFilterInterface mockInterface;
+  {
+    SdfLayerHandle layer = stage->GetRootLayer();
+    SdfChangeBlock changeBlock;
+    for(int i = 0; i < numPrims; ++i)
+    {
+      SdfPath path(groupPath(i) + "/item" + std::to_string(i));
+      SdfPrimSpecHandle spec = SdfCreatePrimInLayer(layer, path);
+      spec->SetSpecifier(SdfSpecifierDef);
+      spec->SetTypeName(xformType);
+
+      SdfPath previousPath = (i & 1) ? SdfPath(groupPath(i) + "/old" + std::to_string(i)) : path;
+      previous.push_back(previousPath);
+      mockInterface.types[previousPath] = xformType;
+    }
+  }
+
+  std::vector<UsdPrim> prims;
+  prims.reserve(numPrims);
+  for(int i = 0; i < numPrims; ++i)
+  {
+    prims.emplace_back(stage->GetPrimAtPath(SdfPath(groupPath(i) + "/item" + std::to_string(i))));
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  AL::usdmaya::nodes::proxy::PrimFilter filter(previous, prims, &mockInterface);
+  auto filtered = std::chrono::high_resolution_clock::now();
+
+  std::cout << "PrimFilter variant switch of " << numPrims << " prims: "
+            << std::chrono::duration<double, std::milli>(filtered - start).count() << "ms" << std::endl;
+
+  EXPECT_EQ(size_t(numPrims / 2), filter.updatablePrimSet().size());
+  EXPECT_EQ(size_t(numPrims / 2), filter.newPrimSet().size());
+  EXPECT_EQ(size_t(numPrims / 2), filter.transformsToCreate().size());
+  ASSERT_EQ(size_t(numPrims / 2), filter.removedPrimSet().size());
+  EXPECT_EQ(1, mockInterface.typeInfoQueries);
+
+  // the removed prims are still reverse sorted, and are the ones that were replaced
+  for(size_t i = 1; i < filter.removedPrimSet().size(); ++i)
+  {
+    EXPECT_TRUE(filter.removedPrimSet()[i] < filter.removedPrimSet()[i - 1]);
+  }
+  for(const SdfPath& path : filter.removedPrimSet())
+  {
+    EXPECT_EQ(0u, path.GetName().find("old"));
+  }
+}
@@ -29,6 +29,9 @@
 #include "pxr/usd/usd/usdaFileFormat.h"
 #include "pxr/usd/usdGeom/tokens.h"
 
+#include <chrono>
+#include <iostream>
+
 using AL::maya::test::buildTempPath;
 
 // Utilities -----------------------------------------------------------------------------------------------------------
@@ -558,3 +561,80 @@ TEST(LayerManager, simpleSaveRestore)
 //    confirmLayerEditsPresent();
 //  }
 }
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Saves and restores a large layer through the serialisation attributes as usda text, and as binary crate
+///         data. Checks that the content round trips in both modes, and reports the time taken and storage used.
+//----------------------------------------------------------------------------------------------------------------------
+TEST(LayerManager, binarySerialisationBenchmark)
+{
+  MFileIO::newFile(true);
+  MStatus status;
+
+  auto *manager = AL::usdmaya::nodes::LayerManager::findOrCreateManager();
+  ASSERT_TRUE(manager);
+
+  // build a layer with a decent amount of array and time sampled data in it
+  auto layer = SdfLayer::New(SdfFileFormat::FindById(UsdUsdaFileFormatTokens->Id), "/my/big/layer.usda");
+  {
+    UsdStageRefPtr stage = UsdStage::Open(layer);
+    VtArray<float> values(256);
+    for(int i = 0; i < 2000; ++i)
+    {
+      UsdPrim prim = stage->DefinePrim(SdfPath("/prim" + std::to_string(i)));
+      UsdAttribute attr = prim.CreateAttribute(TfToken("values"), SdfValueTypeNames->FloatArray);
+      for(int t = 0; t < 10; ++t)
+      {
+        for(size_t j = 0; j < values.size(); ++j)
+        {
+          values[j] = float(i * t) + float(j) * 0.25f;
+        }
+        attr.Set(values, UsdTimeCode(t));
+      }
+    }
+  }
+  std::string original;
+  layer->ExportToString(&original);
+  ASSERT_TRUE(manager->addLayer(layer));
+
+  auto serializedLength = [&] () {
+    MPlug layersPlug0 = manager->layersPlug().elementByPhysicalIndex(0, &status);
+    MObject tempNonConst = manager->serialized();
+    return layersPlug0.child(tempNonConst).asString(MDGContext::fsNormal, &status).length();
+  };
+
+  for(int binary = 0; binary < 2; ++binary)
+  {
+    MGlobal::setOptionVarValue("AL_usdmaya_binaryLayerSerialisation", binary);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(manager->populateSerialisationAttributes());
+    auto populated = std::chrono::high_resolution_clock::now();
+    // nothing has changed, so this should reuse the previous encoding
+    ASSERT_TRUE(manager->populateSerialisationAttributes());
+    auto repopulated = std::chrono::high_resolution_clock::now();
+    const unsigned int length = serializedLength();
+    manager->loadAllLayers();
+    auto loaded = std::chrono::high_resolution_clock::now();
+
+    std::cout << (binary ? "binary" : "usda") << " layer serialisation: " << length << " chars, save "
+              << std::chrono::duration<double, std::milli>(populated - start).count() << "ms, unchanged save "
+              << std::chrono::duration<double, std::milli>(repopulated - populated).count() << "ms, load "
+              << std::chrono::duration<double, std::milli>(loaded - repopulated).count() << "ms" << std::endl;
+
+    std::string restored;
+    layer->ExportToString(&restored);
+    EXPECT_EQ(original, restored);
+    ASSERT_TRUE(manager->clearSerialisationAttributes());
+  }
+
+  // an edit after the last save must be picked up by the next one
+  layer->GetPrimAtPath(SdfPath("/prim0"))->SetDocumentation("edited");
+  ASSERT_TRUE(manager->populateSerialisationAttributes());
+  layer->GetPrimAtPath(SdfPath("/prim0"))->SetDocumentation("");
+  manager->loadAllLayers();
+  EXPECT_EQ(std::string("edited"), layer->GetPrimAtPath(SdfPath("/prim0"))->GetDocumentation());
+
+  MGlobal::setOptionVarValue("AL_usdmaya_binaryLayerSerialisation", 0);
+  ASSERT_TRUE(manager->clearSerialisationAttributes());
+}
@@ -0,0 +1,133 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "test_usdmaya.h"
+#include "AL/usdmaya/nodes/MeshAnimSampleCache.h"
+
+#include "pxr/usd/usd/stage.h"
+#include "pxr/usd/usdGeom/mesh.h"
+
+using AL::usdmaya::nodes::MeshAnimSampleCache;
+
+namespace
+{
+//----------------------------------------------------------------------------------------------------------------------
+// creates a mesh with 4 points, which are all set to (t, 2t, 3t) at every 10th frame in [0, 100]
+UsdAttribute createAnimatedPoints(UsdStageRefPtr stage)
+{
+  UsdGeomMesh mesh = UsdGeomMesh::Define(stage, SdfPath("/mesh"));
+  UsdAttribute points = mesh.CreatePointsAttr();
+  for(int frame = 0; frame <= 100; frame += 10)
+  {
+    const float t = float(frame);
+    points.Set(VtVec3fArray(4, GfVec3f(t, 2.0f * t, 3.0f * t)), UsdTimeCode(frame));
+  }
+  return points;
+}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TEST(MeshAnimSampleCache, interpolation)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  MeshAnimSampleCache cache(2);
+  EXPECT_FALSE(cache.isAnimated());
+
+  float output[12];
+  EXPECT_EQ(0u, cache.evaluate(0.0, output, 4));
+
+  cache.reset(createAnimatedPoints(stage));
+  EXPECT_TRUE(cache.isAnimated());
+
+  // exactly on a sample
+  EXPECT_EQ(4u, cache.evaluate(20.0, output, 4));
+  EXPECT_FLOAT_EQ(20.0f, output[0]);
+  EXPECT_FLOAT_EQ(60.0f, output[11]);
+
+  // sub frames are linearly interpolated between the bracketing samples
+  EXPECT_EQ(4u, cache.evaluate(25.0, output, 4));
+  for(int i = 0; i < 4; ++i)
+  {
+    EXPECT_FLOAT_EQ(25.0f, output[i * 3 + 0]);
+    EXPECT_FLOAT_EQ(50.0f, output[i * 3 + 1]);
+    EXPECT_FLOAT_EQ(75.0f, output[i * 3 + 2]);
+  }
+
+  // times outside of the samples are clamped
+  cache.evaluate(-5.0, output, 4);
+  EXPECT_FLOAT_EQ(0.0f, output[0]);
+  cache.evaluate(150.0, output, 4);
+  EXPECT_FLOAT_EQ(100.0f, output[0]);
+
+  // the output buffer is never overrun
+  EXPECT_EQ(2u, cache.evaluate(50.0, output, 2));
+
+  // held interpolation uses the earlier sample
+  stage->SetInterpolationType(UsdInterpolationTypeHeld);
+  cache.reset(stage->GetAttributeAtPath(SdfPath("/mesh.points")));
+  cache.evaluate(25.0, output, 4);
+  EXPECT_FLOAT_EQ(20.0f, output[0]);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TEST(MeshAnimSampleCache, prefetchWindow)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  MeshAnimSampleCache cache(3);
+  cache.reset(createAnimatedPoints(stage));
+
+  float output[12];
+  cache.evaluate(15.0, output, 4);
+
+  // the bracketing samples (10, 20), plus the 3 samples that follow (30, 40, 50)
+  EXPECT_EQ(5u, cache.decodedSampleCount());
+
+  // moving the playhead discards the samples behind it
+  cache.evaluate(40.0, output, 4);
+  EXPECT_FLOAT_EQ(40.0f, output[0]);
+  EXPECT_EQ(4u, cache.decodedSampleCount());
+
+  // the cached samples are discarded when the attribute is reset
+  cache.clear();
+  EXPECT_EQ(0u, cache.decodedSampleCount());
+  EXPECT_FALSE(cache.isAnimated());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TEST(MeshAnimSampleCache, stageWritableAfterEvaluate)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  MeshAnimSampleCache cache(4);
+  UsdAttribute points = createAnimatedPoints(stage);
+  cache.reset(points);
+
+  // all of the decoding has completed by the time evaluate returns, so the stage can be modified straight away
+  float output[12];
+  cache.evaluate(0.0, output, 4);
+  EXPECT_EQ(5u, cache.decodedSampleCount());
+  for(int frame = 0; frame <= 100; frame += 10)
+  {
+    points.Set(VtVec3fArray(4, GfVec3f(-1.0f)), UsdTimeCode(frame));
+  }
+
+  // the cached samples are still the ones that were decoded
+  cache.evaluate(10.0, output, 4);
+  EXPECT_FLOAT_EQ(10.0f, output[0]);
+
+  // and the new values are read once the cache is reset
+  cache.reset(points);
+  cache.evaluate(10.0, output, 4);
+  EXPECT_FLOAT_EQ(-1.0f, output[0]);
+}
@@ -33,6 +33,7 @@
 #include "pxr/usd/usd/attribute.h"
 #include "pxr/usd/usd/stage.h"
 #include "pxr/usd/usd/usdaFileFormat.h"
+#include "pxr/usd/usdGeom/camera.h"
 #include "pxr/usd/usdGeom/xform.h"
 #include "pxr/usd/usdGeom/xformCommonAPI.h"
 
@@ -1097,7 +1098,52 @@ TEST(ProxyShape, boundingBox)
 // std::vector<UsdPrim> huntForNativeNodesUnderPrim(const MDagPath& proxyTransformPath, SdfPath startPath);
 TEST(ProxyShape, huntForNativeNodesUnderPrim)
 {
-  AL_USDMAYA_UNTESTED;
+  MFileIO::newFile(true);
+
+  // the prims are defined so that the order of a walk of the stage differs from the lexical order of their paths
+  const std::string temp_path = buildTempPath("AL_USDMayaTests_huntForNativeNodesUnderPrim.usda");
+  {
+    UsdStageRefPtr stage = UsdStage::CreateInMemory();
+    UsdGeomXform::Define(stage, SdfPath("/root"));
+    UsdGeomCamera::Define(stage, SdfPath("/root/zcam"));
+    UsdGeomXform::Define(stage, SdfPath("/root/mid"));
+    UsdGeomCamera::Define(stage, SdfPath("/root/mid/ccam"));
+    UsdGeomCamera::Define(stage, SdfPath("/root/mid/bcam"));
+    UsdGeomCamera::Define(stage, SdfPath("/root/acam"));
+    stage->Export(temp_path, false);
+  }
+
+  MFnDagNode fn;
+  MObject xform = fn.create("transform");
+  fn.create("AL_usdmaya_ProxyShape", xform);
+  AL::usdmaya::nodes::ProxyShape* proxy = (AL::usdmaya::nodes::ProxyShape*)fn.userNode();
+  proxy->filePathPlug().setString(temp_path.c_str());
+  ASSERT_TRUE(proxy->getUsdStage());
+
+  MDagPath proxyTransformPath;
+  MDagPath::getAPathTo(xform, proxyTransformPath);
+
+  auto paths = [proxy, &proxyTransformPath](const SdfPath& startPath)
+  {
+    SdfPathVector result;
+    for(const UsdPrim& prim : proxy->huntForNativeNodesUnderPrim(proxyTransformPath, startPath, proxy->translatorManufacture()))
+    {
+      result.push_back(prim.GetPath());
+    }
+    return result;
+  };
+
+  const SdfPathVector expected = {
+    SdfPath("/root/zcam"),
+    SdfPath("/root/mid/ccam"),
+    SdfPath("/root/mid/bcam"),
+    SdfPath("/root/acam")
+  };
+  EXPECT_EQ(expected, paths(SdfPath::AbsoluteRootPath()));
+  EXPECT_EQ(expected, paths(SdfPath("/root")));
+
+  const SdfPathVector expectedMid = { SdfPath("/root/mid/ccam"), SdfPath("/root/mid/bcam") };
+  EXPECT_EQ(expectedMid, paths(SdfPath("/root/mid")));
 }
 
 // void createSelectionChangedCallback();
@@ -1241,3 +1287,200 @@ TEST(ProxyShape, relativePathSupport)
 // inline UsdImagingGLHdEngine* engine() const
 // nodes::SchemaNodeRefDB& schemaDB()
 
+
+namespace {
+void onStageLoaded(void* userData, AL::event::NodeEvents*)
+{
+  ++*(int*)userData;
+}
+}
+
+TEST(ProxyShape, loadAsyncInBatchMode)
+{
+  MFileIO::newFile(true);
+
+  const std::string temp_path = buildTempPath("AL_USDMayaTests_loadAsyncInBatchMode.usda");
+  {
+    UsdStageRefPtr stage = UsdStage::CreateInMemory();
+    UsdGeomXform::Define(stage, SdfPath("/root"));
+    stage->Export(temp_path, false);
+  }
+
+  MFnDagNode fn;
+  MObject xform = fn.create("transform");
+  MObject shape = fn.create("AL_usdmaya_ProxyShape", xform);
+  AL::usdmaya::nodes::ProxyShape* proxy = (AL::usdmaya::nodes::ProxyShape*)fn.userNode();
+
+  int loadedCount = 0;
+  auto scheduler = proxy->scheduler();
+  auto callbackId = scheduler->registerCallback(proxy->getId("StageLoaded"), "loadAsyncInBatchMode", onStageLoaded, 10000, &loadedCount);
+
+  // there is no idle loop in batch mode, so the stage should still be opened synchronously
+  proxy->loadAsyncPlug().setBool(true);
+  proxy->filePathPlug().setString(temp_path.c_str());
+
+  auto stage = proxy->getUsdStage();
+  ASSERT_TRUE(stage);
+  EXPECT_FALSE(proxy->isStageLoading());
+  EXPECT_TRUE(stage->GetPrimAtPath(SdfPath("/root")));
+  EXPECT_EQ(1, loadedCount);
+
+  scheduler->unregisterCallback(callbackId);
+}
+
+namespace {
+std::string exportRootStage(const char* fileName, const char* primPath)
+{
+  const std::string temp_path = buildTempPath(fileName);
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdGeomXform::Define(stage, SdfPath(primPath));
+  stage->Export(temp_path, false);
+  return temp_path;
+}
+}
+
+TEST(ProxyShape, loadAsync)
+{
+  MFileIO::newFile(true);
+  AL::usdmaya::nodes::ProxyShape::enableAsyncStageLoadsInBatchMode(true);
+
+  const std::string temp_path = exportRootStage("AL_USDMayaTests_loadAsync.usda", "/root");
+
+  MFnDagNode fn;
+  MObject xform = fn.create("transform");
+  MObject shape = fn.create("AL_usdmaya_ProxyShape", xform);
+  AL::usdmaya::nodes::ProxyShape* proxy = (AL::usdmaya::nodes::ProxyShape*)fn.userNode();
+
+  int loadedCount = 0;
+  auto scheduler = proxy->scheduler();
+  auto callbackId = scheduler->registerCallback(proxy->getId("StageLoaded"), "loadAsync", onStageLoaded, 10000, &loadedCount);
+
+  proxy->loadAsyncPlug().setBool(true);
+  proxy->filePathPlug().setString(temp_path.c_str());
+
+  // the stage is not handed back to the proxy until the load is completed on the main thread
+  EXPECT_TRUE(proxy->isStageLoading());
+  EXPECT_FALSE(proxy->getUsdStage());
+  EXPECT_EQ(0, loadedCount);
+
+  // whilst loading, the proxy reports the placeholder bound
+  const MBoundingBox placeholder = AL::usdmaya::nodes::ProxyShape::placeholderBound();
+  const MBoundingBox bound = proxy->boundingBox();
+  EXPECT_TRUE(bound.min() == placeholder.min());
+  EXPECT_TRUE(bound.max() == placeholder.max());
+
+  AL::usdmaya::nodes::ProxyShape::waitForAsyncStageLoads();
+
+  auto stage = proxy->getUsdStage();
+  ASSERT_TRUE(stage);
+  EXPECT_FALSE(proxy->isStageLoading());
+  EXPECT_TRUE(stage->GetPrimAtPath(SdfPath("/root")));
+  EXPECT_EQ(1, loadedCount);
+
+  scheduler->unregisterCallback(callbackId);
+  AL::usdmaya::nodes::ProxyShape::enableAsyncStageLoadsInBatchMode(false);
+}
+
+TEST(ProxyShape, loadAsyncDiscardsStaleLoads)
+{
+  MFileIO::newFile(true);
+  AL::usdmaya::nodes::ProxyShape::enableAsyncStageLoadsInBatchMode(true);
+
+  const std::string first_path = exportRootStage("AL_USDMayaTests_loadAsyncStale1.usda", "/first");
+  const std::string second_path = exportRootStage("AL_USDMayaTests_loadAsyncStale2.usda", "/second");
+
+  MFnDagNode fn;
+  MObject xform = fn.create("transform");
+  MObject shape = fn.create("AL_usdmaya_ProxyShape", xform);
+  AL::usdmaya::nodes::ProxyShape* proxy = (AL::usdmaya::nodes::ProxyShape*)fn.userNode();
+
+  int loadedCount = 0;
+  auto scheduler = proxy->scheduler();
+  auto callbackId = scheduler->registerCallback(proxy->getId("StageLoaded"), "loadAsyncDiscardsStaleLoads", onStageLoaded, 10000, &loadedCount);
+
+  // the first load is superseded by the second before either has completed
+  proxy->loadAsyncPlug().setBool(true);
+  proxy->filePathPlug().setString(first_path.c_str());
+  proxy->filePathPlug().setString(second_path.c_str());
+  EXPECT_TRUE(proxy->isStageLoading());
+
+  AL::usdmaya::nodes::ProxyShape::waitForAsyncStageLoads();
+
+  auto stage = proxy->getUsdStage();
+  ASSERT_TRUE(stage);
+  EXPECT_FALSE(proxy->isStageLoading());
+  EXPECT_TRUE(stage->GetPrimAtPath(SdfPath("/second")));
+  EXPECT_FALSE(stage->GetPrimAtPath(SdfPath("/first")));
+  EXPECT_EQ(1, loadedCount);
+  scheduler->unregisterCallback(callbackId);
+
+  // a load whose proxy has been deleted is discarded
+  MFnDagNode fn2;
+  MObject xform2 = fn2.create("transform");
+  MObject shape2 = fn2.create("AL_usdmaya_ProxyShape", xform2);
+  AL::usdmaya::nodes::ProxyShape* proxy2 = (AL::usdmaya::nodes::ProxyShape*)fn2.userNode();
+  proxy2->loadAsyncPlug().setBool(true);
+  proxy2->filePathPlug().setString(first_path.c_str());
+  EXPECT_TRUE(proxy2->isStageLoading());
+
+  MDagModifier modifier;
+  EXPECT_EQ(MStatus(MS::kSuccess), modifier.deleteNode(xform2));
+  EXPECT_EQ(MStatus(MS::kSuccess), modifier.doIt());
+  AL::usdmaya::nodes::ProxyShape::waitForAsyncStageLoads();
+
+  AL::usdmaya::nodes::ProxyShape::enableAsyncStageLoadsInBatchMode(false);
+}
+
+TEST(ProxyShape, loadStagesWithDifferentResolverConfigs)
+{
+  MFileIO::newFile(true);
+
+  // The root layer sublayers "shared.usda" as a search path, which is found in the directory of the asset that the
+  // resolver of each proxy is configured for.
+  const std::string rootPath = buildTempPath("AL_USDMayaTests_loadStagesResolver/root.usda");
+  const std::string configPathA = buildTempPath("AL_USDMayaTests_loadStagesResolver/a/shared.usda");
+  const std::string configPathB = buildTempPath("AL_USDMayaTests_loadStagesResolver/b/shared.usda");
+  {
+    UsdStageRefPtr shared = UsdStage::CreateInMemory();
+    UsdGeomXform::Define(shared, SdfPath("/fromA"));
+    shared->Export(configPathA, false);
+  }
+  {
+    UsdStageRefPtr shared = UsdStage::CreateInMemory();
+    UsdGeomXform::Define(shared, SdfPath("/fromB"));
+    shared->Export(configPathB, false);
+  }
+  {
+    UsdStageRefPtr root = UsdStage::CreateInMemory();
+    root->GetRootLayer()->InsertSubLayerPath("shared.usda");
+    UsdGeomXform::Define(root, SdfPath("/root"));
+    root->Export(rootPath, false);
+  }
+
+  auto createProxy = [&rootPath](const std::string& config)
+  {
+    MFnDagNode fn;
+    MObject xform = fn.create("transform");
+    fn.create("AL_usdmaya_ProxyShape", xform);
+    AL::usdmaya::nodes::ProxyShape* proxy = (AL::usdmaya::nodes::ProxyShape*)fn.userNode();
+    proxy->assetResolverConfigPlug().setString(config.c_str());
+    proxy->filePathPlug().setString(rootPath.c_str());
+    return proxy;
+  };
+  AL::usdmaya::nodes::ProxyShape* proxyA = createProxy(configPathA);
+  AL::usdmaya::nodes::ProxyShape* proxyB = createProxy(configPathB);
+
+  AL::usdmaya::nodes::ProxyShape::loadStages({ proxyA, proxyB });
+
+  UsdStageRefPtr stageA = proxyA->getUsdStage();
+  UsdStageRefPtr stageB = proxyB->getUsdStage();
+  ASSERT_TRUE(stageA);
+  ASSERT_TRUE(stageB);
+  EXPECT_NE(stageA, stageB);
+  EXPECT_TRUE(stageA->GetPrimAtPath(SdfPath("/root")));
+  EXPECT_TRUE(stageA->GetPrimAtPath(SdfPath("/fromA")));
+  EXPECT_FALSE(stageA->GetPrimAtPath(SdfPath("/fromB")));
+  EXPECT_TRUE(stageB->GetPrimAtPath(SdfPath("/root")));
+  EXPECT_TRUE(stageB->GetPrimAtPath(SdfPath("/fromB")));
+  EXPECT_FALSE(stageB->GetPrimAtPath(SdfPath("/fromA")));
+}
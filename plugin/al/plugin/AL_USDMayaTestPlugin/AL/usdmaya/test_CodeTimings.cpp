@@ -0,0 +1,156 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "AL/usdmaya/CodeTimings.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using AL::usdmaya::Profiler;
+
+namespace {
+
+size_t countOccurrences(const std::string& str, const std::string& what)
+{
+  size_t count = 0;
+  for(size_t pos = str.find(what); pos != std::string::npos; pos = str.find(what, pos + what.size()))
+  {
+    ++count;
+  }
+  return count;
+}
+
+// adds up the number of runs of each section in a summary
+size_t sumCounts(const std::string& summary)
+{
+  size_t count = 0;
+  for(size_t pos = summary.find("n="); pos != std::string::npos; pos = summary.find("n=", pos + 2))
+  {
+    count += std::stoul(summary.substr(pos + 2));
+  }
+  return count;
+}
+
+void profiledWork(const int iterations)
+{
+  for(int i = 0; i < iterations; ++i)
+  {
+    AL_BEGIN_PROFILE_SECTION(TestCodeTimingsOuter);
+      AL_BEGIN_PROFILE_SECTION(TestCodeTimingsInner);
+      AL_END_PROFILE_SECTION();
+    AL_END_PROFILE_SECTION();
+  }
+}
+
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Sections recorded concurrently on several threads should all end up in the summary and the trace.
+TEST(CodeTimings, multipleThreads)
+{
+  Profiler::clearAll();
+
+  const int numThreads = 4;
+  const int iterations = 1000;
+  std::vector<std::thread> threads;
+  for(int i = 0; i < numThreads; ++i)
+  {
+    threads.emplace_back(profiledWork, iterations);
+  }
+  for(auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  std::ostringstream summary;
+  Profiler::printSummary(summary);
+  const std::string summaryText = summary.str();
+  const std::string expectedCount = "n=" + std::to_string(numThreads * iterations);
+  EXPECT_NE(std::string::npos, summaryText.find("TestCodeTimingsOuter"));
+  EXPECT_NE(std::string::npos, summaryText.find("TestCodeTimingsInner"));
+  EXPECT_EQ(2u, countOccurrences(summaryText, expectedCount));
+
+  std::ostringstream trace;
+  Profiler::writeChromeTrace(trace);
+  const std::string traceText = trace.str();
+  EXPECT_EQ(0u, traceText.find("{"));
+  EXPECT_EQ(size_t(numThreads * iterations), countOccurrences(traceText, "\"name\":\"TestCodeTimingsOuter\""));
+  EXPECT_EQ(size_t(numThreads * iterations), countOccurrences(traceText, "\"name\":\"TestCodeTimingsInner\""));
+
+  // the timings are only reported once, but are kept for the summary until they are cleared
+  std::ostringstream report;
+  Profiler::printReport(report);
+  EXPECT_NE(std::string::npos, report.str().find("TestCodeTimingsInner"));
+
+  std::ostringstream secondReport;
+  Profiler::printReport(secondReport);
+  EXPECT_EQ(std::string::npos, secondReport.str().find("TestCodeTimingsInner"));
+
+  std::ostringstream secondSummary;
+  Profiler::printSummary(secondSummary);
+  EXPECT_EQ(2u, countOccurrences(secondSummary.str(), expectedCount));
+
+  Profiler::clearAll();
+  std::ostringstream clearedSummary;
+  Profiler::printSummary(clearedSummary);
+  EXPECT_EQ(std::string::npos, clearedSummary.str().find("TestCodeTimingsOuter"));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Clearing the timings part way through a section should keep the sections it contains, as well as the section itself.
+TEST(CodeTimings, clearAllWithinSection)
+{
+  Profiler::clearAll();
+
+  AL_BEGIN_PROFILE_SECTION(TestCodeTimingsOpen);
+    profiledWork(1);
+    Profiler::clearAll();
+    profiledWork(1);
+  AL_END_PROFILE_SECTION();
+  profiledWork(1);
+
+  std::ostringstream summary;
+  Profiler::printSummary(summary);
+  const std::string summaryText = summary.str();
+  EXPECT_NE(std::string::npos, summaryText.find("TestCodeTimingsOpen"));
+  EXPECT_EQ(2u, countOccurrences(summaryText, "n=3"));
+
+  Profiler::clearAll();
+  std::ostringstream clearedSummary;
+  Profiler::printSummary(clearedSummary);
+  EXPECT_EQ(std::string::npos, clearedSummary.str().find("TestCodeTimings"));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Each thread only keeps its most recent sections, rather than growing without limit.
+TEST(CodeTimings, boundedBuffer)
+{
+  Profiler::clearAll();
+
+  // each iteration records two sections. The oldest block of 4096 sections may be partly overwritten.
+  const size_t maxSections = 64 * 4096;
+  profiledWork(int(maxSections));
+
+  std::ostringstream summary;
+  Profiler::printSummary(summary);
+  const size_t numSections = sumCounts(summary.str());
+  EXPECT_LE(numSections, maxSections);
+  EXPECT_GT(numSections, maxSections - 4096);
+
+  Profiler::clearAll();
+}
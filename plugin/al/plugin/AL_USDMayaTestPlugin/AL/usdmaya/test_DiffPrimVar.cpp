@@ -28,6 +28,8 @@
 #include "maya/MFloatPointArray.h"
 #include "maya/MFloatVectorArray.h"
 #include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
 
 using namespace AL::maya;
 using namespace AL::usdmaya;
@@ -1973,3 +1975,96 @@ TEST(DiffPrimVar, guessVec4InterpolationTypeExtensived)
 
 
 
+
+//----------------------------------------------------------------------------------------------------------------------
+// Builds a grid of quads with 8 UV sets (alternating between per-vertex and face varying), and reports the time taken to
+// classify them one at a time, and all together.
+TEST(DiffPrimVar, interpolationClassifierPerformance)
+{
+  const uint32_t side = 1415;
+  const uint32_t numFaces = (side - 1) * (side - 1);
+  const uint32_t numPoints = side * side;
+  MIntArray faceCounts(numFaces, 4);
+  MIntArray pointIndices(numFaces * 4);
+  for(uint32_t y = 0, f = 0; y < side - 1; ++y)
+  {
+    for(uint32_t x = 0; x < side - 1; ++x, ++f)
+    {
+      pointIndices[4 * f + 0] = y * side + x;
+      pointIndices[4 * f + 1] = y * side + x + 1;
+      pointIndices[4 * f + 2] = (y + 1) * side + x + 1;
+      pointIndices[4 * f + 3] = (y + 1) * side + x;
+    }
+  }
+
+  std::vector<AL::usdmaya::utils::UvSetInterpolation> uvSets(8);
+  for(uint32_t i = 0; i < uvSets.size(); ++i)
+  {
+    AL::usdmaya::utils::UvSetInterpolation& uvSet = uvSets[i];
+    if(i & 1)
+    {
+      // a unique UV for each face vertex
+      uvSet.uvIds.setLength(pointIndices.length());
+      uvSet.u.setLength(pointIndices.length());
+      uvSet.v.setLength(pointIndices.length());
+      for(uint32_t j = 0; j < pointIndices.length(); ++j)
+      {
+        uvSet.uvIds[j] = j;
+        uvSet.u[j] = float(j);
+        uvSet.v[j] = float(i);
+      }
+    }
+    else
+    {
+      // a UV for each vertex
+      uvSet.uvIds = pointIndices;
+      uvSet.u.setLength(numPoints);
+      uvSet.v.setLength(numPoints);
+      for(uint32_t j = 0; j < numPoints; ++j)
+      {
+        uvSet.u[j] = float(j % side) / side;
+        uvSet.v[j] = float(j / side) / side;
+      }
+    }
+    uvSet.uvCounts = faceCounts;
+  }
+
+  const auto start = std::chrono::high_resolution_clock::now();
+  for(AL::usdmaya::utils::UvSetInterpolation& uvSet : uvSets)
+  {
+    uvSet.interpolation = AL::usdmaya::utils::guessUVInterpolationTypeExtensive(
+        uvSet.u, uvSet.v, uvSet.uvIds, pointIndices, faceCounts, uvSet.indicesToExtract);
+  }
+  const auto sequential = std::chrono::high_resolution_clock::now();
+  for(uint32_t i = 0; i < uvSets.size(); ++i)
+  {
+    EXPECT_EQ((i & 1) ? UsdGeomTokens->faceVarying : UsdGeomTokens->vertex, uvSets[i].interpolation);
+    uvSets[i].interpolation = TfToken();
+  }
+
+  AL::usdmaya::utils::InterpolationClassifier classifier(pointIndices, faceCounts, numPoints);
+  classifier.classifyUvSets(uvSets);
+  const auto parallel = std::chrono::high_resolution_clock::now();
+
+  for(uint32_t i = 0; i < uvSets.size(); ++i)
+  {
+    if(i & 1)
+    {
+      EXPECT_EQ(UsdGeomTokens->faceVarying, uvSets[i].interpolation);
+    }
+    else
+    {
+      EXPECT_EQ(UsdGeomTokens->vertex, uvSets[i].interpolation);
+      bool extractsEachVertex = uvSets[i].indicesToExtract.size() == numPoints;
+      for(uint32_t j = 0; extractsEachVertex && j < numPoints; ++j)
+      {
+        extractsEachVertex = uvSets[i].indicesToExtract[j] == j;
+      }
+      EXPECT_TRUE(extractsEachVertex);
+    }
+  }
+
+  std::cout << "classified " << uvSets.size() << " UV sets on " << numFaces << " faces: "
+            << std::chrono::duration<double>(sequential - start).count() << "s sequentially, "
+            << std::chrono::duration<double>(parallel - sequential).count() << "s in parallel" << std::endl;
+}
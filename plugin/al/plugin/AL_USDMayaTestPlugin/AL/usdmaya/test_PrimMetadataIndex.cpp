@@ -0,0 +1,142 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <AL/usdmaya/PrimMetadataIndex.h>
+#include <AL/usdmaya/Metadata.h>
+#include <gtest/gtest.h>
+
+#include "pxr/base/tf/notice.h"
+#include "pxr/base/tf/weakBase.h"
+#include "pxr/base/tf/weakPtr.h"
+#include "pxr/usd/usd/stage.h"
+
+using namespace AL::usdmaya;
+
+TEST(PrimMetadataIndex, inheritedState)
+{
+  PrimMetadataIndex index;
+  index.setAuthoredFlags(SdfPath("/A/B"), PrimMetadataIndex::kUnselectable | PrimMetadataIndex::kLockTransform);
+  index.setAuthoredFlags(SdfPath("/A/B/C/D"), PrimMetadataIndex::kLockUnlocked);
+
+  EXPECT_FALSE(index.isUnselectable(SdfPath("/A")));
+  EXPECT_TRUE(index.isUnselectable(SdfPath("/A/B")));
+  EXPECT_TRUE(index.isUnselectable(SdfPath("/A/B/C/D/E")));
+  EXPECT_FALSE(index.isUnselectable(SdfPath("/A/X")));
+
+  EXPECT_FALSE(index.isLocked(SdfPath("/A")));
+  EXPECT_TRUE(index.isLocked(SdfPath("/A/B")));
+  EXPECT_TRUE(index.isLocked(SdfPath("/A/B/C")));
+  EXPECT_FALSE(index.isLocked(SdfPath("/A/B/C/D")));
+  EXPECT_FALSE(index.isLocked(SdfPath("/A/B/C/D/E")));
+
+  // clearing the parent's flags updates the state its descendants inherit
+  EXPECT_TRUE(index.setAuthoredFlags(SdfPath("/A/B"), 0, PrimMetadataIndex::kUnselectable));
+  EXPECT_FALSE(index.isUnselectable(SdfPath("/A/B/C/D/E")));
+  EXPECT_TRUE(index.isLocked(SdfPath("/A/B/C")));
+  EXPECT_FALSE(index.setAuthoredFlags(SdfPath("/A/B"), 0, PrimMetadataIndex::kUnselectable));
+
+  // a new lock above an existing entry is inherited by the prims between them
+  index.setAuthoredFlags(SdfPath("/Z/Y/X"), PrimMetadataIndex::kExcluded);
+  index.setAuthoredFlags(SdfPath("/Z"), PrimMetadataIndex::kLockTransform);
+  EXPECT_TRUE(index.isLocked(SdfPath("/Z/Y/X/W")));
+  EXPECT_TRUE(index.isExcluded(SdfPath("/Z/Y/X/W")));
+  EXPECT_FALSE(index.isExcluded(SdfPath("/Z/Y")));
+
+  const SdfPathVector locked = index.pathsWithAuthoredFlag(PrimMetadataIndex::kLockTransform);
+  ASSERT_EQ(2u, locked.size());
+  EXPECT_EQ(SdfPath("/A/B"), locked[0]);
+  EXPECT_EQ(SdfPath("/Z"), locked[1]);
+
+  EXPECT_EQ(uint32_t(PrimMetadataIndex::kExcluded), index.removeSubtree(SdfPath("/Z/Y")));
+  EXPECT_FALSE(index.isExcluded(SdfPath("/Z/Y/X")));
+  EXPECT_TRUE(index.isLocked(SdfPath("/Z/Y/X")));
+}
+
+TEST(PrimMetadataIndex, resetAuthoredFlag)
+{
+  PrimMetadataIndex index;
+  index.setAuthoredFlags(SdfPath("/A/B"), PrimMetadataIndex::kUnselectable | PrimMetadataIndex::kLockTransform);
+  index.setAuthoredFlags(SdfPath("/C/D"), PrimMetadataIndex::kUnselectable);
+
+  index.resetAuthoredFlag(PrimMetadataIndex::kUnselectable, SdfPathVector{SdfPath("/E")});
+  EXPECT_FALSE(index.isUnselectable(SdfPath("/A/B")));
+  EXPECT_FALSE(index.isUnselectable(SdfPath("/C/D")));
+  EXPECT_TRUE(index.isUnselectable(SdfPath("/E/F")));
+  EXPECT_TRUE(index.isLocked(SdfPath("/A/B/G")));
+
+  // the paths that no longer have any flags are discarded
+  EXPECT_EQ(0u, index.authoredFlags(SdfPath("/C/D")));
+  EXPECT_EQ(4u, index.size());
+}
+
+namespace {
+struct ObjectsChangedListener
+  : public TfWeakBase
+{
+  void onObjectsChanged(const UsdNotice::ObjectsChanged& notice, const UsdStageWeakPtr& sender)
+  {
+    changed |= index.update(sender, notice.GetResyncedPaths(), notice.GetChangedInfoOnlyPaths());
+  }
+
+  uint32_t takeChanged()
+  {
+    uint32_t result = changed;
+    changed = 0;
+    return result;
+  }
+
+  PrimMetadataIndex index;
+  uint32_t changed = 0;
+};
+}
+
+TEST(PrimMetadataIndex, update)
+{
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  ObjectsChangedListener listener;
+  TfWeakPtr<ObjectsChangedListener> me(&listener);
+  TfNotice::Key key = TfNotice::Register(me, &ObjectsChangedListener::onObjectsChanged, UsdStageWeakPtr(stage));
+  const PrimMetadataIndex& index = listener.index;
+
+  stage->DefinePrim(SdfPath("/A/B/C"));
+  stage->DefinePrim(SdfPath("/D/E"));
+  EXPECT_EQ(0u, listener.takeChanged());
+
+  stage->GetPrimAtPath(SdfPath("/A/B")).SetMetadata(Metadata::locked, Metadata::lockTransform);
+  EXPECT_EQ(uint32_t(PrimMetadataIndex::kLockTransform), listener.takeChanged());
+  EXPECT_TRUE(index.isLocked(SdfPath("/A/B/C")));
+
+  stage->GetPrimAtPath(SdfPath("/A/B/C")).SetMetadata(Metadata::selectability, Metadata::unselectable);
+  EXPECT_EQ(uint32_t(PrimMetadataIndex::kUnselectable), listener.takeChanged());
+  EXPECT_TRUE(index.isUnselectable(SdfPath("/A/B/C")));
+  EXPECT_FALSE(index.isUnselectable(SdfPath("/A/B")));
+
+  stage->GetPrimAtPath(SdfPath("/A/B")).SetMetadata(Metadata::locked, Metadata::lockUnlocked);
+  EXPECT_EQ(uint32_t(PrimMetadataIndex::kLockFlags), listener.takeChanged());
+  EXPECT_FALSE(index.isLocked(SdfPath("/A/B/C")));
+
+  // removing a prim discards the state recorded beneath it
+  stage->RemovePrim(SdfPath("/A/B/C"));
+  EXPECT_EQ(uint32_t(PrimMetadataIndex::kUnselectable), listener.takeChanged());
+  EXPECT_FALSE(index.isUnselectable(SdfPath("/A/B/C")));
+  EXPECT_EQ(uint32_t(PrimMetadataIndex::kLockUnlocked), index.authoredFlags(SdfPath("/A/B")));
+
+  stage->GetPrimAtPath(SdfPath("/D")).SetMetadata(Metadata::excludeFromProxyShape, true);
+  EXPECT_EQ(uint32_t(PrimMetadataIndex::kExcluded), listener.takeChanged());
+  EXPECT_TRUE(index.isExcluded(SdfPath("/D/E")));
+
+  TfNotice::Revoke(key);
+}
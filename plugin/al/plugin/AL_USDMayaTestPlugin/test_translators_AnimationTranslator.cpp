@@ -16,6 +16,7 @@
 #include "test_usdmaya.h"
 
 #include "AL/usdmaya/fileio/AnimationTranslator.h"
+#include "AL/usdmaya/fileio/ExportParams.h"
 
 #include "maya/MDGModifier.h"
 #include "maya/MDoubleArray.h"
@@ -24,10 +25,17 @@
 #include "maya/MFnTransform.h"
 #include "maya/MFnNurbsCurve.h"
 #include "maya/MFnExpression.h"
+#include "maya/MFnCompoundAttribute.h"
+#include "maya/MFnNumericAttribute.h"
 #include "maya/MGlobal.h"
 #include "maya/MPointArray.h"
 #include "maya/MSelectionList.h"
 
+#include "pxr/usd/sdf/types.h"
+
+#include <chrono>
+#include <iostream>
+
 using AL::usdmaya::fileio::AnimationTranslator;
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -472,6 +480,134 @@ TEST(translators_AnimationTranslator, isAnimatedTransform)
   mod.doIt();
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Registers (and re-registers) 100k element plugs with the animation translator, and exports a few frames of
+///         them. Checks that duplicates are rejected, and reports the time taken for each stage.
+//----------------------------------------------------------------------------------------------------------------------
+TEST(translators_AnimationTranslator, plugRegistryBenchmark)
+{
+  MFileIO::newFile(true);
+  MStatus status;
+  const uint32_t numPlugs = 100000;
 
+  MFnDependencyNode fn;
+  MObject node = fn.create("transform");
+  MFnNumericAttribute fnAttr;
+  MObject arrayAttr = fnAttr.create("benchValues", "bv", MFnNumericData::kDouble, 0.0, &status);
+  EXPECT_EQ(MStatus(MS::kSuccess), status);
+  fnAttr.setArray(true);
+  fnAttr.setUsesArrayDataBuilder(true);
+  EXPECT_EQ(MStatus(MS::kSuccess), fn.addAttribute(arrayAttr));
+
+  MPlug arrayPlug(node, arrayAttr);
+  std::vector<MPlug> plugs(numPlugs);
+  for(uint32_t i = 0; i < numPlugs; ++i)
+  {
+    plugs[i] = arrayPlug.elementByLogicalIndex(i);
+    plugs[i].setDouble(double(i));
+  }
+
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdPrim prim = stage->DefinePrim(SdfPath("/benchmark"));
+  std::vector<UsdAttribute> attributes(numPlugs);
+  for(uint32_t i = 0; i < numPlugs; ++i)
+  {
+    attributes[i] = prim.CreateAttribute(TfToken(std::string("value") + std::to_string(i)), SdfValueTypeNames->Double);
+  }
+
+  AnimationTranslator translator;
+  auto start = std::chrono::high_resolution_clock::now();
+  for(uint32_t i = 0; i < numPlugs; ++i)
+  {
+    translator.forceAddPlug(plugs[i], attributes[i]);
+  }
+  auto registered = std::chrono::high_resolution_clock::now();
+
+  // registering the same plugs again (via freshly constructed MPlugs) must not add any duplicates
+  for(uint32_t i = 0; i < numPlugs; ++i)
+  {
+    translator.forceAddPlug(arrayPlug.elementByLogicalIndex(i), attributes[(i + 1) % numPlugs]);
+  }
+  auto reregistered = std::chrono::high_resolution_clock::now();
+
+  AL::usdmaya::fileio::ExporterParams params;
+  params.m_minFrame = 1.0;
+  params.m_maxFrame = 3.0;
+  translator.exportAnimation(params);
+  auto exported = std::chrono::high_resolution_clock::now();
+
+  std::cout << "plug registry: register " << numPlugs << " plugs "
+            << std::chrono::duration<double, std::milli>(registered - start).count() << "ms, re-register "
+            << std::chrono::duration<double, std::milli>(reregistered - registered).count() << "ms, export 3 frames "
+            << std::chrono::duration<double, std::milli>(exported - reregistered).count() << "ms" << std::endl;
+
+  for(uint32_t i = 0; i < numPlugs; i += 9973)
+  {
+    EXPECT_EQ(3u, attributes[i].GetNumTimeSamples());
+    double value = -1.0;
+    EXPECT_TRUE(attributes[i].Get(&value, UsdTimeCode(2.0)));
+    EXPECT_EQ(plugs[i].asDouble(), value);
+    EXPECT_EQ(double(i), value);
+  }
+}
 
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Elements of nested arrays share their attribute and their innermost logical index, e.g. a[1].b[2] and
+///         a[3].b[2]. Checks that they are registered as separate plugs, and that each exports its own value.
+//----------------------------------------------------------------------------------------------------------------------
+TEST(translators_AnimationTranslator, nestedElementPlugs)
+{
+  MFileIO::newFile(true);
+  MStatus status;
 
+  MFnDependencyNode fn;
+  MObject node = fn.create("transform");
+  MFnNumericAttribute fnNumeric;
+  MObject innerAttr = fnNumeric.create("inner", "inr", MFnNumericData::kDouble, 0.0, &status);
+  EXPECT_EQ(MStatus(MS::kSuccess), status);
+  fnNumeric.setArray(true);
+  MFnCompoundAttribute fnCompound;
+  MObject outerAttr = fnCompound.create("outer", "otr", &status);
+  EXPECT_EQ(MStatus(MS::kSuccess), status);
+  fnCompound.addChild(innerAttr);
+  fnCompound.setArray(true);
+  EXPECT_EQ(MStatus(MS::kSuccess), fn.addAttribute(outerAttr));
+
+  auto nestedPlug = [&node, &outerAttr, &innerAttr](uint32_t outer, uint32_t inner)
+  {
+    MPlug outerPlug = MPlug(node, outerAttr).elementByLogicalIndex(outer);
+    return outerPlug.child(innerAttr).elementByLogicalIndex(inner);
+  };
+  MPlug plugA = nestedPlug(1, 2);
+  MPlug plugB = nestedPlug(3, 2);
+  plugA.setDouble(12.0);
+  plugB.setDouble(32.0);
+
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdPrim prim = stage->DefinePrim(SdfPath("/nested"));
+  UsdAttribute attrA = prim.CreateAttribute(TfToken("a"), SdfValueTypeNames->Double);
+  UsdAttribute attrB = prim.CreateAttribute(TfToken("b"), SdfValueTypeNames->Double);
+
+  AL::usdmaya::fileio::AnimatedPlugs animatedPlugs;
+  EXPECT_TRUE(animatedPlugs.insert(plugA, attrA));
+  EXPECT_TRUE(animatedPlugs.insert(plugB, attrB));
+  EXPECT_FALSE(animatedPlugs.insert(nestedPlug(1, 2), attrB));
+  EXPECT_FALSE(animatedPlugs.insert(nestedPlug(3, 2), attrA));
+  EXPECT_TRUE(animatedPlugs.contains(nestedPlug(3, 2)));
+  EXPECT_FALSE(animatedPlugs.contains(nestedPlug(2, 2)));
+  EXPECT_EQ(2u, animatedPlugs.size());
+
+  AnimationTranslator translator;
+  translator.forceAddPlug(plugA, attrA);
+  translator.forceAddPlug(plugB, attrB);
+  AL::usdmaya::fileio::ExporterParams params;
+  params.m_minFrame = 1.0;
+  params.m_maxFrame = 2.0;
+  translator.exportAnimation(params);
+
+  double value = -1.0;
+  EXPECT_TRUE(attrA.Get(&value, UsdTimeCode(1.0)));
+  EXPECT_EQ(plugA.asDouble(), value);
+  EXPECT_TRUE(attrB.Get(&value, UsdTimeCode(1.0)));
+  EXPECT_EQ(plugB.asDouble(), value);
+}
@@ -40,12 +40,16 @@
 #include "maya/MTime.h"
 #include "maya/MVector.h"
 
+#include "pxr/base/gf/matrix4d.h"
 #include "pxr/usd/sdf/types.h"
 #include "pxr/usd/usd/attribute.h"
 #include "pxr/usd/usdGeom/xform.h"
 #include "pxr/usd/usdGeom/xformCommonAPI.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstring>
+#include <iostream>
 
 using AL::usdmaya::fileio::ImporterParams;
 using AL::usdmaya::fileio::ExporterParams;
@@ -1811,3 +1815,222 @@ TEST(translators_DgNodeTranslator, dynamicAttributesTest)
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// Compares the time taken to copy large arrays in and out of dynamic attributes one element plug at a time (as the
+// helpers used to), against the bulk array data handle path now used by the helpers.
+TEST(translators_DgNodeTranslator, bulkArrayTimings)
+{
+  const uint32_t count = 100000;
+  const uint32_t flags = kCached | kReadable | kWritable | kStorable | kArray | kUsesArrayDataBuilder;
+  MFnDependencyNode fn;
+  MObject node = fn.create("transform");
+  MObject floatAttr, vec3Attr;
+  EXPECT_EQ(MStatus(MS::kSuccess), NodeHelper::addFloatAttr(node, "bulkFloatArray", "bfa", 0.0f, flags, &floatAttr));
+  EXPECT_EQ(MStatus(MS::kSuccess), NodeHelper::addVec3fAttr(node, "bulkVec3Array", "bva", flags, &vec3Attr));
+
+  std::vector<float> orig(count * 3), result(count * 3);
+  for(auto& value : orig)
+  {
+    value = randFloat();
+  }
+
+  typedef std::chrono::high_resolution_clock clock;
+  auto seconds = [](clock::time_point start) { return std::chrono::duration<double>(clock::now() - start).count(); };
+
+  // one plug per element
+  {
+    MPlug plug(node, floatAttr);
+    auto start = clock::now();
+    plug.setNumElements(count);
+    for(uint32_t i = 0; i < count; ++i)
+    {
+      plug.elementByLogicalIndex(i).setFloat(orig[i]);
+    }
+    const double setTime = seconds(start);
+    start = clock::now();
+    for(uint32_t i = 0; i < count; ++i)
+    {
+      result[i] = plug.elementByLogicalIndex(i).asFloat();
+    }
+    const double getTime = seconds(start);
+    std::cout << "float[" << count << "] per element plug: set " << setTime << "s, get " << getTime << "s" << std::endl;
+  }
+  {
+    MPlug plug(node, vec3Attr);
+    auto start = clock::now();
+    plug.setNumElements(count);
+    for(uint32_t i = 0; i < count; ++i)
+    {
+      MPlug element = plug.elementByLogicalIndex(i);
+      element.child(0).setFloat(orig[3 * i]);
+      element.child(1).setFloat(orig[3 * i + 1]);
+      element.child(2).setFloat(orig[3 * i + 2]);
+    }
+    const double setTime = seconds(start);
+    start = clock::now();
+    for(uint32_t i = 0; i < count; ++i)
+    {
+      MPlug element = plug.elementByLogicalIndex(i);
+      result[3 * i] = element.child(0).asFloat();
+      result[3 * i + 1] = element.child(1).asFloat();
+      result[3 * i + 2] = element.child(2).asFloat();
+    }
+    const double getTime = seconds(start);
+    std::cout << "float3[" << count << "] per element plug: set " << setTime << "s, get " << getTime << "s" << std::endl;
+  }
+
+  // the helpers, writing new values to make sure they do change
+  for(auto& value : orig)
+  {
+    value += 1.0f;
+  }
+  {
+    auto start = clock::now();
+    EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::setFloatArray(node, floatAttr, orig.data(), count));
+    const double setTime = seconds(start);
+    start = clock::now();
+    EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::getFloatArray(node, floatAttr, result.data(), count));
+    const double getTime = seconds(start);
+    std::cout << "float[" << count << "] DgNodeHelper: set " << setTime << "s, get " << getTime << "s" << std::endl;
+    EXPECT_TRUE(std::equal(orig.begin(), orig.begin() + count, result.begin()));
+
+    // the values must also be visible through the plugs
+    MPlug plug(node, floatAttr);
+    EXPECT_EQ(count, plug.numElements());
+    EXPECT_EQ(orig[count - 1], plug.elementByLogicalIndex(count - 1).asFloat());
+  }
+  {
+    auto start = clock::now();
+    EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::setVec3Array(node, vec3Attr, orig.data(), count));
+    const double setTime = seconds(start);
+    start = clock::now();
+    EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::getVec3Array(node, vec3Attr, result.data(), count));
+    const double getTime = seconds(start);
+    std::cout << "float3[" << count << "] DgNodeHelper: set " << setTime << "s, get " << getTime << "s" << std::endl;
+    EXPECT_TRUE(orig == result);
+
+    MPlug plug(node, vec3Attr);
+    EXPECT_EQ(orig[3 * count - 1], plug.elementByLogicalIndex(count - 1).child(2).asFloat());
+  }
+
+  MGlobal::deleteNode(node);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Array attributes imported from USD are created by addDynamicAttribute, so check the helpers against those (including
+// a matrix array), and against an array attribute that was not created to use an array data builder.
+TEST(translators_DgNodeTranslator, importedDynamicArrays)
+{
+  const uint32_t count = SIZE;
+  UsdStageRefPtr stage = UsdStage::CreateInMemory();
+  UsdPrim prim = UsdGeomXform::Define(stage, SdfPath("/imported")).GetPrim();
+
+  VtArray<float> floats(count);
+  VtArray<GfVec3f> vec3s(count);
+  VtArray<GfMatrix4d> matrices(count);
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    floats[i] = randFloat();
+    vec3s[i] = GfVec3f(randFloat(), randFloat(), randFloat());
+    for(uint32_t j = 0; j < 16; ++j)
+    {
+      matrices[i].data()[j] = randDouble();
+    }
+  }
+  UsdAttribute floatUsdAttr = prim.CreateAttribute(TfToken("importedFloats"), SdfValueTypeNames->FloatArray);
+  UsdAttribute vec3UsdAttr = prim.CreateAttribute(TfToken("importedVec3s"), SdfValueTypeNames->Float3Array);
+  UsdAttribute matrixUsdAttr = prim.CreateAttribute(TfToken("importedMatrices"), SdfValueTypeNames->Matrix4dArray);
+  floatUsdAttr.Set(floats);
+  vec3UsdAttr.Set(vec3s);
+  matrixUsdAttr.Set(matrices);
+
+  MFnDependencyNode fn;
+  MObject node = fn.create("transform");
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::addDynamicAttribute(node, floatUsdAttr));
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::addDynamicAttribute(node, vec3UsdAttr));
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::addDynamicAttribute(node, matrixUsdAttr));
+
+  MPlug floatPlug = fn.findPlug("importedFloats", true);
+  MPlug vec3Plug = fn.findPlug("importedVec3s", true);
+  MPlug matrixPlug = fn.findPlug("importedMatrices", true);
+  ASSERT_FALSE(floatPlug.isNull());
+  ASSERT_FALSE(vec3Plug.isNull());
+  ASSERT_FALSE(matrixPlug.isNull());
+  EXPECT_TRUE(MFnAttribute(floatPlug.attribute()).usesArrayDataBuilder());
+  EXPECT_TRUE(MFnAttribute(vec3Plug.attribute()).usesArrayDataBuilder());
+  EXPECT_TRUE(MFnAttribute(matrixPlug.attribute()).usesArrayDataBuilder());
+
+  auto matrixElement = [](const MPlug& plug, const uint32_t i)
+  {
+    return MFnMatrixData(plug.elementByLogicalIndex(i).asMObject()).matrix();
+  };
+
+  // the imported values must be visible through the plugs
+  EXPECT_EQ(count, floatPlug.numElements());
+  EXPECT_EQ(count, vec3Plug.numElements());
+  EXPECT_EQ(count, matrixPlug.numElements());
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    EXPECT_EQ(floats[i], floatPlug.elementByLogicalIndex(i).asFloat());
+    EXPECT_EQ(vec3s[i][2], vec3Plug.elementByLogicalIndex(i).child(2).asFloat());
+    EXPECT_EQ(matrices[i].data()[7], matrixElement(matrixPlug, i).matrix[1][3]);
+  }
+
+  // write new values through the helpers, and read them back through both the helpers and the plugs
+  std::vector<float> newFloats(count * 3), floatResult(count * 3);
+  std::vector<double> newMatrices(count * 16), matrixResult(count * 16);
+  for(auto& value : newFloats)
+  {
+    value = randFloat();
+  }
+  for(auto& value : newMatrices)
+  {
+    value = randDouble();
+  }
+  const MObject floatAttr = floatPlug.attribute();
+  const MObject vec3Attr = vec3Plug.attribute();
+  const MObject matrixAttr = matrixPlug.attribute();
+
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::setFloatArray(node, floatAttr, newFloats.data(), count));
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::getFloatArray(node, floatAttr, floatResult.data(), count));
+  EXPECT_TRUE(std::equal(newFloats.begin(), newFloats.begin() + count, floatResult.begin()));
+  EXPECT_EQ(newFloats[count - 1], MPlug(node, floatAttr).elementByLogicalIndex(count - 1).asFloat());
+
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::setVec3Array(node, vec3Attr, newFloats.data(), count));
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::getVec3Array(node, vec3Attr, floatResult.data(), count));
+  EXPECT_TRUE(newFloats == floatResult);
+  EXPECT_EQ(newFloats[3 * count - 1], MPlug(node, vec3Attr).elementByLogicalIndex(count - 1).child(2).asFloat());
+
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::setMatrix4x4Array(node, matrixAttr, newMatrices.data(), count));
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::getMatrix4x4Array(node, matrixAttr, matrixResult.data(), count));
+  EXPECT_TRUE(newMatrices == matrixResult);
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    const MMatrix m = matrixElement(MPlug(node, matrixAttr), i);
+    EXPECT_TRUE(std::equal(newMatrices.begin() + 16 * i, newMatrices.begin() + 16 * (i + 1), &m.matrix[0][0]));
+  }
+
+  // an array attribute without an array data builder falls back to setting its elements through their plugs
+  const uint32_t flags = kCached | kReadable | kWritable | kStorable | kArray;
+  MObject plainAttr, plainMatrixAttr;
+  EXPECT_EQ(MStatus(MS::kSuccess), NodeHelper::addFloatAttr(node, "plainFloats", "pfs", 0.0f, flags, &plainAttr));
+  EXPECT_EQ(MStatus(MS::kSuccess), NodeHelper::addMatrixAttr(node, "plainMatrices", "pms", MMatrix(), flags, &plainMatrixAttr));
+  EXPECT_FALSE(MFnAttribute(plainAttr).usesArrayDataBuilder());
+
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::setFloatArray(node, plainAttr, newFloats.data(), count));
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::getFloatArray(node, plainAttr, floatResult.data(), count));
+  EXPECT_TRUE(std::equal(newFloats.begin(), newFloats.begin() + count, floatResult.begin()));
+  EXPECT_EQ(newFloats[count - 1], MPlug(node, plainAttr).elementByLogicalIndex(count - 1).asFloat());
+
+  EXPECT_EQ(MStatus(MS::kSuccess), DgNodeTranslator::setMatrix4x4Array(node, plainMatrixAttr, newMatrices.data(), 4));
+  for(uint32_t i = 0; i < 4; ++i)
+  {
+    const MMatrix m = matrixElement(MPlug(node, plainMatrixAttr), i);
+    for(uint32_t j = 0; j < 16; ++j)
+    {
+      EXPECT_NEAR(newMatrices[16 * i + j], (&m.matrix[0][0])[j], 1e-5);
+    }
+  }
+
+  MGlobal::deleteNode(node);
+}
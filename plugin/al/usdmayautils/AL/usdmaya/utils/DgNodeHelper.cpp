@@ -30,6 +30,7 @@
 #include "maya/MFnMatrixArrayData.h"
 #include "maya/MMatrix.h"
 #include "maya/MFloatMatrix.h"
+#include "maya/MFnAttribute.h"
 #include "maya/MFnNumericAttribute.h"
 #include "maya/MFnMatrixAttribute.h"
 #include "maya/MFnTypedAttribute.h"
@@ -37,6 +38,10 @@
 #include "maya/MFnDoubleArrayData.h"
 #include "maya/MFnFloatArrayData.h"
 #include "maya/MFloatArray.h"
+#include "maya/MArrayDataHandle.h"
+#include "maya/MArrayDataBuilder.h"
+#include "maya/MDataHandle.h"
+#include "maya/MFnNumericData.h"
 
 #include <iostream>
 #include <unordered_map>
@@ -46,6 +51,357 @@ namespace AL {
 namespace usdmaya {
 namespace utils {
 
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Type traits used to read and write the numeric elements of array attributes through data handles. The
+///         matches method checks that the data type of the handle is the one the accessors expect, since (unlike plugs)
+///         data handles do not convert between types.
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+struct NumericElement;
+
+template<>
+struct NumericElement<bool>
+{
+  static bool matches(const MFnNumericData::Type t) { return t == MFnNumericData::kBoolean; }
+  static bool get(MDataHandle& h) { return h.asBool(); }
+  static void set(MDataHandle& h, const bool v) { h.setBool(v); }
+};
+
+template<>
+struct NumericElement<int8_t>
+{
+  static bool matches(const MFnNumericData::Type t) { return t == MFnNumericData::kByte || t == MFnNumericData::kChar; }
+  static int8_t get(MDataHandle& h) { return int8_t(h.asChar()); }
+  static void set(MDataHandle& h, const int8_t v) { h.setChar(char(v)); }
+};
+
+template<>
+struct NumericElement<int16_t>
+{
+  static bool matches(const MFnNumericData::Type t) { return t == MFnNumericData::kShort; }
+  static int16_t get(MDataHandle& h) { return h.asShort(); }
+  static void set(MDataHandle& h, const int16_t v) { h.setShort(v); }
+};
+
+template<>
+struct NumericElement<int32_t>
+{
+  static bool matches(const MFnNumericData::Type t) { return t == MFnNumericData::kInt; }
+  static int32_t get(MDataHandle& h) { return h.asInt(); }
+  static void set(MDataHandle& h, const int32_t v) { h.setInt(v); }
+};
+
+template<>
+struct NumericElement<int64_t>
+{
+  static bool matches(const MFnNumericData::Type t) { return t == MFnNumericData::kInt64; }
+  static int64_t get(MDataHandle& h) { return h.asInt64(); }
+  static void set(MDataHandle& h, const int64_t v) { h.setInt64(v); }
+};
+
+template<>
+struct NumericElement<float>
+{
+  static bool matches(const MFnNumericData::Type t) { return t == MFnNumericData::kFloat; }
+  static float get(MDataHandle& h) { return h.asFloat(); }
+  static void set(MDataHandle& h, const float v) { h.setFloat(v); }
+};
+
+template<>
+struct NumericElement<GfHalf>
+{
+  static bool matches(const MFnNumericData::Type t) { return t == MFnNumericData::kFloat; }
+  static GfHalf get(MDataHandle& h) { return AL::usd::utils::float2half_1f(h.asFloat()); }
+  static void set(MDataHandle& h, const GfHalf v) { h.setFloat(AL::usd::utils::half2float_1f(v)); }
+};
+
+template<>
+struct NumericElement<double>
+{
+  static bool matches(const MFnNumericData::Type t) { return t == MFnNumericData::kDouble; }
+  static double get(MDataHandle& h) { return h.asDouble(); }
+  static void set(MDataHandle& h, const double v) { h.setDouble(v); }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Gets the attributes for the N children of the elements in a compound array plug (or nothing if N is 1)
+//----------------------------------------------------------------------------------------------------------------------
+template<uint32_t N>
+bool childAttributes(MPlug& plug, MObject (&children)[N])
+{
+  if(N == 1)
+  {
+    return true;
+  }
+  MPlug element = plug.elementByLogicalIndex(0);
+  if(element.numChildren() != N)
+  {
+    return false;
+  }
+  for(uint32_t k = 0; k < N; ++k)
+  {
+    children[k] = element.child(k).attribute();
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Reads all of the elements of an array plug through one data handle, rather than looking up the plug of each
+///         element in turn. The read functor is passed the handle and index of each element.
+/// \return false if the array data could not be accessed, or its logical indices are not 0 to count-1. The caller should
+///         then fall back to reading the elements through their plugs.
+//----------------------------------------------------------------------------------------------------------------------
+template<typename ReadFn>
+bool readArrayHandle(const MPlug& plug, const size_t count, ReadFn read)
+{
+  MStatus status;
+  MDataHandle handle = plug.asMDataHandle(&status);
+  if(!status)
+  {
+    return false;
+  }
+
+  bool dense = false;
+  MArrayDataHandle arrayHandle(handle, &status);
+  if(status && arrayHandle.elementCount() == count)
+  {
+    dense = true;
+    for(size_t i = 0; i < count; ++i, arrayHandle.next())
+    {
+      MDataHandle element = arrayHandle.inputValue(&status);
+      if(!status || arrayHandle.elementIndex() != i || !read(element, i))
+      {
+        dense = false;
+        break;
+      }
+    }
+  }
+  plug.destructHandle(handle);
+  return dense;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Writes the elements 0 to count-1 of an array plug through a single array data builder, rather than setting the
+///         plug of each element in turn. The write functor is passed the handle and index of each element.
+/// \return false if the attribute was not created to use an array data builder, or the array data could not be
+///         accessed, in which case nothing is written and the caller should fall back to setting the elements through
+///         their plugs.
+//----------------------------------------------------------------------------------------------------------------------
+template<typename WriteFn>
+bool writeArrayHandle(MPlug& plug, const size_t count, WriteFn write)
+{
+  MStatus status;
+  MFnAttribute fnAttr(plug.attribute(), &status);
+  if(!status || !fnAttr.usesArrayDataBuilder())
+  {
+    return false;
+  }
+
+  MDataHandle handle = plug.asMDataHandle(&status);
+  if(!status)
+  {
+    return false;
+  }
+
+  bool written = false;
+  MArrayDataHandle arrayHandle(handle, &status);
+  if(status)
+  {
+    MArrayDataBuilder builder = arrayHandle.builder(&status);
+    written = status;
+    for(size_t i = 0; written && i < count; ++i)
+    {
+      MDataHandle element = builder.addElement(uint32_t(i), &status);
+      written = status && write(element, i);
+    }
+    written = written && arrayHandle.set(builder) && plug.setMDataHandle(handle);
+  }
+  plug.destructHandle(handle);
+  return written;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  reads an array of numeric values (N == 1), or of numeric compounds with N children (e.g. a float3 array), in
+///         bulk through the data handle of the plug.
+//----------------------------------------------------------------------------------------------------------------------
+template<uint32_t N, typename T>
+bool readNumericArray(MPlug& plug, T* const values, const size_t count)
+{
+  MObject children[N];
+  if(!count || !childAttributes(plug, children))
+  {
+    return !count;
+  }
+  return readArrayHandle(plug, count, [values, &children](MDataHandle& element, const size_t i)
+  {
+    for(uint32_t k = 0; k < N; ++k)
+    {
+      MDataHandle value = (N == 1) ? element : element.child(children[k]);
+      if(!i && !NumericElement<T>::matches(value.numericType()))
+      {
+        return false;
+      }
+      values[N * i + k] = NumericElement<T>::get(value);
+    }
+    return true;
+  });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  writes an array of numeric values (N == 1), or of numeric compounds with N children (e.g. a float3 array), in
+///         bulk through the data handle of the plug.
+//----------------------------------------------------------------------------------------------------------------------
+template<uint32_t N, typename T>
+bool writeNumericArray(MPlug& plug, const T* const values, const size_t count)
+{
+  MObject children[N];
+  if(!count || !childAttributes(plug, children))
+  {
+    return !count;
+  }
+  return writeArrayHandle(plug, count, [values, &children](MDataHandle& element, const size_t i)
+  {
+    for(uint32_t k = 0; k < N; ++k)
+    {
+      MDataHandle value = (N == 1) ? element : element.child(children[k]);
+      if(!i && !NumericElement<T>::matches(value.numericType()))
+      {
+        return false;
+      }
+      NumericElement<T>::set(value, values[N * i + k]);
+    }
+    return true;
+  });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  reads an array of (double precision) matrix attributes in bulk through the data handle of the plug
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+bool readMatrixArray(MPlug& plug, T* const values, const size_t count)
+{
+  if(plug.attribute().apiType() != MFn::kMatrixAttribute)
+  {
+    return false;
+  }
+  return readArrayHandle(plug, count, [values](MDataHandle& element, const size_t i)
+  {
+    const MMatrix& m = element.asMatrix();
+    const double* const src = &m.matrix[0][0];
+    T* const dst = values + 16 * i;
+    for(uint32_t k = 0; k < 16; ++k)
+    {
+      dst[k] = T(src[k]);
+    }
+    return true;
+  });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  writes an array of (double precision) matrix attributes in bulk through the data handle of the plug
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+bool writeMatrixArray(MPlug& plug, const T* const values, const size_t count)
+{
+  if(plug.attribute().apiType() != MFn::kMatrixAttribute)
+  {
+    return false;
+  }
+  return writeArrayHandle(plug, count, [values](MDataHandle& element, const size_t i)
+  {
+    MMatrix m;
+    double* const dst = &m.matrix[0][0];
+    const T* const src = values + 16 * i;
+    for(uint32_t k = 0; k < 16; ++k)
+    {
+      dst[k] = double(src[k]);
+    }
+    element.setMMatrix(m);
+    return true;
+  });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  returns true if the plug is an element of an array, or lies beneath one. Such plugs cannot be rebuilt from
+///         their node and attribute, so they have to be read through the plug itself.
+//----------------------------------------------------------------------------------------------------------------------
+bool isWithinArrayElement(const MPlug& plug)
+{
+  MPlug current = plug;
+  for(;;)
+  {
+    if(current.isElement())
+    {
+      return true;
+    }
+    if(!current.isChild())
+    {
+      return false;
+    }
+    current = current.parent();
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  reads the N children of a compound plug as a vector
+//----------------------------------------------------------------------------------------------------------------------
+template<typename V, typename S, uint32_t N>
+bool getElementVec(const MPlug& plug, const float scale, VtValue& result)
+{
+  if(plug.numChildren() != N)
+  {
+    return false;
+  }
+  V value;
+  for(uint32_t i = 0; i < N; ++i)
+  {
+    value[i] = S(plug.child(i).asDouble() * scale);
+  }
+  result = value;
+  return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  reads the value of a (non array) plug that lies within an array element directly from the plug
+/// \return false if the plug is not within an array element, or if its type is not handled
+//----------------------------------------------------------------------------------------------------------------------
+bool getElementPlugValue(const MPlug& plug, const UsdAttribute& usdAttr, const float scale, VtValue& result)
+{
+  if(plug.isArray() || !isWithinArrayElement(plug))
+  {
+    return false;
+  }
+
+  switch(getAttributeType(usdAttr))
+  {
+  case UsdDataType::kBool: result = plug.asBool(); return true;
+  case UsdDataType::kUChar: result = uint8_t(plug.asChar()); return true;
+  case UsdDataType::kInt: result = int32_t(plug.asInt()); return true;
+  case UsdDataType::kUInt: result = uint32_t(plug.asInt()); return true;
+  case UsdDataType::kInt64: result = int64_t(plug.asInt64()); return true;
+  case UsdDataType::kUInt64: result = uint64_t(plug.asInt64()); return true;
+  case UsdDataType::kHalf: result = GfHalf(plug.asFloat() * scale); return true;
+  case UsdDataType::kFloat: result = plug.asFloat() * scale; return true;
+  case UsdDataType::kDouble: result = plug.asDouble() * scale; return true;
+  case UsdDataType::kString: result = std::string(plug.asString().asChar()); return true;
+  case UsdDataType::kVec2d: return getElementVec<GfVec2d, double, 2>(plug, scale, result);
+  case UsdDataType::kVec2f: return getElementVec<GfVec2f, float, 2>(plug, scale, result);
+  case UsdDataType::kVec2h: return getElementVec<GfVec2h, GfHalf, 2>(plug, scale, result);
+  case UsdDataType::kVec3d: return getElementVec<GfVec3d, double, 3>(plug, scale, result);
+  case UsdDataType::kVec3f: return getElementVec<GfVec3f, float, 3>(plug, scale, result);
+  case UsdDataType::kVec3h: return getElementVec<GfVec3h, GfHalf, 3>(plug, scale, result);
+  case UsdDataType::kVec4d: return getElementVec<GfVec4d, double, 4>(plug, scale, result);
+  case UsdDataType::kVec4f: return getElementVec<GfVec4f, float, 4>(plug, scale, result);
+  case UsdDataType::kVec4h: return getElementVec<GfVec4h, GfHalf, 4>(plug, scale, result);
+  case UsdDataType::kColor3d: return getElementVec<GfVec3d, double, 3>(plug, scale, result);
+  case UsdDataType::kColor3f: return getElementVec<GfVec3f, float, 3>(plug, scale, result);
+  case UsdDataType::kColor3h: return getElementVec<GfVec3h, GfHalf, 3>(plug, scale, result);
+  default: return false;
+  }
+}
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 MStatus DgNodeHelper::setFloat(const MObject node, const MObject attr, float value)
 {
@@ -178,6 +534,11 @@ MStatus DgNodeHelper::setBoolArray(MObject node, MObject attribute, const bool*
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<1>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(size_t i = 0; i != count; ++i)
   {
     plug.elementByLogicalIndex(i).setBool(values[i]);
@@ -212,6 +573,11 @@ MStatus DgNodeHelper::setInt8Array(MObject node, MObject attribute, const int8_t
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<1>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(size_t i = 0; i != count; ++i)
   {
     plug.elementByLogicalIndex(i).setChar(values[i]);
@@ -229,6 +595,11 @@ MStatus DgNodeHelper::setInt16Array(MObject node, MObject attribute, const int16
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<1>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(size_t i = 0; i != count; ++i)
   {
     plug.elementByLogicalIndex(i).setShort(values[i]);
@@ -246,6 +617,11 @@ MStatus DgNodeHelper::setInt32Array(MObject node, MObject attribute, const int32
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<1>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(size_t i = 0; i != count; ++i)
   {
     plug.elementByLogicalIndex(i).setValue(values[i]);
@@ -263,6 +639,11 @@ MStatus DgNodeHelper::setInt64Array(MObject node, MObject attribute, const int64
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<1>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(size_t i = 0; i != count; ++i)
   {
     plug.elementByLogicalIndex(i).setInt64(values[i]);
@@ -280,6 +661,11 @@ MStatus DgNodeHelper::setHalfArray(MObject node, MObject attribute, const GfHalf
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<1>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   size_t count8 = count & ~0x7ULL;
   for(size_t j = 0; j != count8; j += 8)
   {
@@ -342,6 +728,11 @@ MStatus DgNodeHelper::setFloatArray(MObject node, MObject attribute, const float
     else
     {
       AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
+
+      if(writeNumericArray<1>(plug, values, count))
+      {
+        return MS::kSuccess;
+      }
       for(size_t i = 0; i != count; ++i)
       {
         plug.elementByLogicalIndex(i).setFloat(values[i]);
@@ -376,6 +767,11 @@ MStatus DgNodeHelper::setDoubleArray(MObject node, MObject attribute, const doub
     else
     {
       AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
+
+      if(writeNumericArray<1>(plug, values, count))
+      {
+        return MS::kSuccess;
+      }
       for(size_t i = 0; i != count; ++i)
       {
         plug.elementByLogicalIndex(i).setDouble(values[i]);
@@ -395,6 +791,11 @@ MStatus DgNodeHelper::setVec2Array(MObject node, MObject attribute, const int32_
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<2>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(size_t i = 0, j = 0; i != count; ++i, j += 2)
   {
     auto v = plug.elementByLogicalIndex(i);
@@ -414,6 +815,11 @@ MStatus DgNodeHelper::setVec2Array(MObject node, MObject attribute, const GfHalf
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<2>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   size_t count4 = count & ~0x3ULL;
   for(size_t i = 0, j = 0; i != count4; i += 4, j += 8)
   {
@@ -466,6 +872,11 @@ MStatus DgNodeHelper::setVec2Array(MObject node, MObject attribute, const float*
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<2>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(size_t i = 0, j = 0; i != count; ++i, j += 2)
   {
     auto v = plug.elementByLogicalIndex(i);
@@ -485,6 +896,11 @@ MStatus DgNodeHelper::setVec2Array(MObject node, MObject attribute, const double
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<2>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(size_t i = 0, j = 0; i != count; ++i, j += 2)
   {
     auto v = plug.elementByLogicalIndex(i);
@@ -503,6 +919,11 @@ MStatus DgNodeHelper::setVec3Array(MObject node, MObject attribute, const int32_
     return MS::kFailure;
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
+
+  if(writeNumericArray<3>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
   for(size_t i = 0, j = 0; i != count; ++i, j += 3)
   {
     auto v = plug.elementByLogicalIndex(i);
@@ -521,6 +942,11 @@ MStatus DgNodeHelper::setVec3Array(MObject node, MObject attribute, const GfHalf
     return MS::kFailure;
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
+
+  if(writeNumericArray<3>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
   size_t count8 = count & ~0x7ULL;
   for(size_t i = 0, j = 0; i != count8; i += 8, j += 24)
   {
@@ -564,6 +990,11 @@ MStatus DgNodeHelper::setVec3Array(MObject node, MObject attribute, const float*
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<3>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(size_t i = 0, j = 0; i != count; ++i, j += 3)
   {
     auto v = plug.elementByLogicalIndex(i);
@@ -584,6 +1015,11 @@ MStatus DgNodeHelper::setVec3Array(MObject node, MObject attribute, const double
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<3>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(size_t i = 0, j = 0; i != count; ++i, j += 3)
   {
     auto v = plug.elementByLogicalIndex(i);
@@ -605,6 +1041,11 @@ MStatus DgNodeHelper::setVec4Array(MObject node, MObject attribute, const GfHalf
   }
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
+
+  if(writeNumericArray<4>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
   size_t count2 = count & ~0x1ULL;
 
   for(size_t i = 0, j = 0; i != count2; i += 2, j += 8)
@@ -645,6 +1086,11 @@ MStatus DgNodeHelper::setVec4Array(MObject node, MObject attribute, const int* c
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<4>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(size_t i = 0, j = 0; i != count; ++i, j += 4)
   {
     auto v = plug.elementByLogicalIndex(i);
@@ -666,6 +1112,11 @@ MStatus DgNodeHelper::setVec4Array(MObject node, MObject attribute, const float*
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<4>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(size_t i = 0, j = 0; i != count; ++i, j += 4)
   {
     auto v = plug.elementByLogicalIndex(i);
@@ -687,6 +1138,11 @@ MStatus DgNodeHelper::setVec4Array(MObject node, MObject attribute, const double
 
   AL_MAYA_CHECK_ERROR(plug.setNumElements(count), "DgNodeHelper: attribute array could not be resized");
 
+  if(writeNumericArray<4>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(size_t i = 0, j = 0; i != count; ++i, j += 4)
   {
     auto v = plug.elementByLogicalIndex(i);
@@ -721,8 +1177,14 @@ MStatus DgNodeHelper::setMatrix4x4Array(MObject node, MObject attribute, const d
   }
   else
   {
+    if(writeMatrixArray(plug, values, count))
+    {
+      return MS::kSuccess;
+    }
+
     // Yes this is horrible. It would appear that as of Maya 2017, setting the contents of matrix array attributes doesn't work.
-    // Well, at least for dynamic attributes. Using an array builder inside a compute method would be one way
+    // Well, at least for dynamic attributes that were not created to use an array data builder (the ones created by
+    // addDynamicAttribute are, and are written above).
     char tempStr[1024] = {0};
     for(uint32_t i = 0; i < 16 * count; i += 16)
     {
@@ -806,7 +1268,12 @@ MStatus DgNodeHelper::setMatrix4x4Array(MObject node, MObject attribute, const f
   }
   else
   {
-    // I can't seem to create a multi of arrays within the Maya API (without using an array data builder within a compute).
+    if(writeMatrixArray(plug, values, count))
+    {
+      return MS::kSuccess;
+    }
+
+    // I can't seem to create a multi of arrays within the Maya API (without an attribute that uses an array data builder).
     char tempStr[2048] = {0};
     for(uint32_t i = 0; i < 16 * count; i += 16)
     {
@@ -1180,6 +1647,11 @@ MStatus DgNodeHelper::getBoolArray(MObject node, MObject attribute, bool* const
     return MS::kFailure;
   }
 
+  if(readNumericArray<1>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
 #if AL_UTILS_ENABLE_SIMD
   uint32_t count16 = count & ~0xF;
   for(uint32_t i = 0; i < count16; i += 16)
@@ -1232,6 +1704,11 @@ MStatus DgNodeHelper::getInt64Array(MObject node, MObject attribute, int64_t* co
     return MS::kFailure;
   }
 
+  if(readNumericArray<1>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
 #if AL_UTILS_ENABLE_SIMD
 
 #ifdef __AVX__
@@ -1297,6 +1774,11 @@ MStatus DgNodeHelper::getInt32Array(MObject node, MObject attribute, int32_t* co
     return MS::kFailure;
   }
 
+  if(readNumericArray<1>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
 #if AL_UTILS_ENABLE_SIMD
 
 #ifdef __AVX__
@@ -1373,6 +1855,11 @@ MStatus DgNodeHelper::getInt8Array(MObject node, MObject attribute, int8_t* cons
     return MS::kFailure;
   }
 
+  if(readNumericArray<1>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(uint32_t i = 0; i < num; ++i)
   {
     values[i] = plug.elementByLogicalIndex(i).asChar();
@@ -1395,6 +1882,11 @@ MStatus DgNodeHelper::getInt16Array(MObject node, MObject attribute, int16_t* co
     return MS::kFailure;
   }
 
+  if(readNumericArray<1>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(uint32_t i = 0; i < num; ++i)
   {
     values[i] = plug.elementByLogicalIndex(i).asShort();
@@ -1417,6 +1909,11 @@ MStatus DgNodeHelper::getFloatArray(MObject node, MObject attribute, float* cons
     return MS::kFailure;
   }
 
+  if(readNumericArray<1>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
 #if AL_UTILS_ENABLE_SIMD
 
 #ifdef __AVX__
@@ -1494,6 +1991,11 @@ MStatus DgNodeHelper::getHalfArray(MObject node, MObject attribute, GfHalf* cons
     return MS::kFailure;
   }
 
+  if(readNumericArray<1>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   size_t count8 = count & ~0x7ULL;
   for(uint32_t i = 0; i < count8; i += 8)
   {
@@ -1543,6 +2045,11 @@ MStatus DgNodeHelper::getDoubleArray(MObject node, MObject attribute, double* co
     MGlobal::displayError("array is sized incorrectly");
     return MS::kFailure;
   }
+
+  if(readNumericArray<1>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
 #if AL_UTILS_ENABLE_SIMD
 
 #ifdef __AVX__
@@ -1621,6 +2128,11 @@ MStatus DgNodeHelper::getVec2Array(MObject node, MObject attribute, double* cons
     return MS::kFailure;
   }
 
+  if(readNumericArray<2>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
 #if AL_UTILS_ENABLE_SIMD
 
 #ifdef __AVX__
@@ -1678,6 +2190,11 @@ MStatus DgNodeHelper::getVec2Array(MObject node, MObject attribute, float* const
     return MS::kFailure;
   }
 
+  if(readNumericArray<2>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
 #if AL_UTILS_ENABLE_SIMD
 
 #ifdef __AVX__
@@ -1755,6 +2272,11 @@ MStatus DgNodeHelper::getVec2Array(MObject node, MObject attribute, GfHalf* cons
     return MS::kFailure;
   }
 
+  if(readNumericArray<2>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(uint32_t i = 0,  j = 0; i < num; ++i, j += 2)
   {
     values[j] = plug.elementByLogicalIndex(i).child(0).asFloat();
@@ -1818,6 +2340,11 @@ MStatus DgNodeHelper::getVec2Array(MObject node, MObject attribute, int32_t* con
     return MS::kFailure;
   }
 
+  if(readNumericArray<2>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
 #if AL_UTILS_ENABLE_SIMD
 
 #ifdef __AVX__
@@ -1893,6 +2420,11 @@ MStatus DgNodeHelper::getVec3Array(MObject node, MObject attribute, float* const
     return MS::kFailure;
   }
 
+  if(readNumericArray<3>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
 #if AL_UTILS_ENABLE_SIMD
 
 #ifdef __AVX__
@@ -2039,6 +2571,11 @@ MStatus DgNodeHelper::getVec3Array(MObject node, MObject attribute, double* cons
     return MS::kFailure;
   }
 
+  if(readNumericArray<3>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
 #if AL_UTILS_ENABLE_SIMD
 
 #ifdef __AVX__
@@ -2143,6 +2680,11 @@ MStatus DgNodeHelper::getVec3Array(MObject node, MObject attribute, GfHalf* cons
     return MS::kFailure;
   }
 
+  if(readNumericArray<3>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   size_t count8 = count & ~0x7ULL;
 
   for(uint32_t i = 0, j = 0; i < count8; i += 8, j += 24)
@@ -2216,6 +2758,11 @@ MStatus DgNodeHelper::getVec3Array(MObject node, MObject attribute, int32_t* con
     return MS::kFailure;
   }
 
+  if(readNumericArray<3>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
 #if AL_UTILS_ENABLE_SIMD
 
 #ifdef __AVX__
@@ -2362,6 +2909,11 @@ MStatus DgNodeHelper::getVec4Array(MObject node, MObject attribute, int32_t* con
     return MS::kFailure;
   }
 
+  if(readNumericArray<4>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   size_t count2 = count & ~1;
   size_t i = 0, j = 0;
   for(; i < count2; i += 2, j += 8)
@@ -2434,6 +2986,11 @@ MStatus DgNodeHelper::getVec4Array(MObject node, MObject attribute, float* const
     return MS::kFailure;
   }
 
+  if(readNumericArray<4>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   size_t count2 = count & ~1;
   size_t i = 0, j = 0;
   for(; i < count2; i += 2, j += 8)
@@ -2506,6 +3063,11 @@ MStatus DgNodeHelper::getVec4Array(MObject node, MObject attribute, double* cons
     return MS::kFailure;
   }
 
+  if(readNumericArray<4>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   for(uint32_t i = 0, j = 0; i < num; ++i, j += 4)
   {
     ALIGN32(double temp[4]);
@@ -2548,6 +3110,11 @@ MStatus DgNodeHelper::getVec4Array(MObject node, MObject attribute, GfHalf* cons
     return MS::kFailure;
   }
 
+  if(readNumericArray<4>(plug, values, count))
+  {
+    return MS::kSuccess;
+  }
+
   size_t count2 = count & ~0x1ULL;
   for(uint32_t i = 0, j = 0; i < count2; i += 2, j += 8)
   {
@@ -2691,6 +3258,11 @@ MStatus DgNodeHelper::getMatrix4x4Array(MObject node, MObject attribute, float*
       return MS::kFailure;
     }
 
+    if(readMatrixArray(plug, values, count))
+    {
+      return MS::kSuccess;
+    }
+
     MFnMatrixData fn;
     MObject elementValue;
     for(uint32_t i = 0, j = 0; i < count; ++i, j += 16)
@@ -2806,6 +3378,11 @@ MStatus DgNodeHelper::getMatrix4x4Array(MObject node, MObject attribute, double*
       return MS::kFailure;
     }
 
+    if(readMatrixArray(plug, values, count))
+    {
+      return MS::kSuccess;
+    }
+
     MFnMatrixData fn;
     MObject elementValue;
     for(uint32_t i = 0, j = 0; i < count; ++i, j += 16)
@@ -4253,9 +4830,10 @@ MStatus DgNodeHelper::addDynamicAttribute(MObject node, const UsdAttribute& usdA
   const UsdDataType dataType = getAttributeType(usdAttr);
   MObject attribute = MObject::kNullObj;
   const char* attrName = usdAttr.GetName().GetString().c_str();
-  const uint32_t flags = (isArray ? AL::maya::utils::NodeHelper::kArray : 0) | AL::maya::utils::NodeHelper::kReadable |
-      AL::maya::utils::NodeHelper::kWritable | AL::maya::utils::NodeHelper::kStorable |
-      AL::maya::utils::NodeHelper::kConnectable;
+  // arrays use an array data builder, so that their values can be set in bulk (see writeArrayHandle)
+  const uint32_t flags = (isArray ? AL::maya::utils::NodeHelper::kArray | AL::maya::utils::NodeHelper::kUsesArrayDataBuilder : 0) |
+      AL::maya::utils::NodeHelper::kReadable | AL::maya::utils::NodeHelper::kWritable |
+      AL::maya::utils::NodeHelper::kStorable | AL::maya::utils::NodeHelper::kConnectable;
   switch(dataType)
   {
   case UsdDataType::kAsset:
@@ -5623,8 +6201,12 @@ MStatus DgNodeHelper::copyDynamicAttributes(MObject node, UsdPrim& prim)
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, const UsdTimeCode& timeCode)
+void DgNodeHelper::getSimpleValue(const MPlug& plug, const UsdAttribute& usdAttr, VtValue& result)
 {
+  if(getElementPlugValue(plug, usdAttr, 1.0f, result))
+  {
+    return;
+  }
   MObject node = plug.node();
   MObject attribute = plug.attribute();
   bool isArray = plug.isArray();
@@ -5635,14 +6217,14 @@ void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, con
     {
       int8_t value;
       getInt8(node, attribute, value);
-      usdAttr.Set(uint8_t(value), timeCode);
+      result = uint8_t(value);
     }
     else
     {
       VtArray<uint8_t> m;
       m.resize(plug.numElements());
       getInt8Array(node, attribute, (int8_t*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      result = m;
     }
     break;
 
@@ -5651,14 +6233,14 @@ void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, con
     {
       int32_t value;
       getInt32(node, attribute, value);
-      usdAttr.Set(value, timeCode);
+      result = value;
     }
     else
     {
       VtArray<int32_t> m;
       m.resize(plug.numElements());
       getInt32Array(node, attribute, (int32_t*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      result = m;
     }
     break;
 
@@ -5667,14 +6249,14 @@ void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, con
     {
       int32_t value;
       getInt32(node, attribute, value);
-      usdAttr.Set(uint32_t(value), timeCode);
+      result = uint32_t(value);
     }
     else
     {
       VtArray<uint32_t> m;
       m.resize(plug.numElements());
       getInt32Array(node, attribute, (int32_t*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      result = m;
     }
     break;
 
@@ -5683,14 +6265,14 @@ void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, con
     {
       int64_t value;
       getInt64(node, attribute, value);
-      usdAttr.Set(value, timeCode);
+      result = value;
     }
     else
     {
       VtArray<int64_t> m;
       m.resize(plug.numElements());
       getInt64Array(node, attribute, (int64_t*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      result = m;
     }
     break;
 
@@ -5699,14 +6281,14 @@ void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, con
     {
       int64_t value;
       getInt64(node, attribute, value);
-      usdAttr.Set(value, timeCode);
+      result = value;
     }
     else
     {
       VtArray<int64_t> m;
       m.resize(plug.numElements());
       getInt64Array(node, attribute, (int64_t*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      result = m;
     }
     break;
 
@@ -5715,14 +6297,14 @@ void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, con
     {
       float value;
       getFloat(node, attribute, value);
-      usdAttr.Set(value, timeCode);
+      result = value;
     }
     else
     {
       VtArray<float> m;
       m.resize(plug.numElements());
       getFloatArray(node, attribute, (float*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      result = m;
     }
     break;
 
@@ -5731,14 +6313,14 @@ void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, con
     {
       double value;
       getDouble(node, attribute, value);
-      usdAttr.Set(value, timeCode);
+      result = value;
     }
     else
     {
       VtArray<double> m;
       m.resize(plug.numElements());
       getDoubleArray(node, attribute, (double*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      result = m;
     }
     break;
 
@@ -5747,14 +6329,14 @@ void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, con
     {
       GfHalf value;
       getHalf(node, attribute, value);
-      usdAttr.Set(value, timeCode);
+      result = value;
     }
     else
     {
       VtArray<GfHalf> m;
       m.resize(plug.numElements());
       getHalfArray(node, attribute, (GfHalf*)m.data(), m.size());
-      usdAttr.Set(m, timeCode);
+      result = m;
     }
     break;
 
@@ -5764,8 +6346,12 @@ void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, con
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr, const UsdTimeCode& timeCode)
+void DgNodeHelper::getAttributeValue(const MPlug& plug, const UsdAttribute& usdAttr, VtValue& result)
 {
+  if(getElementPlugValue(plug, usdAttr, 1.0f, result))
+  {
+    return;
+  }
   MObject node = plug.node();
   MObject attribute = plug.attribute();
   bool isArray = plug.isArray();
@@ -5783,14 +6369,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
         {
           GfVec2d m;
           getVec2(node, attribute, (double*)&m);
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
           VtArray<GfVec2d> m;
           m.resize(plug.numElements());
           getVec2Array(node, attribute, (double*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -5799,14 +6385,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
         {
           GfVec2f m;
           getVec2(node, attribute, (float*)&m);
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
           VtArray<GfVec2f> m;
           m.resize(plug.numElements());
           getVec2Array(node, attribute, (float*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -5815,14 +6401,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
         {
           GfVec2i m;
           getVec2(node, attribute, (int*)&m);
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
           VtArray<GfVec2i> m;
           m.resize(plug.numElements());
           getVec2Array(node, attribute, (int*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -5831,14 +6417,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
         {
           GfVec2h m;
           getVec2(node, attribute, (GfHalf*)&m);
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
           VtArray<GfVec2h> m;
           m.resize(plug.numElements());
           getVec2Array(node, attribute, (GfHalf*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -5860,14 +6446,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
         {
           GfVec3d m;
           getVec3(node, attribute, (double*)&m);
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
           VtArray<GfVec3d> m;
           m.resize(plug.numElements());
           getVec3Array(node, attribute, (double*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -5876,14 +6462,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
         {
           GfVec3f m;
           getVec3(node, attribute, (float*)&m);
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
           VtArray<GfVec3f> m;
           m.resize(plug.numElements());
           getVec3Array(node, attribute, (float*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -5892,14 +6478,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
         {
           GfVec3i m;
           getVec3(node, attribute, (int*)&m);
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
           VtArray<GfVec3i> m;
           m.resize(plug.numElements());
           getVec3Array(node, attribute, (int*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -5908,14 +6494,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
         {
           GfVec3h m;
           getVec3(node, attribute, (GfHalf*)&m);
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
           VtArray<GfVec3h> m;
           m.resize(plug.numElements());
           getVec3Array(node, attribute, (GfHalf*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -5934,14 +6520,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
         {
           GfVec4d m;
           getVec4(node, attribute, (double*)&m);
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
           VtArray<GfVec4d> m;
           m.resize(plug.numElements());
           getVec4Array(node, attribute, (double*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -5950,14 +6536,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
         {
           GfVec4f m;
           getVec4(node, attribute, (float*)&m);
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
           VtArray<GfVec4f> m;
           m.resize(plug.numElements());
           getVec4Array(node, attribute, (float*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -5966,14 +6552,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
         {
           GfVec4i m;
           getVec4(node, attribute, (int*)&m);
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
           VtArray<GfVec4i> m;
           m.resize(plug.numElements());
           getVec4Array(node, attribute, (int*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -5982,14 +6568,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
         {
           GfVec4h m;
           getVec4(node, attribute, (GfHalf*)&m);
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
           VtArray<GfVec4h> m;
           m.resize(plug.numElements());
           getVec4Array(node, attribute, (GfHalf*)m.data(), m.size());
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -6010,14 +6596,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           {
             bool value;
             getBool(node, attribute, value);
-            usdAttr.Set(value, timeCode);
+            result = value;
           }
           else
           {
             VtArray<bool> m;
             m.resize(plug.numElements());
             getUsdBoolArray(node, attribute, m);
-            usdAttr.Set(m, timeCode);
+            result = m;
           }
         }
         break;
@@ -6030,7 +6616,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
       case MFnNumericData::kByte:
       case MFnNumericData::kChar:
         {
-          copySimpleValue(plug, usdAttr, timeCode);
+          getSimpleValue(plug, usdAttr, result);
         }
         break;
 
@@ -6048,7 +6634,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
   case MFn::kDoubleLinearAttribute:
   case MFn::kFloatLinearAttribute:
     {
-      copySimpleValue(plug, usdAttr, timeCode);
+      getSimpleValue(plug, usdAttr, result);
     }
     break;
 
@@ -6062,14 +6648,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           {
             int32_t value;
             getInt32(node, attribute, value);
-            usdAttr.Set(value, timeCode);
+            result = value;
           }
           else
           {
             VtArray<int> m;
             m.resize(plug.numElements());
             getInt32Array(node, attribute, m.data(), m.size());
-            usdAttr.Set(m, timeCode);
+            result = m;
           }
         }
       }
@@ -6087,7 +6673,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
         {
           std::string value;
           getString(node, attribute, value);
-          usdAttr.Set(value, timeCode);
+          result = value;
         }
         break;
 
@@ -6096,7 +6682,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           MFnMatrixArrayData fnData(plug.asMObject());
           VtArray<GfMatrix4d> m;
           m.assign((const GfMatrix4d*)&fnData.array()[0], ((const GfMatrix4d*)&fnData.array()[0]) + fnData.array().length());
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -6137,14 +6723,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
                 {
                   GfMatrix2d value;
                   getMatrix2x2(node, attribute, (double*)&value);
-                  usdAttr.Set(value, timeCode);
+                  result = value;
                 }
                 else
                 {
                   VtArray<GfMatrix2d> value;
                   value.resize(plug.numElements());
                   getMatrix2x2Array(node, attribute, (double*)value.data(), plug.numElements());
-                  usdAttr.Set(value, timeCode);
+                  result = value;
                 }
               }
             }
@@ -6189,14 +6775,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
                 {
                   GfMatrix3d value;
                   getMatrix3x3(node, attribute, (double*)&value);
-                  usdAttr.Set(value, timeCode);
+                  result = value;
                 }
                 else
                 {
                   VtArray<GfMatrix3d> value;
                   value.resize(plug.numElements());
                   getMatrix3x3Array(node, attribute, (double*)value.data(), plug.numElements());
-                  usdAttr.Set(value, timeCode);
+                  result = value;
                 }
               }
             }
@@ -6232,14 +6818,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
                   {
                     GfVec4i value;
                     getVec4(node, attribute, (int32_t*)&value);
-                    usdAttr.Set(value, timeCode);
+                    result = value;
                   }
                   else
                   {
                     VtArray<GfVec4i> value;
                     value.resize(plug.numElements());
                     getVec4Array(node, attribute, (int32_t*)value.data(), value.size());
-                    usdAttr.Set(value, timeCode);
+                    result = value;
                   }
                 }
                 break;
@@ -6250,14 +6836,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
                   {
                     GfVec4f value;
                     getVec4(node, attribute, (float*)&value);
-                    usdAttr.Set(value, timeCode);
+                    result = value;
                   }
                   else
                   {
                     VtArray<GfVec4f> value;
                     value.resize(plug.numElements());
                     getVec4Array(node, attribute, (float*)value.data(), value.size());
-                    usdAttr.Set(value, timeCode);
+                    result = value;
                   }
                 }
                 break;
@@ -6268,14 +6854,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
                   {
                     GfVec4d value;
                     getVec4(node, attribute, (double*)&value);
-                    usdAttr.Set(value, timeCode);
+                    result = value;
                   }
                   else
                   {
                     VtArray<GfVec4d> value;
                     value.resize(plug.numElements());
                     getVec4Array(node, attribute, (double*)value.data(), value.size());
-                    usdAttr.Set(value, timeCode);
+                    result = value;
                   }
                 }
                 break;
@@ -6296,14 +6882,14 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
       {
         GfMatrix4d m;
         getMatrix4x4(node, attribute, (double*)&m);
-        usdAttr.Set(m, timeCode);
+        result = m;
       }
       else
       {
         VtArray<GfMatrix4d> value;
         value.resize(plug.numElements());
         getMatrix4x4Array(node, attribute, (double*)value.data(), value.size());
-        usdAttr.Set(value, timeCode);
+        result = value;
       }
     }
     break;
@@ -6313,8 +6899,12 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, const float scale, const UsdTimeCode& timeCode)
+void DgNodeHelper::getSimpleValue(const MPlug& plug, const UsdAttribute& usdAttr, const float scale, VtValue& result)
 {
+  if(getElementPlugValue(plug, usdAttr, scale, result))
+  {
+    return;
+  }
   MObject node = plug.node();
   MObject attribute = plug.attribute();
   bool isArray = plug.isArray();
@@ -6325,7 +6915,7 @@ void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, con
     {
       float value;
       getFloat(node, attribute, value);
-      usdAttr.Set(value * scale, timeCode);
+      result = value * scale;
     }
     else
     {
@@ -6336,7 +6926,7 @@ void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, con
       {
         *it *= scale;
       }
-      usdAttr.Set(m, timeCode);
+      result = m;
     }
     break;
 
@@ -6345,7 +6935,7 @@ void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, con
     {
       double value;
       getDouble(node, attribute, value);
-      usdAttr.Set(value * scale, timeCode);
+      result = value * scale;
     }
     else
     {
@@ -6357,7 +6947,7 @@ void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, con
       {
         *it *= temp;
       }
-      usdAttr.Set(m, timeCode);
+      result = m;
     }
     break;
 
@@ -6367,8 +6957,12 @@ void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, con
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr, const float scale, const UsdTimeCode& timeCode)
+void DgNodeHelper::getAttributeValue(const MPlug& plug, const UsdAttribute& usdAttr, const float scale, VtValue& result)
 {
+  if(getElementPlugValue(plug, usdAttr, scale, result))
+  {
+    return;
+  }
   MObject node = plug.node();
   MObject attribute = plug.attribute();
   bool isArray = plug.isArray();
@@ -6387,7 +6981,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           GfVec2d m;
           getVec2(node, attribute, (double*)&m);
           m *= scale;
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
@@ -6399,7 +6993,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           {
             *it *= temp;
           }
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -6409,7 +7003,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           GfVec2f m;
           getVec2(node, attribute, (float*)&m);
           m *= scale;
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
@@ -6420,7 +7014,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           {
             *it *= scale;
           }
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -6443,7 +7037,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           GfVec3d m;
           getVec3(node, attribute, (double*)&m);
           m *= scale;
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
@@ -6455,7 +7049,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           {
             *it *= temp;
           }
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -6465,7 +7059,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           GfVec3f m;
           getVec3(node, attribute, (float*)&m);
           m *= scale;
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
@@ -6476,7 +7070,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           {
             *it *= scale;
           }
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -6496,7 +7090,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           GfVec4d m;
           getVec4(node, attribute, (double*)&m);
           m *= scale;
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
@@ -6508,7 +7102,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           {
             *it *= temp;
           }
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -6518,7 +7112,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           GfVec4f m;
           getVec4(node, attribute, (float*)&m);
           m *= scale;
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         else
         {
@@ -6529,7 +7123,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
           {
             *it *= scale;
           }
-          usdAttr.Set(m, timeCode);
+          result = m;
         }
         break;
 
@@ -6552,7 +7146,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
       case MFnNumericData::kByte:
       case MFnNumericData::kChar:
         {
-          copySimpleValue(plug, usdAttr, scale, timeCode);
+          getSimpleValue(plug, usdAttr, scale, result);
         }
         break;
 
@@ -6570,7 +7164,7 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
   case MFn::kDoubleLinearAttribute:
   case MFn::kFloatLinearAttribute:
     {
-      copySimpleValue(plug, usdAttr, scale, timeCode);
+      getSimpleValue(plug, usdAttr, scale, result);
     }
     break;
 
@@ -6578,6 +7172,50 @@ void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr,
   }
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, const UsdTimeCode& timeCode)
+{
+  VtValue value;
+  getSimpleValue(plug, usdAttr, value);
+  if(!value.IsEmpty())
+  {
+    usdAttr.Set(value, timeCode);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr, const UsdTimeCode& timeCode)
+{
+  VtValue value;
+  getAttributeValue(plug, usdAttr, value);
+  if(!value.IsEmpty())
+  {
+    usdAttr.Set(value, timeCode);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void DgNodeHelper::copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, const float scale, const UsdTimeCode& timeCode)
+{
+  VtValue value;
+  getSimpleValue(plug, usdAttr, scale, value);
+  if(!value.IsEmpty())
+  {
+    usdAttr.Set(value, timeCode);
+  }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+void DgNodeHelper::copyAttributeValue(const MPlug& plug, UsdAttribute& usdAttr, const float scale, const UsdTimeCode& timeCode)
+{
+  VtValue value;
+  getAttributeValue(plug, usdAttr, scale, value);
+  if(!value.IsEmpty())
+  {
+    usdAttr.Set(value, timeCode);
+  }
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 } // utils
 } // usdmaya
@@ -1685,6 +1685,37 @@ public:
   AL_USDMAYA_UTILS_PUBLIC
   static void copySimpleValue(const MPlug& plug, UsdAttribute& usdAttr, float scale, const UsdTimeCode& timeCode);
 
+  /// \brief  read the current value of the plug specified, converted to the type expected by usdAttr. No data is
+  ///         written to usdAttr, which allows the maya side of an export to be separated from the USD authoring.
+  /// \param  attr the attribute to be read
+  /// \param  usdAttr the attribute whose type determines the conversion
+  /// \param  result the returned value. This will be empty if the plug type could not be converted.
+  AL_USDMAYA_UTILS_PUBLIC
+  static void getAttributeValue(const MPlug& attr, const UsdAttribute& usdAttr, VtValue& result);
+
+  /// \brief  read the current value of the plug specified, converted to the type expected by usdAttr.
+  /// \param  plug the attribute to be read
+  /// \param  usdAttr the attribute whose type determines the conversion
+  /// \param  result the returned value. This will be empty if the plug type could not be converted.
+  AL_USDMAYA_UTILS_PUBLIC
+  static void getSimpleValue(const MPlug& plug, const UsdAttribute& usdAttr, VtValue& result);
+
+  /// \brief  read the current value of the plug specified, converted to the type expected by usdAttr.
+  /// \param  attr the attribute to be read
+  /// \param  usdAttr the attribute whose type determines the conversion
+  /// \param  scale a scaling factor to apply to the value
+  /// \param  result the returned value. This will be empty if the plug type could not be converted.
+  AL_USDMAYA_UTILS_PUBLIC
+  static void getAttributeValue(const MPlug& attr, const UsdAttribute& usdAttr, float scale, VtValue& result);
+
+  /// \brief  read the current value of the plug specified, converted to the type expected by usdAttr.
+  /// \param  plug the attribute to be read
+  /// \param  usdAttr the attribute whose type determines the conversion
+  /// \param  scale a scaling factor to apply to the value
+  /// \param  result the returned value. This will be empty if the plug type could not be converted.
+  AL_USDMAYA_UTILS_PUBLIC
+  static void getSimpleValue(const MPlug& plug, const UsdAttribute& usdAttr, float scale, VtValue& result);
+
   /// \brief  convert value from the plug specified and set it to usd attribute.
   /// \param  plug the plug to copy the attributes value from
   /// \param  usdAttr the USDAttribute to set the attribute value to
@@ -24,6 +24,9 @@
 #include "pxr/usd/usd/timeCode.h"
 #include "pxr/usd/usdGeom/mesh.h"
 #include "pxr/usd/usd/attribute.h"
+#include "pxr/base/work/loops.h"
+
+#include <algorithm>
 
 PXR_NAMESPACE_USING_DIRECTIVE
 
@@ -728,95 +731,8 @@ TfToken guessUVInterpolationTypeExtensive(
     MIntArray& faceCounts,
     std::vector<uint32_t>& indicesToExtract)
 {
-  // if UV coords are all identical, we have a constant value
-  if(usd::utils::vec2AreAllTheSame(&u[0], &v[0], u.length()))
-  {
-    return UsdGeomTokens->constant;
-  }
-
-  std::map<int32_t, int32_t> indicesMap;
-
-  // do an exhaustive test to see if the UV assignments are per-vertex
-  {
-    indicesMap.emplace(pointIndices[0], indices[0]);
-    for(uint32_t i = 1, n = pointIndices.length(); i < n; ++i)
-    {
-      auto index = pointIndices[i];
-      auto uvindex = indices[i];
-      auto it = indicesMap.find(index);
-
-      // if not found, insert new entry in map
-      if(it == indicesMap.end())
-      {
-        indicesMap.emplace(index, uvindex);
-      }
-      else
-      {
-        // if the UV index matches, we have the same assignment
-        if(uvindex != it->second)
-        {
-          // if not, check to see if the indices differ, but the values are the same
-          const float u0 = u[it->second];
-          const float v0 = v[it->second];
-          const float u1 = u[uvindex];
-          const float v1 = v[uvindex];
-          if(u0 != u1 || v0 != v1)
-          {
-            goto uniform_test;
-          }
-        }
-      }
-    }
-
-    std::vector<uint32_t> tempIndicesToExtract(indicesMap.size());
-    auto iter = indicesMap.begin();
-    for(size_t i = 0; i < tempIndicesToExtract.size(); ++i, ++iter)
-    {
-      tempIndicesToExtract[i] = iter->second;
-    }
-    std::swap(indicesToExtract, tempIndicesToExtract);
-
-    return UsdGeomTokens->vertex;
-  }
-
-uniform_test:
-
-  // An exhaustive test to see if we have per-face assignment of UVs
-  {
-    uint32_t offset = 0;
-    for(uint32_t i = 0, n = faceCounts.length(); i < n; ++i)
-    {
-      const uint32_t numVerts = faceCounts[i];
-      const int32_t index = indices[offset];
-
-      // extract UV for first vertex in face
-      const float u0 = u[index];
-      const float v0 = v[index];
-
-      // process each face
-      for(uint32_t j = 1; j < numVerts; ++j)
-      {
-        const int32_t next_index = indices[offset + j];
-
-        // if the indices don't match
-        if(index != next_index)
-        {
-          // check the UV values directly
-          const float u1 = u[next_index];
-          const float v1 = v[next_index];
-          if(u0 != u1 || v0 != v1)
-          {
-            goto face_varying;
-          }
-        }
-      }
-      offset += numVerts;
-    }
-    return UsdGeomTokens->uniform;
-  }
-
-face_varying:
-  return UsdGeomTokens->faceVarying;
+  InterpolationClassifier classifier(pointIndices, faceCounts);
+  return classifier.classifyUvs(&u[0], &v[0], u.length(), &indices[0], indicesToExtract);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -885,124 +801,8 @@ TfToken guessVec3InterpolationTypeExtensive(
     MIntArray& pointIndices,
     MIntArray& faceCounts)
 {
-  // if prim vars are all identical, we have a constant value
-  if(usd::utils::vec3AreAllTheSame(xyz, numElements))
-  {
-    return UsdGeomTokens->constant;
-  }
-
-  // A little dirty. If running the tests via SSE, step back 1 element. We must not go beyond the end of a memory location
-  // in case we hit an non-mapped page (crash). On the assumption that all this data will come in a valid memory allocation,
-  // stepping back 4bytes will lead us into the allocation header (which we will ignore in our test)
-  #if defined(__SSE__)
-  --xyz;
-  #endif
-
-  std::unordered_map<int32_t, int32_t> indicesMap;
-
-  // do an exhaustive test to see if the prim var assignments are per-vertex
-  {
-    indicesMap.emplace(pointIndices[0], indices[0]);
-    for(uint32_t i = 1, n = pointIndices.length(); i < n; ++i)
-    {
-      auto index = pointIndices[i];
-      auto xyzindex = indices[i];
-      auto it = indicesMap.find(index);
-
-      // if not found, insert new entry in map
-      if(it == indicesMap.end())
-      {
-        indicesMap.emplace(index, xyzindex);
-      }
-      else
-      {
-        // if the index matches, we have the same assignment
-        if(xyzindex != it->second)
-        {
-          #if defined(__SSE__)
-
-          const f128 xyz0 = loadu4f(xyz + 3 * it->second);
-          const f128 xyz1 = loadu4f(xyz + 3 * xyzindex);
-          const f128 cmp = cmpne4f(xyz0, xyz1);
-          if(movemask4f(cmp) & 0xE)
-            goto uniform_test;
-
-          #else
-
-          // if not, check to see if the indices differ, but the values are the same
-          const float x0 = xyz[3 * it->second];
-          const float y0 = xyz[3 * it->second + 1];
-          const float z0 = xyz[3 * it->second + 2];
-          const float x1 = xyz[3 * xyzindex];
-          const float y1 = xyz[3 * xyzindex + 1];
-          const float z1 = xyz[3 * xyzindex + 2];
-          if(x0 != x1 || y0 != y1 || z0 != z1)
-            goto uniform_test;
-
-          #endif
-        }
-      }
-    }
-    return UsdGeomTokens->vertex;
-  }
-
-uniform_test:
-
-  // An exhaustive test to see if we have per-face assignment of prim vars
-  {
-    uint32_t offset = 0;
-    for(uint32_t i = 0, n = faceCounts.length(); i < n; ++i)
-    {
-      const uint32_t numVerts = faceCounts[i];
-      const int32_t index = indices[offset];
-
-      #if defined(__SSE__)
-
-      const f128 xyz0 = loadu4f(xyz + 3 * index);
-
-      #else
-
-      // extract prim var for first vertex in face
-      const float x0 = xyz[3 * index];
-      const float y0 = xyz[3 * index + 1];
-      const float z0 = xyz[3 * index + 2];
-
-      #endif
-
-      // process each face
-      for(uint32_t j = 1; j < numVerts; ++j)
-      {
-        const int32_t next_index = indices[offset + j];
-
-        // if the indices don't match
-        if(index != next_index)
-        {
-          #if defined(__SSE__)
-
-          const f128 xyz1 = loadu4f(xyz + 3 * next_index);
-          const f128 cmp = cmpne4f(xyz0, xyz1);
-          if(movemask4f(cmp) & 0xE)
-            goto face_varying;
-
-          #else
-
-          // check the values directly
-          const float x1 = xyz[3 * next_index];
-          const float y1 = xyz[3 * next_index + 1];
-          const float z1 = xyz[3 * next_index + 2];
-          if(x0 != x1 || y0 != y1 || z0 != z1)
-            goto face_varying;
-
-          #endif
-        }
-      }
-      offset += numVerts;
-    }
-    return UsdGeomTokens->uniform;
-  }
-
-face_varying:
-  return UsdGeomTokens->faceVarying;
+  InterpolationClassifier classifier(pointIndices, faceCounts);
+  return classifier.classifyVec3(xyz, numElements, &indices[0]);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -1071,86 +871,8 @@ TfToken guessVec3InterpolationTypeExtensive(
     MIntArray& pointIndices,
     MIntArray& faceCounts)
 {
-  // if UV coords are all identical, we have a constant value
-  if(usd::utils::vec3AreAllTheSame(xyz, numElements))
-  {
-    return UsdGeomTokens->constant;
-  }
-
-  std::unordered_map<int32_t, int32_t> indicesMap;
-
-  // do an exhaustive test to see if the UV assignments are per-vertex
-  {
-    indicesMap.emplace(pointIndices[0], indices[0]);
-    for(uint32_t i = 1, n = pointIndices.length(); i < n; ++i)
-    {
-      auto index = pointIndices[i];
-      auto xyzindex = indices[i];
-      auto it = indicesMap.find(index);
-
-      // if not found, insert new entry in map
-      if(it == indicesMap.end())
-      {
-        indicesMap.emplace(index, xyzindex);
-      }
-      else
-      {
-        // if the UV index matches, we have the same assignment
-        if(xyzindex != it->second)
-        {
-          // if not, check to see if the indices differ, but the values are the same
-          const double x0 = xyz[3 * it->second];
-          const double y0 = xyz[3 * it->second + 1];
-          const double z0 = xyz[3 * it->second + 2];
-          const double x1 = xyz[3 * xyzindex];
-          const double y1 = xyz[3 * xyzindex + 1];
-          const double z1 = xyz[3 * xyzindex + 2];
-          if(x0 != x1 || y0 != y1 || z0 != z1)
-            goto uniform_test;
-        }
-      }
-    }
-    return UsdGeomTokens->vertex;
-  }
-
-uniform_test:
-
-  // An exhaustive test to see if we have per-face assignment of UVs
-  {
-    uint32_t offset = 0;
-    for(uint32_t i = 0, n = faceCounts.length(); i < n; ++i)
-    {
-      const uint32_t numVerts = faceCounts[i];
-      const int32_t index = indices[offset];
-
-      // extract UV for first vertex in face
-      const double x0 = xyz[3 * index];
-      const double y0 = xyz[3 * index + 1];
-      const double z0 = xyz[3 * index + 2];
-
-      // process each face
-      for(uint32_t j = 1; j < numVerts; ++j)
-      {
-        const int32_t next_index = indices[offset + j];
-
-        // if the indices don't match
-        if(index != next_index)
-        {
-          // check the UV values directly
-          const double x1 = xyz[3 * next_index];
-          const double y1 = xyz[3 * next_index + 1];
-          const double z1 = xyz[3 * next_index + 2];
-          if(x0 != x1 || y0 != y1 || z0 != z1)
-            goto face_varying;
-        }
-      }
-      offset += numVerts;
-    }
-    return UsdGeomTokens->uniform;
-  }
-
-face_varying:
-  return UsdGeomTokens->faceVarying;
+  InterpolationClassifier classifier(pointIndices, faceCounts);
+  return classifier.classifyVec3(xyz, numElements, &indices[0]);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -1218,120 +940,8 @@ TfToken guessVec4InterpolationTypeExtensive(
     MIntArray& pointIndices,
     MIntArray& faceCounts)
 {
-  // if prim vars are all identical, we have a constant value
-  if(usd::utils::vec4AreAllTheSame(xyzw, numElements))
-  {
-    return UsdGeomTokens->constant;
-  }
-
-  std::unordered_map<int32_t, int32_t> indicesMap;
-
-  // do an exhaustive test to see if the UV assignments are per-vertex
-  {
-    indicesMap.emplace(pointIndices[0], indices[0]);
-    for(uint32_t i = 1, n = pointIndices.length(); i < n; ++i)
-    {
-      auto index = pointIndices[i];
-      auto xyzwindex = indices[i];
-      auto it = indicesMap.find(index);
-
-      // if not found, insert new entry in map
-      if(it == indicesMap.end())
-      {
-        indicesMap.emplace(index, xyzwindex);
-      }
-      else
-      {
-        // if the index matches, we have the same assignment
-        if(xyzwindex != it->second)
-        {
-          #if defined(__SSE__)
-
-          const f128 xyzw0 = loadu4f(xyzw + 4 * it->second);
-          const f128 xyzw1 = loadu4f(xyzw + 4 * xyzwindex);
-          const f128 cmp = cmpne4f(xyzw0, xyzw1);
-          if(movemask4f(cmp))
-            goto uniform_test;
-
-          #else
-
-          // if not, check to see if the indices differ, but the values are the same
-          const float x0 = xyzw[4 * it->second];
-          const float y0 = xyzw[4 * it->second + 1];
-          const float z0 = xyzw[4 * it->second + 2];
-          const float w0 = xyzw[4 * it->second + 3];
-          const float x1 = xyzw[4 * xyzwindex];
-          const float y1 = xyzw[4 * xyzwindex + 1];
-          const float z1 = xyzw[4 * xyzwindex + 2];
-          const float w1 = xyzw[4 * xyzwindex + 3];
-          if(x0 != x1 || y0 != y1 || z0 != z1 || w0 != w1)
-            goto uniform_test;
-
-          #endif
-        }
-      }
-    }
-    return UsdGeomTokens->vertex;
-  }
-
-uniform_test:
-
-  // An exhaustive test to see if we have per-face assignment of UVs
-  {
-    uint32_t offset = 0;
-    for(uint32_t i = 0, n = faceCounts.length(); i < n; ++i)
-    {
-      const uint32_t numVerts = faceCounts[i];
-      const int32_t index = indices[offset];
-
-      // extract UV for first vertex in face
-      #if defined(__SSE__)
-
-      const f128 xyzw0 = loadu4f(xyzw + 4 * index);
-
-      #else
-
-      const float x0 = xyzw[4 * index];
-      const float y0 = xyzw[4 * index + 1];
-      const float z0 = xyzw[4 * index + 2];
-      const float w0 = xyzw[4 * index + 3];
-
-      #endif
-
-      // process each face
-      for(uint32_t j = 1; j < numVerts; ++j)
-      {
-        const int32_t next_index = indices[offset + j];
-
-        // if the indices don't match
-        if(index != next_index)
-        {
-          #if defined(__SSE__)
-
-          const f128 xyzw1 = loadu4f(xyzw + 4 * next_index);
-          const f128 cmp = cmpne4f(xyzw0, xyzw1);
-          if(movemask4f(cmp))
-            goto face_varying;
-
-          #else
-          // check the UV values directly
-          const float x1 = xyzw[4 * next_index];
-          const float y1 = xyzw[4 * next_index + 1];
-          const float z1 = xyzw[4 * next_index + 2];
-          const float w1 = xyzw[4 * next_index + 3];
-          if(x0 != x1 || y0 != y1 || z0 != z1 || w0 != w1)
-            goto face_varying;
-
-          #endif
-        }
-      }
-      offset += numVerts;
-    }
-    return UsdGeomTokens->uniform;
-  }
-
-face_varying:
-  return UsdGeomTokens->faceVarying;
+  InterpolationClassifier classifier(pointIndices, faceCounts);
+  return classifier.classifyVec4(xyzw, numElements, &indices[0]);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -1399,268 +1009,294 @@ TfToken guessVec4InterpolationTypeExtensive(
     MIntArray& indices,
     MIntArray& pointIndices,
     MIntArray& faceCounts)
+{
+  InterpolationClassifier classifier(pointIndices, faceCounts);
+  return classifier.classifyVec4(xyzw, numElements, &indices[0]);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+TfToken guessColourSetInterpolationType(
+    const float* rgba,
+    const size_t numElements)
 {
   // if prim vars are all identical, we have a constant value
-  if(usd::utils::vec4AreAllTheSame(xyzw, numElements))
+  if(usd::utils::vec4AreAllTheSame(rgba, numElements))
   {
     return UsdGeomTokens->constant;
   }
 
-  std::unordered_map<int32_t, int32_t> indicesMap;
-
-  // do an exhaustive test to see if the assignments are per-vertex
-  {
-    indicesMap.emplace(pointIndices[0], indices[0]);
-    for(uint32_t i = 1, n = pointIndices.length(); i < n; ++i)
-    {
-      auto index = pointIndices[i];
-      auto xyzindex = indices[i];
-      auto it = indicesMap.find(index);
-
-      // if not found, insert new entry in map
-      if(it == indicesMap.end())
-      {
-        indicesMap.emplace(index, xyzindex);
-      }
-      else
-      {
-        // if the index matches, we have the same assignment
-        if(xyzindex != it->second)
-        {
-          #if defined(__AVX__)
-
-          const d256 xyzw0 = loadu4d(xyzw + 4 * it->second);
-          const d256 xyzw1 = loadu4d(xyzw + 4 * xyzindex);
-          const d256 cmp = cmpne4d(xyzw0, xyzw1);
-          if(movemask4d(cmp))
-            goto uniform_test;
-
-          #elif defined(__SSE__)
-
-          const d128 xy0 = loadu2d(xyzw + 4 * it->second);
-          const d128 zw0 = loadu2d(xyzw + 4 * it->second + 2);
-          const d128 xy1 = loadu2d(xyzw + 4 * xyzindex);
-          const d128 zw1 = loadu2d(xyzw + 4 * xyzindex + 2);
-          const d128 cmp = or2d(cmpne2d(xy0, xy1), cmpne2d(zw0, zw1));
-          if(movemask2d(cmp))
-            goto uniform_test;
-
-          #else
-
-          // if not, check to see if the indices differ, but the values are the same
-          const double x0 = xyzw[4 * it->second];
-          const double y0 = xyzw[4 * it->second + 1];
-          const double z0 = xyzw[4 * it->second + 2];
-          const double w0 = xyzw[4 * it->second + 3];
-          const double x1 = xyzw[4 * xyzindex];
-          const double y1 = xyzw[4 * xyzindex + 1];
-          const double z1 = xyzw[4 * xyzindex + 2];
-          const double w1 = xyzw[4 * xyzindex + 3];
-          if(x0 != x1 || y0 != y1 || z0 != z1 || w0 != w1)
-            goto uniform_test;
-
-          #endif
-        }
-      }
-    }
-    return UsdGeomTokens->vertex;
-  }
+  return UsdGeomTokens->faceVarying;
+}
 
-uniform_test:
 
-  // An exhaustive test to see if we have per-face assignment of UVs
-  {
-    uint32_t offset = 0;
-    for(uint32_t i = 0, n = faceCounts.length(); i < n; ++i)
-    {
-      const uint32_t numVerts = faceCounts[i];
-      const int32_t index = indices[offset];
+//----------------------------------------------------------------------------------------------------------------------
+TfToken guessColourSetInterpolationTypeExtensive(
+    const float* rgba,
+    const size_t numElements,
+    const size_t numPoints,
+    MIntArray& pointIndices,
+    MIntArray& faceCounts,
+    std::vector<uint32_t>& indicesToExtract)
+{
+  InterpolationClassifier classifier(pointIndices, faceCounts, uint32_t(numPoints));
+  return classifier.classifyColours(rgba, numElements, indicesToExtract);
+}
 
-      // extract for first vertex in face
-      #if defined(__AVX__)
 
-      const d256 xyzw0 = loadu4d(xyzw + 4 * index);
+namespace {
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  returns the scratch array used to record the prim var index first seen for each vertex, with all of the
+///         entries set to -1. There is one per thread, and the allocation is kept between calls.
+//----------------------------------------------------------------------------------------------------------------------
+std::vector<int32_t>& vertexScratch(const uint32_t numPoints)
+{
+  static thread_local std::vector<int32_t> scratch;
+  scratch.assign(numPoints, -1);
+  return scratch;
+}
 
-      #elif defined(__SSE__)
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  the prim var index for each face vertex is read from an index array
+//----------------------------------------------------------------------------------------------------------------------
+struct IndexArray
+{
+  const int32_t* indices;
+  inline int32_t operator () (const uint32_t faceVertex) const
+    { return indices[faceVertex]; }
+};
 
-      const d128 xy0 = loadu2d(xyzw + 4 * index);
-      const d128 zw0 = loadu2d(xyzw + 4 * index + 2);
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  the prim var has a value for each face vertex
+//----------------------------------------------------------------------------------------------------------------------
+struct FaceVertexIndex
+{
+  inline int32_t operator () (const uint32_t faceVertex) const
+    { return int32_t(faceVertex); }
+};
 
-      #else
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  returns true if the UVs at two indices differ
+//----------------------------------------------------------------------------------------------------------------------
+struct UvDiffers
+{
+  const float* u;
+  const float* v;
+  inline bool operator () (const int32_t a, const int32_t b) const
+    { return u[a] != u[b] || v[a] != v[b]; }
+};
 
-      const double x0 = xyzw[4 * index];
-      const double y0 = xyzw[4 * index + 1];
-      const double z0 = xyzw[4 * index + 2];
-      const double w0 = xyzw[4 * index + 3];
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  returns true if the N component vectors at two indices differ
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T, uint32_t N>
+struct VecNDiffers
+{
+  const T* data;
+  inline bool operator () (const int32_t a, const int32_t b) const
+  {
+    const T* const pa = data + size_t(N) * a;
+    const T* const pb = data + size_t(N) * b;
+    for(uint32_t i = 0; i < N; ++i)
+    {
+      if(pa[i] != pb[i])
+        return true;
+    }
+    return false;
+  }
+};
 
-      #endif
+#if defined(__SSE__)
+//----------------------------------------------------------------------------------------------------------------------
+template<>
+inline bool VecNDiffers<float, 4>::operator () (const int32_t a, const int32_t b) const
+{
+  const f128 cmp = cmpne4f(loadu4f(data + 4 * size_t(a)), loadu4f(data + 4 * size_t(b)));
+  return movemask4f(cmp) != 0;
+}
+#endif
+}
 
-      // process each face
-      for(uint32_t j = 1; j < numVerts; ++j)
-      {
-        const int32_t next_index = indices[offset + j];
+//----------------------------------------------------------------------------------------------------------------------
+InterpolationClassifier::InterpolationClassifier(MIntArray& pointIndices, MIntArray& faceCounts, const uint32_t numPoints)
+  : m_pointIndices(pointIndices.length() ? &pointIndices[0] : nullptr),
+    m_faceCounts(faceCounts.length() ? &faceCounts[0] : nullptr),
+    m_numFaceVertices(pointIndices.length()),
+    m_numFaces(faceCounts.length()),
+    m_numPoints(numPoints)
+{
+  if(!m_numPoints && m_numFaceVertices)
+  {
+    m_numPoints = uint32_t(*std::max_element(m_pointIndices, m_pointIndices + m_numFaceVertices)) + 1;
+  }
+}
 
-        // if the indices don't match
-        if(index != next_index)
-        {
-          #if defined(__AVX__)
+//----------------------------------------------------------------------------------------------------------------------
+template<typename IndexFn, typename DiffersFn>
+TfToken InterpolationClassifier::classify(IndexFn indexOf, DiffersFn differs, std::vector<uint32_t>* indicesToExtract) const
+{
+  std::vector<int32_t>& vertexIndices = vertexScratch(m_numPoints);
+  bool isVertex = true;
+  bool isUniform = true;
 
-          const d256 xyzw1 = loadu4d(xyzw + 4 * next_index);
-          const d256 cmp = cmpne4d(xyzw0, xyzw1);
-          if(movemask4d(cmp))
-            goto face_varying;
+  for(uint32_t i = 0, offset = 0; i < m_numFaces; ++i)
+  {
+    const uint32_t numVerts = m_faceCounts[i];
+    if(!numVerts)
+    {
+      continue;
+    }
 
-          #elif defined(__SSE__)
+    const int32_t faceIndex = indexOf(offset);
+    for(uint32_t j = 0; j < numVerts; ++j)
+    {
+      const int32_t index = indexOf(offset + j);
 
-          const d128 xy1 = loadu2d(xyzw + 4 * next_index);
-          const d128 zw1 = loadu2d(xyzw + 4 * next_index + 2);
-          const d128 cmp = or2d(cmpne2d(xy0, xy1), cmpne2d(zw0, zw1));
-          if(movemask2d(cmp))
-            goto face_varying;
+      // is the value the same for every face that shares this vertex?
+      if(isVertex)
+      {
+        int32_t& vertexIndex = vertexIndices[m_pointIndices[offset + j]];
+        if(vertexIndex < 0)
+        {
+          vertexIndex = index;
+        }
+        else
+        if(vertexIndex != index && differs(vertexIndex, index))
+        {
+          isVertex = false;
+        }
+      }
 
-          #else
+      // is the value the same for every vertex in this face?
+      if(isUniform && index != faceIndex && differs(faceIndex, index))
+      {
+        isUniform = false;
+      }
+    }
 
-          // check the values directly
-          const double x1 = xyzw[4 * next_index];
-          const double y1 = xyzw[4 * next_index + 1];
-          const double z1 = xyzw[4 * next_index + 2];
-          const double w1 = xyzw[4 * next_index + 3];
-          if(x0 != x1 || y0 != y1 || z0 != z1 || w0 != w1)
-            goto face_varying;
+    if(!isVertex && !isUniform)
+    {
+      return UsdGeomTokens->faceVarying;
+    }
+    offset += numVerts;
+  }
 
-          #endif
-        }
+  if(isVertex)
+  {
+    if(indicesToExtract)
+    {
+      // any vertices that are not used by a face are given the first value
+      indicesToExtract->resize(m_numPoints);
+      for(uint32_t i = 0; i < m_numPoints; ++i)
+      {
+        (*indicesToExtract)[i] = vertexIndices[i] < 0 ? 0 : uint32_t(vertexIndices[i]);
       }
-      offset += numVerts;
     }
-    return UsdGeomTokens->uniform;
+    return UsdGeomTokens->vertex;
   }
+  return UsdGeomTokens->uniform;
+}
 
-face_varying:
-  return UsdGeomTokens->faceVarying;
+//----------------------------------------------------------------------------------------------------------------------
+TfToken InterpolationClassifier::classifyUvs(
+    const float* const u,
+    const float* const v,
+    const uint32_t numUvs,
+    const int32_t* const uvIndices,
+    std::vector<uint32_t>& indicesToExtract) const
+{
+  // if UV coords are all identical, we have a constant value
+  if(usd::utils::vec2AreAllTheSame(u, v, numUvs))
+  {
+    return UsdGeomTokens->constant;
+  }
+  return classify(IndexArray{uvIndices}, UvDiffers{u, v}, &indicesToExtract);
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+TfToken InterpolationClassifier::classifyVec3(const float* const xyz, const size_t numElements, const int32_t* const indices) const
+{
+  if(usd::utils::vec3AreAllTheSame(xyz, numElements))
+  {
+    return UsdGeomTokens->constant;
+  }
+  return classify(IndexArray{indices}, VecNDiffers<float, 3>{xyz}, nullptr);
+}
 
 //----------------------------------------------------------------------------------------------------------------------
-TfToken guessColourSetInterpolationType(
-    const float* rgba,
-    const size_t numElements)
+TfToken InterpolationClassifier::classifyVec3(const double* const xyz, const size_t numElements, const int32_t* const indices) const
 {
-  // if prim vars are all identical, we have a constant value
-  if(usd::utils::vec4AreAllTheSame(rgba, numElements))
+  if(usd::utils::vec3AreAllTheSame(xyz, numElements))
   {
     return UsdGeomTokens->constant;
   }
+  return classify(IndexArray{indices}, VecNDiffers<double, 3>{xyz}, nullptr);
+}
 
-  return UsdGeomTokens->faceVarying;
+//----------------------------------------------------------------------------------------------------------------------
+TfToken InterpolationClassifier::classifyVec4(const float* const xyzw, const size_t numElements, const int32_t* const indices) const
+{
+  if(usd::utils::vec4AreAllTheSame(xyzw, numElements))
+  {
+    return UsdGeomTokens->constant;
+  }
+  return classify(IndexArray{indices}, VecNDiffers<float, 4>{xyzw}, nullptr);
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+TfToken InterpolationClassifier::classifyVec4(const double* const xyzw, const size_t numElements, const int32_t* const indices) const
+{
+  if(usd::utils::vec4AreAllTheSame(xyzw, numElements))
+  {
+    return UsdGeomTokens->constant;
+  }
+  return classify(IndexArray{indices}, VecNDiffers<double, 4>{xyzw}, nullptr);
+}
 
 //----------------------------------------------------------------------------------------------------------------------
-TfToken guessColourSetInterpolationTypeExtensive(
-    const float* rgba,
+TfToken InterpolationClassifier::classifyColours(
+    const float* const rgba,
     const size_t numElements,
-    const size_t numPoints,
-    MIntArray& pointIndices,
-    MIntArray& faceCounts,
-    std::vector<uint32_t>& indicesToExtract)
+    std::vector<uint32_t>& indicesToExtract) const
 {
-  // if prim vars are all identical, we have a constant value
+  indicesToExtract.clear();
   if(usd::utils::vec4AreAllTheSame(rgba, numElements))
   {
     return UsdGeomTokens->constant;
   }
 
-  // check for per-vertex assignment
-  std::vector<uint32_t> indicesMap;
-  indicesMap.resize(numPoints, -1);
-
+  const TfToken interpolation = classify(FaceVertexIndex(), VecNDiffers<float, 4>{rgba}, &indicesToExtract);
+  if(interpolation == UsdGeomTokens->uniform)
   {
-    for(uint32_t i = 0, n = pointIndices.length(); i < n; ++i)
+    // extract the colour of the first vertex in each face
+    indicesToExtract.resize(m_numFaces);
+    for(uint32_t i = 0, offset = 0; i < m_numFaces; offset += m_faceCounts[i], ++i)
     {
-      auto index = pointIndices[i];
-      auto lastIndex = indicesMap[index];
-      if(lastIndex == 0xFFFFFFFF)
-      {
-        indicesMap[index] = i;
-      }
-      else
-      {
-        #if defined(__SSE__)
-
-        const f128 rgba0 = loadu4f(rgba + 4 * lastIndex);
-        const f128 rgba1 = loadu4f(rgba + 4 * i);
-        const f128 cmp = cmpne4f(rgba0, rgba1);
-        if(movemask4f(cmp))
-          goto uniform_test;
-
-        #else
-
-        // if not, check to see if the indices differ, but the values are the same
-        const float x0 = rgba[4 * lastIndex + 0];
-        const float y0 = rgba[4 * lastIndex + 1];
-        const float z0 = rgba[4 * lastIndex + 2];
-        const float w0 = rgba[4 * lastIndex + 3];
-        const float x1 = rgba[4 * i + 0];
-        const float y1 = rgba[4 * i + 1];
-        const float z1 = rgba[4 * i + 2];
-        const float w1 = rgba[4 * i + 3];
-        if(x0 != x1 || y0 != y1 || z0 != z1 || w0 != w1)
-          goto uniform_test;
-
-        #endif
-      }
+      indicesToExtract[i] = offset;
     }
-    std::swap(indicesToExtract, indicesMap);
-    return UsdGeomTokens->vertex;
   }
+  return interpolation;
+}
 
-uniform_test:
-
-  const uint32_t numFaces = faceCounts.length();
-  indicesMap.resize(numFaces);
-  uint32_t offset = 0;
-  for(uint32_t i = 0; i < numFaces; ++i)
+//----------------------------------------------------------------------------------------------------------------------
+void InterpolationClassifier::classifyUvSets(std::vector<UvSetInterpolation>& uvSets) const
+{
+  WorkParallelForN(uvSets.size(), [this, &uvSets](const size_t begin, const size_t end)
   {
-    indicesMap[i] = offset;
-
-    int numPointsInFace = faceCounts[i];
-    #if defined(__SSE__)
-
-    const f128 rgba0 = loadu4f(rgba + 4 * offset);
-    for(int32_t j = 1; j < numPointsInFace; ++j)
-    {
-      const f128 rgba1 = loadu4f(rgba + 4 * (offset + j));
-      const f128 cmp = cmpne4f(rgba0, rgba1);
-      if(movemask4f(cmp))
-        goto faceVarying;
-    }
-
-    #else
-
-    const float* rgba0 = rgba + 4 * offset;
-    for(int32_t j = 1; j < numPointsInFace; ++j)
+    for(size_t i = begin; i < end; ++i)
     {
-      const float* rgba1 = rgba + 4 * (offset + j);
-      if(rgba0[0] != rgba1[0] ||
-         rgba0[1] != rgba1[1] ||
-         rgba0[2] != rgba1[2] ||
-         rgba0[3] != rgba1[3])
-        goto faceVarying;
+      UvSetInterpolation& uvSet = uvSets[i];
+      uvSet.indicesToExtract.clear();
+      if(!uvSet.u.length() || uvSet.uvIds.length() != m_numFaceVertices)
+      {
+        uvSet.interpolation = UsdGeomTokens->faceVarying;
+        continue;
+      }
+      uvSet.interpolation = classifyUvs(&uvSet.u[0], &uvSet.v[0], uvSet.u.length(), &uvSet.uvIds[0], uvSet.indicesToExtract);
     }
-
-    #endif
-
-    offset += numPointsInFace;
-  }
-  std::swap(indicesToExtract, indicesMap);
-  return UsdGeomTokens->uniform;
-
-faceVarying:
-  return UsdGeomTokens->faceVarying;
+  });
 }
 
-
 //----------------------------------------------------------------------------------------------------------------------
 } // utils
 } // usdmaya
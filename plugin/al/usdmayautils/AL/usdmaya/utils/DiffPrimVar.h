@@ -537,6 +537,116 @@ TfToken guessColourSetInterpolationTypeExtensive(
     MIntArray& faceCounts,
     std::vector<uint32_t>& indicesToExtract);
 
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  The data for a single UV set, and the result of classifying it via InterpolationClassifier::classifyUvSets
+//----------------------------------------------------------------------------------------------------------------------
+struct UvSetInterpolation
+{
+  MFloatArray u; ///< the U components
+  MFloatArray v; ///< the V components
+  MIntArray uvCounts; ///< the number of UVs assigned to each face
+  MIntArray uvIds; ///< the UV index for each face vertex
+  TfToken interpolation; ///< the resulting interpolation
+  std::vector<uint32_t> indicesToExtract; ///< for vertex interpolation, the UV index to extract for each vertex
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  Determines the interpolation of prim var data assigned to the face vertices of a single mesh.
+///
+///         Each prim var is classified with a single pass over the face vertices, which tests for per-vertex and
+///         per-face assignment at the same time, stopping as soon as both have failed. The per-vertex test records the
+///         first value seen for each vertex in a dense array indexed by the vertex, rather than a map. That scratch
+///         array is allocated per thread and reused between calls, so classifiers for different meshes (or different
+///         prim vars on the same mesh) may be run in parallel.
+///
+///         The guess*InterpolationTypeExtensive functions are implemented using this class. When classifying all of
+///         the prim vars on a mesh, constructing one classifier and reusing it avoids re-scanning the topology.
+//----------------------------------------------------------------------------------------------------------------------
+class InterpolationClassifier
+{
+public:
+
+  /// \brief  ctor
+  /// \param  pointIndices the vertex index for each face vertex. This array must outlive the classifier.
+  /// \param  faceCounts the number of vertices in each face. This array must outlive the classifier.
+  /// \param  numPoints the number of vertices in the mesh. If zero, this is computed from the pointIndices.
+  AL_USDMAYA_UTILS_PUBLIC
+  InterpolationClassifier(MIntArray& pointIndices, MIntArray& faceCounts, uint32_t numPoints = 0);
+
+  /// \brief  classifies a UV set
+  /// \param  u the U components
+  /// \param  v the V components
+  /// \param  numUvs the number of elements in the u and v arrays
+  /// \param  uvIndices the UV index for each face vertex
+  /// \param  indicesToExtract if the UVs are per-vertex, this is filled with the UV index to extract for each vertex.
+  ///         It is left untouched for the other interpolation types.
+  /// \return UsdGeomTokens->constant, UsdGeomTokens->vertex, UsdGeomTokens->uniform, or UsdGeomTokens->faceVarying
+  AL_USDMAYA_UTILS_PUBLIC
+  TfToken classifyUvs(const float* u, const float* v, uint32_t numUvs, const int32_t* uvIndices,
+                      std::vector<uint32_t>& indicesToExtract) const;
+
+  /// \brief  classifies a set of vec3 prim var values
+  /// \param  xyz the vec3 data
+  /// \param  numElements the number of vec3s in the xyz array
+  /// \param  indices the prim var index for each face vertex
+  /// \return UsdGeomTokens->constant, UsdGeomTokens->vertex, UsdGeomTokens->uniform, or UsdGeomTokens->faceVarying
+  AL_USDMAYA_UTILS_PUBLIC
+  TfToken classifyVec3(const float* xyz, size_t numElements, const int32_t* indices) const;
+
+  /// \brief  classifies a set of vec3 prim var values
+  /// \param  xyz the vec3 data
+  /// \param  numElements the number of vec3s in the xyz array
+  /// \param  indices the prim var index for each face vertex
+  /// \return UsdGeomTokens->constant, UsdGeomTokens->vertex, UsdGeomTokens->uniform, or UsdGeomTokens->faceVarying
+  AL_USDMAYA_UTILS_PUBLIC
+  TfToken classifyVec3(const double* xyz, size_t numElements, const int32_t* indices) const;
+
+  /// \brief  classifies a set of vec4 prim var values
+  /// \param  xyzw the vec4 data
+  /// \param  numElements the number of vec4s in the xyzw array
+  /// \param  indices the prim var index for each face vertex
+  /// \return UsdGeomTokens->constant, UsdGeomTokens->vertex, UsdGeomTokens->uniform, or UsdGeomTokens->faceVarying
+  AL_USDMAYA_UTILS_PUBLIC
+  TfToken classifyVec4(const float* xyzw, size_t numElements, const int32_t* indices) const;
+
+  /// \brief  classifies a set of vec4 prim var values
+  /// \param  xyzw the vec4 data
+  /// \param  numElements the number of vec4s in the xyzw array
+  /// \param  indices the prim var index for each face vertex
+  /// \return UsdGeomTokens->constant, UsdGeomTokens->vertex, UsdGeomTokens->uniform, or UsdGeomTokens->faceVarying
+  AL_USDMAYA_UTILS_PUBLIC
+  TfToken classifyVec4(const double* xyzw, size_t numElements, const int32_t* indices) const;
+
+  /// \brief  classifies a colour set, which has one colour per face vertex
+  /// \param  rgba the face varying colour array
+  /// \param  numElements the number of RGBA colours in the rgba array
+  /// \param  indicesToExtract for vertex or uniform interpolation, this is filled with the index of the colour to
+  ///         extract for each vertex (or face). It is cleared for the other interpolation types.
+  /// \return UsdGeomTokens->constant, UsdGeomTokens->vertex, UsdGeomTokens->uniform, or UsdGeomTokens->faceVarying
+  AL_USDMAYA_UTILS_PUBLIC
+  TfToken classifyColours(const float* rgba, size_t numElements, std::vector<uint32_t>& indicesToExtract) const;
+
+  /// \brief  classifies all of the UV sets of the mesh in parallel, filling in the interpolation and indicesToExtract
+  ///         of each. Sets that have no UVs are left as faceVarying.
+  /// \param  uvSets the UV sets to classify
+  AL_USDMAYA_UTILS_PUBLIC
+  void classifyUvSets(std::vector<UvSetInterpolation>& uvSets) const;
+
+  /// \brief  returns the number of vertices in the mesh
+  inline uint32_t numPoints() const
+    { return m_numPoints; }
+
+private:
+  template<typename IndexFn, typename DiffersFn>
+  TfToken classify(IndexFn indexOf, DiffersFn differs, std::vector<uint32_t>* indicesToExtract) const;
+
+  const int32_t* m_pointIndices;
+  const int32_t* m_faceCounts;
+  uint32_t m_numFaceVertices;
+  uint32_t m_numFaces;
+  uint32_t m_numPoints;
+};
+
 //----------------------------------------------------------------------------------------------------------------------
 } // utils
 } // usdmaya
@@ -1095,128 +1095,152 @@ void MeshExportContext::copyUvSetData()
   }
 
   VtArray<GfVec2f> uvValues;
-  MFloatArray uValues, vValues;
-  MIntArray uvCounts, uvIds;
-  std::vector<uint32_t> indicesToExtract;
 
+  // extract the data for all of the UV sets up front (sparse UV sets are skipped), so that they can be classified together
+  std::vector<UvSetInterpolation> uvSets(uvSetNames.length());
+  std::vector<bool> validUvSets(uvSetNames.length(), false);
   for (uint32_t i = 0; i < uvSetNames.length(); i++)
   {
-    TfToken interpolation = UsdGeomTokens->faceVarying;
-
-    // Initialize the VtArray to the max possible size (facevarying)
-    if(fnMesh.getAssignedUVs(uvCounts, uvIds, &uvSetNames[i]))
+    UvSetInterpolation& uvData = uvSets[i];
+    uvData.interpolation = UsdGeomTokens->faceVarying;
+    if(fnMesh.getAssignedUVs(uvData.uvCounts, uvData.uvIds, &uvSetNames[i]))
     {
-      int32_t* ptr = &uvCounts[0];
-      if(!isUvSetDataSparse(ptr, uvCounts.length()))
+      int32_t* ptr = &uvData.uvCounts[0];
+      if(!isUvSetDataSparse(ptr, uvData.uvCounts.length()))
       {
-        if(fnMesh.getUVs(uValues, vValues, &uvSetNames[i]))
-        {
-          indicesToExtract.clear();
-          switch(compaction)
-          {
-          case kNone:
-            break;
-          case kBasic:
-            interpolation = guessUVInterpolationType(uValues, vValues, uvIds, faceConnects);
-            break;
-          case kMedium:
-            interpolation = guessUVInterpolationTypeExtended(uValues, vValues, uvIds, faceConnects, uvCounts);
-            break;
-          case kFull:
-            interpolation = guessUVInterpolationTypeExtensive(uValues, vValues, uvIds, faceConnects, uvCounts, indicesToExtract);
-            break;
-          }
+        validUvSets[i] = fnMesh.getUVs(uvData.u, uvData.v, &uvSetNames[i]) == MS::kSuccess;
+      }
+      else
+      {
+        // What to do here then....
+      }
+    }
+  }
 
-          if(interpolation == UsdGeomTokens->constant)
-          {
-            uvValues.resize(1);
-            fnMesh.getUV(0, uvValues[0][0], uvValues[0][1], &uvSetNames[i]);
-            if (uvSetNames[i] == "map1")
-            {
-              uvSetNames[i] = "st";
-            }
-            UsdGeomPrimvar uvSet = mesh.CreatePrimvar(TfToken(uvSetNames[i].asChar()), SdfValueTypeNames->Float2Array, UsdGeomTokens->constant);
-            uvSet.Set(uvValues, m_timeCode);
-          }
-          else
-          if(interpolation == UsdGeomTokens->vertex)
-          {
-            if(uValues.length())
-            {
-              const uint32_t npoints = fnMesh.numVertices();
-              uvValues.resize(npoints);
+  switch(compaction)
+  {
+  case kNone:
+    break;
+  case kBasic:
+    for (uint32_t i = 0; i < uvSetNames.length(); i++)
+    {
+      if(validUvSets[i])
+        uvSets[i].interpolation = guessUVInterpolationType(uvSets[i].u, uvSets[i].v, uvSets[i].uvIds, faceConnects);
+    }
+    break;
+  case kMedium:
+    for (uint32_t i = 0; i < uvSetNames.length(); i++)
+    {
+      if(validUvSets[i])
+        uvSets[i].interpolation = guessUVInterpolationTypeExtended(uvSets[i].u, uvSets[i].v, uvSets[i].uvIds, faceConnects, uvSets[i].uvCounts);
+    }
+    break;
+  case kFull:
+    {
+      // sets that were skipped above have no UVs, so are left as face varying
+      InterpolationClassifier classifier(faceConnects, faceCounts, fnMesh.numVertices());
+      classifier.classifyUvSets(uvSets);
+    }
+    break;
+  }
 
-              float* uptr = &uValues[0];
-              float* vptr = &vValues[0];
-              float* uvptr = (float*)uvValues.data();
-              if(indicesToExtract.empty())
-              {
-                zipUVs(uptr, vptr, uvptr, uValues.length());
-              }
-              else
-              {
-                for(uint32_t j = 0; j < indicesToExtract.size(); ++j)
-                {
-                  uint32_t index = indicesToExtract[j];
-                  uvptr[j * 2 + 0] = uptr[index];
-                  uvptr[j * 2 + 1] = vptr[index];
-                }
-              }
-              if (uvSetNames[i] == "map1")
-              {
-                uvSetNames[i] = "st";
-              }
-              UsdGeomPrimvar uvSet = mesh.CreatePrimvar(TfToken(uvSetNames[i].asChar()), SdfValueTypeNames->Float2Array, UsdGeomTokens->vertex);
-              uvSet.Set(uvValues, m_timeCode);
-            }
-          }
-          else
-          if(interpolation == UsdGeomTokens->uniform)
-          {
-            const uint32_t nfaces = fnMesh.numPolygons();
-            uvValues.resize(nfaces);
-            for(uint32_t j = 0; j < nfaces; ++j)
-            {
-              fnMesh.getPolygonUV(j, 0, uvValues[j][0], uvValues[j][1], &uvSetNames[i]);
-            }
-            if (uvSetNames[i] == "map1")
-            {
-              uvSetNames[i] = "st";
-            }
-            UsdGeomPrimvar uvSet = mesh.CreatePrimvar(TfToken(uvSetNames[i].asChar()), SdfValueTypeNames->Float2Array, UsdGeomTokens->uniform);
-            uvSet.Set(uvValues, m_timeCode);
-          }
-          else
-          {
-            uvValues.resize(uValues.length());
-            if (uvSetNames[i] == "map1")
-            {
-              uvSetNames[i] = "st";
-            }
+  for (uint32_t i = 0; i < uvSetNames.length(); i++)
+  {
+    if(!validUvSets[i])
+    {
+      continue;
+    }
 
-            float* uptr = &uValues[0];
-            float* vptr = &vValues[0];
-            float* uvptr = (float*)uvValues.data();
-            zipUVs(uptr, vptr, uvptr, vValues.length());
+    const TfToken& interpolation = uvSets[i].interpolation;
+    const std::vector<uint32_t>& indicesToExtract = uvSets[i].indicesToExtract;
+    MFloatArray& uValues = uvSets[i].u;
+    MFloatArray& vValues = uvSets[i].v;
+    MIntArray& uvIds = uvSets[i].uvIds;
 
-            /// \todo   Ideally I'd want some form of interpolation scheme such as UsdGeomTokens->faceVaryingIndexed
-            UsdGeomPrimvar uvSet = mesh.CreatePrimvar(TfToken(uvSetNames[i].asChar()), SdfValueTypeNames->Float2Array, UsdGeomTokens->faceVarying);
-            uvSet.Set(uvValues);
+    if(interpolation == UsdGeomTokens->constant)
+    {
+      uvValues.resize(1);
+      fnMesh.getUV(0, uvValues[0][0], uvValues[0][1], &uvSetNames[i]);
+      if (uvSetNames[i] == "map1")
+      {
+        uvSetNames[i] = "st";
+      }
+      UsdGeomPrimvar uvSet = mesh.CreatePrimvar(TfToken(uvSetNames[i].asChar()), SdfValueTypeNames->Float2Array, UsdGeomTokens->constant);
+      uvSet.Set(uvValues, m_timeCode);
+    }
+    else
+    if(interpolation == UsdGeomTokens->vertex)
+    {
+      if(uValues.length())
+      {
+        const uint32_t npoints = fnMesh.numVertices();
+        uvValues.resize(npoints);
 
-            VtArray<int32_t> uvIndices;
-            int32_t* ptr = &uvIds[0];
-            uvIndices.assign(ptr, ptr + uvIds.length());
-            uvSet.SetIndices(uvIndices, m_timeCode);
+        float* uptr = &uValues[0];
+        float* vptr = &vValues[0];
+        float* uvptr = (float*)uvValues.data();
+        if(indicesToExtract.empty())
+        {
+          zipUVs(uptr, vptr, uvptr, uValues.length());
+        }
+        else
+        {
+          for(uint32_t j = 0; j < indicesToExtract.size(); ++j)
+          {
+            uint32_t index = indicesToExtract[j];
+            uvptr[j * 2 + 0] = uptr[index];
+            uvptr[j * 2 + 1] = vptr[index];
           }
         }
+        if (uvSetNames[i] == "map1")
+        {
+          uvSetNames[i] = "st";
+        }
+        UsdGeomPrimvar uvSet = mesh.CreatePrimvar(TfToken(uvSetNames[i].asChar()), SdfValueTypeNames->Float2Array, UsdGeomTokens->vertex);
+        uvSet.Set(uvValues, m_timeCode);
       }
-      else
+    }
+    else
+    if(interpolation == UsdGeomTokens->uniform)
+    {
+      const uint32_t nfaces = fnMesh.numPolygons();
+      uvValues.resize(nfaces);
+      for(uint32_t j = 0; j < nfaces; ++j)
       {
-        // What to do here then....
+        fnMesh.getPolygonUV(j, 0, uvValues[j][0], uvValues[j][1], &uvSetNames[i]);
+      }
+      if (uvSetNames[i] == "map1")
+      {
+        uvSetNames[i] = "st";
       }
+      UsdGeomPrimvar uvSet = mesh.CreatePrimvar(TfToken(uvSetNames[i].asChar()), SdfValueTypeNames->Float2Array, UsdGeomTokens->uniform);
+      uvSet.Set(uvValues, m_timeCode);
+    }
+    else
+    {
+      uvValues.resize(uValues.length());
+      if (uvSetNames[i] == "map1")
+      {
+        uvSetNames[i] = "st";
+      }
+
+      float* uptr = &uValues[0];
+      float* vptr = &vValues[0];
+      float* uvptr = (float*)uvValues.data();
+      zipUVs(uptr, vptr, uvptr, vValues.length());
+
+      /// \todo   Ideally I'd want some form of interpolation scheme such as UsdGeomTokens->faceVaryingIndexed
+      UsdGeomPrimvar uvSet = mesh.CreatePrimvar(TfToken(uvSetNames[i].asChar()), SdfValueTypeNames->Float2Array, UsdGeomTokens->faceVarying);
+      uvSet.Set(uvValues);
+
+      VtArray<int32_t> uvIndices;
+      int32_t* ptr = &uvIds[0];
+      uvIndices.assign(ptr, ptr + uvIds.length());
+      uvSet.SetIndices(uvIndices, m_timeCode);
     }
   }
 
+  MFloatArray uValues, vValues;
   for (uint32_t i = 0; i < diff_report.size(); i++)
   {
     UsdGeomPrimvar& uvSet = diff_report[i].primVar();
@@ -29,12 +29,14 @@
 #endif
 #include "pxr/base/gf/half.h"
 #include "pxr/base/gf/ilmbase_half.h"
+#include "AL/usd/utils/SIMD.h"
 
 PXR_NAMESPACE_USING_DIRECTIVE
 
 namespace AL {
 namespace usd {
 namespace utils {
+inline namespace AL_SIMD_NAMESPACE {
 
 #ifdef __F16C__
 
@@ -256,6 +258,7 @@ inline GfHalf double2half_1f(const double f)
 }
 #endif
 
+} // AL_SIMD_NAMESPACE
 } // utils
 } // usd
 } // AL
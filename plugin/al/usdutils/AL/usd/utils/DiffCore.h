@@ -446,6 +446,67 @@ bool compareRGBAArray(
     const size_t count,
     const float eps = 1e-5f);
 
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  The instruction sets that the DiffCore methods have been compiled for. The methods above are dispatched at
+///         runtime to the highest tier that both the library was built with, and the CPU supports.
+//----------------------------------------------------------------------------------------------------------------------
+enum class SIMDTier : uint32_t
+{
+  kSSE, ///< the instruction set that the rest of the library is compiled for (SSE3 on linux)
+  kAVX2, ///< AVX2, FMA & F16C
+  kAVX512, ///< AVX-512 F, BW & VL
+  kNumTiers
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  A table of the DiffCore methods, as compiled for one of the SIMD tiers. See the free functions above for
+///         a description of each method.
+//----------------------------------------------------------------------------------------------------------------------
+struct DiffCoreKernels
+{
+  bool (*vec2AreAllTheSameUV)(const float* u, const float* v, size_t count);
+  bool (*vec2AreAllTheSameFloat)(const float* array, size_t count);
+  bool (*vec3AreAllTheSameFloat)(const float* array, size_t count);
+  bool (*vec4AreAllTheSameFloat)(const float* array, size_t count);
+  bool (*vec2AreAllTheSameDouble)(const double* array, size_t count);
+  bool (*vec3AreAllTheSameDouble)(const double* array, size_t count);
+  bool (*vec4AreAllTheSameDouble)(const double* array, size_t count);
+  bool (*compareArrayHalfFloat)(const GfHalf* input0, const float* input1, size_t count0, size_t count1, float eps);
+  bool (*compareArrayHalfDouble)(const GfHalf* input0, const double* input1, size_t count0, size_t count1, double eps);
+  bool (*compareArrayDoubleFloat)(const double* input0, const float* input1, size_t count0, size_t count1, float eps);
+  bool (*compareArrayDouble)(const double* input0, const double* input1, size_t count0, size_t count1, double eps);
+  bool (*compareArrayFloat)(const float* input0, const float* input1, size_t count0, size_t count1, float eps);
+  bool (*compareArrayInt8)(const int8_t* input0, const int8_t* input1, size_t count0, size_t count1);
+  bool (*compareArrayInt32)(const int32_t* input0, const int32_t* input1, size_t count0, size_t count1);
+  bool (*compareArray3Dto4D)(const float* input3d, const float* input4d, size_t count3d, size_t count4d, float eps);
+  bool (*compareArrayFloat3DtoDouble4D)(const float* input3d, const double* input4d, size_t count3d, size_t count4d,
+                                        float eps);
+  bool (*compareUvArray)(const float* u0, const float* v0, const float* uv1, size_t count0, size_t count1, float eps);
+  bool (*compareUvArrayToConstant)(float u0, float v0, const float* u1, const float* v1, size_t count, float eps);
+  bool (*compareRGBAArray)(float r, float g, float b, float a, const float* rgba, size_t count, float eps);
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  returns the kernels compiled for the specified tier
+/// \param  tier the instruction set of the kernels to return
+/// \return the kernels, or nullptr if the library was built without that tier, or the CPU does not support it
+//----------------------------------------------------------------------------------------------------------------------
+AL_USD_UTILS_PUBLIC
+const DiffCoreKernels* diffCoreKernels(SIMDTier tier);
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  returns the tier used by the DiffCore methods. This is the highest tier that is available, unless it has
+///         been limited via the AL_USDUTILS_SIMD_TIER environment variable (set to "sse", "avx2" or "avx512").
+//----------------------------------------------------------------------------------------------------------------------
+AL_USD_UTILS_PUBLIC
+SIMDTier activeSIMDTier();
+
+//----------------------------------------------------------------------------------------------------------------------
+/// \brief  returns the name of the tier, e.g. "avx2"
+//----------------------------------------------------------------------------------------------------------------------
+AL_USD_UTILS_PUBLIC
+const char* simdTierName(SIMDTier tier);
+
 //----------------------------------------------------------------------------------------------------------------------
 } // utils
 } // usd
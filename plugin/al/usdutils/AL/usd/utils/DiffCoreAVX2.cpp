@@ -0,0 +1,26 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// The DiffCore kernels, compiled with AVX2, FMA & F16C enabled (see CMakeLists.txt).
+#if !defined(__AVX2__)
+# error "DiffCoreAVX2.cpp must be compiled with AVX2 enabled"
+#endif
+#if defined(_MSC_VER) && !defined(__F16C__)
+// MSVC does not define __F16C__, but every CPU that supports AVX2 also supports F16C
+# define __F16C__ 1
+#endif
+#define AL_USD_UTILS_DIFFCORE_TIER avx2
+#include "AL/usd/utils/DiffCoreKernels.h"
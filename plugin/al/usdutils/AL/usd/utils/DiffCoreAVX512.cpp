@@ -0,0 +1,22 @@
+//
+// Copyright 2019 Animal Logic
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// The DiffCore kernels, compiled with AVX-512 F, BW & VL enabled (see CMakeLists.txt).
+#if !defined(__AVX512F__) || !defined(__AVX512BW__) || !defined(__AVX512VL__)
+# error "DiffCoreAVX512.cpp must be compiled with AVX-512 F, BW and VL enabled"
+#endif
+#define AL_USD_UTILS_DIFFCORE_TIER avx512
+#include "AL/usd/utils/DiffCoreKernels.h"
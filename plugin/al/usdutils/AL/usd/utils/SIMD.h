@@ -59,7 +59,28 @@
 # define ENABLE_SOME_AVX_ROUTINES 1
 #endif
 
+// The helpers in this file (and in ALHalf.h) are compiled differently depending on the instruction sets that are
+// enabled. A library may build some of its files for a higher instruction set than the rest (see DiffCore), in which
+// case the linker must not merge the copies of an inline function compiled for different instruction sets, so each
+// variant lives in its own (inline) namespace.
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+# define AL_SIMD_AVX512 1
+#endif
+
+#if defined(AL_SIMD_AVX512)
+# define AL_SIMD_NAMESPACE simd_avx512
+#elif defined(__AVX2__)
+# define AL_SIMD_NAMESPACE simd_avx2
+#elif defined(__F16C__)
+# define AL_SIMD_NAMESPACE simd_sse_f16c
+#elif defined(__SSE__)
+# define AL_SIMD_NAMESPACE simd_sse
+#else
+# define AL_SIMD_NAMESPACE simd_scalar
+#endif
+
 namespace AL {
+inline namespace AL_SIMD_NAMESPACE {
 
 #if defined(__SSE__)
 typedef __m128 f128;
@@ -415,4 +436,80 @@ inline f128 loadmask3f(const void* const ptr, size_t count)
 }
 #endif
 
+#if defined(AL_SIMD_AVX512)
+typedef __m512 f512;
+typedef __m512i i512;
+typedef __m512d d512;
+typedef __mmask8 mask8;
+typedef __mmask16 mask16;
+typedef __mmask32 mask32;
+typedef __mmask64 mask64;
+
+/// \brief  returns a mask with the first N bits set (all bits if N is larger than the mask)
+AL_DLL_HIDDEN inline mask8 firstNmask8(const size_t n) { return n >= 8 ? mask8(0xFF) : mask8((1u << n) - 1); }
+AL_DLL_HIDDEN inline mask16 firstNmask16(const size_t n) { return n >= 16 ? mask16(0xFFFF) : mask16((1u << n) - 1); }
+AL_DLL_HIDDEN inline mask32 firstNmask32(const size_t n) { return n >= 32 ? mask32(0xFFFFFFFF) : mask32((1u << n) - 1); }
+AL_DLL_HIDDEN inline mask64 firstNmask64(const size_t n) { return n >= 64 ? ~mask64(0) : mask64((1ULL << n) - 1); }
+
+AL_DLL_HIDDEN inline f512 zero16f() { return _mm512_setzero_ps(); }
+
+AL_DLL_HIDDEN inline f512 cast16f(const i512 reg) { return _mm512_castsi512_ps(reg); }
+AL_DLL_HIDDEN inline i512 cast16i(const f512 reg) { return _mm512_castps_si512(reg); }
+AL_DLL_HIDDEN inline d512 cast8d(const f512 reg) { return _mm512_castps_pd(reg); }
+AL_DLL_HIDDEN inline f512 cast16f(const d512 reg) { return _mm512_castpd_ps(reg); }
+
+AL_DLL_HIDDEN inline f512 splat16f(const float f) { return _mm512_set1_ps(f); }
+AL_DLL_HIDDEN inline d512 splat8d(const double f) { return _mm512_set1_pd(f); }
+AL_DLL_HIDDEN inline i512 splat16i(const int32_t f) { return _mm512_set1_epi32(f); }
+
+AL_DLL_HIDDEN inline f512 load16f(const void* const ptr) { return _mm512_load_ps(ptr); }
+AL_DLL_HIDDEN inline d512 load8d(const void* const ptr) { return _mm512_load_pd(ptr); }
+AL_DLL_HIDDEN inline i512 load16i(const void* const ptr) { return _mm512_load_si512(ptr); }
+
+AL_DLL_HIDDEN inline f512 loadu16f(const void* const ptr) { return _mm512_loadu_ps(ptr); }
+AL_DLL_HIDDEN inline d512 loadu8d(const void* const ptr) { return _mm512_loadu_pd(ptr); }
+AL_DLL_HIDDEN inline i512 loadu16i(const void* const ptr) { return _mm512_loadu_si512(ptr); }
+
+/// \brief  loads the elements of ptr that are set in the mask, and sets the other elements to zero. Memory for the
+///         masked out elements is not accessed, so this may be used to load the tail end of an array.
+AL_DLL_HIDDEN inline f512 loadmask16f(const void* const ptr, const mask16 mask) { return _mm512_maskz_loadu_ps(mask, ptr); }
+AL_DLL_HIDDEN inline d512 loadmask8d(const void* const ptr, const mask8 mask) { return _mm512_maskz_loadu_pd(mask, ptr); }
+AL_DLL_HIDDEN inline i512 loadmask16i(const void* const ptr, const mask16 mask) { return _mm512_maskz_loadu_epi32(mask, ptr); }
+AL_DLL_HIDDEN inline i512 loadmask64i8(const void* const ptr, const mask64 mask) { return _mm512_maskz_loadu_epi8(mask, ptr); }
+AL_DLL_HIDDEN inline i256 loadmask16i16(const void* const ptr, const mask16 mask) { return _mm256_maskz_loadu_epi16(mask, ptr); }
+
+AL_DLL_HIDDEN inline f512 sub16f(const f512 a, const f512 b) { return _mm512_sub_ps(a, b); }
+AL_DLL_HIDDEN inline d512 sub8d(const d512 a, const d512 b) { return _mm512_sub_pd(a, b); }
+
+AL_DLL_HIDDEN inline f512 abs16f(const f512 v) { return cast16f(_mm512_and_epi32(cast16i(v), splat16i(0x7FFFFFFF))); }
+AL_DLL_HIDDEN inline d512 abs8d(const d512 v)
+  { return _mm512_castsi512_pd(_mm512_and_epi64(_mm512_castpd_si512(v), _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL))); }
+
+/// \brief  the AVX-512 comparisons return a bit mask rather than a register. The masked variants only compare the
+///         elements that are set in the mask (the others are returned as zero).
+AL_DLL_HIDDEN inline mask16 cmpgt16f(const f512 a, const f512 b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+AL_DLL_HIDDEN inline mask16 cmpgt16f(const mask16 m, const f512 a, const f512 b) { return _mm512_mask_cmp_ps_mask(m, a, b, _CMP_GT_OQ); }
+AL_DLL_HIDDEN inline mask8 cmpgt8d(const d512 a, const d512 b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+AL_DLL_HIDDEN inline mask8 cmpgt8d(const mask8 m, const d512 a, const d512 b) { return _mm512_mask_cmp_pd_mask(m, a, b, _CMP_GT_OQ); }
+AL_DLL_HIDDEN inline mask16 cmpne16f(const f512 a, const f512 b) { return _mm512_cmp_ps_mask(a, b, _CMP_NEQ_UQ); }
+AL_DLL_HIDDEN inline mask16 cmpne16f(const mask16 m, const f512 a, const f512 b) { return _mm512_mask_cmp_ps_mask(m, a, b, _CMP_NEQ_UQ); }
+AL_DLL_HIDDEN inline mask8 cmpne8d(const d512 a, const d512 b) { return _mm512_cmp_pd_mask(a, b, _CMP_NEQ_UQ); }
+AL_DLL_HIDDEN inline mask8 cmpne8d(const mask8 m, const d512 a, const d512 b) { return _mm512_mask_cmp_pd_mask(m, a, b, _CMP_NEQ_UQ); }
+AL_DLL_HIDDEN inline mask16 cmpne16i(const i512 a, const i512 b) { return _mm512_cmpneq_epi32_mask(a, b); }
+AL_DLL_HIDDEN inline mask16 cmpne16i(const mask16 m, const i512 a, const i512 b) { return _mm512_mask_cmpneq_epi32_mask(m, a, b); }
+AL_DLL_HIDDEN inline mask64 cmpne64i8(const i512 a, const i512 b) { return _mm512_cmpneq_epi8_mask(a, b); }
+AL_DLL_HIDDEN inline mask64 cmpne64i8(const mask64 m, const i512 a, const i512 b) { return _mm512_mask_cmpneq_epi8_mask(m, a, b); }
+
+AL_DLL_HIDDEN inline f512 cvtph16(const i256 reg) { return _mm512_cvtph_ps(reg); }
+AL_DLL_HIDDEN inline f256 cvt8d_to_8f(const d512 reg) { return _mm512_cvtpd_ps(reg); }
+
+/// \brief  combines two 8 float registers into a 16 float register
+AL_DLL_HIDDEN inline f512 set2f256(const f256 lo, const f256 hi)
+  { return cast16f(_mm512_insertf64x4(cast8d(_mm512_castps256_ps512(lo)), _mm256_castps_pd(hi), 1)); }
+
+/// \brief  selects 16 floats from the 32 elements of a & b, e.g. an index of 17 selects b[1]
+AL_DLL_HIDDEN inline f512 permute2x16f(const f512 a, const i512 indices, const f512 b) { return _mm512_permutex2var_ps(a, indices, b); }
+#endif
+
+} // AL_SIMD_NAMESPACE
 } // AL
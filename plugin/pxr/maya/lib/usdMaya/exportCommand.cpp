@@ -91,6 +91,15 @@ MSyntax UsdMayaExportCommand::createSyntax()
     syntax.addFlag("-ef" ,
                    UsdMayaJobExportArgsTokens->eulerFilter.GetText(),
                    MSyntax::kBoolean);
+    syntax.addFlag("-dgc",
+                   UsdMayaJobExportArgsTokens->dgContextEvaluation.GetText(),
+                   MSyntax::kBoolean);
+    syntax.addFlag("-pau",
+                   UsdMayaJobExportArgsTokens->parallelAuthoring.GetText(),
+                   MSyntax::kBoolean);
+    syntax.addFlag("-stg",
+                   UsdMayaJobExportArgsTokens->stagingLayer.GetText(),
+                   MSyntax::kBoolean);
     syntax.addFlag("-dms",
                    UsdMayaJobExportArgsTokens->defaultMeshScheme.GetText(),
                    MSyntax::kString);
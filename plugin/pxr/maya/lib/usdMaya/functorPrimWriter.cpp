@@ -52,6 +52,14 @@ UsdMaya_FunctorPrimWriter::~UsdMaya_FunctorPrimWriter()
 {
 }
 
+/* virtual */
+bool
+UsdMaya_FunctorPrimWriter::SupportsDGContextEvaluation() const
+{
+    // The plugin's write function may read Maya data any way it likes.
+    return false;
+}
+
 /* virtual */
 void
 UsdMaya_FunctorPrimWriter::Write(const UsdTimeCode& usdTime)
@@ -78,6 +78,9 @@ UsdMayaImportCommand::createSyntax()
     syntax.addFlag("-uac",
                    UsdMayaJobImportArgsTokens->useAsAnimationCache.GetText(),
                    MSyntax::kBoolean);
+    syntax.addFlag("-upc",
+                   UsdMayaJobImportArgsTokens->usePointCache.GetText(),
+                   MSyntax::kBoolean);
 
     // These are additional flags under our control.
     syntax.addFlag("-f" , "-file", MSyntax::kString);
@@ -252,6 +252,9 @@ UsdMayaJobExportArgs::UsdMayaJobExportArgs(
                     UsdGeomTokens->bilinear,
                     UsdGeomTokens->none
                 })),
+        dgContextEvaluation(
+            _Boolean(userArgs,
+                UsdMayaJobExportArgsTokens->dgContextEvaluation)),
         eulerFilter(
             _Boolean(userArgs, UsdMayaJobExportArgsTokens->eulerFilter)),
         excludeInvisible(
@@ -313,6 +316,12 @@ UsdMayaJobExportArgs::UsdMayaJobExportArgs(
         stripNamespaces(
             _Boolean(userArgs,
                 UsdMayaJobExportArgsTokens->stripNamespaces)),
+        parallelAuthoring(
+            _Boolean(userArgs,
+                UsdMayaJobExportArgsTokens->parallelAuthoring)),
+        stagingLayer(
+            _Boolean(userArgs,
+                UsdMayaJobExportArgsTokens->stagingLayer)),
         parentScope(
             _AbsolutePath(userArgs, UsdMayaJobExportArgsTokens->parentScope)),
         renderLayerMode(
@@ -358,6 +367,7 @@ operator <<(std::ostream& out, const UsdMayaJobExportArgs& exportArgs)
 {
     out << "compatibility: " << exportArgs.compatibility << std::endl
         << "defaultMeshScheme: " << exportArgs.defaultMeshScheme << std::endl
+        << "dgContextEvaluation: " << TfStringify(exportArgs.dgContextEvaluation) << std::endl
         << "eulerFilter: " << TfStringify(exportArgs.eulerFilter) << std::endl
         << "excludeInvisible: " << TfStringify(exportArgs.excludeInvisible) << std::endl
         << "exportCollectionBasedBindings: " << TfStringify(exportArgs.exportCollectionBasedBindings) << std::endl
@@ -376,10 +386,12 @@ operator <<(std::ostream& out, const UsdMayaJobExportArgs& exportArgs)
         << "materialsScopeName: " << exportArgs.materialsScopeName << std::endl
         << "mergeTransformAndShape: " << TfStringify(exportArgs.mergeTransformAndShape) << std::endl
         << "normalizeNurbs: " << TfStringify(exportArgs.normalizeNurbs) << std::endl
+        << "parallelAuthoring: " << TfStringify(exportArgs.parallelAuthoring) << std::endl
         << "parentScope: " << exportArgs.parentScope << std::endl
         << "renderLayerMode: " << exportArgs.renderLayerMode << std::endl
         << "rootKind: " << exportArgs.rootKind << std::endl
         << "shadingMode: " << exportArgs.shadingMode << std::endl
+        << "stagingLayer: " << TfStringify(exportArgs.stagingLayer) << std::endl
         << "stripNamespaces: " << TfStringify(exportArgs.stripNamespaces) << std::endl
         << "timeSamples: " << exportArgs.timeSamples.size() << " sample(s)" << std::endl
         << "usdModelRootOverridePath: " << exportArgs.usdModelRootOverridePath << std::endl;
@@ -446,6 +458,7 @@ UsdMayaJobExportArgs::GetDefaultDictionary()
         d[UsdMayaJobExportArgsTokens->defaultCameras] = false;
         d[UsdMayaJobExportArgsTokens->defaultMeshScheme] = 
                 UsdGeomTokens->catmullClark.GetString();
+        d[UsdMayaJobExportArgsTokens->dgContextEvaluation] = false;
         d[UsdMayaJobExportArgsTokens->eulerFilter] = false;
         d[UsdMayaJobExportArgsTokens->exportCollectionBasedBindings] = false;
         d[UsdMayaJobExportArgsTokens->exportColorSets] = true;
@@ -468,6 +481,7 @@ UsdMayaJobExportArgs::GetDefaultDictionary()
         d[UsdMayaJobExportArgsTokens->melPostCallback] = std::string();
         d[UsdMayaJobExportArgsTokens->mergeTransformAndShape] = true;
         d[UsdMayaJobExportArgsTokens->normalizeNurbs] = false;
+        d[UsdMayaJobExportArgsTokens->parallelAuthoring] = false;
         d[UsdMayaJobExportArgsTokens->parentScope] = std::string();
         d[UsdMayaJobExportArgsTokens->pythonPerFrameCallback] = std::string();
         d[UsdMayaJobExportArgsTokens->pythonPostCallback] = std::string();
@@ -476,6 +490,7 @@ UsdMayaJobExportArgs::GetDefaultDictionary()
                 UsdMayaJobExportArgsTokens->defaultLayer.GetString();
         d[UsdMayaJobExportArgsTokens->shadingMode] =
                 UsdMayaShadingModeTokens->displayColor.GetString();
+        d[UsdMayaJobExportArgsTokens->stagingLayer] = false;
         d[UsdMayaJobExportArgsTokens->stripNamespaces] = false;
         d[UsdMayaJobExportArgsTokens->verbose] = false;
 
@@ -554,6 +569,9 @@ UsdMayaJobImportArgs::UsdMayaJobImportArgs(
         useAsAnimationCache(
             _Boolean(userArgs,
                 UsdMayaJobImportArgsTokens->useAsAnimationCache)),
+        usePointCache(
+            _Boolean(userArgs,
+                UsdMayaJobImportArgsTokens->usePointCache)),
 
         importWithProxyShapes(importWithProxyShapes),
         timeInterval(timeInterval)
@@ -592,6 +610,7 @@ const VtDictionary& UsdMayaJobImportArgs::GetDefaultDictionary()
         d[UsdMayaJobImportArgsTokens->shadingMode] =
                 UsdMayaShadingModeTokens->displayColor.GetString();
         d[UsdMayaJobImportArgsTokens->useAsAnimationCache] = false;
+        d[UsdMayaJobImportArgsTokens->usePointCache] = false;
 
         // plugInfo.json site defaults.
         // The defaults dict should be correctly-typed, so enable
@@ -612,6 +631,7 @@ operator <<(std::ostream& out, const UsdMayaJobImportArgs& importArgs)
         << "assemblyRep: " << importArgs.assemblyRep << std::endl
         << "timeInterval: " << importArgs.timeInterval << std::endl
         << "useAsAnimationCache: " << TfStringify(importArgs.useAsAnimationCache) << std::endl
+        << "usePointCache: " << TfStringify(importArgs.usePointCache) << std::endl
         << "importWithProxyShapes: " << TfStringify(importArgs.importWithProxyShapes) << std::endl;
 
     return out;
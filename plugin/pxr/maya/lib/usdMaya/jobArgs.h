@@ -60,6 +60,7 @@ TF_DECLARE_PUBLIC_TOKENS(
     (compatibility) \
     (defaultCameras) \
     (defaultMeshScheme) \
+    (dgContextEvaluation) \
     (eulerFilter) \
     (exportCollectionBasedBindings) \
     (exportColorSets) \
@@ -79,12 +80,14 @@ TF_DECLARE_PUBLIC_TOKENS(
     (melPostCallback) \
     (mergeTransformAndShape) \
     (normalizeNurbs) \
+    (parallelAuthoring) \
     (parentScope) \
     (pythonPerFrameCallback) \
     (pythonPostCallback) \
     (renderableOnly) \
     (renderLayerMode) \
     (shadingMode) \
+    (stagingLayer) \
     (stripNamespaces) \
     (verbose) \
     /* Special "none" token */ \
@@ -112,6 +115,7 @@ TF_DECLARE_PUBLIC_TOKENS(
     (metadata) \
     (shadingMode) \
     (useAsAnimationCache) \
+    (usePointCache) \
     /* assemblyRep values */ \
     (Collapsed) \
     (Full) \
@@ -128,6 +132,14 @@ struct UsdMayaJobExportArgs
 {
     const TfToken compatibility;
     const TfToken defaultMeshScheme;
+
+    /// If set to true, time-sampled data is evaluated with an MDGContext for
+    /// each time sample instead of moving the global scene time. This avoids
+    /// viewport refreshes and time-change callbacks. If any prim writer
+    /// cannot read its data in a DG context (see
+    /// UsdMayaPrimWriter::SupportsDGContextEvaluation()), the export falls
+    /// back to changing the scene time. Requires Maya 2018 or later.
+    const bool dgContextEvaluation;
     const bool eulerFilter;
     const bool excludeInvisible;
 
@@ -165,6 +177,20 @@ struct UsdMayaJobExportArgs
     const bool normalizeNurbs;
     const bool stripNamespaces;
 
+    /// If set to true, prim writers that support it are split into three
+    /// phases for each time sample: the data is read from Maya on the main
+    /// thread, is converted by all of those writers in parallel, and is
+    /// then authored to USD on the main thread. Other prim writers are
+    /// unaffected.
+    const bool parallelAuthoring;
+
+    /// If set to true, prims are authored into an anonymous in-memory layer
+    /// for the duration of the export, and its content is written to the
+    /// output file in a single pass when the export finishes. The output
+    /// layer is not edited (and so no stages that use it are notified)
+    /// until then.
+    const bool stagingLayer;
+
     /// This is the path of the USD prim under which *all* prims will be
     /// authored.
     const SdfPath parentScope;
@@ -253,6 +279,10 @@ struct UsdMayaJobImportArgs
     const TfToken::Set includeMetadataKeys;
     TfToken shadingMode; // XXX can we make this const?
     const bool useAsAnimationCache;
+    /// Stream the points of deforming meshes from the file with a point
+    /// cache deformer, rather than creating a blend shape target per time
+    /// sample.
+    const bool usePointCache;
 
     const bool importWithProxyShapes;
     /// The interval over which to import animated data.
@@ -24,6 +24,7 @@
 #include "pxr/base/tf/token.h"
 #include "pxr/base/vt/array.h"
 #include "pxr/base/vt/types.h"
+#include "pxr/base/work/loops.h"
 
 #include "pxr/usd/sdf/path.h"
 #include "pxr/usd/usd/attribute.h"
@@ -32,6 +33,7 @@
 #include "pxr/usd/usd/timeCode.h"
 #include "pxr/usd/usdGeom/pointBased.h"
 
+#include <maya/MArrayDataHandle.h>
 #include <maya/MDataBlock.h>
 #include <maya/MDataHandle.h>
 #include <maya/MFnData.h>
@@ -44,6 +46,7 @@
 #include <maya/MObject.h>
 #include <maya/MPlug.h>
 #include <maya/MPoint.h>
+#include <maya/MPointArray.h>
 #include <maya/MPxDeformerNode.h>
 #include <maya/MStatus.h>
 #include <maya/MString.h>
@@ -51,6 +54,7 @@
 #include <maya/MTypeId.h>
 
 #include <string>
+#include <vector>
 
 
 PXR_NAMESPACE_OPEN_SCOPE
@@ -69,6 +73,46 @@ MObject UsdMayaPointBasedDeformerNode::inUsdStageAttr;
 MObject UsdMayaPointBasedDeformerNode::primPathAttr;
 MObject UsdMayaPointBasedDeformerNode::timeAttr;
 
+// Below this number of points, the blend is not worth distributing across
+// threads.
+static const size_t _ParallelBlendMinPoints = 4096u;
+
+/// Fills \p weights with the deformer weight of each of the first \p numPoints
+/// component indices of the geometry at \p multiIndex. This reads the sparse
+/// weight array once, rather than calling weightValue() per point.
+static
+void
+_GetWeights(
+        MDataBlock& block,
+        const unsigned int multiIndex,
+        const size_t numPoints,
+        std::vector<float>* weights)
+{
+    // Indices without an explicit weight use the default weight of 1.
+    weights->assign(numPoints, 1.0f);
+
+    MStatus status;
+    MArrayDataHandle weightListHandle =
+        block.inputArrayValue(MPxDeformerNode::weightList, &status);
+    if (!status || !weightListHandle.jumpToElement(multiIndex)) {
+        return;
+    }
+
+    MArrayDataHandle weightsHandle =
+        weightListHandle.inputValue(&status).child(MPxDeformerNode::weights);
+    if (!status) {
+        return;
+    }
+
+    const unsigned int numWeights = weightsHandle.elementCount();
+    for (unsigned int i = 0u; i < numWeights; ++i, weightsHandle.next()) {
+        const unsigned int index = weightsHandle.elementIndex();
+        if (index < numPoints) {
+            (*weights)[index] = weightsHandle.inputValue().asFloat();
+        }
+    }
+}
+
 
 /* static */
 void*
@@ -161,56 +205,139 @@ UsdMayaPointBasedDeformerNode::deform(
     const MDataHandle primPathHandle = block.inputValue(primPathAttr, &status);
     CHECK_MSTATUS_AND_RETURN_IT(status);
 
-    const std::string primPathString =
-        TfStringTrim(primPathHandle.asString().asChar());
-
-    if (primPathString.empty()) {
+    const UsdAttribute& pointsAttr =
+        _GetPointsAttr(usdStage, primPathHandle.asString());
+    if (!pointsAttr) {
         return MS::kFailure;
     }
 
-    const SdfPath primPath(primPathString);
+    const MDataHandle timeHandle = block.inputValue(timeAttr, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+    const UsdTimeCode usdTime(timeHandle.asTime().value());
 
-    const UsdPrim& usdPrim = usdStage->GetPrimAtPath(primPath);
-    const UsdGeomPointBased usdPointBased(usdPrim);
-    if (!usdPointBased) {
+    VtVec3fArray usdPoints;
+    if (!pointsAttr.Get(&usdPoints, usdTime) || usdPoints.empty()) {
         return MS::kFailure;
     }
 
-    const MDataHandle timeHandle = block.inputValue(timeAttr, &status);
-    CHECK_MSTATUS_AND_RETURN_IT(status);
-    const UsdTimeCode usdTime(timeHandle.asTime().value());
+    return DeformToPoints(block, iter, multiIndex, usdPoints);
+}
+
+/* static */
+MStatus
+UsdMayaPointBasedDeformerNode::DeformToPoints(
+        MDataBlock& block,
+        MItGeometry& iter,
+        const unsigned int multiIndex,
+        const VtVec3fArray& usdPoints)
+{
+    MStatus status;
 
     const MDataHandle envelopeHandle = block.inputValue(envelope, &status);
     CHECK_MSTATUS_AND_RETURN_IT(status);
     const float envelope = envelopeHandle.asFloat();
 
-    VtVec3fArray usdPoints;
-    if (!usdPointBased.GetPointsAttr().Get(&usdPoints, usdTime) ||
-            usdPoints.empty()) {
+    // Gather the positions being deformed, and the component index of each
+    // of them (which may be a subset of the geometry).
+    MPointArray mayaPoints;
+    status = iter.allPositions(mayaPoints);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    std::vector<int> indices;
+    indices.reserve(mayaPoints.length());
+    for ( ; !iter.isDone(); iter.next()) {
+        indices.push_back(iter.index());
+    }
+    iter.reset();
+    if (indices.size() != mayaPoints.length()) {
         return MS::kFailure;
     }
 
-    for ( ; !iter.isDone(); iter.next()) {
-        const int index = iter.index();
-        if (index < 0 || static_cast<size_t>(index) >= usdPoints.size()) {
-            continue;
+    std::vector<float> weights;
+    _GetWeights(block, multiIndex, usdPoints.size(), &weights);
+
+    // Copy the positions into a flat buffer here on the calling thread, so
+    // that the worker threads below only touch plain memory and never the
+    // MPointArray itself.
+    const size_t numPoints = indices.size();
+    std::vector<double> positions(numPoints * 3u);
+    for (size_t i = 0u; i < numPoints; ++i) {
+        const MPoint& mayaPoint = mayaPoints[static_cast<unsigned int>(i)];
+        positions[i * 3u + 0u] = mayaPoint.x;
+        positions[i * 3u + 1u] = mayaPoint.y;
+        positions[i * 3u + 2u] = mayaPoint.z;
+    }
+
+    const GfVec3f* const usdPointsData = usdPoints.cdata();
+    const size_t numUsdPoints = usdPoints.size();
+    double* const positionsData = positions.data();
+    const auto blendPoints = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const int index = indices[i];
+            if (index < 0 || static_cast<size_t>(index) >= numUsdPoints) {
+                continue;
+            }
+
+            const double alpha = weights[index] * envelope;
+            const GfVec3f& usdPoint = usdPointsData[index];
+            double* const position = positionsData + i * 3u;
+            position[0] += alpha * (usdPoint[0] - position[0]);
+            position[1] += alpha * (usdPoint[1] - position[1]);
+            position[2] += alpha * (usdPoint[2] - position[2]);
         }
+    };
+
+    if (numPoints >= _ParallelBlendMinPoints) {
+        WorkParallelForN(numPoints, blendPoints);
+    } else {
+        blendPoints(0u, numPoints);
+    }
 
-        const MPoint mayaPoint = iter.position();
-        const float weight = weightValue(block, multiIndex, index);
+    for (size_t i = 0u; i < numPoints; ++i) {
+        MPoint& mayaPoint = mayaPoints[static_cast<unsigned int>(i)];
+        mayaPoint.x = positions[i * 3u + 0u];
+        mayaPoint.y = positions[i * 3u + 1u];
+        mayaPoint.z = positions[i * 3u + 2u];
+    }
 
-        const GfVec3f& usdPoint = usdPoints[static_cast<size_t>(index)];
+    status = iter.setAllPositions(mayaPoints);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
 
-        const GfVec3f deformedPoint =
-            GfLerp<GfVec3f>(weight * envelope,
-                            GfVec3f(mayaPoint[0], mayaPoint[1], mayaPoint[2]),
-                            usdPoint);
+    return status;
+}
 
-        iter.setPosition(
-            MPoint(deformedPoint[0], deformedPoint[1], deformedPoint[2]));
+const UsdAttribute&
+UsdMayaPointBasedDeformerNode::_GetPointsAttr(
+        const UsdStageRefPtr& usdStage,
+        const MString& primPathString)
+{
+    if (_cachedPointsAttr &&
+            get_pointer(_cachedStage) == get_pointer(usdStage) &&
+            _cachedPrimPathString == primPathString) {
+        return _cachedPointsAttr;
     }
 
-    return status;
+    _cachedStage = usdStage;
+    _cachedPrimPathString = primPathString;
+    _cachedPointsAttr = UsdAttribute();
+
+    const std::string trimmedPrimPath =
+        TfStringTrim(primPathString.asChar());
+    if (trimmedPrimPath.empty()) {
+        return _cachedPointsAttr;
+    }
+
+    const SdfPath primPath(trimmedPrimPath);
+    if (!primPath.IsPrimPath()) {
+        return _cachedPointsAttr;
+    }
+
+    const UsdGeomPointBased usdPointBased(usdStage->GetPrimAtPath(primPath));
+    if (usdPointBased) {
+        _cachedPointsAttr = usdPointBased.GetPointsAttr();
+    }
+
+    return _cachedPointsAttr;
 }
 
 UsdMayaPointBasedDeformerNode::UsdMayaPointBasedDeformerNode() :
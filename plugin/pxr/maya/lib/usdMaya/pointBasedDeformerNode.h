@@ -23,6 +23,9 @@
 #include "pxr/pxr.h"
 
 #include "pxr/base/tf/staticTokens.h"
+#include "pxr/base/vt/types.h"
+#include "pxr/usd/usd/attribute.h"
+#include "pxr/usd/usd/stage.h"
 
 #include <maya/MDataBlock.h>
 #include <maya/MItGeometry.h>
@@ -55,6 +58,10 @@ TF_DECLARE_PUBLIC_TOKENS(UsdMayaPointBasedDeformerNodeTokens,
 /// the deformer runs, it will read the points attribute of the prim at that
 /// time sample and use the positions to modify the positions of the geometry
 /// being deformed.
+///
+/// The points attribute is resolved once and reused by subsequent evaluations
+/// until the stage or prim path changes. Positions are read and written in
+/// bulk, and the blend is split across threads for large point counts.
 class UsdMayaPointBasedDeformerNode : public MPxDeformerNode
 {
     public:
@@ -85,6 +92,19 @@ class UsdMayaPointBasedDeformerNode : public MPxDeformerNode
                 const MMatrix& mat,
                 unsigned int multiIndex) override;
 
+        /// Moves the points of the geometry at \p multiIndex being iterated
+        /// by \p iter towards \p usdPoints, scaled by the deformer's
+        /// envelope and the weight of each point.
+        ///
+        /// This is shared with the other deformers that read their points
+        /// from USD.
+        PXRUSDMAYA_API
+        static MStatus DeformToPoints(
+                MDataBlock& block,
+                MItGeometry& iter,
+                unsigned int multiIndex,
+                const VtVec3fArray& usdPoints);
+
     private:
         UsdMayaPointBasedDeformerNode();
         ~UsdMayaPointBasedDeformerNode() override;
@@ -92,6 +112,17 @@ class UsdMayaPointBasedDeformerNode : public MPxDeformerNode
         UsdMayaPointBasedDeformerNode(const UsdMayaPointBasedDeformerNode&);
         UsdMayaPointBasedDeformerNode& operator=(
                 const UsdMayaPointBasedDeformerNode&);
+
+        /// Returns the points attribute of the prim at \p primPathString in
+        /// \p usdStage, re-using the attribute resolved by the previous
+        /// evaluation where possible.
+        const UsdAttribute& _GetPointsAttr(
+                const UsdStageRefPtr& usdStage,
+                const MString& primPathString);
+
+        UsdStageWeakPtr _cachedStage;
+        MString _cachedPrimPathString;
+        UsdAttribute _cachedPointsAttr;
 };
 
 
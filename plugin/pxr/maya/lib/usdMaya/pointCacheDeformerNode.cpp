@@ -0,0 +1,336 @@
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "usdMaya/pointCacheDeformerNode.h"
+
+#include "usdMaya/pointBasedDeformerNode.h"
+
+#include "pxr/base/gf/vec3f.h"
+#include "pxr/base/tf/staticTokens.h"
+#include "pxr/base/tf/stringUtils.h"
+#include "pxr/base/tf/token.h"
+#include "pxr/base/vt/array.h"
+#include "pxr/base/vt/types.h"
+
+#include "pxr/usd/sdf/path.h"
+#include "pxr/usd/usd/attributeQuery.h"
+#include "pxr/usd/usd/interpolation.h"
+#include "pxr/usd/usd/prim.h"
+#include "pxr/usd/usd/stage.h"
+#include "pxr/usd/usd/stagePopulationMask.h"
+#include "pxr/usd/usd/timeCode.h"
+#include "pxr/usd/usdGeom/pointBased.h"
+
+#include <maya/MDataBlock.h>
+#include <maya/MDataHandle.h>
+#include <maya/MFnData.h>
+#include <maya/MFnNumericAttribute.h>
+#include <maya/MFnNumericData.h>
+#include <maya/MFnStringData.h>
+#include <maya/MFnTypedAttribute.h>
+#include <maya/MFnUnitAttribute.h>
+#include <maya/MItGeometry.h>
+#include <maya/MMatrix.h>
+#include <maya/MObject.h>
+#include <maya/MPxDeformerNode.h>
+#include <maya/MStatus.h>
+#include <maya/MString.h>
+#include <maya/MTime.h>
+#include <maya/MTypeId.h>
+
+#include <algorithm>
+#include <string>
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+
+TF_DEFINE_PUBLIC_TOKENS(UsdMayaPointCacheDeformerNodeTokens,
+                        PXRUSDMAYA_POINT_CACHE_DEFORMER_NODE_TOKENS);
+
+
+const MTypeId UsdMayaPointCacheDeformerNode::typeId(0x00126404);
+const MString UsdMayaPointCacheDeformerNode::typeName(
+    UsdMayaPointCacheDeformerNodeTokens->MayaTypeName.GetText());
+
+// Attributes
+MObject UsdMayaPointCacheDeformerNode::filePathAttr;
+MObject UsdMayaPointCacheDeformerNode::primPathAttr;
+MObject UsdMayaPointCacheDeformerNode::timeAttr;
+MObject UsdMayaPointCacheDeformerNode::cacheSizeAttr;
+
+
+/* static */
+void*
+UsdMayaPointCacheDeformerNode::creator()
+{
+    return new UsdMayaPointCacheDeformerNode();
+}
+
+/* static */
+MStatus
+UsdMayaPointCacheDeformerNode::initialize()
+{
+    MStatus status;
+
+    MFnTypedAttribute typedAttrFn;
+    MFnNumericAttribute numericAttrFn;
+    MFnUnitAttribute unitAttrFn;
+
+    MFnStringData stringDataFn;
+    const MObject defaultStringDataObj = stringDataFn.create("");
+
+    filePathAttr = typedAttrFn.create("filePath",
+                                      "fp",
+                                      MFnData::kString,
+                                      defaultStringDataObj,
+                                      &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+    status = typedAttrFn.setUsedAsFilename(true);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+    status = addAttribute(filePathAttr);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    primPathAttr = typedAttrFn.create("primPath",
+                                      "pp",
+                                      MFnData::kString,
+                                      defaultStringDataObj,
+                                      &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+    status = addAttribute(primPathAttr);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    timeAttr = unitAttrFn.create("time",
+                                 "tm",
+                                 MFnUnitAttribute::kTime,
+                                 0.0,
+                                 &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+    status = addAttribute(timeAttr);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    cacheSizeAttr = numericAttrFn.create("cacheSize",
+                                         "cs",
+                                         MFnNumericData::kInt,
+                                         8,
+                                         &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+    status = numericAttrFn.setMin(2);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+    status = addAttribute(cacheSizeAttr);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    status = attributeAffects(filePathAttr, outputGeom);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+    status = attributeAffects(primPathAttr, outputGeom);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+    status = attributeAffects(timeAttr, outputGeom);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    return status;
+}
+
+/* virtual */
+MStatus
+UsdMayaPointCacheDeformerNode::deform(
+        MDataBlock& block,
+        MItGeometry& iter,
+        const MMatrix& /* mat */,
+        unsigned int multiIndex)
+{
+    MStatus status;
+
+    const MDataHandle filePathHandle = block.inputValue(filePathAttr, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    const MDataHandle primPathHandle = block.inputValue(primPathAttr, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    if (!_UpdatePointsQuery(filePathHandle.asString(),
+                            primPathHandle.asString())) {
+        return MS::kFailure;
+    }
+
+    const MDataHandle timeHandle = block.inputValue(timeAttr, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    const MDataHandle cacheSizeHandle =
+        block.inputValue(cacheSizeAttr, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+    const size_t cacheSize =
+        static_cast<size_t>(std::max(2, cacheSizeHandle.asInt()));
+
+    VtVec3fArray usdPoints;
+    if (!_ComputePoints(timeHandle.asTime().value(), cacheSize, &usdPoints) ||
+            usdPoints.empty()) {
+        return MS::kFailure;
+    }
+
+    return UsdMayaPointBasedDeformerNode::DeformToPoints(
+        block, iter, multiIndex, usdPoints);
+}
+
+size_t
+UsdMayaPointCacheDeformerNode::GetNumCachedSamples() const
+{
+    return _samples.size();
+}
+
+bool
+UsdMayaPointCacheDeformerNode::_UpdatePointsQuery(
+        const MString& filePath,
+        const MString& primPath)
+{
+    if (_cachedFilePath == filePath && _cachedPrimPath == primPath) {
+        return _pointsQuery.IsValid();
+    }
+
+    _cachedFilePath = filePath;
+    _cachedPrimPath = primPath;
+    _stage = nullptr;
+    _pointsQuery = UsdAttributeQuery();
+    _timeSamples.clear();
+    _samples.clear();
+    _samplesByIndex.clear();
+
+    const std::string trimmedFilePath = TfStringTrim(filePath.asChar());
+    const std::string trimmedPrimPath = TfStringTrim(primPath.asChar());
+    if (trimmedFilePath.empty() || trimmedPrimPath.empty()) {
+        return false;
+    }
+
+    const SdfPath usdPrimPath(trimmedPrimPath);
+    if (!usdPrimPath.IsPrimPath()) {
+        return false;
+    }
+
+    // Only the prim being read is populated, so that opening the stage does
+    // not pay for the rest of the scene.
+    _stage = UsdStage::OpenMasked(trimmedFilePath,
+                                  UsdStagePopulationMask({usdPrimPath}));
+    if (!_stage) {
+        return false;
+    }
+
+    const UsdGeomPointBased usdPointBased(_stage->GetPrimAtPath(usdPrimPath));
+    if (!usdPointBased) {
+        return false;
+    }
+
+    _pointsQuery = UsdAttributeQuery(usdPointBased.GetPointsAttr());
+    _pointsQuery.GetTimeSamples(&_timeSamples);
+    _interpolate =
+        _stage->GetInterpolationType() == UsdInterpolationTypeLinear;
+
+    return _pointsQuery.IsValid();
+}
+
+const VtVec3fArray&
+UsdMayaPointCacheDeformerNode::_GetSample(
+        const size_t sampleIndex,
+        const size_t cacheSize)
+{
+    const auto it = _samplesByIndex.find(sampleIndex);
+    if (it != _samplesByIndex.end()) {
+        _samples.splice(_samples.begin(), _samples, it->second);
+        return _samples.front().second;
+    }
+
+    // Make room for the new sample before decoding it, so that the cache
+    // never holds more than cacheSize samples.
+    while (!_samples.empty() && _samples.size() >= cacheSize) {
+        _samplesByIndex.erase(_samples.back().first);
+        _samples.pop_back();
+    }
+
+    _samples.emplace_front(sampleIndex, VtVec3fArray());
+    _samplesByIndex[sampleIndex] = _samples.begin();
+
+    const UsdTimeCode usdTime = _timeSamples.empty() ?
+        UsdTimeCode::Default() :
+        UsdTimeCode(_timeSamples[sampleIndex]);
+    _pointsQuery.Get(&_samples.front().second, usdTime);
+
+    return _samples.front().second;
+}
+
+bool
+UsdMayaPointCacheDeformerNode::_ComputePoints(
+        const double time,
+        const size_t cacheSize,
+        VtVec3fArray* points)
+{
+    if (_timeSamples.empty()) {
+        *points = _GetSample(0u, cacheSize);
+        return true;
+    }
+
+    // Find the samples that bracket the time, holding the first and last
+    // samples outside of the sampled range.
+    const auto upper =
+        std::lower_bound(_timeSamples.begin(), _timeSamples.end(), time);
+    if (upper == _timeSamples.begin()) {
+        *points = _GetSample(0u, cacheSize);
+        return true;
+    }
+    if (upper == _timeSamples.end()) {
+        *points = _GetSample(_timeSamples.size() - 1u, cacheSize);
+        return true;
+    }
+
+    const size_t hi = static_cast<size_t>(upper - _timeSamples.begin());
+    if (*upper == time || !_interpolate) {
+        *points = _GetSample(*upper == time ? hi : hi - 1u, cacheSize);
+        return true;
+    }
+
+    const size_t lo = hi - 1u;
+
+    // Take a (shared) copy of the lower sample, since decoding the upper
+    // sample may evict entries from the cache.
+    const VtVec3fArray lower = _GetSample(lo, cacheSize);
+    const VtVec3fArray& higher = _GetSample(hi, cacheSize);
+    if (lower.size() != higher.size()) {
+        *points = lower;
+        return true;
+    }
+
+    const float alpha = static_cast<float>(
+        (time - _timeSamples[lo]) / (_timeSamples[hi] - _timeSamples[lo]));
+
+    points->resize(lower.size());
+    GfVec3f* const pointsData = points->data();
+    const GfVec3f* const lowerData = lower.cdata();
+    const GfVec3f* const higherData = higher.cdata();
+    for (size_t i = 0u; i < lower.size(); ++i) {
+        pointsData[i] = lowerData[i] + alpha * (higherData[i] - lowerData[i]);
+    }
+
+    return true;
+}
+
+UsdMayaPointCacheDeformerNode::UsdMayaPointCacheDeformerNode() :
+    MPxDeformerNode(),
+    _interpolate(true)
+{
+}
+
+/* virtual */
+UsdMayaPointCacheDeformerNode::~UsdMayaPointCacheDeformerNode()
+{
+}
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,148 @@
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef PXRUSDMAYA_POINT_CACHE_DEFORMER_NODE_H
+#define PXRUSDMAYA_POINT_CACHE_DEFORMER_NODE_H
+
+/// \file usdMaya/pointCacheDeformerNode.h
+
+#include "usdMaya/api.h"
+
+#include "pxr/pxr.h"
+
+#include "pxr/base/tf/staticTokens.h"
+#include "pxr/base/vt/types.h"
+#include "pxr/usd/usd/attributeQuery.h"
+#include "pxr/usd/usd/stage.h"
+
+#include <maya/MDataBlock.h>
+#include <maya/MItGeometry.h>
+#include <maya/MMatrix.h>
+#include <maya/MObject.h>
+#include <maya/MPxDeformerNode.h>
+#include <maya/MStatus.h>
+#include <maya/MString.h>
+#include <maya/MTypeId.h>
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+
+#define PXRUSDMAYA_POINT_CACHE_DEFORMER_NODE_TOKENS \
+    ((MayaTypeName, "pxrUsdPointCacheDeformerNode"))
+
+TF_DECLARE_PUBLIC_TOKENS(UsdMayaPointCacheDeformerNodeTokens,
+                         PXRUSDMAYA_API,
+                         PXRUSDMAYA_POINT_CACHE_DEFORMER_NODE_TOKENS);
+
+
+/// Maya deformer that streams the points of a UsdGeomPointBased prim from a
+/// USD file to deform the geometry.
+///
+/// Unlike UsdMayaPointBasedDeformerNode, this deformer does not need a USD
+/// stage node. It takes the path of a USD file and the prim path of a
+/// UsdGeomPointBased prim in it, and opens its own stage, masked to just that
+/// prim. The time samples of the points attribute are looked up once, and
+/// only the samples that bracket the evaluated time are decoded. The most
+/// recently used decoded samples (up to the number given by the cacheSize
+/// attribute) are kept, so that scrubbing and playback around the playhead do
+/// not read from the file again. When the stage interpolates linearly, times
+/// between samples are interpolated.
+class UsdMayaPointCacheDeformerNode : public MPxDeformerNode
+{
+    public:
+        PXRUSDMAYA_API
+        static const MTypeId typeId;
+        PXRUSDMAYA_API
+        static const MString typeName;
+
+        // Attributes
+        PXRUSDMAYA_API
+        static MObject filePathAttr;
+        PXRUSDMAYA_API
+        static MObject primPathAttr;
+        PXRUSDMAYA_API
+        static MObject timeAttr;
+        PXRUSDMAYA_API
+        static MObject cacheSizeAttr;
+
+        PXRUSDMAYA_API
+        static void* creator();
+
+        PXRUSDMAYA_API
+        static MStatus initialize();
+
+        // MPxGeometryFilter overrides
+        PXRUSDMAYA_API
+        MStatus deform(
+                MDataBlock& block,
+                MItGeometry& iter,
+                const MMatrix& mat,
+                unsigned int multiIndex) override;
+
+        /// Returns the number of decoded time samples currently cached.
+        PXRUSDMAYA_API
+        size_t GetNumCachedSamples() const;
+
+    private:
+        UsdMayaPointCacheDeformerNode();
+        ~UsdMayaPointCacheDeformerNode() override;
+
+        UsdMayaPointCacheDeformerNode(const UsdMayaPointCacheDeformerNode&);
+        UsdMayaPointCacheDeformerNode& operator=(
+                const UsdMayaPointCacheDeformerNode&);
+
+        /// Opens the stage and looks up the points attribute and its time
+        /// samples if \p filePath or \p primPath differ from the previous
+        /// evaluation. Returns false if there are no points to read.
+        bool _UpdatePointsQuery(
+                const MString& filePath,
+                const MString& primPath);
+
+        /// Returns the points at the time sample at \p sampleIndex, decoding
+        /// them if they are not cached, and evicting the least recently used
+        /// samples beyond \p cacheSize.
+        const VtVec3fArray& _GetSample(size_t sampleIndex, size_t cacheSize);
+
+        /// Computes the points at \p time into \p points.
+        bool _ComputePoints(
+                double time,
+                size_t cacheSize,
+                VtVec3fArray* points);
+
+        MString _cachedFilePath;
+        MString _cachedPrimPath;
+        UsdStageRefPtr _stage;
+        UsdAttributeQuery _pointsQuery;
+        std::vector<double> _timeSamples;
+        bool _interpolate;
+
+        // The decoded samples, most recently used first, and an index into
+        // them by sample index.
+        typedef std::list<std::pair<size_t, VtVec3fArray>> _SampleList;
+        _SampleList _samples;
+        std::unordered_map<size_t, _SampleList::iterator> _samplesByIndex;
+};
+
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+
+#endif
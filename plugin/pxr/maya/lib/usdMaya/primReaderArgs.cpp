@@ -67,5 +67,11 @@ UsdMayaPrimReaderArgs::GetUseAsAnimationCache() const
     return _jobArgs.useAsAnimationCache;
 }
 
+bool
+UsdMayaPrimReaderArgs::GetUsePointCache() const
+{
+    return _jobArgs.usePointCache;
+}
+
 
 PXR_NAMESPACE_CLOSE_SCOPE
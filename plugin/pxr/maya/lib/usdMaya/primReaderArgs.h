@@ -66,6 +66,8 @@ public:
 
     PXRUSDMAYA_API
     bool GetUseAsAnimationCache() const;
+    PXRUSDMAYA_API
+    bool GetUsePointCache() const;
 
     bool ShouldImportUnboundShaders() const {
         // currently this is disabled.
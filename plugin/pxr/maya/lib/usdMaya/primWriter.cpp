@@ -288,6 +288,39 @@ UsdMayaPrimWriter::ShouldPruneChildren() const
     return false;
 }
 
+/* virtual */
+bool
+UsdMayaPrimWriter::SupportsStagedWrite() const
+{
+    return false;
+}
+
+/* virtual */
+bool
+UsdMayaPrimWriter::SupportsDGContextEvaluation() const
+{
+    return false;
+}
+
+/* virtual */
+void
+UsdMayaPrimWriter::ReadFrame(const UsdTimeCode& usdTime)
+{
+    Write(usdTime);
+}
+
+/* virtual */
+void
+UsdMayaPrimWriter::ComputeFrame(const UsdTimeCode& /* usdTime */)
+{
+}
+
+/* virtual */
+void
+UsdMayaPrimWriter::AuthorFrame(const UsdTimeCode& /* usdTime */)
+{
+}
+
 /* virtual */
 void
 UsdMayaPrimWriter::PostExport()
@@ -80,6 +80,56 @@ public:
     PXRUSDMAYA_API
     virtual void Write(const UsdTimeCode& usdTime);
 
+    /// Whether this prim writer splits the export of each time sample into
+    /// ReadFrame(), ComputeFrame() and AuthorFrame(), rather than using
+    /// Write().
+    /// This is only used for time samples (not the default time), and only
+    /// when parallel authoring is enabled in the export args.
+    ///
+    /// Base implementation returns \c false; prim writers that can separate
+    /// reading from Maya, converting the data and authoring to USD should
+    /// override.
+    PXRUSDMAYA_API
+    virtual bool SupportsStagedWrite() const;
+
+    /// First phase of a staged write of a time sample. Reads everything
+    /// needed to author \p usdTime from Maya. This is always called on the
+    /// main thread, one prim writer at a time, so it may also author to USD.
+    ///
+    /// Base implementation calls Write().
+    PXRUSDMAYA_API
+    virtual void ReadFrame(const UsdTimeCode& usdTime);
+
+    /// Second phase of a staged write of a time sample. Converts the data
+    /// gathered by ReadFrame() into the values to author, and keeps them on
+    /// the prim writer. This may be called on any thread, concurrently with
+    /// ComputeFrame() of other prim writers, so it must access neither the
+    /// Maya scene nor the USD stage. Maya API arrays that ReadFrame() copied
+    /// the data into may still be read.
+    ///
+    /// Base implementation does nothing.
+    PXRUSDMAYA_API
+    virtual void ComputeFrame(const UsdTimeCode& usdTime);
+
+    /// Last phase of a staged write of a time sample. Authors the values
+    /// computed by ComputeFrame() to USD. This is always called on the main
+    /// thread, one prim writer at a time.
+    ///
+    /// Base implementation does nothing.
+    PXRUSDMAYA_API
+    virtual void AuthorFrame(const UsdTimeCode& usdTime);
+
+    /// Whether this prim writer reads all of its time-varying data by
+    /// evaluating plugs, so that it sees the time of the current MDGContext.
+    /// Function sets such as MFnMesh(dagPath) read the data at the current
+    /// scene time instead. When any prim writer returns \c false, exports
+    /// with dgContextEvaluation fall back to changing the scene time.
+    ///
+    /// Base implementation returns \c false; prim writers that only read
+    /// time-varying data through plugs should override.
+    PXRUSDMAYA_API
+    virtual bool SupportsDGContextEvaluation() const;
+
     /// Post export function that runs before saving the stage.
     ///
     /// Base implementation does nothing.
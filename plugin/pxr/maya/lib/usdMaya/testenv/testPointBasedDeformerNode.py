@@ -19,6 +19,9 @@ import os
 import unittest
 
 from pxr import Gf
+from pxr import Usd
+from pxr import UsdGeom
+from pxr import Vt
 
 from maya import OpenMaya as OM
 from maya import OpenMayaAnim as OMA
@@ -109,5 +112,70 @@ class testPointBasedDeformerNode(unittest.TestCase):
         self._ValidateControlPoint(testCube, 3, Gf.Vec3d(0.0, 1.0, 1.0))
 
 
+    def _GetMeshPoints(self, meshName):
+        selectionList = OM.MSelectionList()
+        selectionList.add(meshName)
+        dagPath = OM.MDagPath()
+        selectionList.getDagPath(0, dagPath)
+        mayaPoints = OM.MPointArray()
+        OM.MFnMesh(dagPath).getPoints(mayaPoints)
+        return [Gf.Vec3d(mayaPoints[i].x, mayaPoints[i].y, mayaPoints[i].z)
+            for i in range(mayaPoints.length())]
+
+    def testDenseMeshWithWeightsAndEnvelope(self):
+        """
+        Tests that a mesh with enough points for the blend to be split across
+        threads is deformed correctly, honoring the envelope and per-point
+        weights.
+        """
+        # An 80x80 plane has 6561 points, which is enough for the deformer to
+        # blend the points in parallel.
+        testPlane = cmds.polyPlane(width=1.0, height=1.0,
+            subdivisionsX=80, subdivisionsY=80)[0]
+        restPoints = self._GetMeshPoints(testPlane)
+        self.assertGreater(len(restPoints), 4096)
+
+        # Author a USD mesh whose points are the rest points moved up by one
+        # unit.
+        offset = Gf.Vec3d(0.0, 1.0, 0.0)
+        usdFilePath = os.path.abspath('DensePlane.usda')
+        stage = Usd.Stage.CreateNew(usdFilePath)
+        usdMesh = UsdGeom.Mesh.Define(stage, '/DensePlane')
+        usdMesh.CreatePointsAttr().Set(
+            Vt.Vec3fArray([Gf.Vec3f(p + offset) for p in restPoints]),
+            Usd.TimeCode(self.START_TIMECODE))
+        stage.GetRootLayer().Save()
+
+        stageNode = cmds.createNode('pxrUsdStageNode')
+        cmds.setAttr('%s.filePath' % stageNode, usdFilePath, type='string')
+
+        cmds.select(testPlane, replace=True)
+        deformerNode = cmds.deformer(type='pxrUsdPointBasedDeformerNode')[0]
+        cmds.setAttr('%s.primPath' % deformerNode, '/DensePlane',
+            type='string')
+        cmds.connectAttr('%s.outUsdStage' % stageNode,
+            '%s.inUsdStage' % deformerNode)
+        cmds.connectAttr('time1.outTime', '%s.time' % deformerNode)
+        cmds.currentTime(self.START_TIMECODE)
+
+        # Halve the envelope, and give a few points explicit weights.
+        cmds.setAttr('%s.envelope' % deformerNode, 0.5)
+        weights = {0: 0.0, 100: 0.5, len(restPoints) - 1: 0.0}
+        for index, weight in weights.items():
+            cmds.setAttr('%s.weightList[0].weights[%d]' %
+                (deformerNode, index), weight)
+
+        deformedPoints = self._GetMeshPoints(testPlane)
+        self.assertEqual(len(deformedPoints), len(restPoints))
+        for i, (restPoint, deformedPoint) in enumerate(
+                zip(restPoints, deformedPoints)):
+            alpha = 0.5 * weights.get(i, 1.0)
+            expectedPoint = restPoint + offset * alpha
+            self.assertTrue(
+                Gf.IsClose(deformedPoint, expectedPoint, self.EPSILON),
+                'Point %d is %s, expected %s' %
+                    (i, deformedPoint, expectedPoint))
+
+
 if __name__ == '__main__':
     unittest.main(verbosity=2)
@@ -0,0 +1,126 @@
+#!/pxrpythonsubst
+#
+# Copyright 2019 Pixar
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import os
+import unittest
+
+from pxr import Gf
+
+from maya import OpenMaya as OM
+from maya import OpenMayaAnim as OMA
+from maya import cmds
+from maya import standalone
+
+
+class testPointCacheDeformerNode(unittest.TestCase):
+
+    START_TIMECODE = 1.0
+    MID_TIMECODE = 13.0
+    END_TIMECODE = 24.0
+
+    EPSILON = 1e-3
+
+    @classmethod
+    def setUpClass(cls):
+        standalone.initialize('usd')
+
+        cmds.loadPlugin('pxrUsd')
+
+        cls._deformingCubeUsdFilePath = os.path.abspath('DeformingCube.usda')
+        cls._deformingCubePrimPath = '/DeformingCube/Geom/Cube'
+
+    @classmethod
+    def tearDownClass(cls):
+        standalone.uninitialize()
+
+    def setUp(self):
+        cmds.file(new=True, force=True)
+        OMA.MAnimControl.setAnimationStartEndTime(
+            OM.MTime(self.START_TIMECODE), OM.MTime(self.END_TIMECODE))
+
+    def _ValidateControlPoint(self, nodeName, cpId, expectedPosition):
+        cpX = cmds.getAttr('%s.controlPoints[%d].xValue' % (nodeName, cpId))
+        cpY = cmds.getAttr('%s.controlPoints[%d].yValue' % (nodeName, cpId))
+        cpZ = cmds.getAttr('%s.controlPoints[%d].zValue' % (nodeName, cpId))
+        cpPosition = Gf.Vec3d(cpX, cpY, cpZ)
+
+        self.assertTrue(Gf.IsClose(cpPosition, expectedPosition, self.EPSILON))
+
+    def _ValidateDeformation(self, nodeName):
+        # The Maya cube should be driven by the USD cube, which is twice the
+        # size.
+        cmds.currentTime(self.START_TIMECODE)
+
+        self._ValidateControlPoint(nodeName, 0, Gf.Vec3d(-1.0, -1.0, 1.0))
+        self._ValidateControlPoint(nodeName, 1, Gf.Vec3d(1.0, -1.0, 1.0))
+        self._ValidateControlPoint(nodeName, 2, Gf.Vec3d(-1.0, 1.0, 1.0))
+        self._ValidateControlPoint(nodeName, 3, Gf.Vec3d(1.0, 1.0, 1.0))
+
+        # The animated deformation on the cube should twist the top of it in
+        # the middle of the frame range.
+        cmds.currentTime(self.MID_TIMECODE)
+
+        self._ValidateControlPoint(nodeName, 0, Gf.Vec3d(0.0, -1.0, 1.0))
+        self._ValidateControlPoint(nodeName, 1, Gf.Vec3d(1.0, 0.0, 1.0))
+        self._ValidateControlPoint(nodeName, 2, Gf.Vec3d(-1.0, 0.0, 1.0))
+        self._ValidateControlPoint(nodeName, 3, Gf.Vec3d(0.0, 1.0, 1.0))
+
+    def testCubeWithDeformer(self):
+        """
+        Tests that a native Maya mesh is deformed correctly by a point cache
+        deformer node, without a USD stage node.
+        """
+        testCube = cmds.polyCube(depth=1.0, height=1.0, width=1.0)[0]
+        cmds.select(testCube, replace=True)
+
+        deformerNode = cmds.deformer(type='pxrUsdPointCacheDeformerNode')[0]
+        cmds.setAttr('%s.filePath' % deformerNode,
+            self._deformingCubeUsdFilePath, type='string')
+        cmds.setAttr('%s.primPath' % deformerNode, self._deformingCubePrimPath,
+            type='string')
+        cmds.connectAttr('time1.outTime', '%s.time' % deformerNode)
+
+        self._ValidateDeformation(testCube)
+
+        # Scrubbing back and forth over the cached samples should give the
+        # same result.
+        cmds.currentTime(self.END_TIMECODE)
+        self._ValidateDeformation(testCube)
+
+    def testImportWithPointCache(self):
+        """
+        Tests that importing a deforming mesh with usePointCache streams its
+        points through a point cache deformer, rather than creating a blend
+        shape target per time sample.
+        """
+        cmds.usdImport(file=self._deformingCubeUsdFilePath,
+            readAnimData=True, usePointCache=True, shadingMode='none')
+
+        self.assertEqual(cmds.ls(type='pxrUsdStageNode'), [])
+        self.assertEqual(cmds.ls(type='blendShape'), [])
+
+        deformerNodes = cmds.ls(type='pxrUsdPointCacheDeformerNode')
+        self.assertEqual(len(deformerNodes), 1)
+        self.assertEqual(
+            cmds.getAttr('%s.primPath' % deformerNodes[0]),
+            self._deformingCubePrimPath)
+
+        self._ValidateDeformation('CubeShape')
+
+
+if __name__ == '__main__':
+    unittest.main(verbosity=2)
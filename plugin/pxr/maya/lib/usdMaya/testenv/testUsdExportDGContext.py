@@ -0,0 +1,162 @@
+#!/pxrpythonsubst
+#
+# Copyright 2019 Pixar
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+
+import os
+import unittest
+
+from maya import cmds
+from maya import standalone
+
+from pxr import Usd
+
+
+class testUsdExportDGContext(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        standalone.initialize('usd')
+
+        cmds.loadPlugin('pxrUsd', quiet=True)
+
+    @classmethod
+    def tearDownClass(cls):
+        standalone.uninitialize()
+
+    def _BuildAnimatedScene(self):
+        cmds.file(new=True, force=True)
+        cmds.polyCube(name='cube')
+        cmds.setKeyframe('cube', attribute='translateX', time=1, value=0.0)
+        cmds.setKeyframe('cube', attribute='translateX', time=10, value=9.0)
+        cmds.setKeyframe('cube', attribute='rotateY', time=1, value=0.0)
+        cmds.setKeyframe('cube', attribute='rotateY', time=10, value=90.0)
+        cmds.setKeyframe('polyCube1', attribute='width', time=1, value=1.0)
+        cmds.setKeyframe('polyCube1', attribute='width', time=10, value=4.0)
+
+    def _AssertSamplesMatch(self, usdFileA, usdFileB):
+        stageA = Usd.Stage.Open(usdFileA)
+        stageB = Usd.Stage.Open(usdFileB)
+        numAnimated = 0
+        for primA in stageA.Traverse():
+            primB = stageB.GetPrimAtPath(primA.GetPath())
+            self.assertTrue(primB)
+            for attrA in primA.GetAttributes():
+                attrB = primB.GetAttribute(attrA.GetName())
+                self.assertTrue(attrB)
+                timesA = attrA.GetTimeSamples()
+                self.assertEqual(timesA, attrB.GetTimeSamples())
+                if timesA:
+                    numAnimated += 1
+                for time in timesA:
+                    self.assertEqual(attrA.Get(time), attrB.Get(time),
+                        '%s differs at time %s' % (attrA.GetPath(), time))
+        self.assertGreater(numAnimated, 0)
+
+    def testExportMatchesSceneTimeExport(self):
+        '''
+        Exporting with DG context evaluation should author the same samples as
+        exporting by changing the scene time, and leave the scene time alone.
+        '''
+        self._BuildAnimatedScene()
+        cmds.currentTime(5)
+
+        timeFile = os.path.abspath('UsdExportDGContext_sceneTime.usda')
+        cmds.usdExport(file=timeFile, shadingMode='none',
+                       frameRange=(1.0, 10.0))
+
+        contextFile = os.path.abspath('UsdExportDGContext_dgContext.usda')
+        cmds.usdExport(file=contextFile, shadingMode='none',
+                       frameRange=(1.0, 10.0), dgContextEvaluation=True)
+
+        self._AssertSamplesMatch(timeFile, contextFile)
+        self.assertEqual(cmds.currentTime(query=True), 5)
+
+    def _ExportBothWays(self, name):
+        timeFile = os.path.abspath('UsdExportDGContext_%s_sceneTime.usda' % name)
+        cmds.usdExport(file=timeFile, shadingMode='none',
+                       frameRange=(1.0, 10.0))
+
+        contextFile = os.path.abspath('UsdExportDGContext_%s_dgContext.usda' % name)
+        cmds.usdExport(file=contextFile, shadingMode='none',
+                       frameRange=(1.0, 10.0), dgContextEvaluation=True)
+        return timeFile, contextFile
+
+    def testDeformingMesh(self):
+        '''
+        The points of a deforming mesh should be evaluated at each sample
+        time, even though MFnMesh reads at the current scene time.
+        '''
+        cmds.file(new=True, force=True)
+        cmds.polyCube(name='cube')
+        cmds.select('cube.vtx[0:3]')
+        clusterHandle = cmds.cluster()[1]
+        cmds.setKeyframe(clusterHandle, attribute='translateY', time=1,
+                         value=0.0)
+        cmds.setKeyframe(clusterHandle, attribute='translateY', time=10,
+                         value=5.0)
+        cmds.currentTime(5)
+
+        timeFile, contextFile = self._ExportBothWays('deformingMesh')
+        self._AssertSamplesMatch(timeFile, contextFile)
+        self.assertEqual(cmds.currentTime(query=True), 5)
+
+        points = Usd.Stage.Open(contextFile).GetPrimAtPath(
+            '/cube').GetAttribute('points')
+        self.assertNotEqual(points.Get(1.0), points.Get(10.0))
+        self.assertNotEqual(points.Get(1.0), points.Get(5.0))
+
+    def testAnimatedUVs(self):
+        '''
+        UVs should be read from the mesh evaluated in the DG
+        context too, not from the mesh at the current scene time.
+        '''
+        cmds.file(new=True, force=True)
+        cmds.polyCube(name='cube')
+        moveUV = cmds.polyMoveUV('cube.map[0:13]')[0]
+        cmds.setKeyframe(moveUV, attribute='translateU', time=1, value=0.0)
+        cmds.setKeyframe(moveUV, attribute='translateU', time=10, value=0.5)
+        cmds.currentTime(5)
+
+        timeFile, contextFile = self._ExportBothWays('animatedUVs')
+        self._AssertSamplesMatch(timeFile, contextFile)
+        self.assertEqual(cmds.currentTime(query=True), 5)
+
+        st = Usd.Stage.Open(contextFile).GetPrimAtPath(
+            '/cube').GetAttribute('primvars:st')
+        self.assertNotEqual(st.Get(1.0), st.Get(10.0))
+
+    def testUnsupportedWriterFallsBack(self):
+        '''
+        Prim writers that read through function sets (e.g. cameras) make the
+        export fall back to changing the scene time, so the samples are still
+        correct.
+        '''
+        cmds.file(new=True, force=True)
+        cameraTransform, cameraShape = cmds.camera(name='cam')
+        cmds.setKeyframe(cameraShape, attribute='focalLength', time=1,
+                         value=35.0)
+        cmds.setKeyframe(cameraShape, attribute='focalLength', time=10,
+                         value=85.0)
+        cmds.currentTime(5)
+
+        timeFile, contextFile = self._ExportBothWays('camera')
+        self._AssertSamplesMatch(timeFile, contextFile)
+        self.assertEqual(cmds.currentTime(query=True), 5)
+
+
+if __name__ == '__main__':
+    unittest.main(verbosity=2)
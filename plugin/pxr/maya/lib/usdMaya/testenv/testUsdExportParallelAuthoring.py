@@ -0,0 +1,107 @@
+#!/pxrpythonsubst
+#
+# Copyright 2019 Pixar
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+
+import os
+import time
+import unittest
+
+from maya import cmds
+from maya import standalone
+
+from pxr import Usd
+
+
+class testUsdExportParallelAuthoring(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        standalone.initialize('usd')
+
+        cmds.loadPlugin('pxrUsd', quiet=True)
+
+    @classmethod
+    def tearDownClass(cls):
+        standalone.uninitialize()
+
+    def _BuildAnimatedScene(self, numCubes):
+        cmds.file(new=True, force=True)
+        for i in range(numCubes):
+            cube, polyCube = cmds.polyCube(name='cube%d' % i)
+            cmds.setKeyframe(cube, attribute='translateX', time=1, value=0.0)
+            cmds.setKeyframe(cube, attribute='translateX', time=10, value=i)
+            cmds.setKeyframe(polyCube, attribute='width', time=1, value=1.0)
+            cmds.setKeyframe(polyCube, attribute='width', time=10,
+                             value=2.0 + i)
+
+    def _AssertSamplesMatch(self, usdFileA, usdFileB):
+        stageA = Usd.Stage.Open(usdFileA)
+        stageB = Usd.Stage.Open(usdFileB)
+        numAnimated = 0
+        for primA in stageA.Traverse():
+            primB = stageB.GetPrimAtPath(primA.GetPath())
+            self.assertTrue(primB)
+            for attrA in primA.GetAttributes():
+                attrB = primB.GetAttribute(attrA.GetName())
+                self.assertTrue(attrB)
+                timesA = attrA.GetTimeSamples()
+                self.assertEqual(timesA, attrB.GetTimeSamples())
+                if timesA:
+                    numAnimated += 1
+                for time in timesA:
+                    self.assertEqual(attrA.Get(time), attrB.Get(time),
+                        '%s differs at time %s' % (attrA.GetPath(), time))
+        self.assertGreater(numAnimated, 0)
+
+    def testExportMatchesSerialExport(self):
+        '''
+        Exporting with parallel authoring should author the same samples as a
+        serial export.
+        '''
+        self._BuildAnimatedScene(32)
+
+        serialFile = os.path.abspath('UsdExportParallelAuthoring_serial.usda')
+        start = time.time()
+        cmds.usdExport(file=serialFile, shadingMode='none',
+                       frameRange=(1.0, 10.0))
+        serialTime = time.time() - start
+
+        parallelFile = os.path.abspath(
+            'UsdExportParallelAuthoring_parallel.usda')
+        start = time.time()
+        cmds.usdExport(file=parallelFile, shadingMode='none',
+                       frameRange=(1.0, 10.0), parallelAuthoring=True)
+        parallelTime = time.time() - start
+
+        # Only the extent computation of the meshes runs in parallel, so
+        # report the timings rather than asserting on them.
+        print('serial export: %fs, parallel authoring export: %fs' %
+              (serialTime, parallelTime))
+
+        self._AssertSamplesMatch(serialFile, parallelFile)
+
+        # The points of every cube are animated.
+        stage = Usd.Stage.Open(parallelFile)
+        for i in range(32):
+            points = stage.GetAttributeAtPath('/cube%d.points' % i)
+            self.assertEqual(len(points.GetTimeSamples()), 10)
+            extent = stage.GetAttributeAtPath('/cube%d.extent' % i)
+            self.assertEqual(len(extent.GetTimeSamples()), 10)
+
+
+if __name__ == '__main__':
+    unittest.main(verbosity=2)
@@ -0,0 +1,142 @@
+#!/pxrpythonsubst
+#
+# Copyright 2019 Pixar
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+
+import os
+import time
+import unittest
+
+from maya import cmds
+from maya import standalone
+
+from pxr import Sdf
+from pxr import Usd
+
+
+class testUsdExportStagingLayer(unittest.TestCase):
+
+    NUM_CUBES = 64
+    END_FRAME = 20.0
+
+    @classmethod
+    def setUpClass(cls):
+        standalone.initialize('usd')
+
+        cmds.loadPlugin('pxrUsd', quiet=True)
+
+        cmds.file(new=True, force=True)
+        for i in range(cls.NUM_CUBES):
+            cube, polyCube = cmds.polyCube(name='cube%d' % i)
+            cmds.setKeyframe(cube, attribute='translateX', time=1, value=0.0)
+            cmds.setKeyframe(cube, attribute='translateX',
+                             time=cls.END_FRAME, value=i)
+            cmds.setKeyframe(polyCube, attribute='width', time=1, value=1.0)
+            cmds.setKeyframe(polyCube, attribute='width',
+                             time=cls.END_FRAME, value=2.0 + i)
+
+    @classmethod
+    def tearDownClass(cls):
+        standalone.uninitialize()
+
+    def _Export(self, fileName, **kwargs):
+        usdFile = os.path.abspath(fileName)
+        start = time.time()
+        cmds.usdExport(file=usdFile, shadingMode='none',
+                       frameRange=(1.0, self.END_FRAME), **kwargs)
+        return usdFile, time.time() - start
+
+    def _AssertLayersMatch(self, usdFileA, usdFileB):
+        stageA = Usd.Stage.Open(usdFileA)
+        stageB = Usd.Stage.Open(usdFileB)
+        self.assertEqual(stageA.GetStartTimeCode(), stageB.GetStartTimeCode())
+        self.assertEqual(stageA.GetEndTimeCode(), stageB.GetEndTimeCode())
+        self.assertEqual(stageA.GetDefaultPrim().GetPath(),
+                         stageB.GetDefaultPrim().GetPath())
+
+        numPrims = 0
+        for primA in stageA.Traverse():
+            numPrims += 1
+            primB = stageB.GetPrimAtPath(primA.GetPath())
+            self.assertTrue(primB)
+            for attrA in primA.GetAttributes():
+                attrB = primB.GetAttribute(attrA.GetName())
+                self.assertTrue(attrB)
+                timesA = attrA.GetTimeSamples()
+                self.assertEqual(timesA, attrB.GetTimeSamples())
+                self.assertEqual(attrA.Get(), attrB.Get())
+                for t in timesA:
+                    self.assertEqual(attrA.Get(t), attrB.Get(t),
+                        '%s differs at time %s' % (attrA.GetPath(), t))
+        self.assertEqual(numPrims,
+                         len(list(stageB.Traverse())))
+
+    def testExportMatchesDirectExport(self):
+        '''
+        Exporting through a staging layer should write the same file as
+        authoring to the output layer directly.
+        '''
+        directFile, directTime = self._Export(
+            'UsdExportStagingLayer_direct.usdc')
+        stagedFile, stagedTime = self._Export(
+            'UsdExportStagingLayer_staged.usdc', stagingLayer=True)
+
+        print('Exported %d animated meshes over %d frames: '
+              'direct %.3fs, staged %.3fs' %
+              (self.NUM_CUBES, int(self.END_FRAME), directTime, stagedTime))
+
+        self._AssertLayersMatch(directFile, stagedFile)
+
+    def testExportOverOpenLayer(self):
+        '''
+        The content of a layer that is already open is replaced when the
+        export is saved, and not before.
+        '''
+        usdFile, _ = self._Export('UsdExportStagingLayer_open.usda')
+        layer = Sdf.Layer.FindOrOpen(usdFile)
+        self.assertTrue(layer)
+        layer.GetPrimAtPath('/cube0').SetInfo('documentation', 'stale')
+
+        self._Export('UsdExportStagingLayer_open.usda', stagingLayer=True)
+
+        self.assertTrue(layer.GetPrimAtPath('/cube0'))
+        self.assertFalse(layer.GetPrimAtPath('/cube0').HasInfo('documentation'))
+        self.assertFalse(layer.dirty)
+        self.assertFalse(layer.anonymous)
+
+        directFile, _ = self._Export('UsdExportStagingLayer_open_direct.usda')
+        self._AssertLayersMatch(directFile, usdFile)
+
+    def testAppend(self):
+        '''
+        Appending through a staging layer keeps the existing content of the
+        output layer.
+        '''
+        usdFile = os.path.abspath('UsdExportStagingLayer_append.usda')
+        layer = Sdf.Layer.CreateNew(usdFile)
+        Sdf.CreatePrimInLayer(layer, '/Existing').specifier = Sdf.SpecifierDef
+        layer.Save()
+
+        cmds.usdExport(file=usdFile, shadingMode='none', append=True,
+                       stagingLayer=True)
+
+        stage = Usd.Stage.Open(usdFile)
+        self.assertTrue(stage.GetPrimAtPath('/Existing'))
+        self.assertTrue(stage.GetPrimAtPath('/cube0'))
+
+
+if __name__ == '__main__':
+    unittest.main(verbosity=2)
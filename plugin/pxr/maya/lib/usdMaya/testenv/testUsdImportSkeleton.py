@@ -14,8 +14,8 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 #
-import unittest, os
-from pxr import Gf, Usd, UsdSkel
+import unittest, os, time
+from pxr import Gf, Usd, UsdSkel, Vt
 
 from maya import cmds
 from maya import standalone
@@ -51,6 +51,52 @@ def _ArraysAreClose(a, b, threshold=1e-5):
     return True
 
 
+def _CreateAnimatedSkel(fileName, numChains, chainLength, numFrames):
+    """
+    Writes a Skeleton of numChains chains of chainLength joints, with a
+    SkelAnimation that animates every joint over numFrames frames.
+    """
+    path = os.path.abspath(fileName)
+    stage = Usd.Stage.CreateNew(path)
+    stage.SetStartTimeCode(1)
+    stage.SetEndTimeCode(numFrames)
+
+    root = UsdSkel.Root.Define(stage, "/Root")
+    skel = UsdSkel.Skeleton.Define(stage, "/Root/Skeleton")
+    anim = UsdSkel.Animation.Define(stage, "/Root/Skeleton/Anim")
+
+    joints = []
+    for c in xrange(numChains):
+        for j in xrange(chainLength):
+            joints.append("/".join("c%d_j%d" % (c, k) for k in xrange(j+1)))
+    numJoints = len(joints)
+
+    identities = Vt.Matrix4dArray([Gf.Matrix4d(1)]*numJoints)
+    skel.CreateJointsAttr(joints)
+    skel.CreateBindTransformsAttr(identities)
+    skel.CreateRestTransformsAttr(identities)
+    UsdSkel.BindingAPI.Apply(root.GetPrim()).CreateSkeletonRel().SetTargets(
+        [skel.GetPrim().GetPath()])
+    UsdSkel.BindingAPI.Apply(skel.GetPrim()).CreateAnimationSourceRel(
+        ).SetTargets([anim.GetPrim().GetPath()])
+
+    anim.CreateJointsAttr(joints)
+    anim.CreateScalesAttr(Vt.Vec3hArray([Gf.Vec3h(1)]*numJoints))
+    translationsAttr = anim.CreateTranslationsAttr()
+    rotationsAttr = anim.CreateRotationsAttr()
+    for frame in xrange(1, numFrames+1):
+        translationsAttr.Set(Vt.Vec3fArray(
+            [Gf.Vec3f(1, 0.01*frame, 0.001*j) for j in xrange(numJoints)]),
+            frame)
+        rotationsAttr.Set(Vt.QuatfArray(
+            [Gf.Quatf(Gf.Rotation(Gf.Vec3d(0, 0, 1),
+                                  (frame + j) % 90).GetQuat())
+             for j in xrange(numJoints)]), frame)
+
+    stage.GetRootLayer().Save()
+    return path
+
+
 class testUsdImportSkeleton(unittest.TestCase):
 
     @classmethod
@@ -276,5 +322,41 @@ class testUsdImportSkeleton(unittest.TestCase):
             usdSkinningQuery=skinningQuery)
 
 
+    def test_LargeSkelAnimImport(self):
+        """
+        Imports the animation of a Skeleton with many joints over many frames,
+        and checks a selection of the joints against the SkelAnimation.
+        """
+        numChains, chainLength, numFrames = 30, 10, 1000
+        path = _CreateAnimatedSkel("largeSkelAnim.usdc",
+                                   numChains, chainLength, numFrames)
+
+        cmds.file(new=True, force=True)
+        start = time.time()
+        cmds.usdImport(file=path, readAnimData=True, primPath="/Root",
+                       shadingMode="none")
+        print("Imported the animation of %d joints over %d frames in %.3fs" %
+              (numChains*chainLength, numFrames, time.time() - start))
+
+        stage = Usd.Stage.Open(path)
+        skelCache = UsdSkel.Cache()
+        skelCache.Populate(UsdSkel.Root.Get(stage, "/Root"))
+        skelQuery = skelCache.GetSkelQuery(
+            UsdSkel.Skeleton.Get(stage, "/Root/Skeleton"))
+        self.assertTrue(skelQuery)
+
+        jointNames = [name.split("/")[-1] for name in skelQuery.GetJointOrder()]
+        checkedJoints = range(0, len(jointNames), 37) + [len(jointNames)-1]
+
+        for frame in (1, 2, numFrames/2, numFrames):
+            cmds.currentTime(frame)
+            usdXforms = skelQuery.ComputeJointLocalTransforms(frame)
+            for i in checkedJoints:
+                self.assertTrue(_ArraysAreClose(
+                    cmds.getAttr("%s.matrix" % jointNames[i]),
+                    _GfMatrixToList(usdXforms[i]), 1e-4),
+                    "joint %s at frame %d" % (jointNames[i], frame))
+
+
 if __name__ == '__main__':
     unittest.main(verbosity=2)
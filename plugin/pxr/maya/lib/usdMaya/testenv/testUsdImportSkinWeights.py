@@ -0,0 +1,177 @@
+#!/pxrpythonsubst
+#
+# Copyright 2019 Pixar
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+
+import os
+import resource
+import time
+import unittest
+
+from maya import cmds
+from maya import standalone
+
+from pxr import Gf
+from pxr import Usd
+from pxr import UsdGeom
+from pxr import UsdSkel
+from pxr import Vt
+
+
+# The weights given to the influences of each point.
+_INFLUENCE_WEIGHTS = [0.4, 0.3, 0.2, 0.1]
+
+
+def _InfluenceJoints(point, numJoints):
+    '''
+    Returns the joints influencing a point. Every fifth point lists its first
+    joint twice, so that the weights of repeated joints must be summed.
+    '''
+    joints = [(point * 7 + k * 13) % numJoints
+              for k in range(len(_INFLUENCE_WEIGHTS))]
+    if point % 5 == 0:
+        joints[-1] = joints[0]
+    return joints
+
+
+def _ExpectedWeights(point, numJoints):
+    weights = [0.0] * numJoints
+    for joint, weight in zip(_InfluenceJoints(point, numJoints),
+                             _INFLUENCE_WEIGHTS):
+        weights[joint] += weight
+    return weights
+
+
+def _CreateRig(fileName, side, numJoints):
+    '''
+    Writes a skinned grid mesh of side*side points, bound to a skeleton of
+    numJoints joints, with four influences per point.
+    '''
+    path = os.path.abspath(fileName)
+    stage = Usd.Stage.CreateNew(path)
+
+    root = UsdSkel.Root.Define(stage, '/Root')
+
+    skel = UsdSkel.Skeleton.Define(stage, '/Root/Skeleton')
+    skel.CreateJointsAttr(Vt.TokenArray(
+        ['joint%d' % j for j in range(numJoints)]))
+    identities = Vt.Matrix4dArray([Gf.Matrix4d(1)] * numJoints)
+    skel.CreateBindTransformsAttr(identities)
+    skel.CreateRestTransformsAttr(identities)
+    UsdSkel.BindingAPI.Apply(root.GetPrim()).CreateSkeletonRel().SetTargets(
+        [skel.GetPrim().GetPath()])
+
+    mesh = UsdGeom.Mesh.Define(stage, '/Root/Mesh')
+    mesh.CreatePointsAttr(Vt.Vec3fArray(
+        [Gf.Vec3f(x, 0, z) for z in range(side) for x in range(side)]))
+    counts = []
+    faceIndices = []
+    for z in range(side - 1):
+        for x in range(side - 1):
+            i = z * side + x
+            counts.append(4)
+            faceIndices.extend([i, i + side, i + side + 1, i + 1])
+    mesh.CreateFaceVertexCountsAttr(Vt.IntArray(counts))
+    mesh.CreateFaceVertexIndicesAttr(Vt.IntArray(faceIndices))
+
+    numPoints = side * side
+    jointIndices = []
+    for point in range(numPoints):
+        jointIndices.extend(_InfluenceJoints(point, numJoints))
+    binding = UsdSkel.BindingAPI.Apply(mesh.GetPrim())
+    binding.CreateGeomBindTransformAttr(Gf.Matrix4d(1))
+    binding.CreateJointIndicesPrimvar(
+        False, len(_INFLUENCE_WEIGHTS)).Set(Vt.IntArray(jointIndices))
+    binding.CreateJointWeightsPrimvar(
+        False, len(_INFLUENCE_WEIGHTS)).Set(
+            Vt.FloatArray(_INFLUENCE_WEIGHTS * numPoints))
+
+    stage.GetRootLayer().Save()
+    return path
+
+
+def _PeakMemory():
+    # ru_maxrss is reported in kilobytes on Linux.
+    return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss * 1024
+
+
+class testUsdImportSkinWeights(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        standalone.initialize('usd')
+        cmds.loadPlugin('pxrUsd', quiet=True)
+
+    @classmethod
+    def tearDownClass(cls):
+        standalone.uninitialize()
+
+    def _ImportRig(self, fileName, side, numJoints):
+        path = _CreateRig(fileName, side, numJoints)
+
+        cmds.file(new=True, force=True)
+        peakBefore = _PeakMemory()
+        start = time.time()
+        cmds.usdImport(file=path, primPath='/Root', shadingMode='none')
+        elapsed = time.time() - start
+        peakGrowth = _PeakMemory() - peakBefore
+
+        numPoints = side * side
+        denseBytes = numPoints * numJoints * 8
+        print('Imported skin weights for %d points and %d joints in %.3fs; '
+              'peak memory grew by %.1fMB (dense weights would be %.1fMB)' %
+              (numPoints, numJoints, elapsed,
+               peakGrowth / 1048576.0, denseBytes / 1048576.0))
+        return peakGrowth, denseBytes
+
+    def _ValidateWeights(self, side, numJoints):
+        numPoints = side * side
+        for point in range(0, numPoints, max(1, numPoints // 20)) + [
+                numPoints - 1]:
+            weights = cmds.skinPercent('skinCluster_Mesh',
+                                       'Mesh.vtx[%d]' % point,
+                                       query=True, value=True)
+            self.assertEqual(len(weights), numJoints)
+            expected = _ExpectedWeights(point, numJoints)
+            for joint in range(numJoints):
+                self.assertTrue(Gf.IsClose(weights[joint], expected[joint],
+                                           1e-6),
+                                'point %d, joint %d: %f != %f' %
+                                (point, joint, weights[joint],
+                                 expected[joint]))
+
+    def testSmallRig(self):
+        '''
+        A rig small enough for its weights to be set from a dense array.
+        '''
+        side, numJoints = 10, 16
+        self._ImportRig('UsdImportSkinWeights_small.usda', side, numJoints)
+        self._ValidateWeights(side, numJoints)
+
+    def testLargeRig(self):
+        '''
+        A rig whose weights are too large to be set densely. Only the
+        non-zero weights should be set, without allocating the dense array.
+        '''
+        side, numJoints = 317, 600
+        peakGrowth, denseBytes = self._ImportRig(
+            'UsdImportSkinWeights_large.usdc', side, numJoints)
+        self._ValidateWeights(side, numJoints)
+        self.assertLess(peakGrowth, denseBytes)
+
+
+if __name__ == '__main__':
+    unittest.main(verbosity=2)
@@ -451,6 +451,13 @@ UsdMayaTransformWriter::UsdMayaTransformWriter(
     }
 }
 
+/* virtual */
+bool
+UsdMayaTransformWriter::SupportsDGContextEvaluation() const
+{
+    return true;
+}
+
 /* virtual */
 void
 UsdMayaTransformWriter::Write(const UsdTimeCode& usdTime)
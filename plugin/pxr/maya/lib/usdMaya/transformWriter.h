@@ -62,6 +62,11 @@ public:
     PXRUSDMAYA_API
     void Write(const UsdTimeCode& usdTime) override;
 
+    /// Xform ops are read from their plugs, so they can be evaluated in a
+    /// DG context. Subclasses that read other data must override this.
+    PXRUSDMAYA_API
+    bool SupportsDGContextEvaluation() const override;
+
 private:
     using _TokenRotationMap = std::unordered_map<
             const TfToken, MEulerRotation, TfToken::HashFunctor>;
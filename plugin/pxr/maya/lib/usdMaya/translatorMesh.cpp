@@ -17,6 +17,7 @@
 
 #include "usdMaya/meshUtil.h"
 #include "usdMaya/pointBasedDeformerNode.h"
+#include "usdMaya/pointCacheDeformerNode.h"
 #include "usdMaya/primReaderArgs.h"
 #include "usdMaya/primReaderContext.h"
 #include "usdMaya/readUtil.h"
@@ -33,12 +34,14 @@
 #include "pxr/base/vt/array.h"
 #include "pxr/base/vt/types.h"
 
+#include "pxr/usd/sdf/layer.h"
 #include "pxr/usd/sdf/path.h"
 #include "pxr/usd/sdf/tokens.h"
 #include "pxr/usd/sdf/types.h"
 #include "pxr/usd/sdf/valueTypeName.h"
 #include "pxr/usd/usd/attribute.h"
 #include "pxr/usd/usd/prim.h"
+#include "pxr/usd/usd/stage.h"
 #include "pxr/usd/usd/timeCode.h"
 #include "pxr/usd/usdGeom/mesh.h"
 #include "pxr/usd/usdGeom/primvar.h"
@@ -73,6 +76,108 @@
 PXR_NAMESPACE_OPEN_SCOPE
 
 
+/// Creates a deformer node of type \p deformerTypeName for \p prim, naming
+/// it with \p nodeNamePrefix, and registers it with \p context.
+/// The deformer is not yet applied to any geometry; see
+/// _AddMayaNodeToDeformer().
+static
+bool
+_CreateDeformerForPrim(
+        const UsdPrim& prim,
+        const TfToken& deformerTypeName,
+        const std::string& nodeNamePrefix,
+        UsdMayaPrimReaderContext* context,
+        MObject* deformerNode,
+        MString* deformerNodeName)
+{
+    // Clear the selection list so that the deformer command doesn't try to add
+    // anything to the new deformer's set. We'll do that manually afterwards.
+    MStatus status = MGlobal::clearSelectionList();
+    CHECK_MSTATUS_AND_RETURN(status, false);
+
+    // Create the deformer node for this prim.
+    const std::string nodeName =
+        TfStringPrintf("%s%s",
+                       nodeNamePrefix.c_str(),
+                       TfStringReplace(prim.GetPath().GetString(),
+                                       SdfPathTokens->childDelimiter.GetString(),
+                                       "_").c_str());
+
+    const std::string deformerCmd = TfStringPrintf(
+        "from maya import cmds; cmds.deformer(name=\'%s\', type=\'%s\')[0]",
+        nodeName.c_str(),
+        deformerTypeName.GetText());
+    status = MGlobal::executePythonCommand(deformerCmd.c_str(),
+                                           *deformerNodeName);
+    CHECK_MSTATUS_AND_RETURN(status, false);
+
+    // Get the newly created deformer node.
+    status = UsdMayaUtil::GetMObjectByName(deformerNodeName->asChar(),
+                                           *deformerNode);
+    CHECK_MSTATUS_AND_RETURN(status, false);
+
+    context->RegisterNewMayaNode(deformerNodeName->asChar(), *deformerNode);
+
+    return true;
+}
+
+/// Applies the deformer \p deformerNode named \p deformerNodeName to
+/// \p mayaObj, so that it is evaluated before any component edits.
+static
+bool
+_AddMayaNodeToDeformer(
+        const MObject& mayaObj,
+        const MObject& deformerNode,
+        const MString& deformerNodeName)
+{
+    MStatus status;
+
+    // Add the Maya object to the deformer node's set.
+    const MFnGeometryFilter geomFilterFn(deformerNode, &status);
+    CHECK_MSTATUS_AND_RETURN(status, false);
+
+    MObject deformerSet = geomFilterFn.deformerSet(&status);
+    CHECK_MSTATUS_AND_RETURN(status, false);
+
+    MFnSet setFn(deformerSet, &status);
+    CHECK_MSTATUS_AND_RETURN(status, false);
+
+    status = setFn.addMember(mayaObj);
+    CHECK_MSTATUS_AND_RETURN(status, false);
+
+    // When we created the deformer, Maya will have automatically created a
+    // tweak deformer and put it *before* our deformer in the deformer chain.
+    // We don't want that, since any component edits made interactively in
+    // Maya will appear to have no effect since they'll be overridden by our
+    // deformer. Instead, we want the tweak to go *after* our deformer. To do
+    // this, we need to dig for the name of the tweak deformer node that Maya
+    // created to be able to pass it to the reorderDeformers command.
+    const MFnDagNode dagNodeFn(mayaObj, &status);
+    CHECK_MSTATUS_AND_RETURN(status, false);
+
+    // XXX: This seems to be the "most sane" way of finding the tweak deformer
+    // node's name...
+    const std::string findTweakCmd = TfStringPrintf(
+        "from maya import cmds; [x for x in cmds.listHistory(\'%s\') if cmds.nodeType(x) == \'tweak\'][0]",
+        dagNodeFn.fullPathName().asChar());
+
+    MString tweakDeformerNodeName;
+    status = MGlobal::executePythonCommand(findTweakCmd.c_str(),
+                                           tweakDeformerNodeName);
+    CHECK_MSTATUS_AND_RETURN(status, false);
+
+    // Do the reordering.
+    const std::string reorderDeformersCmd = TfStringPrintf(
+        "from maya import cmds; cmds.reorderDeformers(\'%s\', \'%s\', \'%s\')",
+        tweakDeformerNodeName.asChar(),
+        deformerNodeName.asChar(),
+        dagNodeFn.fullPathName().asChar());
+    status = MGlobal::executePythonCommand(reorderDeformersCmd.c_str());
+    CHECK_MSTATUS_AND_RETURN(status, false);
+
+    return true;
+}
+
 static
 bool
 _SetupPointBasedDeformerForMayaNode(
@@ -104,35 +209,17 @@ _SetupPointBasedDeformerForMayaNode(
     MObject timeNode = timePlug.node(&status);
     CHECK_MSTATUS_AND_RETURN(status, false);
 
-    // Clear the selection list so that the deformer command doesn't try to add
-    // anything to the new deformer's set. We'll do that manually afterwards.
-    status = MGlobal::clearSelectionList();
-    CHECK_MSTATUS_AND_RETURN(status, false);
-
-    // Create the point based deformer node for this prim.
-    const std::string pointBasedDeformerNodeName =
-        TfStringPrintf("usdPointBasedDeformerNode%s",
-                       TfStringReplace(prim.GetPath().GetString(),
-                                       SdfPathTokens->childDelimiter.GetString(),
-                                       "_").c_str());
-
-    const std::string deformerCmd = TfStringPrintf(
-        "from maya import cmds; cmds.deformer(name=\'%s\', type=\'%s\')[0]",
-        pointBasedDeformerNodeName.c_str(),
-        UsdMayaPointBasedDeformerNodeTokens->MayaTypeName.GetText());
-    MString newPointBasedDeformerName;
-    status = MGlobal::executePythonCommand(deformerCmd.c_str(),
-                                           newPointBasedDeformerName);
-    CHECK_MSTATUS_AND_RETURN(status, false);
-
-    // Get the newly created point based deformer node.
     MObject pointBasedDeformerNode;
-    status = UsdMayaUtil::GetMObjectByName(newPointBasedDeformerName.asChar(),
-                                              pointBasedDeformerNode);
-    CHECK_MSTATUS_AND_RETURN(status, false);
-
-    context->RegisterNewMayaNode(newPointBasedDeformerName.asChar(),
-                                 pointBasedDeformerNode);
+    MString newPointBasedDeformerName;
+    if (!_CreateDeformerForPrim(
+            prim,
+            UsdMayaPointBasedDeformerNodeTokens->MayaTypeName,
+            "usdPointBasedDeformerNode",
+            context,
+            &pointBasedDeformerNode,
+            &newPointBasedDeformerName)) {
+        return false;
+    }
 
     MFnDependencyNode depNodeFn(pointBasedDeformerNode, &status);
     CHECK_MSTATUS_AND_RETURN(status, false);
@@ -166,51 +253,91 @@ _SetupPointBasedDeformerForMayaNode(
     status = dgMod.doIt();
     CHECK_MSTATUS_AND_RETURN(status, false);
 
-    // Add the Maya object to the point based deformer node's set.
-    const MFnGeometryFilter geomFilterFn(pointBasedDeformerNode, &status);
+    return _AddMayaNodeToDeformer(mayaObj,
+                                  pointBasedDeformerNode,
+                                  newPointBasedDeformerName);
+}
+
+/// Sets up a point cache deformer that streams the points of \p prim from
+/// the root layer of its stage onto \p mayaObj. Unlike the point based
+/// deformer, this does not need a USD stage node.
+static
+bool
+_SetupPointCacheDeformerForMayaNode(
+        MObject& mayaObj,
+        const UsdPrim& prim,
+        UsdMayaPrimReaderContext* context)
+{
+    if (!context) {
+        return false;
+    }
+
+    // The deformer reads the points back from the file, so there must be one.
+    const SdfLayerHandle rootLayer = prim.GetStage()->GetRootLayer();
+    if (!rootLayer || rootLayer->IsAnonymous()) {
+        return false;
+    }
+
+    // Get the output time plug and node for Maya's global time object.
+    MPlug timePlug = UsdMayaUtil::GetMayaTimePlug();
+    if (timePlug.isNull()) {
+        return false;
+    }
+
+    MStatus status;
+    MObject timeNode = timePlug.node(&status);
     CHECK_MSTATUS_AND_RETURN(status, false);
 
-    MObject deformerSet = geomFilterFn.deformerSet(&status);
+    MObject pointCacheDeformerNode;
+    MString newPointCacheDeformerName;
+    if (!_CreateDeformerForPrim(
+            prim,
+            UsdMayaPointCacheDeformerNodeTokens->MayaTypeName,
+            "usdPointCacheDeformerNode",
+            context,
+            &pointCacheDeformerNode,
+            &newPointCacheDeformerName)) {
+        return false;
+    }
+
+    MFnDependencyNode depNodeFn(pointCacheDeformerNode, &status);
     CHECK_MSTATUS_AND_RETURN(status, false);
 
-    MFnSet setFn(deformerSet, &status);
+    MDGModifier dgMod;
+
+    // Set the file and prim paths on the deformer node.
+    MPlug filePathPlug =
+        depNodeFn.findPlug(UsdMayaPointCacheDeformerNode::filePathAttr,
+                           true,
+                           &status);
     CHECK_MSTATUS_AND_RETURN(status, false);
 
-    status = setFn.addMember(mayaObj);
+    status = dgMod.newPlugValueString(filePathPlug,
+                                      rootLayer->GetRealPath().c_str());
     CHECK_MSTATUS_AND_RETURN(status, false);
 
-    // When we created the point based deformer, Maya will have automatically
-    // created a tweak deformer and put it *before* the point based deformer in
-    // the deformer chain. We don't want that, since any component edits made
-    // interactively in Maya will appear to have no effect since they'll be
-    // overridden by the point based deformer. Instead, we want the tweak to go
-    // *after* the point based deformer. To do this, we need to dig for the
-    // name of the tweak deformer node that Maya created to be able to pass it
-    // to the reorderDeformers command.
-    const MFnDagNode dagNodeFn(mayaObj, &status);
+    MPlug primPathPlug =
+        depNodeFn.findPlug(UsdMayaPointCacheDeformerNode::primPathAttr,
+                           true,
+                           &status);
     CHECK_MSTATUS_AND_RETURN(status, false);
 
-    // XXX: This seems to be the "most sane" way of finding the tweak deformer
-    // node's name...
-    const std::string findTweakCmd = TfStringPrintf(
-        "from maya import cmds; [x for x in cmds.listHistory(\'%s\') if cmds.nodeType(x) == \'tweak\'][0]",
-        dagNodeFn.fullPathName().asChar());
+    status = dgMod.newPlugValueString(primPathPlug, prim.GetPath().GetText());
+    CHECK_MSTATUS_AND_RETURN(status, false);
 
-    MString tweakDeformerNodeName;
-    status = MGlobal::executePythonCommand(findTweakCmd.c_str(),
-                                           tweakDeformerNodeName);
+    // Connect the global Maya time to the deformer node.
+    status = dgMod.connect(timeNode,
+                           timePlug.attribute(),
+                           pointCacheDeformerNode,
+                           UsdMayaPointCacheDeformerNode::timeAttr);
     CHECK_MSTATUS_AND_RETURN(status, false);
 
-    // Do the reordering.
-    const std::string reorderDeformersCmd = TfStringPrintf(
-        "from maya import cmds; cmds.reorderDeformers(\'%s\', \'%s\', \'%s\')",
-        tweakDeformerNodeName.asChar(),
-        newPointBasedDeformerName.asChar(),
-        dagNodeFn.fullPathName().asChar());
-    status = MGlobal::executePythonCommand(reorderDeformersCmd.c_str());
+    status = dgMod.doIt();
     CHECK_MSTATUS_AND_RETURN(status, false);
 
-    return true;
+    return _AddMayaNodeToDeformer(mayaObj,
+                                  pointCacheDeformerNode,
+                                  newPointCacheDeformerName);
 }
 
 /* static */
@@ -540,6 +667,13 @@ UsdMayaTranslatorMesh::Create(
         return true;
     }
 
+    // Otherwise, if we're streaming the points from the file, try to setup
+    // the point cache deformer, which avoids creating a mesh per time sample.
+    if (args.GetUsePointCache() &&
+            _SetupPointCacheDeformerForMayaNode(meshObj, prim, context)) {
+        return true;
+    }
+
     // Use blendShapeDeformer so that all the points for a frame are contained
     // in a single node.
     //
@@ -19,8 +19,10 @@
 #include "usdMaya/translatorXformable.h"
 #include "usdMaya/util.h"
 
+#include "pxr/base/tf/envSetting.h"
 #include "pxr/base/tf/staticData.h"
 #include "pxr/base/tf/staticTokens.h"
+#include "pxr/base/work/loops.h"
 
 #include "pxr/usd/usdSkel/skeleton.h"
 #include "pxr/usd/usdSkel/skeletonQuery.h"
@@ -39,15 +41,28 @@
 #include <maya/MFnNumericAttribute.h>
 #include <maya/MFnSingleIndexedComponent.h>
 #include <maya/MFnSkinCluster.h>
+#include <maya/MIntArray.h>
 #include <maya/MMatrix.h>
 #include <maya/MObjectHandle.h>
 #include <maya/MPlug.h>
 #include <maya/MPlugArray.h>
 
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
 
 PXR_NAMESPACE_OPEN_SCOPE
 
 
+TF_DEFINE_ENV_SETTING(PIXMAYA_SKIN_WEIGHTS_MAX_DENSE_VALUES, 1 << 22,
+        "The largest number of values (points times joints) for which "
+        "skinCluster weights are imported in one batch, from a dense array. "
+        "Larger skinClusters only have their non-zero weights set, one "
+        "influence at a time.");
+
+
 // There are a lot of nodes and connections that go into a basic skinning rig.
 // The following is an overview of everything that must be rigged up:
 //
@@ -210,82 +225,70 @@ _SetAnimPlugData(MFnDependencyNode& depNode,
 }
 
 
+/// The number of channels in a decomposed transform: translate, rotate and
+/// scale, each with X, Y and Z components.
+constexpr size_t _NumXformChannels = 9;
+
+
+/// Decompose \p xform into translate, rotate and scale channels, writing
+/// channel c to \p channels[c*stride].
+void
+_DecomposeTransform(const GfMatrix4d& xform, double* channels, size_t stride)
+{
+    GfVec3d t(0.0), r(0.0), s(1.0);
+    if (!UsdMayaTranslatorXformable::ConvertUsdMatrixToComponents(
+           xform, &t, &r, &s)) {
+        t = GfVec3d(0.0);
+        r = GfVec3d(0.0);
+        s = GfVec3d(1.0);
+    }
+    for (int c = 0; c < 3; ++c) {
+        channels[c*stride] = t[c];
+        channels[(3 + c)*stride] = r[c];
+        channels[(6 + c)*stride] = s[c];
+    }
+}
+
+
 /// Set animation on \p transformNode.
-/// The \p xforms holds transforms at each time, while the \p times
-/// array holds the corresponding times.
+/// The \p channels hold the decomposed transform at each time (as written
+/// by _DecomposeTransform, with a stride of the number of times), while the
+/// \p times array holds the corresponding times.
 bool
 _SetTransformAnim(MFnDependencyNode& transformNode,
-                  const std::vector<GfMatrix4d>& xforms,
+                  const double* channels,
                   MTimeArray& times,
                   const UsdMayaPrimReaderContext* context)
 {
-    if (xforms.size() != times.length()) {
-        TF_WARN("xforms size [%zu] != times size [%du].",
-                xforms.size(), times.length());
-        return false;
-    }
-    if (xforms.empty())
+    const unsigned int numSamples = times.length();
+    if (numSamples == 0)
         return true;
 
-    MStatus status;
-
-    const unsigned int numSamples = times.length();
+    auto channel = [&](int c) { return channels + c*numSamples; };
 
     if (numSamples > 1) {
-        MDoubleArray translates[3] = {
-            MDoubleArray(numSamples),
-            MDoubleArray(numSamples),   
-            MDoubleArray(numSamples)
-        };
-        MDoubleArray rotates[3] = {
-            MDoubleArray(numSamples),
-            MDoubleArray(numSamples),
-            MDoubleArray(numSamples)
-        };
-        MDoubleArray scales[3] = {
-            MDoubleArray(numSamples, 1),
-            MDoubleArray(numSamples, 1),
-            MDoubleArray(numSamples, 1)
-        };
-
-        // Decompose all transforms.
-        for (unsigned int i = 0; i < numSamples; ++i) {
-            const auto& xform = xforms[i];
-            GfVec3d t, r, s;
-            if (UsdMayaTranslatorXformable::ConvertUsdMatrixToComponents(
-                   xform, &t, &r, &s)) {
-                for (int c = 0 ; c < 3; ++c) {
-                    translates[c][i] = t[c];
-                    rotates[c][i] = r[c];
-                    scales[c][i] = s[c];
-                }
-            }
-        }
-
         for (int c = 0; c < 3; ++c) {
+            MDoubleArray translates(channel(c), numSamples);
+            MDoubleArray rotates(channel(3 + c), numSamples);
+            MDoubleArray scales(channel(6 + c), numSamples);
             if (!_SetAnimPlugData(transformNode, _MayaTokens->translates[c],
-                                 translates[c], times, context) ||
+                                 translates, times, context) ||
                !_SetAnimPlugData(transformNode, _MayaTokens->rotates[c],
-                                 rotates[c], times, context) ||
+                                 rotates, times, context) ||
                !_SetAnimPlugData(transformNode, _MayaTokens->scales[c],
-                                 scales[c], times, context)) {
+                                 scales, times, context)) {
                 return false;
             }
         }
     } else {
-        const auto& xform = xforms.front();
-        GfVec3d t, r, s;
-        if (UsdMayaTranslatorXformable::ConvertUsdMatrixToComponents(
-               xform, &t, &r, &s)) {
-            for (int c = 0; c < 3; ++c) {
-                if (!UsdMayaUtil::setPlugValue(
-                       transformNode, _MayaTokens->translates[c], t[c]) ||
-                   !UsdMayaUtil::setPlugValue(
-                       transformNode, _MayaTokens->rotates[c], r[c]) ||
-                   !UsdMayaUtil::setPlugValue(
-                       transformNode, _MayaTokens->scales[c], s[c])) {
-                    return false;
-                }
+        for (int c = 0; c < 3; ++c) {
+            if (!UsdMayaUtil::setPlugValue(
+                   transformNode, _MayaTokens->translates[c], *channel(c)) ||
+               !UsdMayaUtil::setPlugValue(
+                   transformNode, _MayaTokens->rotates[c], *channel(3 + c)) ||
+               !UsdMayaUtil::setPlugValue(
+                   transformNode, _MayaTokens->scales[c], *channel(6 + c))) {
+                return false;
             }
         }
     }
@@ -487,6 +490,72 @@ _CopyJointRestStatesFromSkel(const UsdSkelSkeletonQuery& skelQuery,
 }
 
 
+/// Sample the local transforms of the Skeleton of \p skelQuery, and of each
+/// of its joints, at \p usdTimes, and decompose them into \p channels.
+///
+/// The channels are stored as a structure of arrays, so that the samples of
+/// each channel of each joint are contiguous, and can be handed directly to
+/// _SetTransformAnim:
+///   joint_0_channel_0_time_0 ... joint_0_channel_0_time_n ...
+///   joint_0_channel_8_time_n ... joint_n_channel_8_time_n
+/// The Skeleton itself is stored after the last joint.
+///
+/// The times are sampled and decomposed in parallel, as the Skeleton query
+/// is safe to read from multiple threads.
+/// If \p concatSkelOntoRoots is true, the local transform of the Skeleton
+/// is concatenated onto the root joints.
+bool
+_SampleSkelAnim(const UsdSkelSkeletonQuery& skelQuery,
+                const std::vector<double>& usdTimes,
+                bool concatSkelOntoRoots,
+                std::vector<double>* channels)
+{
+    const UsdSkelTopology& topology = skelQuery.GetTopology();
+    const size_t numJoints = topology.GetNumJoints();
+    const size_t numSamples = usdTimes.size();
+    const size_t jointStride = _NumXformChannels*numSamples;
+
+    channels->resize((numJoints + 1)*jointStride);
+    double* skelChannels = channels->data() + numJoints*jointStride;
+
+    UsdGeomXformable::XformQuery xfQuery(skelQuery.GetSkeleton());
+
+    std::atomic<bool> success(true);
+    WorkParallelForN(
+        numSamples,
+        [&](size_t begin, size_t end) {
+            VtMatrix4dArray xforms;
+            for (size_t i = begin; i < end && success; ++i) {
+                GfMatrix4d skelLocalXform;
+                if (!xfQuery.GetLocalTransformation(&skelLocalXform,
+                                                    usdTimes[i])) {
+                    skelLocalXform.SetIdentity();
+                }
+                _DecomposeTransform(skelLocalXform, skelChannels + i,
+                                    numSamples);
+
+                if (!skelQuery.ComputeJointLocalTransforms(&xforms,
+                                                           usdTimes[i]) ||
+                    xforms.size() != numJoints) {
+                    success = false;
+                    return;
+                }
+                for (size_t j = 0; j < numJoints; ++j) {
+                    GfMatrix4d xform = xforms[j];
+                    if (concatSkelOntoRoots && topology.GetParent(j) < 0) {
+                        // This is a root joint. Concat by the local skel xform.
+                        xform *= skelLocalXform;
+                    }
+                    _DecomposeTransform(
+                        xform, channels->data() + j*jointStride + i,
+                        numSamples);
+                }
+            }
+        });
+    return success;
+}
+
+
 /// Apply joint animation, as computed from from \p skelQuery,
 /// onto \p jointNodes.
 /// If \p jointContainerIsSkeleton is true, the \p jointContainer node
@@ -511,14 +580,21 @@ _CopyAnimFromSkel(const UsdSkelSkeletonQuery& skelQuery,
 
     MStatus status;
 
-    // Pre-sample the Skeleton's local transforms.
-    std::vector<GfMatrix4d> skelLocalXforms(usdTimes.size());
-    UsdGeomXformable::XformQuery xfQuery(skelQuery.GetSkeleton());
-    for (size_t i = 0; i < usdTimes.size(); ++i) {
-        if (!xfQuery.GetLocalTransformation(&skelLocalXforms[i], usdTimes[i])) {
-            skelLocalXforms[i].SetIdentity();
-        }
+    // Pre-sample and decompose all of the animation. This is the bulk of the
+    // work, and does not touch Maya, so it is done up front (and in
+    // parallel). Only the creation of the anim curves happens below.
+    // We do not have a node to receive the local transforms of the
+    // Skeleton unless the jointContainer represents it, so otherwise any
+    // local transforms on the Skeleton must be concatenated onto the root
+    // joints instead.
+    std::vector<double> channels;
+    if (!_SampleSkelAnim(skelQuery, usdTimes,
+                         /*concatSkelOntoRoots*/ !jointContainerIsSkeleton,
+                         &channels)) {
+        return false;
     }
+    const size_t numJoints = skelQuery.GetTopology().GetNumJoints();
+    const size_t jointStride = _NumXformChannels*usdTimes.size();
 
     if (jointContainerIsSkeleton) {
         // The jointContainer is being used to represent the Skeleton.
@@ -527,46 +603,24 @@ _CopyAnimFromSkel(const UsdSkelSkeletonQuery& skelQuery,
         MFnDependencyNode skelXformDep(jointContainer, &status);
         CHECK_MSTATUS_AND_RETURN(status, false);
 
-        if (!_SetTransformAnim(skelXformDep, skelLocalXforms,
+        if (!_SetTransformAnim(skelXformDep,
+                               channels.data() + numJoints*jointStride,
                                mayaTimes, context)) {
             return false;
         }
     }
 
-    // Pre-sample all joint animation.
-    std::vector<VtMatrix4dArray> samples(usdTimes.size());
-    for (size_t i = 0; i < samples.size(); ++i) {
-        if (!skelQuery.ComputeJointLocalTransforms(&samples[i], usdTimes[i])) {
-            return false;
-        }
-        if (!jointContainerIsSkeleton) {
-            // We do not have a node to receive the local transforms of the
-            // Skeleton, so any local transforms on the Skeleton must be
-            // concatened onto the root joints instead.
-            for (size_t j = 0; j < skelQuery.GetTopology().GetNumJoints(); ++j){
-                if (skelQuery.GetTopology().GetParent(j) < 0) {
-                    // This is a root joint. Concat by the local skel xform.
-                    samples[i][j] *= skelLocalXforms[i];
-                }
-            }
-        }
-    }
-
     MFnDependencyNode jointDep;
 
-    std::vector<GfMatrix4d> xforms(samples.size());
-
-    for (size_t jointIdx = 0; jointIdx < jointNodes.size(); ++jointIdx) {
+    for (size_t jointIdx = 0;
+         jointIdx < std::min(jointNodes.size(), numJoints); ++jointIdx) {
 
         if (!jointDep.setObject(jointNodes[jointIdx]))
             continue;
 
-        // Get the transforms of just this joint.
-        for (size_t i = 0; i < samples.size(); ++i) {
-            xforms[i] = samples[i][jointIdx];
-        }
-
-        if (!_SetTransformAnim(jointDep, xforms, mayaTimes, context))
+        if (!_SetTransformAnim(jointDep,
+                               channels.data() + jointIdx*jointStride,
+                               mayaTimes, context))
             return false;
     }
     return true;
@@ -912,6 +966,32 @@ UsdMayaTranslatorSkel::GetBindPose(const UsdSkelSkeletonQuery& skelQuery,
 namespace {
 
 
+/// Set the weights of a single influence on the points listed in
+/// \p pointIndices. Used when importing weights sparsely.
+bool
+_SetInfluenceWeights(MFnSkinCluster& skinClusterFn,
+                     const MDagPath& dagPath,
+                     unsigned int influenceIndex,
+                     const int* pointIndices,
+                     const double* weights,
+                     unsigned int count)
+{
+    MStatus status;
+
+    MFnSingleIndexedComponent components;
+    components.create(MFn::kMeshVertComponent);
+    status = components.addElements(MIntArray(pointIndices, count));
+    CHECK_MSTATUS_AND_RETURN(status, false);
+
+    status = skinClusterFn.setWeights(dagPath, components.object(),
+                                      MIntArray(1, influenceIndex),
+                                      MDoubleArray(weights, count),
+                                      /*normalize*/ false);
+    CHECK_MSTATUS_AND_RETURN(status, false);
+    return true;
+}
+
+
 bool
 _SetVaryingJointInfluences(const MFnMesh& meshFn,
                            const MObject& skinCluster,
@@ -935,34 +1015,91 @@ _SetVaryingJointInfluences(const MFnMesh& meshFn,
 
     const unsigned int numJoints = static_cast<unsigned int>(joints.size());
 
+    // The weights are set in one batch from a dense, vertex-ordered array
+    // when it is small enough. Otherwise (e.g., a character with a few hundred
+    // thousand points and hundreds of joints, where the dense array would
+    // need gigabytes of mostly-zero values), only the non-zero weights are
+    // set, one influence at a time. The skinCluster was created without any
+    // weights, so the weights that are skipped are already zero.
+    const size_t numDenseWeights = size_t(numPoints)*numJoints;
+    const bool sparse = numDenseWeights > static_cast<size_t>(std::max(
+        TfGetEnvSetting(PIXMAYA_SKIN_WEIGHTS_MAX_DENSE_VALUES), 0));
+
     // Compute a vertex-ordered weight arrays. Weights are stored as:
     //   vert_0_joint_0 ... vert_0_joint_n ... vert_n_joint_0 ... vert_n_joint_n
-    MDoubleArray vertOrderedWeights(numPoints*numJoints, 0.0f); 
-    for (unsigned int pt = 0; pt < numPoints; ++pt) {
+    MDoubleArray vertOrderedWeights(sparse ? 0 : numDenseWeights, 0.0);
+
+    // Otherwise, the point indices and weights of each joint are gathered
+    // into contiguous runs (offsets[j] to offsets[j+1]), so that the memory
+    // needed is bounded by numPoints*numInfluencesPerPoint.
+    std::vector<unsigned int> offsets;
+    std::vector<int> pointsByJoint;
+    std::vector<double> weightsByJoint;
+
+    // There may be multiple influences referencing the same joint
+    // for a point. eg., 'unweighted' points are assigned
+    // index 0 and weight 0. Sum the weight contributions to ensure
+    // that we properly account for this.
+    using _JointWeight = std::pair<int, double>;
+    std::vector<_JointWeight> pointWeights;
+    pointWeights.reserve(numInfluencesPerPoint);
+    auto sumPointWeights = [&](unsigned int pt) {
+        pointWeights.clear();
         for (int c = 0; c < numInfluencesPerPoint; ++c) {
             int jointIdx = indices[pt*numInfluencesPerPoint+c];
             if (jointIdx >= 0 
                && static_cast<unsigned int>(jointIdx) < numJoints) {
                 float w = weights[pt*numInfluencesPerPoint+c];
-                // There may be multiple influences referencing the same joint
-                // for this point. eg., 'unweighted' points are assigned
-                // index 0 and weight 0. Sum the weight contributions to ensure
-                // that we properly account for this.
-                vertOrderedWeights[pt*numJoints + jointIdx] += w;
+                auto it = std::find_if(pointWeights.begin(),
+                                       pointWeights.end(),
+                                       [jointIdx](const _JointWeight& p)
+                                       { return p.first == jointIdx; });
+                if (it != pointWeights.end()) {
+                    it->second += w;
+                } else {
+                    pointWeights.emplace_back(jointIdx, w);
+                }
+            }
+        }
+    };
+
+    if (sparse) {
+        // First pass counts the non-zero weights of each joint, the second
+        // fills in the runs.
+        offsets.assign(numJoints + 1, 0);
+        for (unsigned int pt = 0; pt < numPoints; ++pt) {
+            sumPointWeights(pt);
+            for (const auto& pw : pointWeights) {
+                if (pw.second != 0.0) {
+                    ++offsets[pw.first + 1];
+                }
+            }
+        }
+        for (unsigned int j = 0; j < numJoints; ++j) {
+            offsets[j + 1] += offsets[j];
+        }
+        pointsByJoint.resize(offsets[numJoints]);
+        weightsByJoint.resize(offsets[numJoints]);
+        std::vector<unsigned int> cursors(offsets.begin(), offsets.end() - 1);
+        for (unsigned int pt = 0; pt < numPoints; ++pt) {
+            sumPointWeights(pt);
+            for (const auto& pw : pointWeights) {
+                if (pw.second != 0.0) {
+                    const unsigned int i = cursors[pw.first]++;
+                    pointsByJoint[i] = static_cast<int>(pt);
+                    weightsByJoint[i] = pw.second;
+                }
+            }
+        }
+    } else {
+        for (unsigned int pt = 0; pt < numPoints; ++pt) {
+            sumPointWeights(pt);
+            for (const auto& pw : pointWeights) {
+                vertOrderedWeights[pt*numJoints + pw.first] += pw.second;
             }
         }
     }
 
-    MIntArray influenceIndices(numJoints);
-    for (unsigned int i = 0; i < numJoints; ++i) {
-        influenceIndices[i] = i;
-    }
-
-    // Set all weights in one batch 
-    MFnSingleIndexedComponent components;
-    components.create(MFn::kMeshVertComponent);
-    components.setCompleteData(numPoints);
-
     // XXX: Note that weights are expected to be pre-normalized in USD.
     // In order to faithfully transfer our source data, we do not perform
     // any normalization on import. Maya's weight normalization also seems
@@ -991,10 +1128,33 @@ _SetVaryingJointInfluences(const MFnMesh& meshFn,
     // Apply the weights. Note that this fails with kInvalidParameter
     // if the influenceIndices are invalid. Validity is based on the
     // set of joints wired up to the skinCluster.
-    status = skinClusterFn.setWeights(dagPath, components.object(),
-                                      influenceIndices, vertOrderedWeights,
-                                      /*normalize*/ false);
-    CHECK_MSTATUS_AND_RETURN(status, false);
+    if (sparse) {
+        for (unsigned int j = 0; j < numJoints; ++j) {
+            const unsigned int count = offsets[j + 1] - offsets[j];
+            if (count > 0 &&
+                !_SetInfluenceWeights(skinClusterFn, dagPath, j,
+                                      pointsByJoint.data() + offsets[j],
+                                      weightsByJoint.data() + offsets[j],
+                                      count)) {
+                return false;
+            }
+        }
+    } else {
+        MIntArray influenceIndices(numJoints);
+        for (unsigned int i = 0; i < numJoints; ++i) {
+            influenceIndices[i] = i;
+        }
+
+        // Set all weights in one batch 
+        MFnSingleIndexedComponent components;
+        components.create(MFn::kMeshVertComponent);
+        components.setCompleteData(numPoints);
+
+        status = skinClusterFn.setWeights(dagPath, components.object(),
+                                          influenceIndices, vertOrderedWeights,
+                                          /*normalize*/ false);
+        CHECK_MSTATUS_AND_RETURN(status, false);
+    }
 
 
     // Reset the normalization flag to its previous value.
@@ -49,9 +49,9 @@
 #include <maya/MFnSet.h>
 #include <maya/MFnTypedAttribute.h>
 #include <maya/MGlobal.h>
+#include <maya/MIntArray.h>
 #include <maya/MItDependencyGraph.h>
 #include <maya/MItDependencyNodes.h>
-#include <maya/MItMeshFaceVertex.h>
 #include <maya/MItMeshPolygon.h>
 #include <maya/MMatrix.h>
 #include <maya/MObject.h>
@@ -1051,13 +1051,46 @@ UsdMayaUtil::CompressFaceVaryingPrimvarIndices(
         return;
     }
 
+    MIntArray mayaFaceVertexCounts;
+    MIntArray mayaFaceVertexIndices;
+    if (!mesh.getVertices(mayaFaceVertexCounts, mayaFaceVertexIndices)) {
+        return;
+    }
+
+    VtIntArray faceVertexCounts(mayaFaceVertexCounts.length());
+    mayaFaceVertexCounts.get(faceVertexCounts.data());
+    VtIntArray faceVertexIndices(mayaFaceVertexIndices.length());
+    mayaFaceVertexIndices.get(faceVertexIndices.data());
+
+    CompressFaceVaryingPrimvarIndices(
+        faceVertexCounts,
+        faceVertexIndices,
+        mesh.numVertices(),
+        interpolation,
+        assignmentIndices);
+}
+
+void
+UsdMayaUtil::CompressFaceVaryingPrimvarIndices(
+        const VtIntArray& faceVertexCounts,
+        const VtIntArray& faceVertexIndices,
+        const int numVertices,
+        TfToken* interpolation,
+        VtIntArray* assignmentIndices)
+{
+    if (!interpolation ||
+            !assignmentIndices ||
+            assignmentIndices->size() == 0u ||
+            assignmentIndices->size() != faceVertexIndices.size()) {
+        return;
+    }
+
     // Use -2 as the initial "un-stored" sentinel value, since -1 is the
     // default unauthored value index for primvars.
-    int numPolygons = mesh.numPolygons();
+    const size_t numPolygons = faceVertexCounts.size();
     VtIntArray uniformAssignments;
-    uniformAssignments.assign((size_t)numPolygons, -2);
+    uniformAssignments.assign(numPolygons, -2);
 
-    int numVertices = mesh.numVertices();
     VtIntArray vertexAssignments;
     vertexAssignments.assign((size_t)numVertices, -2);
 
@@ -1067,41 +1100,46 @@ UsdMayaUtil::CompressFaceVaryingPrimvarIndices(
     bool isUniform = true;
     bool isVertex = true;
 
-    MItMeshFaceVertex itFV(mesh.object());
-    unsigned int fvi = 0;
-    for (itFV.reset(); !itFV.isDone(); itFV.next(), ++fvi) {
-        int faceIndex = itFV.faceId();
-        int vertexIndex = itFV.vertId();
+    size_t fvi = 0;
+    for (size_t faceIndex = 0; faceIndex < numPolygons; ++faceIndex) {
+        const int numFaceVertices = faceVertexCounts[faceIndex];
+        for (int i = 0; i < numFaceVertices; ++i, ++fvi) {
+            const int vertexIndex = faceVertexIndices[fvi];
+            if (vertexIndex < 0 || vertexIndex >= numVertices) {
+                return;
+            }
 
-        int assignedIndex = (*assignmentIndices)[fvi];
+            const int assignedIndex = (*assignmentIndices)[fvi];
 
-        if (isConstant) {
-            if (assignedIndex != (*assignmentIndices)[0]) {
-                isConstant = false;
+            if (isConstant) {
+                if (assignedIndex != (*assignmentIndices)[0]) {
+                    isConstant = false;
+                }
             }
-        }
 
-        if (isUniform) {
-            if (uniformAssignments[faceIndex] < -1) {
-                // No value for this face yet, so store one.
-                uniformAssignments[faceIndex] = assignedIndex;
-            } else if (assignedIndex != uniformAssignments[faceIndex]) {
-                isUniform = false;
+            if (isUniform) {
+                if (uniformAssignments[faceIndex] < -1) {
+                    // No value for this face yet, so store one.
+                    uniformAssignments[faceIndex] = assignedIndex;
+                } else if (assignedIndex != uniformAssignments[faceIndex]) {
+                    isUniform = false;
+                }
             }
-        }
 
-        if (isVertex) {
-            if (vertexAssignments[vertexIndex] < -1) {
-                // No value for this vertex yet, so store one.
-                vertexAssignments[vertexIndex] = assignedIndex;
-            } else if (assignedIndex != vertexAssignments[vertexIndex]) {
-                isVertex = false;
+            if (isVertex) {
+                if (vertexAssignments[vertexIndex] < -1) {
+                    // No value for this vertex yet, so store one.
+                    vertexAssignments[vertexIndex] = assignedIndex;
+                } else if (assignedIndex != vertexAssignments[vertexIndex]) {
+                    isVertex = false;
+                }
             }
-        }
 
-        if (!isConstant && !isUniform && !isVertex) {
-            // No compression will be possible, so stop trying.
-            break;
+            if (!isConstant && !isUniform && !isVertex) {
+                // No compression will be possible, so stop trying.
+                *interpolation = UsdGeomTokens->faceVarying;
+                return;
+            }
         }
     }
 
@@ -351,6 +351,18 @@ void CompressFaceVaryingPrimvarIndices(
         PXR_NS::TfToken* interpolation,
         PXR_NS::VtIntArray* assignmentIndices);
 
+/// \overload
+/// Takes the topology of the mesh as the face vertex counts and indices
+/// authored to USD, rather than as an MFnMesh. This does not access Maya, so
+/// it may be called from any thread.
+PXRUSDMAYA_API
+void CompressFaceVaryingPrimvarIndices(
+        const PXR_NS::VtIntArray& faceVertexCounts,
+        const PXR_NS::VtIntArray& faceVertexIndices,
+        int numVertices,
+        PXR_NS::TfToken* interpolation,
+        PXR_NS::VtIntArray* assignmentIndices);
+
 /// Get whether \p plug is authored in the Maya scene.
 ///
 /// A plug is considered authored if its value has been changed from the
@@ -34,6 +34,7 @@
 #include "pxr/base/tf/pathUtils.h"
 #include "pxr/base/tf/stl.h"
 #include "pxr/base/tf/stringUtils.h"
+#include "pxr/base/work/loops.h"
 #include "pxr/usd/ar/resolver.h"
 #include "pxr/usd/kind/registry.h"
 #include "pxr/usd/sdf/layer.h"
@@ -55,6 +56,10 @@
 
 #include <maya/MAnimControl.h>
 #include <maya/MComputation.h>
+#include <maya/MDGContext.h>
+#if MAYA_API_VERSION >= 20180000
+#include <maya/MDGContextGuard.h>
+#endif
 #include <maya/MDistance.h>
 #include <maya/MFnDagNode.h>
 #include <maya/MFnRenderLayer.h>
@@ -68,6 +73,7 @@
 #include <limits>
 #include <map>
 #include <unordered_set>
+#include <vector>
 
 PXR_NAMESPACE_OPEN_SCOPE
 
@@ -139,18 +145,56 @@ UsdMaya_WriteJob::Write(const std::string& fileName, bool append)
     if (!timeSamples.empty()) {
         const MTime oldCurTime = MAnimControl::currentTime();
 
+        bool dgContextEvaluation = mJobCtx.mArgs.dgContextEvaluation;
+#if MAYA_API_VERSION < 20180000
+        if (dgContextEvaluation) {
+            TF_WARN("DG context evaluation requires Maya 2018 or later; "
+                    "falling back to changing the scene time.");
+            dgContextEvaluation = false;
+        }
+#endif
+        if (dgContextEvaluation) {
+            for (const UsdMayaPrimWriterSharedPtr& primWriter :
+                    mJobCtx.mMayaPrimWriterList) {
+                if (!primWriter->SupportsDGContextEvaluation()) {
+                    TF_WARN("The prim writer for %s cannot be evaluated in a "
+                            "DG context; falling back to changing the scene "
+                            "time.",
+                            primWriter->GetDagPath().fullPathName().asChar());
+                    dgContextEvaluation = false;
+                    break;
+                }
+            }
+        }
+
         int progress = 0;
         for (double t : timeSamples) {
             if (mJobCtx.mArgs.verbose) {
                 TF_STATUS("%f", t);
             }
-            MGlobal::viewFrame(t);
             computation.setProgress(progress);
             progress++;
 
             // Process per frame data.
-            if (!_WriteFrame(t)) {
-                MGlobal::viewFrame(oldCurTime);
+            bool frameWritten = false;
+            if (dgContextEvaluation) {
+#if MAYA_API_VERSION >= 20180000
+                // Evaluate everything read during this frame at time t,
+                // leaving the global scene time untouched.
+                const MDGContext context(MTime(t, MTime::uiUnit()));
+                const MDGContextGuard contextGuard(context);
+                frameWritten = _WriteFrame(t);
+#endif
+            }
+            else {
+                MGlobal::viewFrame(t);
+                frameWritten = _WriteFrame(t);
+            }
+
+            if (!frameWritten) {
+                if (!dgContextEvaluation) {
+                    MGlobal::viewFrame(oldCurTime);
+                }
                 computation.endComputation();
                 return false;
             }
@@ -162,7 +206,9 @@ UsdMaya_WriteJob::Write(const std::string& fileName, bool append)
         }
 
         // Set the time back.
-        MGlobal::viewFrame(oldCurTime);
+        if (!dgContextEvaluation) {
+            MGlobal::viewFrame(oldCurTime);
+        }
     }
 
     // Finalize the export, close the stage.
@@ -442,15 +488,40 @@ bool
 UsdMaya_WriteJob::_WriteFrame(double iFrame)
 {
     const UsdTimeCode usdTime(iFrame);
+    const bool parallelAuthoring = mJobCtx.mArgs.parallelAuthoring;
 
+    // Prim writers that support it only read from Maya here. They then
+    // convert what they read in parallel, and finally author the results
+    // on this thread.
+    std::vector<UsdMayaPrimWriter*> stagedWriters;
     for (const UsdMayaPrimWriterSharedPtr& primWriter :
             mJobCtx.mMayaPrimWriterList) {
         const UsdPrim& usdPrim = primWriter->GetUsdPrim();
         if (usdPrim) {
-            primWriter->Write(usdTime);
+            if (parallelAuthoring && primWriter->SupportsStagedWrite()) {
+                primWriter->ReadFrame(usdTime);
+                stagedWriters.push_back(primWriter.get());
+            }
+            else {
+                primWriter->Write(usdTime);
+            }
         }
     }
 
+    WorkParallelForN(
+        stagedWriters.size(),
+        [&stagedWriters, &usdTime](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                stagedWriters[i]->ComputeFrame(usdTime);
+            }
+        });
+
+    // The stage is not thread safe for writing, so the values are authored
+    // serially.
+    for (UsdMayaPrimWriter* primWriter : stagedWriters) {
+        primWriter->AuthorFrame(usdTime);
+    }
+
     for (UsdMayaChaserRefPtr& chaser : mChasers) {
         if (!chaser->ExportFrame(iFrame)) {
             return false;
@@ -541,9 +612,7 @@ UsdMaya_WriteJob::_FinishWriting()
     _PostCallback();
 
     TF_STATUS("Saving stage");
-    if (mJobCtx.mStage->GetRootLayer()->PermissionToSave()) {
-        mJobCtx.mStage->GetRootLayer()->Save();
-    }
+    mJobCtx._SaveFile();
 
     // If we are making a usdz archive, invoke the packaging API and then clean
     // up the non-packaged stage file.
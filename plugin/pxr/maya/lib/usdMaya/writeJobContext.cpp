@@ -403,7 +403,11 @@ UsdMayaWriteJobContext::_OpenFile(const std::string& filename, bool append)
         if (SdfLayerRefPtr existingLayer = SdfLayer::Find(filename)) {
             TF_STATUS(
                     "Writing to already-open layer '%s'", filename.c_str());
-            existingLayer->Clear();
+            // When staging, the layer's content is replaced in one go when
+            // the export is saved.
+            if (!mArgs.stagingLayer) {
+                existingLayer->Clear();
+            }
             layer = existingLayer;
         }
         else {
@@ -416,6 +420,19 @@ UsdMayaWriteJobContext::_OpenFile(const std::string& filename, bool append)
         }
     }
 
+    _outputLayer = SdfLayerRefPtr();
+    if (mArgs.stagingLayer) {
+        // Author into an anonymous layer that no other stage can be using,
+        // so that edits made during the export don't trigger change
+        // processing on the output layer. When appending, the staging layer
+        // starts out with the existing content.
+        _outputLayer = layer;
+        layer = SdfLayer::CreateAnonymous(TfGetBaseName(filename));
+        if (append) {
+            layer->TransferContent(_outputLayer);
+        }
+    }
+
     mStage = UsdStage::Open(layer, resolverCtx);
     if (!mStage) {
         TF_RUNTIME_ERROR("Error opening stage for '%s'", filename.c_str());
@@ -441,6 +458,30 @@ UsdMayaWriteJobContext::_OpenFile(const std::string& filename, bool append)
     return true;
 }
 
+bool
+UsdMayaWriteJobContext::_SaveFile()
+{
+    if (!mStage) {
+        return false;
+    }
+
+    SdfLayerHandle rootLayer = mStage->GetRootLayer();
+    if (_outputLayer) {
+        TF_STATUS("Transferring staging layer to '%s'",
+                _outputLayer->GetIdentifier().c_str());
+        _outputLayer->TransferContent(rootLayer);
+        rootLayer = _outputLayer;
+    }
+
+    bool success = false;
+    if (rootLayer->PermissionToSave()) {
+        success = rootLayer->Save();
+    }
+
+    _outputLayer = SdfLayerRefPtr();
+    return success;
+}
+
 bool
 UsdMayaWriteJobContext::_PostProcess()
 {
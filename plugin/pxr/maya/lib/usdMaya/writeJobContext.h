@@ -25,6 +25,7 @@
 
 #include "pxr/pxr.h"
 
+#include "pxr/usd/sdf/layer.h"
 #include "pxr/usd/sdf/path.h"
 
 #include <maya/MDagPath.h>
@@ -140,6 +141,13 @@ protected:
     PXRUSDMAYA_API
     bool _OpenFile(const std::string& filename, bool append);
 
+    /// Saves the stage opened by _OpenFile() to its file.
+    /// If the export was authored into a staging layer, its content is
+    /// transferred to the output layer first, and the output layer is
+    /// released once it has been saved.
+    PXRUSDMAYA_API
+    bool _SaveFile();
+
     /// Whether the current export options should traverse \p curDag and its
     /// descendants.
     PXRUSDMAYA_API
@@ -215,6 +223,10 @@ private:
 
     std::unique_ptr<UsdMaya_SkelBindingsProcessor> _skelBindingsProcessor;
 
+    // The layer that the export is saved to, when the stage was opened on an
+    // anonymous staging layer instead (see UsdMayaJobExportArgs::stagingLayer).
+    SdfLayerRefPtr _outputLayer;
+
     // Cache of node type names mapped to their "resolved" writer factory,
     // taking into account Maya's type hierarchy (note that this means that
     // some types not resolved by the UsdMayaPrimWriterRegistry will get
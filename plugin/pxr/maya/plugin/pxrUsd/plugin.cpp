@@ -30,6 +30,7 @@
 #include "usdMaya/listShadingModesCommand.h"
 #include "usdMaya/notice.h"
 #include "usdMaya/pointBasedDeformerNode.h"
+#include "usdMaya/pointCacheDeformerNode.h"
 #include "usdMaya/proxyShape.h"
 #include "usdMaya/referenceAssembly.h"
 #include "usdMaya/stageData.h"
@@ -78,6 +79,14 @@ initializePlugin(MObject obj)
         MPxNode::kDeformerNode);
     CHECK_MSTATUS(status);
 
+    status = plugin.registerNode(
+        UsdMayaPointCacheDeformerNode::typeName,
+        UsdMayaPointCacheDeformerNode::typeId,
+        UsdMayaPointCacheDeformerNode::creator,
+        UsdMayaPointCacheDeformerNode::initialize,
+        MPxNode::kDeformerNode);
+    CHECK_MSTATUS(status);
+
     status = plugin.registerShape(
         UsdMayaProxyShape::typeName,
         UsdMayaProxyShape::typeId,
@@ -274,6 +283,9 @@ uninitializePlugin(MObject obj)
     status = plugin.deregisterNode(UsdMayaProxyShape::typeId);
     CHECK_MSTATUS(status);
 
+    status = plugin.deregisterNode(UsdMayaPointCacheDeformerNode::typeId);
+    CHECK_MSTATUS(status);
+
     status = plugin.deregisterNode(UsdMayaPointBasedDeformerNode::typeId);
     CHECK_MSTATUS(status);
 
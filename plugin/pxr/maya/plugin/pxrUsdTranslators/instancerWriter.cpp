@@ -201,6 +201,14 @@ PxrUsdTranslators_InstancerWriter::PxrUsdTranslators_InstancerWriter(
     _modelPaths.push_back(_usdPrim.GetPath());
 }
 
+/* virtual */
+bool
+PxrUsdTranslators_InstancerWriter::SupportsDGContextEvaluation() const
+{
+    // Reads its data through function sets at the current scene time.
+    return false;
+}
+
 /* virtual */
 void
 PxrUsdTranslators_InstancerWriter::Write(const UsdTimeCode& usdTime)
@@ -59,6 +59,7 @@ public:
             UsdMayaWriteJobContext& jobCtx);
 
     void Write(const UsdTimeCode& usdTime) override;
+    bool SupportsDGContextEvaluation() const override;
     void PostExport() override;
     bool ShouldPruneChildren() const override;
     const SdfPathVector& GetModelPaths() const override;
@@ -38,6 +38,7 @@
 #include "pxr/usd/usdUtils/pipeline.h"
 
 #include <maya/MFnDependencyNode.h>
+#include <maya/MFloatVector.h>
 #include <maya/MFnMesh.h>
 #include <maya/MIntArray.h>
 #include <maya/MPlug.h>
@@ -176,6 +177,207 @@ PxrUsdTranslators_MeshWriter::Write(const UsdTimeCode& usdTime)
     writeMeshAttrs(usdTime, primSchema);
 }
 
+/* virtual */
+bool
+PxrUsdTranslators_MeshWriter::SupportsStagedWrite() const
+{
+    return true;
+}
+
+/* virtual */
+bool
+PxrUsdTranslators_MeshWriter::SupportsDGContextEvaluation() const
+{
+    return true;
+}
+
+/* virtual */
+void
+PxrUsdTranslators_MeshWriter::ReadFrame(const UsdTimeCode& usdTime)
+{
+    _deferSample = true;
+    Write(usdTime);
+    _deferSample = false;
+}
+
+/* virtual */
+void
+PxrUsdTranslators_MeshWriter::ComputeFrame(const UsdTimeCode& /* usdTime */)
+{
+    // Nothing is pending if the mesh is not animated.
+    if (_hasPendingSample) {
+        _ComputeMeshSample(&_pendingSample);
+    }
+}
+
+/* virtual */
+void
+PxrUsdTranslators_MeshWriter::AuthorFrame(const UsdTimeCode& usdTime)
+{
+    if (_hasPendingSample) {
+        UsdGeomMesh primSchema(_usdPrim);
+        _AuthorMeshSample(usdTime, primSchema, &_pendingSample);
+        _pendingSample = _MeshSample();
+        _hasPendingSample = false;
+    }
+}
+
+/* static */
+void
+PxrUsdTranslators_MeshWriter::_ComputeMeshSample(_MeshSample* sample)
+{
+    const float* mayaRawPoints = sample->rawPoints.data();
+    const int numVertices = sample->numVertices;
+    sample->points.resize(numVertices);
+    for (int i = 0; i < numVertices; i++) {
+        const int floatIndex = i*3;
+        sample->points[i].Set(mayaRawPoints[floatIndex],
+                              mayaRawPoints[floatIndex+1],
+                              mayaRawPoints[floatIndex+2]);
+    }
+
+    // Compute the extent using the raw points
+    sample->extent.resize(2);
+    UsdGeomPointBased::ComputeExtent(sample->points, &sample->extent);
+
+    sample->faceVertexCounts.resize(sample->mayaFaceVertexCounts.length());
+    sample->mayaFaceVertexCounts.get(sample->faceVertexCounts.data());
+    sample->faceVertexIndices.resize(sample->mayaFaceVertexIndices.length());
+    sample->mayaFaceVertexIndices.get(sample->faceVertexIndices.data());
+
+    // Using itFV.getNormal() does not always give us the right answer, so
+    // instead the normal ids of the face vertices index into the normals.
+    if (sample->emitNormals) {
+        const unsigned int numFaceVertices = sample->faceVertexIndices.size();
+        const unsigned int numNormals = sample->mayaNormals.length();
+        sample->normalsValid =
+            (sample->mayaNormalIds.length() == numFaceVertices);
+        sample->normals.resize(sample->normalsValid ? numFaceVertices : 0);
+        for (unsigned int fvi = 0;
+                sample->normalsValid && fvi < numFaceVertices; ++fvi) {
+            const int normalId = sample->mayaNormalIds[fvi];
+            if (normalId < 0 ||
+                    static_cast<unsigned int>(normalId) >= numNormals) {
+                sample->normalsValid = false;
+                break;
+            }
+
+            const MFloatVector& normal = sample->mayaNormals[normalId];
+            sample->normals[fvi].Set(normal[0], normal[1], normal[2]);
+        }
+    }
+
+    for (_UVSetSample& uvSet : sample->uvSets) {
+        _ComputeMeshUVSet(*sample, &uvSet);
+    }
+
+    for (_ColorSetSample& colorSet : sample->colorSets) {
+        _ComputeMeshColorSet(*sample, &colorSet);
+    }
+}
+
+void
+PxrUsdTranslators_MeshWriter::_AuthorMeshSample(
+        const UsdTimeCode& usdTime,
+        UsdGeomMesh& primSchema,
+        _MeshSample* sample)
+{
+    _SetAttribute(primSchema.GetPointsAttr(), &sample->points, usdTime);
+    _SetAttribute(primSchema.CreateExtentAttr(), &sample->extent, usdTime);
+    _SetAttribute(primSchema.GetFaceVertexCountsAttr(),
+                  &sample->faceVertexCounts, usdTime);
+    _SetAttribute(primSchema.GetFaceVertexIndicesAttr(),
+                  &sample->faceVertexIndices, usdTime);
+
+    if (sample->normalsValid) {
+        _SetAttribute(primSchema.GetNormalsAttr(), &sample->normals, usdTime);
+        primSchema.SetNormalsInterpolation(UsdGeomTokens->faceVarying);
+    }
+
+    // == Write UVSets as Vec2f Primvars
+    for (const _UVSetSample& uvSet : sample->uvSets) {
+        if (!uvSet.valid) {
+            continue;
+        }
+
+        _createUVPrimVar(primSchema,
+                         uvSet.name,
+                         usdTime,
+                         uvSet.values,
+                         uvSet.interpolation,
+                         uvSet.assignmentIndices);
+    }
+
+    for (const _ColorSetSample& colorSet : sample->colorSets) {
+        if (!colorSet.valid) {
+            continue;
+        }
+
+        if (colorSet.isDisplayColor) {
+            // We tag the resulting displayColor/displayOpacity primvar as
+            // authored to make sure we reconstruct the color set on import.
+            _addDisplayPrimvars(
+                primSchema,
+                usdTime,
+                colorSet.colorSetRep,
+                colorSet.RGBData,
+                colorSet.AlphaData,
+                colorSet.interpolation,
+                colorSet.assignmentIndices,
+                colorSet.clamped,
+                true);
+        } else if (colorSet.colorSetRep == MFnMesh::kAlpha) {
+            _createAlphaPrimVar(primSchema,
+                                colorSet.name,
+                                usdTime,
+                                colorSet.AlphaData,
+                                colorSet.interpolation,
+                                colorSet.assignmentIndices,
+                                colorSet.clamped);
+        } else if (colorSet.colorSetRep == MFnMesh::kRGB) {
+            _createRGBPrimVar(primSchema,
+                              colorSet.name,
+                              usdTime,
+                              colorSet.RGBData,
+                              colorSet.interpolation,
+                              colorSet.assignmentIndices,
+                              colorSet.clamped);
+        } else if (colorSet.colorSetRep == MFnMesh::kRGBA) {
+            _createRGBAPrimVar(primSchema,
+                               colorSet.name,
+                               usdTime,
+                               colorSet.RGBData,
+                               colorSet.AlphaData,
+                               colorSet.interpolation,
+                               colorSet.assignmentIndices,
+                               colorSet.clamped);
+        }
+    }
+
+    // _addDisplayPrimvars() will only author displayColor and displayOpacity
+    // if no authored opinions exist, so the code below only has an effect if
+    // we did NOT find a displayColor color set above.
+    if (_GetExportArgs().exportDisplayColor) {
+        // Using the shader default values (an alpha of zero, in particular)
+        // results in Gprims rendering the same way in usdview as they do in
+        // Maya (i.e. unassigned components are invisible).
+        //
+        // Since these colors come from the shaders and not a colorset, we are
+        // not adding the clamp attribute as custom data. We also don't need to
+        // reconstruct a color set from them on import since they originated
+        // from the bound shader(s), so the authored flag is set to false.
+        _addDisplayPrimvars(primSchema,
+                            usdTime,
+                            MFnMesh::kRGBA,
+                            sample->shadersRGBData,
+                            sample->shadersAlphaData,
+                            sample->shadersInterpolation,
+                            sample->shadersAssignmentIndices,
+                            false,
+                            false);
+    }
+}
+
 bool
 PxrUsdTranslators_MeshWriter::writeMeshAttrs(
         const UsdTimeCode& usdTime,
@@ -212,6 +414,26 @@ PxrUsdTranslators_MeshWriter::writeMeshAttrs(
     // and user-defined tagging (e.g. subdiv tags).
     MObject geomMeshObj = _skelInputMesh.isNull() ?
             finalMesh.object() : _skelInputMesh;
+
+    // The mesh to read UVs, color sets, holes and creases from. Tags that
+    // are stored as attributes on the node are read through finalMesh's
+    // plugs, which are evaluated in the current DG context as well.
+    MObject sidecarMeshObj = finalMesh.object();
+
+    // MFnMesh(dagPath) always reads the mesh at the current scene time. When
+    // samples are evaluated in a DG context instead, pull the mesh through
+    // the outMesh plug so that it is evaluated in that context, and read all
+    // of the mesh data from it so that every attribute is from the same time.
+    if (_skelInputMesh.isNull() && _GetExportArgs().dgContextEvaluation) {
+        MPlug outMeshPlug = finalMesh.findPlug("outMesh", true, &status);
+        if (status) {
+            MObject outMeshObj = outMeshPlug.asMObject(&status);
+            if (status && !outMeshObj.isNull()) {
+                geomMeshObj = outMeshObj;
+                sidecarMeshObj = outMeshObj;
+            }
+        }
+    }
     MFnMesh geomMesh(geomMeshObj, &status);
     if (!status) {
         TF_RUNTIME_ERROR(
@@ -219,6 +441,13 @@ PxrUsdTranslators_MeshWriter::writeMeshAttrs(
             GetDagPath().fullPathName().asChar());
         return false;
     }
+    MFnMesh sidecarMesh(sidecarMeshObj, &status);
+    if (!status) {
+        TF_RUNTIME_ERROR(
+            "Failed to get sidecar mesh at DAG path: %s",
+            GetDagPath().fullPathName().asChar());
+        return false;
+    }
 
     // Return if usdTime does not match if shape is animated.
     if (usdTime.IsDefault() == _IsMeshAnimated()) {
@@ -228,44 +457,27 @@ PxrUsdTranslators_MeshWriter::writeMeshAttrs(
         return true;
     }
 
-    unsigned int numVertices = geomMesh.numVertices();
-    unsigned int numPolygons = geomMesh.numPolygons();
+    // The animated data is only copied out of Maya here. It is converted and
+    // authored at the end, or by ComputeFrame() and AuthorFrame() for a
+    // staged write.
+    _MeshSample localSample;
+    _MeshSample& sample = _deferSample ? _pendingSample : localSample;
+    sample = _MeshSample();
 
-    // Set mesh attrs ==========
     // Get points
-    // TODO: Use memcpy()
+    sample.numVertices = geomMesh.numVertices();
     const float* mayaRawPoints = geomMesh.getRawPoints(&status);
-    VtArray<GfVec3f> points(numVertices);
-    for (unsigned int i = 0; i < numVertices; i++) {
-        unsigned int floatIndex = i*3;
-        points[i].Set(mayaRawPoints[floatIndex],
-                      mayaRawPoints[floatIndex+1],
-                      mayaRawPoints[floatIndex+2]);
+    if (mayaRawPoints) {
+        sample.rawPoints.assign(
+            mayaRawPoints, mayaRawPoints + sample.numVertices * 3);
+    } else {
+        sample.numVertices = 0;
     }
 
-    VtArray<GfVec3f> extent(2);
-    // Compute the extent using the raw points
-    UsdGeomPointBased::ComputeExtent(points, &extent);
-
-    _SetAttribute(primSchema.GetPointsAttr(), &points, usdTime);
-    _SetAttribute(primSchema.CreateExtentAttr(), &extent, usdTime);
-
-    // Get faceVertexIndices
-    unsigned int numFaceVertices = geomMesh.numFaceVertices(&status);
-    VtArray<int>     faceVertexCounts(numPolygons);
-    VtArray<int>     faceVertexIndices(numFaceVertices);
-    MIntArray mayaFaceVertexIndices; // used in loop below
-    unsigned int curFaceVertexIndex = 0;
-    for (unsigned int i = 0; i < numPolygons; i++) {
-        geomMesh.getPolygonVertices(i, mayaFaceVertexIndices);
-        faceVertexCounts[i] = mayaFaceVertexIndices.length();
-        for (unsigned int j=0; j < mayaFaceVertexIndices.length(); j++) {
-            faceVertexIndices[ curFaceVertexIndex ] = mayaFaceVertexIndices[j]; // push_back
-            curFaceVertexIndex++;
-        }
-    }
-    _SetAttribute(primSchema.GetFaceVertexCountsAttr(), &faceVertexCounts, usdTime);
-    _SetAttribute(primSchema.GetFaceVertexIndicesAttr(), &faceVertexIndices, usdTime);
+    // Get faceVertexCounts and faceVertexIndices
+    geomMesh.getVertices(
+        sample.mayaFaceVertexCounts,
+        sample.mayaFaceVertexIndices);
 
     // Read subdiv scheme tagging. If not set, we default to defaultMeshScheme
     // flag (this is specified by the job args but defaults to catmullClark).
@@ -279,20 +491,11 @@ PxrUsdTranslators_MeshWriter::writeMeshAttrs(
         // Polygonal mesh - export normals.
         bool emitNormals = true; // Default to emitting normals if no tagging.
         UsdMayaMeshUtil::GetEmitNormalsTag(finalMesh, &emitNormals);
-        if (emitNormals) {
-            VtArray<GfVec3f> meshNormals;
-            TfToken normalInterp;
-
-            if (UsdMayaMeshUtil::GetMeshNormals(
-                    geomMesh,
-                    &meshNormals,
-                    &normalInterp)) {
-                _SetAttribute(
-                    primSchema.GetNormalsAttr(),
-                    &meshNormals,
-                    usdTime);
-                primSchema.SetNormalsInterpolation(normalInterp);
-            }
+        if (emitNormals && geomMesh.numNormals() > 0) {
+            MIntArray normalIdCounts;
+            sample.emitNormals =
+                geomMesh.getNormals(sample.mayaNormals) &&
+                geomMesh.getNormalIds(normalIdCounts, sample.mayaNormalIds);
         }
     } else {
         // Subdivision surface - export subdiv-specific attributes.
@@ -310,11 +513,11 @@ PxrUsdTranslators_MeshWriter::writeMeshAttrs(
                           sdFVLinearInterpolation);
         }
 
-        assignSubDivTagsToUSDPrim(finalMesh, primSchema);
+        assignSubDivTagsToUSDPrim(sidecarMesh, primSchema);
     }
 
     // Holes - we treat InvisibleFaces as holes
-    MUintArray mayaHoles = finalMesh.getInvisibleFaces();
+    MUintArray mayaHoles = sidecarMesh.getInvisibleFaces();
     if (mayaHoles.length() > 0) {
         VtArray<int> subdHoles(mayaHoles.length());
         for (unsigned int i=0; i < mayaHoles.length(); i++) {
@@ -324,22 +527,15 @@ PxrUsdTranslators_MeshWriter::writeMeshAttrs(
         _SetAttribute(primSchema.GetHoleIndicesAttr(), &subdHoles);
     }
 
-    // == Write UVSets as Vec2f Primvars
+    // == Gather UVSets
     MStringArray uvSetNames;
     if (_GetExportArgs().exportMeshUVs) {
-        status = finalMesh.getUVSetNames(uvSetNames);
+        status = sidecarMesh.getUVSetNames(uvSetNames);
     }
     for (unsigned int i = 0; i < uvSetNames.length(); ++i) {
-        VtArray<GfVec2f> uvValues;
-        TfToken interpolation;
-        VtArray<int> assignmentIndices;
-
-        if (!_GetMeshUVSetData(
-                finalMesh,
-                uvSetNames[i],
-                &uvValues,
-                &interpolation,
-                &assignmentIndices)) {
+        sample.uvSets.emplace_back();
+        if (!_ReadMeshUVSet(sidecarMesh, uvSetNames[i], &sample.uvSets.back())) {
+            sample.uvSets.pop_back();
             continue;
         }
 
@@ -351,20 +547,14 @@ PxrUsdTranslators_MeshWriter::writeMeshAttrs(
         if (setName == "map1") {
             setName = UsdUtilsGetPrimaryUVSetName();
         }
-
-        _createUVPrimVar(primSchema,
-                         setName,
-                         usdTime,
-                         uvValues,
-                         interpolation,
-                         assignmentIndices);
+        sample.uvSets.back().name = setName;
     }
 
     // == Gather ColorSets
     std::vector<std::string> colorSetNames;
     if (_GetExportArgs().exportColorSets) {
         MStringArray mayaColorSetNames;
-        status = finalMesh.getColorSetNames(mayaColorSetNames);
+        status = sidecarMesh.getColorSetNames(mayaColorSetNames);
         colorSetNames.reserve(mayaColorSetNames.length());
         for (unsigned int i = 0; i < mayaColorSetNames.length(); i++) {
             colorSetNames.emplace_back(mayaColorSetNames[i].asChar());
@@ -373,11 +563,6 @@ PxrUsdTranslators_MeshWriter::writeMeshAttrs(
 
     std::set<std::string> colorSetNamesSet(colorSetNames.begin(), colorSetNames.end());
 
-    VtArray<GfVec3f> shadersRGBData;
-    VtArray<float> shadersAlphaData;
-    TfToken shadersInterpolation;
-    VtArray<int> shadersAssignmentIndices;
-
     // If we're exporting displayColor or we have color sets, gather colors and
     // opacities from the shaders assigned to the mesh and/or its faces.
     // If we find a displayColor color set, the shader colors and opacities
@@ -385,10 +570,10 @@ PxrUsdTranslators_MeshWriter::writeMeshAttrs(
     if (_GetExportArgs().exportDisplayColor || !colorSetNames.empty()) {
         UsdMayaUtil::GetLinearShaderColor(
             finalMesh,
-            &shadersRGBData,
-            &shadersAlphaData,
-            &shadersInterpolation,
-            &shadersAssignmentIndices);
+            &sample.shadersRGBData,
+            &sample.shadersAlphaData,
+            &sample.shadersInterpolation,
+            &sample.shadersAssignmentIndices);
     }
 
     for (const std::string& colorSetName: colorSetNames) {
@@ -414,47 +599,9 @@ PxrUsdTranslators_MeshWriter::writeMeshAttrs(
             continue;
         }
 
-        VtArray<GfVec3f> RGBData;
-        VtArray<float> AlphaData;
-        TfToken interpolation;
-        VtArray<int> assignmentIndices;
-        MFnMesh::MColorRepresentation colorSetRep;
-        bool clamped = false;
-
-        if (!_GetMeshColorSetData(
-                finalMesh,
-                MString(colorSetName.c_str()),
-                isDisplayColor,
-                shadersRGBData,
-                shadersAlphaData,
-                shadersAssignmentIndices,
-                &RGBData,
-                &AlphaData,
-                &interpolation,
-                &assignmentIndices,
-                &colorSetRep,
-                &clamped)) {
-            TF_WARN("Unable to retrieve colorSet data: %s on mesh: %s. "
-                    "Skipping...",
-                    colorSetName.c_str(), finalMesh.fullPathName().asChar());
-            continue;
-        }
-
-        if (isDisplayColor) {
-            // We tag the resulting displayColor/displayOpacity primvar as
-            // authored to make sure we reconstruct the color set on import.
-            _addDisplayPrimvars(
-                primSchema,
-                usdTime,
-                colorSetRep,
-                RGBData,
-                AlphaData,
-                interpolation,
-                assignmentIndices,
-                clamped,
-                true);
-        } else {
-            const std::string sanitizedName = UsdMayaUtil::SanitizeColorSetName(colorSetName);
+        std::string sanitizedName = colorSetName;
+        if (!isDisplayColor) {
+            sanitizedName = UsdMayaUtil::SanitizeColorSetName(colorSetName);
             // if our sanitized name is different than our current one and the
             // sanitized name already exists, it means 2 things are trying to
             // write to the same primvar.  warn and continue.
@@ -465,58 +612,29 @@ PxrUsdTranslators_MeshWriter::writeMeshAttrs(
                         colorSetName.c_str(), sanitizedName.c_str());
                 continue;
             }
+        }
 
-            TfToken colorSetNameToken = TfToken(sanitizedName);
-            if (colorSetRep == MFnMesh::kAlpha) {
-                _createAlphaPrimVar(primSchema,
-                                    colorSetNameToken,
-                                    usdTime,
-                                    AlphaData,
-                                    interpolation,
-                                    assignmentIndices,
-                                    clamped);
-            } else if (colorSetRep == MFnMesh::kRGB) {
-                _createRGBPrimVar(primSchema,
-                                  colorSetNameToken,
-                                  usdTime,
-                                  RGBData,
-                                  interpolation,
-                                  assignmentIndices,
-                                  clamped);
-            } else if (colorSetRep == MFnMesh::kRGBA) {
-                _createRGBAPrimVar(primSchema,
-                                   colorSetNameToken,
-                                   usdTime,
-                                   RGBData,
-                                   AlphaData,
-                                   interpolation,
-                                   assignmentIndices,
-                                   clamped);
-            }
+        sample.colorSets.emplace_back();
+        _ColorSetSample& colorSet = sample.colorSets.back();
+        if (!_ReadMeshColorSet(
+                sidecarMesh,
+                MString(colorSetName.c_str()),
+                &colorSet)) {
+            TF_WARN("Unable to retrieve colorSet data: %s on mesh: %s. "
+                    "Skipping...",
+                    colorSetName.c_str(), finalMesh.fullPathName().asChar());
+            sample.colorSets.pop_back();
+            continue;
         }
+        colorSet.name = TfToken(sanitizedName);
+        colorSet.isDisplayColor = isDisplayColor;
     }
 
-    // _addDisplayPrimvars() will only author displayColor and displayOpacity
-    // if no authored opinions exist, so the code below only has an effect if
-    // we did NOT find a displayColor color set above.
-    if (_GetExportArgs().exportDisplayColor) {
-        // Using the shader default values (an alpha of zero, in particular)
-        // results in Gprims rendering the same way in usdview as they do in
-        // Maya (i.e. unassigned components are invisible).
-        //
-        // Since these colors come from the shaders and not a colorset, we are
-        // not adding the clamp attribute as custom data. We also don't need to
-        // reconstruct a color set from them on import since they originated
-        // from the bound shader(s), so the authored flag is set to false.
-        _addDisplayPrimvars(primSchema,
-                            usdTime,
-                            MFnMesh::kRGBA,
-                            shadersRGBData,
-                            shadersAlphaData,
-                            shadersInterpolation,
-                            shadersAssignmentIndices,
-                            false,
-                            false);
+    if (_deferSample) {
+        _hasPendingSample = true;
+    } else {
+        _ComputeMeshSample(&sample);
+        _AuthorMeshSample(usdTime, primSchema, &sample);
     }
 
     return true;
@@ -34,12 +34,17 @@
 #include "pxr/usd/usdGeom/mesh.h"
 #include "pxr/usd/usdGeom/primvar.h"
 
+#include <maya/MColorArray.h>
+#include <maya/MFloatArray.h>
+#include <maya/MFloatVectorArray.h>
 #include <maya/MFnDependencyNode.h>
 #include <maya/MFnMesh.h>
+#include <maya/MIntArray.h>
 #include <maya/MString.h>
 
 #include <set>
 #include <string>
+#include <vector>
 
 
 PXR_NAMESPACE_OPEN_SCOPE
@@ -58,12 +63,99 @@ public:
     void Write(const UsdTimeCode& usdTime) override;
     bool ExportsGprims() const override;
 
+    /// Animated meshes copy their points, topology, normals, UVs and color
+    /// sets out of Maya in ReadFrame(), convert them to USD values (and
+    /// compute the extent) in ComputeFrame(), and author them in
+    /// AuthorFrame().
+    bool SupportsStagedWrite() const override;
+    void ReadFrame(const UsdTimeCode& usdTime) override;
+    void ComputeFrame(const UsdTimeCode& usdTime) override;
+    void AuthorFrame(const UsdTimeCode& usdTime) override;
+
+    /// With dgContextEvaluation, the mesh geometry, UVs, color sets and
+    /// subdiv tags are all read from the outMesh plug, so that they are
+    /// evaluated in the current DG context.
+    bool SupportsDGContextEvaluation() const override;
+
     void PostExport() override;
 
 protected:
     bool writeMeshAttrs(const UsdTimeCode& usdTime, UsdGeomMesh& primSchema);
 
 private:
+    /// The data of a UV set read from Maya, and the primvar values converted
+    /// from it.
+    struct _UVSetSample
+    {
+        TfToken name;
+        MFloatArray uArray;
+        MFloatArray vArray;
+        MIntArray uvCounts;
+        MIntArray uvIds;
+
+        bool valid = false;
+        VtArray<GfVec2f> values;
+        TfToken interpolation;
+        VtArray<int> assignmentIndices;
+    };
+
+    /// The data of a color set read from Maya, and the primvar values
+    /// converted from it.
+    struct _ColorSetSample
+    {
+        TfToken name;
+        bool isDisplayColor = false;
+        MColorArray colors;
+        MFnMesh::MColorRepresentation colorSetRep = MFnMesh::kRGBA;
+        bool clamped = false;
+
+        bool valid = false;
+        VtArray<GfVec3f> RGBData;
+        VtArray<float> AlphaData;
+        TfToken interpolation;
+        VtArray<int> assignmentIndices;
+    };
+
+    /// The animated data of the mesh at one time sample. The Maya data is
+    /// copied by writeMeshAttrs(), converted by _ComputeMeshSample() without
+    /// accessing Maya or USD, and authored by _AuthorMeshSample().
+    struct _MeshSample
+    {
+        int numVertices = 0;
+        std::vector<float> rawPoints;
+        MIntArray mayaFaceVertexCounts;
+        MIntArray mayaFaceVertexIndices;
+        bool emitNormals = false;
+        MFloatVectorArray mayaNormals;
+        MIntArray mayaNormalIds;
+        std::vector<_UVSetSample> uvSets;
+        std::vector<_ColorSetSample> colorSets;
+
+        /// Colors and opacities of the shaders assigned to the mesh, which
+        /// are read from Maya but need no conversion.
+        VtArray<GfVec3f> shadersRGBData;
+        VtArray<float> shadersAlphaData;
+        TfToken shadersInterpolation;
+        VtArray<int> shadersAssignmentIndices;
+
+        VtArray<GfVec3f> points;
+        VtArray<GfVec3f> extent;
+        VtArray<int> faceVertexCounts;
+        VtArray<int> faceVertexIndices;
+        bool normalsValid = false;
+        VtArray<GfVec3f> normals;
+    };
+
+    /// Converts the Maya data in \p sample. This accesses neither Maya nor
+    /// USD, so it may be called from any thread.
+    static void _ComputeMeshSample(_MeshSample* sample);
+
+    /// Authors the values converted by _ComputeMeshSample() at \p usdTime.
+    void _AuthorMeshSample(
+            const UsdTimeCode& usdTime,
+            UsdGeomMesh& primSchema,
+            _MeshSample* sample);
+
     bool isMeshValid();
     void assignSubDivTagsToUSDPrim(MFnMesh& meshFn, UsdGeomMesh& primSchema);
 
@@ -78,26 +170,31 @@ private:
     /// This should only be called once at the default time.
     MObject writeSkinningData(UsdGeomMesh& primSchema);
 
-    bool _GetMeshUVSetData(
+    /// Copies the UVs of \p uvSetName and their assignments out of \p mesh.
+    /// Returns false if the UV set has no assigned UVs.
+    static bool _ReadMeshUVSet(
             const MFnMesh& mesh,
             const MString& uvSetName,
-            VtArray<GfVec2f>* uvArray,
-            TfToken* interpolation,
-            VtArray<int>* assignmentIndices);
+            _UVSetSample* uvSet);
 
-    bool _GetMeshColorSetData(
-            MFnMesh& mesh,
+    /// Converts the UVs copied by _ReadMeshUVSet() into primvar values and
+    /// indices. This accesses neither Maya nor USD.
+    static void _ComputeMeshUVSet(
+            const _MeshSample& sample,
+            _UVSetSample* uvSet);
+
+    /// Copies the face vertex colors of \p colorSet out of \p mesh.
+    /// Returns false if the color set has no colors.
+    static bool _ReadMeshColorSet(
+            const MFnMesh& mesh,
             const MString& colorSet,
-            bool isDisplayColor,
-            const VtArray<GfVec3f>& shadersRGBData,
-            const VtArray<float>& shadersAlphaData,
-            const VtArray<int>& shadersAssignmentIndices,
-            VtArray<GfVec3f>* colorSetRGBData,
-            VtArray<float>* colorSetAlphaData,
-            TfToken* interpolation,
-            VtArray<int>* colorSetAssignmentIndices,
-            MFnMesh::MColorRepresentation* colorSetRep,
-            bool* clamped);
+            _ColorSetSample* colorSetSample);
+
+    /// Converts the colors copied by _ReadMeshColorSet() into primvar values
+    /// and indices. This accesses neither Maya nor USD.
+    static void _ComputeMeshColorSet(
+            const _MeshSample& sample,
+            _ColorSetSample* colorSetSample);
 
     bool _createAlphaPrimVar(
             UsdGeomGprim& primSchema,
@@ -196,6 +293,13 @@ private:
     /// Input mesh before any skeletal deformations, cached between iterations.
     MObject _skelInputMesh;
 
+    /// When set, writeMeshAttrs() only reads the animated data into
+    /// _pendingSample. ComputeFrame() then converts it, and AuthorFrame()
+    /// authors it.
+    bool _deferSample = false;
+    bool _hasPendingSample = false;
+    _MeshSample _pendingSample;
+
     /// Set of color sets that should be excluded.
     /// Intermediate processes may alter this set prior to writeMeshAttrs().
     std::set<std::string> _excludeColorSets;
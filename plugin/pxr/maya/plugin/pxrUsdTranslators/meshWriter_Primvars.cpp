@@ -31,76 +31,100 @@
 #include <maya/MColorArray.h>
 #include <maya/MFloatArray.h>
 #include <maya/MFnMesh.h>
-#include <maya/MItMeshFaceVertex.h>
+#include <maya/MIntArray.h>
 #include <maya/MItMeshVertex.h>
 
+#include <algorithm>
+
 PXR_NAMESPACE_OPEN_SCOPE
 
+/* static */
 bool
-PxrUsdTranslators_MeshWriter::_GetMeshUVSetData(
+PxrUsdTranslators_MeshWriter::_ReadMeshUVSet(
         const MFnMesh& mesh,
         const MString& uvSetName,
-        VtArray<GfVec2f>* uvArray,
-        TfToken* interpolation,
-        VtArray<int>* assignmentIndices)
+        _UVSetSample* uvSet)
 {
     MStatus status;
 
     // Sanity check first to make sure this UV set even has assigned values
     // before we attempt to do anything with the data.
-    MIntArray uvCounts, uvIds;
-    status = mesh.getAssignedUVs(uvCounts, uvIds, &uvSetName);
+    status = mesh.getAssignedUVs(uvSet->uvCounts, uvSet->uvIds, &uvSetName);
     if (status != MS::kSuccess) {
         return false;
     }
-    if (uvCounts.length() == 0 || uvIds.length() == 0) {
+    if (uvSet->uvCounts.length() == 0 || uvSet->uvIds.length() == 0) {
         return false;
     }
 
     // using itFV.getUV() does not always give us the right answer, so
-    // instead, we have to use itFV.getUVIndex() and use that to index into the
-    // UV set.
-    MFloatArray uArray;
-    MFloatArray vArray;
-    mesh.getUVs(uArray, vArray, &uvSetName);
-    if (uArray.length() != vArray.length()) {
+    // instead, we use the assigned UV ids to index into the UV set.
+    mesh.getUVs(uvSet->uArray, uvSet->vArray, &uvSetName);
+    if (uvSet->uArray.length() != uvSet->vArray.length()) {
         return false;
     }
 
+    return true;
+}
+
+/* static */
+void
+PxrUsdTranslators_MeshWriter::_ComputeMeshUVSet(
+        const _MeshSample& sample,
+        _UVSetSample* uvSet)
+{
+    const VtArray<int>& faceVertexCounts = sample.faceVertexCounts;
+    if (uvSet->uvCounts.length() != faceVertexCounts.size()) {
+        return;
+    }
+
     // We'll populate the assignment indices for every face vertex, but we'll
     // only push values into the data if the face vertex has a value. All face
-    // vertices are initially unassigned/unauthored.
-    const unsigned int numFaceVertices = mesh.numFaceVertices(&status);
-    uvArray->clear();
-    assignmentIndices->assign((size_t)numFaceVertices, -1);
-    *interpolation = UsdGeomTokens->faceVarying;
-
-    MItMeshFaceVertex itFV(mesh.object());
+    // vertices are initially unassigned/unauthored. A face either has a UV
+    // for each of its face vertices or none at all.
+    VtArray<GfVec2f>& uvArray = uvSet->values;
+    VtArray<int>& assignmentIndices = uvSet->assignmentIndices;
+    uvArray.clear();
+    assignmentIndices.assign(sample.faceVertexIndices.size(), -1);
+    uvSet->interpolation = UsdGeomTokens->faceVarying;
+
+    const unsigned int numUVs = uvSet->uArray.length();
+    const unsigned int numUVIds = uvSet->uvIds.length();
     unsigned int fvi = 0;
-    for (itFV.reset(); !itFV.isDone(); itFV.next(), ++fvi) {
-        if (!itFV.hasUVs(uvSetName)) {
-            // No UVs for this faceVertex, so leave it unassigned.
-            continue;
-        }
+    unsigned int uvIdIndex = 0;
+    for (size_t faceIndex = 0; faceIndex < faceVertexCounts.size(); ++faceIndex) {
+        const int numFaceVertices = faceVertexCounts[faceIndex];
+        const int numFaceUVs = uvSet->uvCounts[faceIndex];
+        for (int i = 0; i < numFaceVertices; ++i, ++fvi) {
+            if (i >= numFaceUVs) {
+                // No UVs for this faceVertex, so leave it unassigned.
+                continue;
+            }
 
-        int uvIndex;
-        itFV.getUVIndex(uvIndex, &uvSetName);
-        if (uvIndex < 0 || static_cast<size_t>(uvIndex) >= uArray.length()) {
-            return false;
-        }
+            if (uvIdIndex + i >= numUVIds) {
+                return;
+            }
+            const int uvIndex = uvSet->uvIds[uvIdIndex + i];
+            if (uvIndex < 0 || static_cast<unsigned int>(uvIndex) >= numUVs) {
+                return;
+            }
 
-        GfVec2f value(uArray[uvIndex], vArray[uvIndex]);
-        uvArray->push_back(value);
-        (*assignmentIndices)[fvi] = uvArray->size() - 1;
+            GfVec2f value(uvSet->uArray[uvIndex], uvSet->vArray[uvIndex]);
+            uvArray.push_back(value);
+            assignmentIndices[fvi] = uvArray.size() - 1;
+        }
+        uvIdIndex += std::max(numFaceUVs, 0);
     }
 
-    UsdMayaUtil::MergeEquivalentIndexedValues(uvArray,
-                                                 assignmentIndices);
-    UsdMayaUtil::CompressFaceVaryingPrimvarIndices(mesh,
-                                                      interpolation,
-                                                      assignmentIndices);
+    UsdMayaUtil::MergeEquivalentIndexedValues(&uvArray,
+                                                 &assignmentIndices);
+    UsdMayaUtil::CompressFaceVaryingPrimvarIndices(sample.faceVertexCounts,
+                                                      sample.faceVertexIndices,
+                                                      sample.numVertices,
+                                                      &uvSet->interpolation,
+                                                      &assignmentIndices);
 
-    return true;
+    uvSet->valid = true;
 }
 
 // This function condenses distinct indices that point to the same color values
@@ -179,173 +203,196 @@ _LinearColorFromColorSet(
     return c;
 }
 
-/// Collect values from the color set named \p colorSet.
-/// If \p isDisplayColor is true and this color set represents displayColor,
-/// the unauthored/unpainted values in the color set will be filled in using
-/// the shader values in \p shadersRGBData and \p shadersAlphaData if available.
-/// Values are gathered per face vertex, but then the data is compressed to
-/// vertex, uniform, or constant interpolation if possible.
-/// Unauthored/unpainted values will be given the index -1.
-bool PxrUsdTranslators_MeshWriter::_GetMeshColorSetData(
-        MFnMesh& mesh,
+/* static */
+bool
+PxrUsdTranslators_MeshWriter::_ReadMeshColorSet(
+        const MFnMesh& mesh,
         const MString& colorSet,
-        bool isDisplayColor,
-        const VtArray<GfVec3f>& shadersRGBData,
-        const VtArray<float>& shadersAlphaData,
-        const VtArray<int>& shadersAssignmentIndices,
-        VtArray<GfVec3f>* colorSetRGBData,
-        VtArray<float>* colorSetAlphaData,
-        TfToken* interpolation,
-        VtArray<int>* colorSetAssignmentIndices,
-        MFnMesh::MColorRepresentation* colorSetRep,
-        bool* clamped)
+        _ColorSetSample* colorSetSample)
 {
     // If there are no colors, return immediately as failure.
     if (mesh.numColors(colorSet) == 0) {
         return false;
     }
 
-    MColorArray colorSetData;
     const MColor unsetColor(-FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX);
-    if (mesh.getFaceVertexColors(colorSetData, &colorSet, &unsetColor)
+    if (mesh.getFaceVertexColors(colorSetSample->colors, &colorSet, &unsetColor)
             == MS::kFailure) {
         return false;
     }
 
-    if (colorSetData.length() == 0) {
+    if (colorSetSample->colors.length() == 0) {
         return false;
     }
 
     // Get the color set representation and clamping.
-    *colorSetRep = mesh.getColorRepresentation(colorSet);
-    *clamped = mesh.isColorClamped(colorSet);
+    colorSetSample->colorSetRep = mesh.getColorRepresentation(colorSet);
+    colorSetSample->clamped = mesh.isColorClamped(colorSet);
+
+    return true;
+}
+
+/// Convert the face vertex colors of a color set.
+/// If the color set represents displayColor, the unauthored/unpainted values
+/// in the color set will be filled in using the shader values in the sample
+/// if available.
+/// Values are gathered per face vertex, but then the data is compressed to
+/// vertex, uniform, or constant interpolation if possible.
+/// Unauthored/unpainted values will be given the index -1.
+/* static */
+void
+PxrUsdTranslators_MeshWriter::_ComputeMeshColorSet(
+        const _MeshSample& sample,
+        _ColorSetSample* colorSetSample)
+{
+    MColorArray& colorSetData = colorSetSample->colors;
+    if (colorSetData.length() != sample.faceVertexIndices.size()) {
+        return;
+    }
+
+    const bool isDisplayColor = colorSetSample->isDisplayColor;
+    const MFnMesh::MColorRepresentation colorSetRep =
+        colorSetSample->colorSetRep;
+    const VtArray<GfVec3f>& shadersRGBData = sample.shadersRGBData;
+    const VtArray<float>& shadersAlphaData = sample.shadersAlphaData;
+    const VtArray<int>& shadersAssignmentIndices =
+        sample.shadersAssignmentIndices;
+    const MColor unsetColor(-FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX);
 
     // We'll populate the assignment indices for every face vertex, but we'll
     // only push values into the data if the face vertex has a value. All face
     // vertices are initially unassigned/unauthored.
+    VtArray<GfVec3f>* colorSetRGBData = &colorSetSample->RGBData;
+    VtArray<float>* colorSetAlphaData = &colorSetSample->AlphaData;
+    VtArray<int>* colorSetAssignmentIndices =
+        &colorSetSample->assignmentIndices;
     colorSetRGBData->clear();
     colorSetAlphaData->clear();
     colorSetAssignmentIndices->assign((size_t)colorSetData.length(), -1);
-    *interpolation = UsdGeomTokens->faceVarying;
+    colorSetSample->interpolation = UsdGeomTokens->faceVarying;
 
     // Loop over every face vertex to populate the value arrays.
-    MItMeshFaceVertex itFV(mesh.object());
     unsigned int fvi = 0;
-    for (itFV.reset(); !itFV.isDone(); itFV.next(), ++fvi) {
-        // If this is a displayColor color set, we may need to fallback on the
-        // bound shader colors/alphas for this face in some cases. In
-        // particular, if the color set is alpha-only, we fallback on the
-        // shader values for the color. If the color set is RGB-only, we
-        // fallback on the shader values for alpha only. If there's no authored
-        // color for this face vertex, we use both the color AND alpha values
-        // from the shader.
-        bool useShaderColorFallback = false;
-        bool useShaderAlphaFallback = false;
-        if (isDisplayColor) {
-            if (colorSetData[fvi] == unsetColor) {
-                useShaderColorFallback = true;
-                useShaderAlphaFallback = true;
-            } else if (*colorSetRep == MFnMesh::kAlpha) {
-                // The color set does not provide color, so fallback on shaders.
-                useShaderColorFallback = true;
-            } else if (*colorSetRep == MFnMesh::kRGB) {
-                // The color set does not provide alpha, so fallback on shaders.
-                useShaderAlphaFallback = true;
+    const int numFaces = static_cast<int>(sample.faceVertexCounts.size());
+    for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
+        const int numFaceVertices = sample.faceVertexCounts[faceIndex];
+        for (int i = 0; i < numFaceVertices; ++i, ++fvi) {
+            // If this is a displayColor color set, we may need to fallback on the
+            // bound shader colors/alphas for this face in some cases. In
+            // particular, if the color set is alpha-only, we fallback on the
+            // shader values for the color. If the color set is RGB-only, we
+            // fallback on the shader values for alpha only. If there's no authored
+            // color for this face vertex, we use both the color AND alpha values
+            // from the shader.
+            bool useShaderColorFallback = false;
+            bool useShaderAlphaFallback = false;
+            if (isDisplayColor) {
+                if (colorSetData[fvi] == unsetColor) {
+                    useShaderColorFallback = true;
+                    useShaderAlphaFallback = true;
+                } else if (colorSetRep == MFnMesh::kAlpha) {
+                    // The color set does not provide color, so fallback on shaders.
+                    useShaderColorFallback = true;
+                } else if (colorSetRep == MFnMesh::kRGB) {
+                    // The color set does not provide alpha, so fallback on shaders.
+                    useShaderAlphaFallback = true;
+                }
             }
-        }
 
-        // If we're exporting displayColor and we use the value from the color
-        // set, we need to convert it to linear.
-        bool convertDisplayColorToLinear = isDisplayColor;
-
-        // Shader values for the mesh could be constant
-        // (shadersAssignmentIndices is empty) or uniform.
-        int faceIndex = itFV.faceId();
-        if (useShaderColorFallback) {
-            // There was no color value in the color set to use, so we use the
-            // shader color, or the default color if there is no shader color.
-            // This color will already be in linear space, so don't convert it
-            // again.
-            convertDisplayColorToLinear = false;
-
-            int valueIndex = -1;
-            if (shadersAssignmentIndices.empty()) {
-                if (shadersRGBData.size() == 1) {
-                    valueIndex = 0;
-                }
-            } else if (faceIndex >= 0 && 
-                static_cast<size_t>(faceIndex) < shadersAssignmentIndices.size()) {
+            // If we're exporting displayColor and we use the value from the color
+            // set, we need to convert it to linear.
+            bool convertDisplayColorToLinear = isDisplayColor;
+
+            // Shader values for the mesh could be constant
+            // (shadersAssignmentIndices is empty) or uniform.
+            if (useShaderColorFallback) {
+                // There was no color value in the color set to use, so we use the
+                // shader color, or the default color if there is no shader color.
+                // This color will already be in linear space, so don't convert it
+                // again.
+                convertDisplayColorToLinear = false;
+
+                int valueIndex = -1;
+                if (shadersAssignmentIndices.empty()) {
+                    if (shadersRGBData.size() == 1) {
+                        valueIndex = 0;
+                    }
+                } else if (faceIndex >= 0 && 
+                    static_cast<size_t>(faceIndex) < shadersAssignmentIndices.size()) {
 
-                int tmpIndex = shadersAssignmentIndices[faceIndex];
-                if (tmpIndex >= 0 && 
-                    static_cast<size_t>(tmpIndex) < shadersRGBData.size()) {
-                    valueIndex = tmpIndex;
+                    int tmpIndex = shadersAssignmentIndices[faceIndex];
+                    if (tmpIndex >= 0 && 
+                        static_cast<size_t>(tmpIndex) < shadersRGBData.size()) {
+                        valueIndex = tmpIndex;
+                    }
+                }
+                if (valueIndex >= 0) {
+                    colorSetData[fvi][0] = shadersRGBData[valueIndex][0];
+                    colorSetData[fvi][1] = shadersRGBData[valueIndex][1];
+                    colorSetData[fvi][2] = shadersRGBData[valueIndex][2];
+                } else {
+                    // No shader color to fallback on. Use the default shader color.
+                    colorSetData[fvi][0] = _ShaderDefaultRGB[0];
+                    colorSetData[fvi][1] = _ShaderDefaultRGB[1];
+                    colorSetData[fvi][2] = _ShaderDefaultRGB[2];
                 }
             }
-            if (valueIndex >= 0) {
-                colorSetData[fvi][0] = shadersRGBData[valueIndex][0];
-                colorSetData[fvi][1] = shadersRGBData[valueIndex][1];
-                colorSetData[fvi][2] = shadersRGBData[valueIndex][2];
-            } else {
-                // No shader color to fallback on. Use the default shader color.
-                colorSetData[fvi][0] = _ShaderDefaultRGB[0];
-                colorSetData[fvi][1] = _ShaderDefaultRGB[1];
-                colorSetData[fvi][2] = _ShaderDefaultRGB[2];
-            }
-        }
-        if (useShaderAlphaFallback) {
-            int valueIndex = -1;
-            if (shadersAssignmentIndices.empty()) {
-                if (shadersAlphaData.size() == 1) {
-                    valueIndex = 0;
+            if (useShaderAlphaFallback) {
+                int valueIndex = -1;
+                if (shadersAssignmentIndices.empty()) {
+                    if (shadersAlphaData.size() == 1) {
+                        valueIndex = 0;
+                    }
+                } else if (faceIndex >= 0 && 
+                    static_cast<size_t>(faceIndex) < shadersAssignmentIndices.size()) {
+                    int tmpIndex = shadersAssignmentIndices[faceIndex];
+                    if (tmpIndex >= 0 && 
+                        static_cast<size_t>(tmpIndex) < shadersAlphaData.size()) {
+                        valueIndex = tmpIndex;
+                    }
                 }
-            } else if (faceIndex >= 0 && 
-                static_cast<size_t>(faceIndex) < shadersAssignmentIndices.size()) {
-                int tmpIndex = shadersAssignmentIndices[faceIndex];
-                if (tmpIndex >= 0 && 
-                    static_cast<size_t>(tmpIndex) < shadersAlphaData.size()) {
-                    valueIndex = tmpIndex;
+                if (valueIndex >= 0) {
+                    colorSetData[fvi][3] = shadersAlphaData[valueIndex];
+                } else {
+                    // No shader alpha to fallback on. Use the default shader alpha.
+                    colorSetData[fvi][3] = _ShaderDefaultAlpha;
                 }
             }
-            if (valueIndex >= 0) {
-                colorSetData[fvi][3] = shadersAlphaData[valueIndex];
-            } else {
-                // No shader alpha to fallback on. Use the default shader alpha.
-                colorSetData[fvi][3] = _ShaderDefaultAlpha;
-            }
-        }
 
-        // If we have a color/alpha value, add it to the data to be returned.
-        if (colorSetData[fvi] != unsetColor) {
-            GfVec3f rgbValue = _ColorSetDefaultRGB;
-            float alphaValue = _ColorSetDefaultAlpha;
+            // If we have a color/alpha value, add it to the data to be returned.
+            if (colorSetData[fvi] != unsetColor) {
+                GfVec3f rgbValue = _ColorSetDefaultRGB;
+                float alphaValue = _ColorSetDefaultAlpha;
 
-            if (useShaderColorFallback              || 
-                    (*colorSetRep == MFnMesh::kRGB) || 
-                    (*colorSetRep == MFnMesh::kRGBA)) {
-                rgbValue = _LinearColorFromColorSet(colorSetData[fvi],
-                                                    convertDisplayColorToLinear);
-            }
-            if (useShaderAlphaFallback                || 
-                    (*colorSetRep == MFnMesh::kAlpha) || 
-                    (*colorSetRep == MFnMesh::kRGBA)) {
-                alphaValue = colorSetData[fvi][3];
-            }
+                if (useShaderColorFallback              || 
+                        (colorSetRep == MFnMesh::kRGB) || 
+                        (colorSetRep == MFnMesh::kRGBA)) {
+                    rgbValue = _LinearColorFromColorSet(colorSetData[fvi],
+                                                        convertDisplayColorToLinear);
+                }
+                if (useShaderAlphaFallback                || 
+                        (colorSetRep == MFnMesh::kAlpha) || 
+                        (colorSetRep == MFnMesh::kRGBA)) {
+                    alphaValue = colorSetData[fvi][3];
+                }
 
-            colorSetRGBData->push_back(rgbValue);
-            colorSetAlphaData->push_back(alphaValue);
-            (*colorSetAssignmentIndices)[fvi] = colorSetRGBData->size() - 1;
+                colorSetRGBData->push_back(rgbValue);
+                colorSetAlphaData->push_back(alphaValue);
+                (*colorSetAssignmentIndices)[fvi] = colorSetRGBData->size() - 1;
+            }
         }
     }
 
     _MergeEquivalentColorSetValues(colorSetRGBData,
                                    colorSetAlphaData,
                                    colorSetAssignmentIndices);
-    UsdMayaUtil::CompressFaceVaryingPrimvarIndices(mesh,
-                                                      interpolation,
+    UsdMayaUtil::CompressFaceVaryingPrimvarIndices(sample.faceVertexCounts,
+                                                      sample.faceVertexIndices,
+                                                      sample.numVertices,
+                                                      &colorSetSample->interpolation,
                                                       colorSetAssignmentIndices);
 
-    return true;
+    colorSetSample->valid = true;
 }
 
 bool PxrUsdTranslators_MeshWriter::_createAlphaPrimVar(
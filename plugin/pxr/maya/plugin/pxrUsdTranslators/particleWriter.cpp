@@ -213,6 +213,14 @@ PxrUsdTranslators_ParticleWriter::PxrUsdTranslators_ParticleWriter(
     initializeUserAttributes();
 }
 
+/* virtual */
+bool
+PxrUsdTranslators_ParticleWriter::SupportsDGContextEvaluation() const
+{
+    // Reads its data through function sets at the current scene time.
+    return false;
+}
+
 /* virtual */
 void
 PxrUsdTranslators_ParticleWriter::Write(const UsdTimeCode& usdTime)
@@ -47,6 +47,7 @@ public:
             UsdMayaWriteJobContext& jobCtx);
 
     void Write(const UsdTimeCode& usdTime) override;
+    bool SupportsDGContextEvaluation() const override;
 
 private:
     void writeParams(const UsdTimeCode& usdTime, UsdGeomPoints& points);